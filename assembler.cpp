@@ -0,0 +1,1152 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <deque>
+#include <set>
+
+#include "assembler.h"
+#include "definitions.h"
+#include "object_file.h"
+#include "symbol_table.h"
+
+namespace assembler {
+
+    const instruction_info instructions[] = {
+        {"LOAD",   LOAD,   "ar"},
+        {"STORE",  STORE,  "ra"},
+        {"STORER", STORER, "rrr"},
+        {"SET",    SET,    "vr"},
+        {"INC",    INC,    "r"},
+        {"DEC",    DEC,    "r"},
+        {"JMP",    JMP,    "a"},
+        {"CMP",    CMP,    "rv"},
+        {"CMPR",   CMPR,   "rr"},
+        {"JZ",     JZ,     "ra"},
+        {"JNZ",    JNZ,    "ra"},
+        {"JC",     JC,     "a"},
+        {"JNC",    JNC,    "a"},
+        {"ADD",    ADD,    "vr"},
+        {"ADDR",   ADDR,   "rr"},
+        {"PUSH",   PUSH,   "p"},
+        {"POP",    POP,    "p"},
+        {"CALL",   CALL,   "a"},
+        {"RET",    RET,    ""},
+        {"SUB",    SUB,    "vr"},
+        {"SUBR",   SUBR,   "rr"},
+        {"MUL",    MUL,    "vrr"},
+        {"MULR",   MULR,   "rrr"},
+        {"DIV",    DIV,    "vrr"},
+        {"DIVR",   DIVR,   "rrr"},
+        {"SHL",    SHL,    "vr"},
+        {"SHR",    SHR,    "vr"},
+        {"MEMCPY", MEMCPY, "rrrrrr"},
+        {"MEMSET", MEMSET, "rrrrr"},
+        {"MEMCMP", MEMCMP, "rrrrrrr"},
+        {"HALT",   HALT,   ""},
+        {"NOP",    NOP,    ""},
+    };
+
+    const uint32_t memory_size = 0x10000;
+
+    /**
+     * One line emitting bytes (an instruction or DB), encoded by the first
+     * pass with the symbols left to the relocations.
+     */
+    class item
+    {
+    public:
+        std::string_view file;
+        int line{};
+        uint32_t size{};
+        uint32_t address{};
+        bool fixed{};
+        bool instruction{};
+        size_t unit{};
+        uint32_t offset{};                      // offset in the unit
+        std::vector<uint8_t> bytes;
+        std::vector<data_run> runs;             // DB pieces, none for instructions
+        std::vector<relocation> relocations;
+    };
+
+    /**
+     * Part of an item written to the memory image: a fill run long enough
+     * for a fill segment or the literal bytes of the item.
+     */
+    class piece
+    {
+    public:
+        size_t item{};
+        bool fill{};
+    };
+
+    /**
+     * Items of one file in a row overwriting the data of one other item,
+     * reported by one warning (an include placed over a reserved block
+     * would else give one per line).
+     */
+    class overlap_run
+    {
+    public:
+        size_t first{};         // first overwriting item
+        size_t last{};          // last overwriting item
+        size_t other{};         // item whose data they overwrite
+        uint32_t bytes{};       // overwritten bytes
+        bool open{};
+    };
+
+    const uint32_t fill_min = 16;               // shorter runs are put as data
+
+    /**
+     * Floating items placed together. Consecutive instructions stay in one
+     * unit (so the code falls through), every DB line is a unit of its own.
+     */
+    class unit
+    {
+    public:
+        uint32_t size{};
+        uint32_t address{};
+    };
+
+    class label_ref
+    {
+    public:
+        std::string name;
+        size_t item{};                          // items.size() - end of code
+    };
+
+    class pending_label
+    {
+    public:
+        std::string name;
+        std::string_view file;
+        int line{};
+    };
+
+    /**
+     * Sizes of the assembly state, to undo an object whose checks failed.
+     */
+    class state_mark
+    {
+    public:
+        size_t items{};
+        size_t units{};
+        uint32_t last_unit_size{};
+        size_t labels{};
+        size_t pending_labels{};
+        size_t symbols{};
+        size_t errors{};
+        size_t warnings{};
+    };
+
+    class assembly_state
+    {
+    public:
+        symbol_table symbols;
+        std::vector<item> items;
+        std::vector<unit> units;
+        std::vector<label_ref> labels;
+        std::vector<pending_label> pending_labels;
+        assembly_parser::source_arena &sources;
+        const object_cache *cache;
+        std::deque<std::string> names;          // file names of the items
+        std::vector<std::string> include_stack;
+        std::vector<std::string> &errors;
+        std::vector<std::string> &warnings;
+
+        assembly_state(assembly_parser::source_arena &sources, const object_cache *cache,
+                       std::vector<std::string> &errors, std::vector<std::string> &warnings)
+            : sources(sources), cache(cache), errors(errors), warnings(warnings) {}
+    };
+
+    std::string location(const std::string_view file, const int line)
+    {
+        return std::string(file) + ":" + std::to_string(line + 1);
+    }
+
+    void add_error(assembly_state &state, const std::string_view file, const int line, const std::string &message)
+    {
+        state.errors.push_back(location(file, line) + ": " + message);
+    }
+
+    std::string_view intern(assembly_state &state, const std::string &name)
+    {
+        for (const auto &known : state.names)
+        {
+            if (known == name) return known;
+        }
+        state.names.push_back(name);
+        return state.names.back();
+    }
+
+    const instruction_info *find_instruction(const std::string_view mnemonic)
+    {
+        for (const auto &instruction : instructions)
+        {
+            if (mnemonic == instruction.mnemonic) return &instruction;
+        }
+        return nullptr;
+    }
+
+    bool parse_number(const std::string_view text, int &value)
+    {
+        if (text.size() == 3 && text[0] == '\'' && text[2] == '\'')
+        {
+            value = static_cast<unsigned char>(text[1]);
+            return true;
+        }
+
+        auto digits = text;
+        auto negative = false;
+        auto base = 10;
+
+        if (!digits.empty() && digits[0] == '-')
+        {
+            negative = true;
+            digits.remove_prefix(1);
+        }
+
+        if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X'))
+        {
+            base = 16;
+            digits.remove_prefix(2);
+        }
+        else if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'b' || digits[1] == 'B'))
+        {
+            base = 2;
+            digits.remove_prefix(2);
+        }
+
+        if (digits.empty() || digits.size() > 16) return false;
+
+        long parsed = 0;
+        for (auto ch : digits)
+        {
+            auto digit = base;
+            if (ch >= '0' && ch <= '9') digit = ch - '0';
+            else if (ch >= 'a' && ch <= 'f') digit = ch - 'a' + 10;
+            else if (ch >= 'A' && ch <= 'F') digit = ch - 'A' + 10;
+            if (digit >= base) return false;
+            parsed = parsed * base + digit;
+        }
+
+        value = static_cast<int>(negative ? -parsed : parsed);
+        return true;
+    }
+
+    bool parse_register(const std::string_view text, uint8_t &code)
+    {
+        if (text.size() != 2) return false;
+
+        const char name[] = {static_cast<char>(std::toupper(static_cast<unsigned char>(text[0]))),
+                             static_cast<char>(std::toupper(static_cast<unsigned char>(text[1]))), '\0'};
+
+        if (name[0] == 'R' && name[1] >= '0' && name[1] <= '7')
+        {
+            code = static_cast<uint8_t>(IR0 + (name[1] - '0'));
+            return true;
+        }
+
+        if (std::string_view(name) == "IP") { code = IIP; return true; }
+        if (std::string_view(name) == "SP") { code = ISP; return true; }
+        if (std::string_view(name) == "BP") { code = IBP; return true; }
+
+        return false;
+    }
+
+    bool is_symbol(const std::string_view text)
+    {
+        if (text.empty() || std::isdigit(static_cast<unsigned char>(text[0]))) return false;
+
+        for (auto ch : text)
+        {
+            if (!std::isalnum(static_cast<unsigned char>(ch)) && ch != '_') return false;
+        }
+        return true;
+    }
+
+    /**
+     * Value of a symbol, following DEF aliases. Labels are only known after
+     * the placement.
+     */
+    bool resolve_symbol(assembly_state &state, const std::string_view name, int &value)
+    {
+        auto current = name;
+        size_t depth = 0;
+
+        while (depth++ <= state.symbols.symbols().size())
+        {
+            const auto found = state.symbols.find(current);
+            if (!found) return false;
+
+            if (found->kind != symbol_kind::alias)
+            {
+                value = found->value;
+                return found->resolved;
+            }
+            current = found->alias;
+        }
+
+        return false;  // cycle of aliases
+    }
+
+    std::string_view trim(std::string_view text)
+    {
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) text.remove_prefix(1);
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) text.remove_suffix(1);
+        return text;
+    }
+
+    /**
+     * Splits "value[count]" into its two parts.
+     */
+    bool split_fill(const std::string_view param, std::string_view &value, std::string_view &count)
+    {
+        const auto open = param.find('[');
+        if (open == std::string_view::npos || param.back() != ']' || param.front() == '"') return false;
+
+        value = trim(param.substr(0, open));
+        count = trim(param.substr(open + 1, param.size() - open - 2));
+        return true;
+    }
+
+    uint32_t instruction_size(const instruction_info &instruction)
+    {
+        uint32_t size = 1;
+        for (auto kind = instruction.operands; *kind; kind++)
+        {
+            size += *kind == 'a' ? 2 : 1;
+        }
+        return size;
+    }
+
+    /**
+     * File being assembled by the first pass, with the object recording it.
+     */
+    class file_pass
+    {
+    public:
+        assembly_state &state;
+        object_file &object;
+        std::string_view file;
+        int line{};
+
+        void error(const std::string &message) { add_error(state, file, line, message); }
+    };
+
+    /**
+     * Looks a symbol up for the first pass. The result is recorded as a check
+     * entry, a cached object is only replayed while all its checks hold.
+     */
+    bool query(file_pass &pass, const std::string_view name, int &value)
+    {
+        object_entry check;
+        check.kind = entry_kind::check;
+        check.line = pass.line;
+        check.name = std::string(name);
+        check.known = resolve_symbol(pass.state, name, check.value);
+        pass.object.entries.push_back(check);
+
+        value = check.value;
+        return check.known;
+    }
+
+    /**
+     * Numbers, characters and already known symbols (counts of DB blocks and
+     * DEF values, which have to be known in the first pass).
+     */
+    bool evaluate(file_pass &pass, const std::string_view text, int &value)
+    {
+        if (parse_number(text, value)) return true;
+        return is_symbol(text) && query(pass, text, value);
+    }
+
+    void encode_value(file_pass &pass, const std::string_view text, object_entry &entry)
+    {
+        auto value = 0;
+
+        if (parse_number(text, value))
+        {
+            if (value < -128 || value > 255) pass.error("value out of range: " + std::string(text));
+        }
+        else if (is_symbol(text))
+        {
+            entry.relocations.push_back({static_cast<uint32_t>(entry.bytes.size()), relocation_kind::value, std::string(text)});
+        }
+        else
+        {
+            pass.error("invalid value: " + std::string(text));
+        }
+        entry.bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    void encode_address(file_pass &pass, const std::string_view text, object_entry &entry)
+    {
+        auto value = 0;
+
+        if (parse_number(text, value))
+        {
+            if (value < 0 || value > 0xFFFF) pass.error("address out of range: " + std::string(text));
+        }
+        else if (is_symbol(text))
+        {
+            entry.relocations.push_back({static_cast<uint32_t>(entry.bytes.size()), relocation_kind::address, std::string(text)});
+        }
+        else
+        {
+            pass.error("invalid value: " + std::string(text));
+        }
+        entry.bytes.push_back(static_cast<uint8_t>((value & 0xFF00) >> 8));
+        entry.bytes.push_back(static_cast<uint8_t>(value & 0x00FF));
+    }
+
+    void encode_register(file_pass &pass, const std::string_view text, const bool pushable, object_entry &entry)
+    {
+        auto code = uint8_t{0};
+
+        if (!parse_register(text, code) || (!pushable && (code < IR0 || code > IR7)))
+        {
+            pass.error("invalid register: " + std::string(text));
+        }
+        entry.bytes.push_back(code);
+    }
+
+    void encode_instruction(file_pass &pass, const assembly_parser::command_line_str &cmd_str,
+                            const instruction_info &instruction, object_entry &entry)
+    {
+        const std::string_view operands = instruction.operands;
+        const auto &params = cmd_str.parameters;
+        const auto split = operands.find('a') != std::string_view::npos && params.size() == operands.size() + 1;
+
+        entry.instruction = true;
+        entry.size = instruction_size(instruction);
+
+        if (params.size() != operands.size() && !split)
+        {
+            pass.error("wrong number of operands of " + std::string(cmd_str.command));
+            return;
+        }
+
+        entry.bytes.push_back(instruction.opcode);
+
+        size_t param = 0;
+        for (auto kind : operands)
+        {
+            switch (kind)
+            {
+                case 'r': encode_register(pass, params[param++], false, entry); break;
+                case 'p': encode_register(pass, params[param++], true, entry); break;
+                case 'v': encode_value(pass, params[param++], entry); break;
+                case 'a':
+                    if (split)
+                    {
+                        encode_value(pass, params[param++], entry);
+                        encode_value(pass, params[param++], entry);
+                    }
+                    else
+                    {
+                        encode_address(pass, params[param++], entry);
+                    }
+                    break;
+                default: break;
+            }
+        }
+    }
+
+    /**
+     * Appends a run to a DB item, literals merge with the literals before.
+     */
+    void add_run(object_entry &entry, const uint32_t size, const uint32_t count)
+    {
+        if (size == 0) return;
+
+        if (count == 1 && !entry.runs.empty() && entry.runs.back().count == 1)
+        {
+            entry.runs.back().size += size;
+        }
+        else
+        {
+            entry.runs.push_back({size, count});
+        }
+        entry.size += size * count;
+    }
+
+    /**
+     * Encodes the parameters of DB as runs, a value[count] keeps its value
+     * once, so reservations cost the same however large they are.
+     */
+    void encode_data(file_pass &pass, const assembly_parser::command_line_str &cmd_str, object_entry &entry)
+    {
+        std::string_view value_text;
+        std::string_view count_text;
+
+        for (const auto &param : cmd_str.parameters)
+        {
+            auto count = 0;
+
+            if (param.size() >= 2 && param.front() == '"' && param.back() == '"')
+            {
+                entry.bytes.insert(entry.bytes.end(), param.begin() + 1, param.end() - 1);
+                add_run(entry, static_cast<uint32_t>(param.size() - 2), 1);
+            }
+            else if (split_fill(param, value_text, count_text))
+            {
+                if (!evaluate(pass, count_text, count) || count < 0 || count > static_cast<int>(memory_size))
+                {
+                    pass.error("invalid count: " + std::string(param));
+                    continue;
+                }
+
+                if (count == 0) continue;
+
+                encode_value(pass, value_text, entry);
+                add_run(entry, 1, static_cast<uint32_t>(count));
+            }
+            else
+            {
+                encode_value(pass, param, entry);
+                add_run(entry, 1, 1);
+            }
+
+            if (entry.size > memory_size)
+            {
+                pass.error("data does not fit into the memory");
+                return;
+            }
+        }
+    }
+
+    void process_file(assembly_state &state, const std::string &path, std::string_view from_file, int from_line);
+
+    /**
+     * Applies one entry of the first pass to the assembly. Both the first
+     * pass over a source and the replay of a cached object go through here.
+     */
+    void apply_entry(assembly_state &state, const object_entry &entry, const std::string_view file)
+    {
+        switch (entry.kind)
+        {
+            case entry_kind::def:
+            {
+                auto inserted = false;
+                auto &constant = state.symbols.insert(entry.name, inserted);
+
+                if (!inserted)
+                {
+                    add_error(state, file, entry.line, "symbol defined twice: " + entry.name + " (first at " +
+                              location(constant.file, constant.line) + ")");
+                    return;
+                }
+
+                constant.file = file;
+                constant.line = entry.line;
+                constant.kind = entry.known ? symbol_kind::constant : symbol_kind::alias;
+                constant.value = entry.value;
+                constant.resolved = entry.known;
+                constant.alias = entry.alias;
+                return;
+            }
+
+            case entry_kind::label:
+                state.pending_labels.push_back({entry.name, file, entry.line});
+                return;
+
+            case entry_kind::include:
+                if (std::find(state.include_stack.begin(), state.include_stack.end(), entry.name) != state.include_stack.end())
+                {
+                    add_error(state, file, entry.line, "recursive include of " + entry.name);
+                    return;
+                }
+                process_file(state, entry.name, file, entry.line);
+                return;
+
+            case entry_kind::check:
+                return;
+
+            case entry_kind::item:
+                break;
+        }
+
+        item current;
+        current.file = file;
+        current.line = entry.line;
+        current.size = entry.size;
+        current.address = entry.address;
+        current.fixed = entry.fixed;
+        current.instruction = entry.instruction;
+        current.bytes = entry.bytes;
+        current.runs = entry.runs;
+        current.relocations = entry.relocations;
+
+        if (!current.fixed)
+        {
+            const auto previous = state.items.empty() ? nullptr : &state.items.back();
+            const auto continues = current.instruction && previous && !previous->fixed && previous->instruction;
+
+            if (!continues || state.units.empty())
+            {
+                state.units.emplace_back();
+            }
+
+            current.unit = state.units.size() - 1;
+            current.offset = state.units.back().size;
+            state.units.back().size += current.size;
+        }
+
+        state.items.push_back(std::move(current));
+
+        for (const auto &label : state.pending_labels)
+        {
+            auto inserted = false;
+            auto &entry_symbol = state.symbols.insert(label.name, inserted);
+
+            if (!inserted)
+            {
+                add_error(state, label.file, label.line, "symbol defined twice: " + label.name + " (first at " +
+                          location(entry_symbol.file, entry_symbol.line) + ")");
+                continue;
+            }
+
+            entry_symbol.kind = symbol_kind::label;
+            entry_symbol.file = label.file;
+            entry_symbol.line = label.line;
+            state.labels.push_back({label.name, state.items.size() - 1});
+        }
+        state.pending_labels.clear();
+    }
+
+    void emit(file_pass &pass, const object_entry &entry)
+    {
+        pass.object.entries.push_back(entry);
+        apply_entry(pass.state, pass.object.entries.back(), pass.file);
+    }
+
+    void define_constant(file_pass &pass, const assembly_parser::command_line_str &cmd_str)
+    {
+        if (cmd_str.parameters.size() != 2 || !is_symbol(cmd_str.parameters[0]))
+        {
+            pass.error("DEF expects a name and a value");
+            return;
+        }
+
+        const auto value_text = cmd_str.parameters[1];
+        object_entry entry;
+
+        entry.kind = entry_kind::def;
+        entry.line = pass.line;
+        entry.name = std::string(cmd_str.parameters[0]);
+        entry.known = evaluate(pass, value_text, entry.value);
+
+        if (!entry.known && !is_symbol(value_text))
+        {
+            pass.error("invalid value: " + std::string(value_text));
+            return;
+        }
+
+        if (!entry.known) entry.alias = std::string(value_text);
+        emit(pass, entry);
+    }
+
+    /**
+     * First pass over the lines of one file: turns every line to entries of
+     * the object, applying them to the assembly right away, so the lines
+     * further down see the constants defined above.
+     */
+    void collect(file_pass &pass, const std::vector<assembly_parser::command_line_str> &commands)
+    {
+        for (const auto &cmd_str : commands)
+        {
+            pass.line = cmd_str.line_number;
+
+            if (cmd_str.command == "#INCLUDE")
+            {
+                object_entry entry;
+                entry.kind = entry_kind::include;
+                entry.line = pass.line;
+                entry.name = assembly_parser::include_path(cmd_str);
+
+                if (entry.name.empty())
+                {
+                    pass.error("#include expects a file name in quotes");
+                    continue;
+                }
+                emit(pass, entry);
+                continue;
+            }
+
+            if (cmd_str.command == "DEF")
+            {
+                define_constant(pass, cmd_str);
+                continue;
+            }
+
+            object_entry entry;
+            entry.line = pass.line;
+
+            if (!cmd_str.label.empty())
+            {
+                auto fixed_address = 0;
+
+                if (parse_number(cmd_str.label, fixed_address) || (is_symbol(cmd_str.label) && query(pass, cmd_str.label, fixed_address)))
+                {
+                    /* numeric label, or label named like a DEF constant */
+                    entry.fixed = true;
+                    entry.address = static_cast<uint32_t>(fixed_address);
+
+                    if (fixed_address < 0 || fixed_address >= static_cast<int>(memory_size))
+                    {
+                        pass.error("address out of range: " + std::string(cmd_str.label));
+                        continue;
+                    }
+                }
+                else if (!is_symbol(cmd_str.label))
+                {
+                    pass.error("invalid label: " + std::string(cmd_str.label));
+                }
+                else if (const auto constant = pass.state.symbols.find(cmd_str.label))
+                {
+                    if (constant->kind == symbol_kind::label)
+                    {
+                        pass.error("symbol defined twice: " + std::string(cmd_str.label) + " (first at " +
+                                   location(constant->file, constant->line) + ")");
+                    }
+                    else
+                    {
+                        pass.error("address of " + std::string(cmd_str.label) + " is not known");
+                    }
+                }
+                else
+                {
+                    object_entry label;
+                    label.kind = entry_kind::label;
+                    label.line = pass.line;
+                    label.name = std::string(cmd_str.label);
+                    emit(pass, label);
+                }
+            }
+
+            if (cmd_str.command.empty()) continue;
+
+            const auto instruction = find_instruction(cmd_str.command);
+
+            if (instruction)
+            {
+                encode_instruction(pass, cmd_str, *instruction, entry);
+            }
+            else if (cmd_str.command == "DB")
+            {
+                encode_data(pass, cmd_str, entry);
+            }
+            else
+            {
+                pass.error("unknown command: " + std::string(cmd_str.command));
+                continue;
+            }
+
+            if (entry.fixed && entry.address + entry.size > memory_size)
+            {
+                pass.error("address out of range: " + std::string(cmd_str.label));
+                continue;
+            }
+
+            emit(pass, entry);
+        }
+    }
+
+    state_mark mark_state(const assembly_state &state)
+    {
+        state_mark mark;
+        mark.items = state.items.size();
+        mark.units = state.units.size();
+        mark.last_unit_size = state.units.empty() ? 0 : state.units.back().size;
+        mark.labels = state.labels.size();
+        mark.pending_labels = state.pending_labels.size();
+        mark.symbols = state.symbols.symbols().size();
+        mark.errors = state.errors.size();
+        mark.warnings = state.warnings.size();
+        return mark;
+    }
+
+    void rollback_state(assembly_state &state, const state_mark &mark)
+    {
+        state.items.resize(mark.items);
+        state.units.resize(mark.units);
+        if (!state.units.empty()) state.units.back().size = mark.last_unit_size;
+        state.labels.resize(mark.labels);
+        state.pending_labels.resize(mark.pending_labels);
+        state.symbols.truncate(mark.symbols);
+        state.errors.resize(mark.errors);
+        state.warnings.resize(mark.warnings);
+    }
+
+    /**
+     * Replays a cached object. Fails (leaving the state to be rolled back)
+     * when a symbol looked up by the first pass has a different value now.
+     */
+    bool replay(assembly_state &state, const object_file &object, const std::string_view file)
+    {
+        for (const auto &entry : object.entries)
+        {
+            if (entry.kind == entry_kind::check)
+            {
+                auto value = 0;
+                const auto known = resolve_symbol(state, entry.name, value);
+                if (known != entry.known || (known && value != entry.value)) return false;
+                continue;
+            }
+            apply_entry(state, entry, file);
+        }
+        return true;
+    }
+
+    /**
+     * Adds one source file to the assembly, from the cache when its content
+     * and the constants it depends on did not change, otherwise parsed and
+     * stored to the cache for the next time.
+     */
+    void process_file(assembly_state &state, const std::string &path, const std::string_view from_file, const int from_line)
+    {
+        const auto file = intern(state, path);
+        uint64_t content_hash = 0;
+        const auto hashed = state.cache && hash_file(path, content_hash);
+
+        state.include_stack.push_back(path);
+
+        if (hashed)
+        {
+            object_file cached;
+
+            if (state.cache->load(path, content_hash, cached))
+            {
+                const auto mark = mark_state(state);
+                if (replay(state, cached, file))
+                {
+                    state.include_stack.pop_back();
+                    return;
+                }
+                rollback_state(state, mark);
+            }
+        }
+
+        const auto commands = state.sources.parse_file(path);
+
+        if (!commands)
+        {
+            if (from_file.empty())
+            {
+                state.errors.push_back("can not read " + path);
+            }
+            else
+            {
+                add_error(state, from_file, from_line, "can not open " + path);
+            }
+            state.include_stack.pop_back();
+            return;
+        }
+
+        object_file object;
+        file_pass pass{state, object, file};
+        const auto errors = state.errors.size();
+
+        object.content_hash = content_hash;
+        collect(pass, *commands);
+
+        if (hashed && state.errors.size() == errors) state.cache->store(path, object);
+        state.include_stack.pop_back();
+    }
+
+    /**
+     * Puts the floating units to the free gaps between the fixed items. Every
+     * unit (in the source order) takes the smallest gap it fits into, so the
+     * whole placement is O(n log n) in the number of items.
+     */
+    bool place_units(assembly_state &state)
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> taken;
+        std::set<std::pair<uint32_t, uint32_t>> gaps;   // (size, address)
+        uint32_t address = 0;
+
+        for (const auto &current : state.items)
+        {
+            if (current.fixed && current.size > 0) taken.emplace_back(current.address, current.address + current.size);
+        }
+        std::sort(taken.begin(), taken.end());
+
+        for (const auto &range : taken)
+        {
+            if (range.first > address) gaps.emplace(range.first - address, address);
+            address = std::max(address, range.second);
+        }
+        if (address < memory_size) gaps.emplace(memory_size - address, address);
+
+        for (auto &current : state.units)
+        {
+            if (current.size == 0) continue;
+
+            const auto gap = gaps.lower_bound({current.size, 0});
+            if (gap == gaps.end())
+            {
+                state.errors.push_back("program does not fit into the memory (" + std::to_string(current.size) +
+                                       " bytes left to place)");
+                return false;
+            }
+
+            current.address = gap->second;
+            if (gap->first > current.size) gaps.emplace(gap->first - current.size, gap->second + current.size);
+            gaps.erase(gap);
+        }
+
+        for (auto &current : state.items)
+        {
+            if (!current.fixed) current.address = state.units[current.unit].address + current.offset;
+        }
+
+        /* labels at the end of the source point behind the last floating item */
+
+        uint32_t end = 0;
+        for (const auto &current : state.items)
+        {
+            if (!current.fixed) end = current.address + current.size;
+        }
+
+        for (const auto &label : state.labels)
+        {
+            auto &entry = *state.symbols.find(label.name);
+            entry.value = static_cast<int>(label.item < state.items.size() ? state.items[label.item].address : end);
+            entry.resolved = true;
+        }
+
+        return true;
+    }
+
+    /**
+     * Patches the symbol values into the encoded items.
+     */
+    void relocate_items(assembly_state &state)
+    {
+        for (auto &current : state.items)
+        {
+            for (const auto &fixup : current.relocations)
+            {
+                auto value = 0;
+
+                if (!resolve_symbol(state, fixup.symbol, value))
+                {
+                    add_error(state, current.file, current.line, "undefined symbol: " + fixup.symbol);
+                    continue;
+                }
+
+                if (fixup.kind == relocation_kind::address)
+                {
+                    if (value < 0 || value > 0xFFFF) add_error(state, current.file, current.line, "address out of range: " + fixup.symbol);
+                    current.bytes[fixup.offset] = static_cast<uint8_t>((value & 0xFF00) >> 8);
+                    current.bytes[fixup.offset + 1] = static_cast<uint8_t>(value & 0x00FF);
+                }
+                else
+                {
+                    if (value < -128 || value > 255) add_error(state, current.file, current.line, "value out of range: " + fixup.symbol);
+                    current.bytes[fixup.offset] = static_cast<uint8_t>(value);
+                }
+            }
+        }
+    }
+
+    void report_overlap(assembly_state &state, const overlap_run &run)
+    {
+        if (!run.open) return;
+
+        const auto &first = state.items[run.first];
+        const auto &last = state.items[run.last];
+        const auto &other = state.items[run.other];
+        const auto lines = run.last != run.first ? "-" + std::to_string(last.line + 1) : std::string();
+
+        state.warnings.push_back(location(first.file, first.line) + lines + ": overwrites data of " +
+                                 location(other.file, other.line) + " (" + std::to_string(run.bytes) + " bytes)");
+    }
+
+    /**
+     * Adds an overwritten byte to the open run of overlaps, or reports the
+     * run and starts a new one when the byte does not continue it.
+     */
+    void add_overlap(assembly_state &state, overlap_run &run, const size_t item, const size_t other)
+    {
+        if (run.open && run.other == other &&
+            (item == run.last || (item == run.last + 1 && state.items[run.last].file == state.items[item].file)))
+        {
+            run.last = item;
+            run.bytes++;
+            return;
+        }
+
+        report_overlap(state, run);
+        run = {item, item, other, 1, true};
+    }
+
+    /**
+     * Writes a range of an item to the memory image as one piece.
+     */
+    void write_piece(assembly_state &state, std::vector<uint8_t> &memory, std::vector<int32_t> &owner,
+                     std::vector<piece> &pieces, const uint32_t address, const uint8_t *bytes, const uint32_t size,
+                     const uint32_t count, overlap_run &overlaps)
+    {
+        const auto end = address + size * count;
+
+        for (auto i = address; i < end; i++)
+        {
+            if (owner[i] >= 0)
+            {
+                add_overlap(state, overlaps, pieces.back().item, pieces[static_cast<size_t>(owner[i])].item);
+            }
+            owner[i] = static_cast<int32_t>(pieces.size() - 1);
+        }
+
+        for (uint32_t k = 0; k < count; k++)
+        {
+            std::copy(bytes, bytes + size, memory.begin() + address + k * size);
+        }
+    }
+
+    /**
+     * Writes all items to the memory image, expanding the runs of DB items
+     * only here. owner[] remembers the piece which wrote every byte, so
+     * overlaps can be reported and fills recognized.
+     */
+    void write_items(assembly_state &state, std::vector<uint8_t> &memory, std::vector<int32_t> &owner,
+                     std::vector<piece> &pieces)
+    {
+        overlap_run overlaps;
+
+        for (size_t index = 0; index < state.items.size(); index++)
+        {
+            const auto &current = state.items[index];
+            auto address = current.address;
+            size_t byte = 0;
+
+            if (current.runs.empty())
+            {
+                pieces.push_back({index, false});
+                write_piece(state, memory, owner, pieces, address, current.bytes.data(), current.size, 1, overlaps);
+                continue;
+            }
+
+            for (const auto &run : current.runs)
+            {
+                const auto fill = run.size == 1 && run.count >= fill_min;
+
+                if (pieces.empty() || pieces.back().item != index || fill || pieces.back().fill)
+                {
+                    pieces.push_back({index, fill});
+                }
+
+                write_piece(state, memory, owner, pieces, address, current.bytes.data() + byte, run.size, run.count,
+                            overlaps);
+                address += run.size * run.count;
+                byte += run.size;
+            }
+        }
+    }
+
+    /**
+     * Turns the memory image to segments. A range written by one fill piece
+     * is a fill segment, other consecutive bytes with the same placement kind
+     * are data segments.
+     */
+    void build_segments(const assembly_state &state, const std::vector<uint8_t> &memory,
+                        const std::vector<int32_t> &owner, const std::vector<piece> &pieces, image_builder &image)
+    {
+        uint32_t address = 0;
+
+        while (address < memory_size)
+        {
+            if (owner[address] < 0)
+            {
+                address++;
+                continue;
+            }
+
+            const auto &start = pieces[static_cast<size_t>(owner[address])];
+            const auto &first = state.items[start.item];
+            auto end = address + 1;
+
+            if (start.fill)
+            {
+                while (end < memory_size && owner[end] == owner[address]) end++;
+                image_add_fill(image, static_cast<uint16_t>(address), memory[address], end - address, first.fixed);
+            }
+            else
+            {
+                while (end < memory_size && owner[end] >= 0)
+                {
+                    const auto &next = pieces[static_cast<size_t>(owner[end])];
+                    if (next.fill || state.items[next.item].fixed != first.fixed) break;
+                    end++;
+                }
+                image_add_data(image, static_cast<uint16_t>(address), memory.data() + address, end - address, first.fixed);
+            }
+
+            address = end;
+        }
+    }
+
+    bool assemble(assembly_parser::source_arena &sources, const std::string &filename, image_builder &image,
+                  std::vector<std::string> &errors, std::vector<std::string> &warnings, const object_cache *cache)
+    {
+        assembly_state state(sources, cache, errors, warnings);
+
+        if (cache)
+        {
+            /* unchanged includes come from the cache, do not tokenize them */
+            sources.prefetch_filter = [cache](const std::string &path) { return !cache->is_current(path); };
+        }
+
+        process_file(state, filename, {}, 0);
+        sources.prefetch_filter = nullptr;
+
+        for (const auto &label : state.pending_labels)
+        {
+            auto inserted = false;
+            auto &entry = state.symbols.insert(label.name, inserted);
+
+            if (!inserted)
+            {
+                add_error(state, label.file, label.line, "symbol defined twice: " + label.name + " (first at " +
+                          location(entry.file, entry.line) + ")");
+                continue;
+            }
+
+            entry.kind = symbol_kind::label;
+            entry.file = label.file;
+            entry.line = label.line;
+            state.labels.push_back({label.name, state.items.size()});
+        }
+
+        if (!errors.empty() || !place_units(state)) return false;
+
+        relocate_items(state);
+        if (!errors.empty()) return false;
+
+        std::vector<uint8_t> memory(memory_size, 0);
+        std::vector<int32_t> owner(memory_size, -1);
+        std::vector<piece> pieces;
+
+        write_items(state, memory, owner, pieces);
+        build_segments(state, memory, owner, pieces, image);
+
+        for (const auto &entry : state.symbols.symbols())
+        {
+            auto value = 0;
+            if (!resolve_symbol(state, entry.name, value))
+            {
+                add_error(state, entry.file, entry.line, "undefined symbol: " + (entry.kind == symbol_kind::alias ? entry.alias : entry.name));
+                continue;
+            }
+            image_add_symbol(image, entry.name, static_cast<uint16_t>(value),
+                             entry.kind == symbol_kind::label ? IMAGE_SYMBOL_LABEL : IMAGE_SYMBOL_DEF);
+        }
+
+        auto start = 0;
+        image.entry = static_cast<uint16_t>(resolve_symbol(state, "start", start) ? start : 0);
+
+        return errors.empty();
+    }
+
+}
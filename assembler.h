@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "assembly_parser.h"
+#include "image.h"
+#include "object_file.h"
+
+namespace assembler {
+
+    /**
+     * Operand kinds of an instruction, one character per operand:
+     *
+     *   r - general purpose register (R0 .. R7)
+     *   p - pushable register (R0 .. R7, IP, SP, BP)
+     *   v - 8 bit value
+     *   a - 16 bit address (or two 8 bit values, high byte first)
+     */
+    class instruction_info
+    {
+    public:
+        const char *mnemonic;
+        uint8_t opcode;
+        const char *operands;
+    };
+
+    const instruction_info *find_instruction(std::string_view mnemonic);
+    bool parse_number(std::string_view text, int &value);
+    bool parse_register(std::string_view text, uint8_t &code);
+
+    /**
+     * Two-pass assembler. The first pass follows the #include directives,
+     * defines the DEF constants and encodes every line, leaving the symbols
+     * to relocations. Then the fixed lines are put at their addresses (a
+     * numeric label, or a label named like a DEF constant) and the floating
+     * ones to the best fitting free gaps, and the relocations are patched.
+     *
+     * With a cache the first pass of every file is stored as an object, and
+     * unchanged files (same content, same values of the constants they use)
+     * are replayed from it instead of being parsed again.
+     *
+     * Fixed lines overlapping each other are reported as warnings, the later
+     * line wins.
+     */
+    bool assemble(assembly_parser::source_arena &sources, const std::string &filename, image_builder &image,
+                  std::vector<std::string> &errors, std::vector<std::string> &warnings,
+                  const object_cache *cache = nullptr);
+
+}
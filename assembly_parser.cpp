@@ -1,120 +1,529 @@
-#include <fstream>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "assembly_parser.h"
-#include "my_string.h"
+#include "definitions.h"
 
 namespace assembly_parser {
 
-    std::string eat_string(command_line_str &cmd_str, const std::string& parameters_line)
+    const size_t parameter_block_size = 4096;
+    const size_t min_chunk_size = 256 * 1024;
+
+    bool is_space(const char ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\v' || ch == '\f';
+    }
+
+    /**
+     * Characters ending a word (a command, a label or a number).
+     */
+    bool is_separator(const char ch)
     {
-        auto string_trimmed = my_string::trim(parameters_line);
-        if (string_trimmed.empty() || string_trimmed[0] != '"') return string_trimmed;
-        const int pos = string_trimmed.find('"', 1);
-        if (pos >= 0)
+        return is_space(ch) || ch == ';' || ch == ':' || ch == ',' || ch == '[' || ch == ']' || ch == '"' ||
+               ch == '\'';
+    }
+
+    uint32_t word_kind(const std::string_view word)
+    {
+        auto digits = word;
+        if (digits.size() > 1 && digits[0] == '-') digits.remove_prefix(1);
+        if (!std::isdigit(static_cast<unsigned char>(digits[0]))) return LEX_LABEL;
+
+        if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) return LEX_HEX_NUMBER;
+        if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'b' || digits[1] == 'B')) return LEX_BIN_NUMBER;
+        return LEX_DEC_NUMBER;
+    }
+
+    /**
+     * Splits one line to tokens in a single scan. The line is terminated by
+     * a LEX_END_OF_LINE token.
+     */
+    void tokenize_line(const std::string_view line, std::vector<token> &tokens)
+    {
+        size_t pos = 0;
+
+        tokens.clear();
+
+        while (pos < line.size())
         {
-            const auto out_string = my_string::trim(string_trimmed.substr(0, pos + 1));
-            auto rest_string = my_string::trim(string_trimmed.substr(pos + 1));
-            cmd_str.parameters.push_back(out_string);
-            return rest_string;
+            const auto ch = line[pos];
+            const auto start = pos;
+
+            if (is_space(ch))
+            {
+                pos++;
+                continue;
+            }
+
+            switch (ch)
+            {
+                case ';':
+                    pos = line.size();
+                    while (pos > start + 1 && is_space(line[pos - 1])) pos--;
+                    tokens.push_back({LEX_COMMENT, line.substr(start, pos - start)});
+                    pos = line.size();
+                    continue;
+                case ':': tokens.push_back({LEX_COLON, line.substr(pos++, 1)}); continue;
+                case ',': tokens.push_back({LEX_COMMA, line.substr(pos++, 1)}); continue;
+                case '[': tokens.push_back({LEX_OPEN_BRACKET, line.substr(pos++, 1)}); continue;
+                case ']': tokens.push_back({LEX_CLOSE_BRACKET, line.substr(pos++, 1)}); continue;
+                case '"':
+                    pos = line.find('"', start + 1);
+                    pos = pos == std::string_view::npos ? line.size() : pos + 1;
+                    tokens.push_back({LEX_STRING, line.substr(start, pos - start)});
+                    continue;
+                case '\'':
+                    if (start + 2 < line.size() && line[start + 2] == '\'')
+                    {
+                        pos += 3;
+                        tokens.push_back({LEX_CHAR, line.substr(start, 3)});
+                        continue;
+                    }
+                    break;
+                default:
+                    break;
+            }
+
+            pos++;
+            while (pos < line.size() && !is_separator(line[pos])) pos++;
+
+            const auto word = line.substr(start, pos - start);
+            tokens.push_back({word_kind(word), word});
         }
-        return string_trimmed;
+
+        tokens.push_back({LEX_END_OF_LINE, line.substr(line.size())});
     }
 
-    std::string eat_char(command_line_str &cmd_str, const std::string& parameters_line)
+    /**
+     * Text from the first to the last of the tokens.
+     */
+    std::string_view span(const token &first, const token &last)
     {
-        auto string_trimmed = my_string::trim(parameters_line);
-        if (string_trimmed.size() < 3 || string_trimmed[0] != '\'' || string_trimmed[2] != '\'') return string_trimmed;
-        const auto out_string = my_string::trim(string_trimmed.substr(0, 3));
-        auto rest_string = my_string::trim(string_trimmed.substr(3));
-        cmd_str.parameters.push_back(out_string);
-        return rest_string;
+        return std::string_view(first.text.data(), static_cast<size_t>(last.text.data() + last.text.size() - first.text.data()));
     }
 
-    void parse_params(command_line_str &cmd_str, const std::string& parameters_line)
+    /**
+     * Parses one line in place (the command gets upper cased). The parameters
+     * are collected to the scratch vector. Returns false for lines with no
+     * label and no command.
+     */
+    bool parse_line(command_line_str &cmd_str, char *line, const size_t size, std::vector<token> &tokens,
+                    std::vector<std::string_view> &parameters)
     {
-        if (my_string::trim(parameters_line).empty()) return;
-        auto to_eat = parameters_line;
-        to_eat = eat_string(cmd_str, to_eat);
-        to_eat = eat_char(cmd_str, to_eat);
-        int sep = to_eat.find(',');
-        while (sep >= 0)
+        tokenize_line(std::string_view(line, size), tokens);
+        parameters.clear();
+
+        size_t index = 0;
+        auto label_end = tokens.size();
+
+        /* the label is everything in front of a colon preceding the parameters */
+
+        for (size_t i = 0; i < tokens.size(); i++)
+        {
+            const auto kind = tokens[i].kind;
+            if (kind == LEX_COLON) { label_end = i; break; }
+            if (kind == LEX_COMMA || kind == LEX_STRING || kind == LEX_CHAR || kind == LEX_COMMENT) break;
+        }
+
+        if (label_end < tokens.size())
+        {
+            if (label_end > 0) cmd_str.label = span(tokens[0], tokens[label_end - 1]);
+            index = label_end + 1;
+        }
+
+        if (tokens[index].kind != LEX_END_OF_LINE && tokens[index].kind != LEX_COMMENT)
+        {
+            const auto command = tokens[index++].text;
+            auto upper = line + (command.data() - line);
+
+            for (size_t i = 0; i < command.size(); i++)
+            {
+                upper[i] = static_cast<char>(std::toupper(static_cast<unsigned char>(upper[i])));
+            }
+            cmd_str.command = command;
+        }
+
+        /* parameters are the comma separated token runs */
+
+        auto first = index;
+        for (; tokens[index].kind != LEX_END_OF_LINE && tokens[index].kind != LEX_COMMENT; index++)
         {
-            auto clean_param = my_string::trim(to_eat.substr(0, sep));
-            if (!clean_param.empty()) cmd_str.parameters.push_back(clean_param);
-            to_eat = to_eat.substr(sep + 1, to_eat.size());
-            to_eat = eat_string(cmd_str, to_eat);
-            to_eat = eat_char(cmd_str, to_eat);
-            sep = to_eat.find(',');
+            if (tokens[index].kind != LEX_COMMA) continue;
+            if (index > first) parameters.push_back(span(tokens[first], tokens[index - 1]));
+            first = index + 1;
         }
-        auto to_eat_trimmed = my_string::trim(to_eat);
-        if (!to_eat_trimmed.empty())
-            cmd_str.parameters.push_back(to_eat_trimmed);
+        if (index > first) parameters.push_back(span(tokens[first], tokens[index - 1]));
+
+        if (tokens[index].kind == LEX_COMMENT)
+        {
+            auto comment = tokens[index].text.substr(1);
+            while (!comment.empty() && is_space(comment.front())) comment.remove_prefix(1);
+            cmd_str.comments = comment;
+        }
+
+        return !cmd_str.command.empty() || !cmd_str.label.empty();
     }
 
-    void parse_command(command_line_str &cmd_str, const std::string& clean_command_line)
+    /**
+     * File name of an #include line, relative to the including file.
+     * Returns an empty string for malformed lines.
+     */
+    std::string include_path(const command_line_str &cmd_str)
     {
-        const int sep = clean_command_line.find(' ');
-        std::string params;
-        if (sep >= 0)
+        if (cmd_str.parameters.size() != 1) return "";
+
+        const auto name = cmd_str.parameters[0];
+        if (name.size() < 3 || name.front() != '"' || name.back() != '"') return "";
+
+        auto path = std::string(name.substr(1, name.size() - 2));
+        const auto slash = cmd_str.file.find_last_of("/\\");
+
+        if (slash != std::string::npos && path.find_first_of("/\\") != 0 && path.find(':') == std::string::npos)
         {
-            cmd_str.command = my_string::to_upper(my_string::trim(clean_command_line.substr(0, sep)));
-            parse_params(cmd_str, my_string::trim(clean_command_line.substr(sep + 1, clean_command_line.size())));
+            path = std::string(cmd_str.file.substr(0, slash + 1)) + path;
         }
-        else
+        return path;
+    }
+
+    const std::string_view *parameter_store::store(const std::vector<std::string_view> &parameters)
+    {
+        if (parameters.empty()) return nullptr;
+
+        if (block_used + parameters.size() > block_size)
         {
-            cmd_str.command = my_string::to_upper(my_string::trim(clean_command_line));
+            block_size = std::max(parameter_block_size, parameters.size());
+            blocks.emplace_back(new std::string_view[block_size]);
+            block_used = 0;
         }
+
+        const auto stored = blocks.back().get() + block_used;
+        std::copy(parameters.begin(), parameters.end(), stored);
+        block_used += parameters.size();
+        return stored;
     }
 
-    void parse_label(command_line_str &cmd_str, const std::string& clean_command_line)
+    bool map_source(const std::string &filename, mapped_source &source)
     {
-        const int sep = clean_command_line.find(':');
-        auto command = clean_command_line;
-        if (sep >= 0)
+        source = mapped_source();
+
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER size;
+
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        if (!GetFileSizeEx(file, &size))
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        if (size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return true;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0) : nullptr;
+
+        if (!view)
         {
-            command = clean_command_line.substr(sep + 1, clean_command_line.size());
-            cmd_str.label = my_string::trim(clean_command_line.substr(0, sep));
+            if (mapping) CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
         }
-        parse_command(cmd_str, my_string::trim(command));
+
+        source.base = static_cast<char *>(view);
+        source.size = static_cast<size_t>(size.QuadPart);
+        source.file = file;
+        source.mapping = mapping;
+#else
+        struct stat status;
+        const int file = open(filename.c_str(), O_RDONLY);
+
+        if (file < 0) return false;
+
+        if (fstat(file, &status) != 0)
+        {
+            close(file);
+            return false;
+        }
+
+        if (status.st_size == 0)
+        {
+            close(file);
+            return true;
+        }
+
+        void *view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+        close(file);
+
+        if (view == MAP_FAILED) return false;
+
+        source.base = static_cast<char *>(view);
+        source.size = static_cast<size_t>(status.st_size);
+#endif
+
+        return true;
+    }
+
+    void unmap_source(mapped_source &source)
+    {
+        if (!source.base) return;
+
+#if defined(_WIN32)
+        UnmapViewOfFile(source.base);
+        CloseHandle(source.mapping);
+        CloseHandle(source.file);
+#else
+        munmap(source.base, source.size);
+#endif
+
+        source = mapped_source();
     }
 
-    void parse_line(command_line_str &cmd_str, const std::string& command_line)
+    parse_pool::parse_pool(const unsigned thread_count)
     {
-        const int col_pos = command_line.find(';');
-        auto command = command_line;
-        if (col_pos >= 0)
+        for (unsigned i = 0; i < thread_count; i++)
         {
-            cmd_str.comments = my_string::trim(command_line.substr(col_pos + 1, command_line.size()));
-            command = command_line.substr(0, col_pos);
+            threads.emplace_back(&parse_pool::worker, this);
         }
-        parse_label(cmd_str, my_string::trim(command));
     }
 
-    std::vector<command_line_str> parse_file(const std::string& filename)
+    parse_pool::~parse_pool()
     {
-        std::string line;
-        std::ifstream source_file(filename);
-        std::vector<command_line_str> parsed_commands;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
 
-        if (!source_file.is_open()) return parsed_commands;
+        for (auto &thread : threads) thread.join();
+    }
 
-        int line_number = 0;
-        while (std::getline(source_file, line))
+    void parse_pool::submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+        changed.notify_all();
+    }
+
+    /**
+     * Runs queued tasks until done() (called with the pool locked) holds.
+     */
+    void parse_pool::wait(const std::function<bool()> &done)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (!done())
+        {
+            if (tasks.empty())
+            {
+                changed.wait(lock);
+                continue;
+            }
+
+            auto task = std::move(tasks.front());
+            tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+            changed.notify_all();
+        }
+    }
+
+    void parse_pool::worker()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true)
+        {
+            if (tasks.empty())
+            {
+                if (stopping) return;
+                changed.wait(lock);
+                continue;
+            }
+
+            auto task = std::move(tasks.front());
+            tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+            changed.notify_all();
+        }
+    }
+
+    source_arena::source_arena() : pool(std::max(1u, std::thread::hardware_concurrency()))
+    {
+    }
+
+    source_arena::~source_arena()
+    {
+        /* prefetched includes nobody asked for may still be parsing */
+
+        pool.wait([this]()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto &file : files)
+            {
+                if (!file.second->ready) return false;
+            }
+            return true;
+        });
+
+        for (auto &file : files) unmap_source(file.second->source);
+    }
+
+    source_file &source_arena::start_file(const std::string &filename)
+    {
+        source_file *file = nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto &entry = files[filename];
+            if (entry) return *entry;
+
+            entry.reset(new source_file());
+            file = entry.get();
+            file->name = files.find(filename)->first;
+        }
+
+        pool.submit([this, file]() { load_file(*file); });
+        return *file;
+    }
+
+    /**
+     * Maps the file and splits it to chunks at line breaks, parsed by the
+     * pool in parallel.
+     */
+    void source_arena::load_file(source_file &file)
+    {
+        file.opened = map_source(std::string(file.name), file.source);
+
+        const auto size = file.source.size;
+        const auto text = file.source.base;
+        const auto chunk_size = std::max(min_chunk_size, size / (std::max(1u, std::thread::hardware_concurrency()) * 4));
+        size_t begin = 0;
+
+        while (begin < size)
+        {
+            auto end = std::min(size, begin + chunk_size);
+            while (end < size && text[end - 1] != '\n') end++;
+
+            file.chunks.emplace_back();
+            file.chunks.back().begin = begin;
+            file.chunks.back().end = end;
+            begin = end;
+        }
+
+        if (file.chunks.empty())
+        {
+            finish_file(file);
+            return;
+        }
+
+        file.pending_chunks = file.chunks.size();
+        for (size_t index = 1; index < file.chunks.size(); index++)
+        {
+            pool.submit([this, &file, index]() { parse_chunk(file, index); });
+        }
+        parse_chunk(file, 0);
+    }
+
+    void source_arena::parse_chunk(source_file &file, const size_t index)
+    {
+        auto &chunk = file.chunks[index];
+        const auto text = file.source.base;
+        std::vector<token> tokens;
+        std::vector<std::string_view> parameters;
+        auto start = chunk.begin;
+
+        while (start < chunk.end)
         {
+            const auto found = static_cast<const char *>(memchr(text + start, '\n', chunk.end - start));
+            const auto end = found ? static_cast<size_t>(found - text) : chunk.end;
+
             command_line_str cmd_str;
-            if (!my_string::trim(line).empty())
+            if (parse_line(cmd_str, text + start, end - start, tokens, parameters))
+            {
+                cmd_str.line_number = chunk.lines;
+                cmd_str.file = file.name;
+                cmd_str.parameters.first = chunk.parameters.store(parameters);
+                cmd_str.parameters.count = parameters.size();
+                chunk.commands.push_back(cmd_str);
+            }
+
+            start = end + 1;
+            chunk.lines++;
+        }
+
+        if (--file.pending_chunks == 0) finish_file(file);
+    }
+
+    /**
+     * Merges the chunks in order (chunk line numbers are local) and starts
+     * parsing the included files.
+     */
+    void source_arena::finish_file(source_file &file)
+    {
+        size_t count = 0;
+        for (const auto &chunk : file.chunks) count += chunk.commands.size();
+        file.commands.reserve(count);
+
+        auto first_line = 0;
+        for (auto &chunk : file.chunks)
+        {
+            for (auto cmd_str : chunk.commands)
             {
-                parse_line(cmd_str, line);
-                cmd_str.line_number = line_number;
-                cmd_str.file = filename;
-                if (!cmd_str.command.empty() || !cmd_str.label.empty()) {
-                    parsed_commands.push_back(cmd_str);
-                }
+                cmd_str.line_number += first_line;
+                file.commands.push_back(cmd_str);
             }
-            line_number++;
+            first_line += chunk.lines;
+            file.parameters.push_back(std::move(chunk.parameters));
+        }
+        file.chunks.clear();
+
+        for (const auto &cmd_str : file.commands)
+        {
+            if (cmd_str.command != "#INCLUDE") continue;
+
+            const auto path = include_path(cmd_str);
+            if (!path.empty() && (!prefetch_filter || prefetch_filter(path))) start_file(path);
         }
 
-        return parsed_commands;
+        file.ready = true;
+    }
+
+    void source_arena::prefetch(const std::string &filename)
+    {
+        start_file(filename);
+    }
+
+    /**
+     * Parsed lines of the file (waiting for it if it is being parsed).
+     * Returns nullptr when the file can not be read.
+     */
+    const std::vector<command_line_str> *source_arena::parse_file(const std::string &filename)
+    {
+        auto &file = start_file(filename);
+
+        pool.wait([&file]() { return file.ready.load(); });
+        return file.opened ? &file.commands : nullptr;
     }
 
 }
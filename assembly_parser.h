@@ -1,27 +1,174 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace assembly_parser {
 
+    /**
+     * One token of a source line, kind is one of the LEX_* values. The text
+     * points into the source buffer.
+     */
+    class token
+    {
+    public:
+        uint32_t kind{};
+        std::string_view text;
+    };
+
+    /**
+     * Parameters of a command, a range of the parameter arena.
+     */
+    class parameter_list
+    {
+    public:
+        const std::string_view *first{};
+        size_t count{};
+
+        const std::string_view *begin() const { return first; }
+        const std::string_view *end() const { return first + count; }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const std::string_view &operator[](size_t index) const { return first[index]; }
+    };
+
+    /**
+     * Parsed line. All the views point into the buffers of the source_arena
+     * which parsed it (the command is upper cased in place).
+     */
     class command_line_str
     {
     public:
         int line_number{};
-        std::string label;
-        std::string command;
-        std::vector<std::string> parameters;
-        std::string comments;
-        std::string file;
-    };
-
-    std::string eat_string(command_line_str &cmd_str, const std::string& parameters_line);
-    std::string eat_char(command_line_str &cmd_str, const std::string& parameters_line);
-    void parse_params(command_line_str &cmd_str, const std::string& parameters_line);
-    void parse_command(command_line_str &cmd_str, const std::string& clean_command_line);
-    void parse_label(command_line_str &cmd_str, const std::string& clean_command_line);
-    void parse_line(command_line_str &cmd_str, const std::string& command_line);
-    std::vector<command_line_str> parse_file(const std::string& filename);
+        std::string_view label;
+        std::string_view command;
+        parameter_list parameters;
+        std::string_view comments;
+        std::string_view file;
+    };
+
+    /**
+     * Blocks of parameter views. A line never spans two blocks, long lines
+     * get a block of their own.
+     */
+    class parameter_store
+    {
+    public:
+        const std::string_view *store(const std::vector<std::string_view> &parameters);
+
+        std::vector<std::unique_ptr<std::string_view[]>> blocks;
+        size_t block_used{};
+        size_t block_size{};
+    };
+
+    /**
+     * Source file mapped copy-on-write to the memory, so the parser can
+     * upper case the commands in place.
+     */
+    class mapped_source
+    {
+    public:
+        char *base{};
+        size_t size{};
+#if defined(_WIN32)
+        void *file{};
+        void *mapping{};
+#endif
+    };
+
+    /**
+     * Piece of a file between two line breaks, tokenized by one task.
+     */
+    class source_chunk
+    {
+    public:
+        size_t begin{};
+        size_t end{};
+        int lines{};
+        std::vector<command_line_str> commands;
+        parameter_store parameters;
+    };
+
+    class source_file
+    {
+    public:
+        std::string_view name;
+        mapped_source source;
+        bool opened{};
+        std::vector<source_chunk> chunks;
+        std::atomic<size_t> pending_chunks{};
+        std::atomic<bool> ready{};
+        std::vector<command_line_str> commands;
+        std::vector<parameter_store> parameters;
+    };
+
+    /**
+     * Fixed set of threads running the parsing tasks. Threads waiting for a
+     * result run the queued tasks meanwhile, so tasks may wait for tasks.
+     */
+    class parse_pool
+    {
+    public:
+        explicit parse_pool(unsigned thread_count);
+        ~parse_pool();
+
+        void submit(std::function<void()> task);
+        void wait(const std::function<bool()> &done);
+
+    private:
+        void worker();
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::deque<std::function<void()>> tasks;
+        std::vector<std::thread> threads;
+        bool stopping{};
+    };
+
+    /**
+     * Owner of everything the parsed lines point to: the mapped files, their
+     * names and the parameter blocks. Files are split to chunks tokenized in
+     * parallel and the included files start parsing as soon as the including
+     * file is parsed, so they are usually ready when the assembler needs them.
+     */
+    class source_arena
+    {
+    public:
+        source_arena();
+        ~source_arena();
+
+        const std::vector<command_line_str> *parse_file(const std::string &filename);
+        void prefetch(const std::string &filename);
+
+        /* included files are only prefetched when this returns true */
+        std::function<bool(const std::string &filename)> prefetch_filter;
+
+    private:
+        source_file &start_file(const std::string &filename);
+        void load_file(source_file &file);
+        void parse_chunk(source_file &file, size_t index);
+        void finish_file(source_file &file);
+
+        std::mutex mutex;
+        std::unordered_map<std::string, std::unique_ptr<source_file>> files;
+        parse_pool pool;
+    };
+
+    bool map_source(const std::string &filename, mapped_source &source);
+    void unmap_source(mapped_source &source);
+    void tokenize_line(std::string_view line, std::vector<token> &tokens);
+    bool parse_line(command_line_str &cmd_str, char *line, size_t size, std::vector<token> &tokens,
+                    std::vector<std::string_view> &parameters);
+    std::string include_path(const command_line_str &cmd_str);
 
 }
@@ -0,0 +1,135 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    atlas.cpp                                                        */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Glyph atlas (see atlas.h). The rows are expanded to pixels by raster_row  */
+/* of the rasterizer, the same expansion the video memory goes through.      */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <cstring>
+#include <memory>
+
+#include "atlas.h"
+#include "raster.h"
+
+/* ATLAS *********************************************************************/
+
+#define ATLAS_INK           0xFFFFFFFF  /* pixel of a glyph (color modulated) */
+#define ATLAS_CLEAR         0x00000000  /* transparent                       */
+
+static void glyph_position(const uint8_t glyph, int &x, int &y)
+{
+    x = (glyph % ATLAS_COLUMNS) * 8;
+    y = (glyph / ATLAS_COLUMNS) * CHARSET_ROWS;
+}
+
+/**
+ *
+ * Creates the texture for the renderer. The glyphs are uploaded by the
+ * first atlas_update().
+ *
+ */
+bool atlas_open(glyph_atlas &atlas, SDL_Renderer *renderer)
+{
+    atlas.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC,
+                                      ATLAS_WIDTH, ATLAS_HEIGHT);
+    atlas.loaded = false;
+
+    if (!atlas.texture) return false;
+
+    SDL_SetTextureBlendMode(atlas.texture, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void atlas_close(glyph_atlas &atlas)
+{
+    if (atlas.texture) SDL_DestroyTexture(atlas.texture);
+
+    atlas.texture = nullptr;
+    atlas.loaded = false;
+}
+
+/**
+ *
+ * Brings the texture to the given rows (CHARSET_SIZE bytes, for example
+ * m.mem + CHAR_MEM_ADDRESS). The first update uploads the whole texture,
+ * later ones only the glyphs which differ from the last update. Returns
+ * the number of glyphs uploaded.
+ *
+ */
+uint32_t atlas_update(glyph_atlas &atlas, const uint8_t *glyphs)
+{
+    uint32_t pixels[8 * CHARSET_ROWS];
+    uint32_t glyph, row, uploaded = 0;
+    SDL_Rect rect;
+
+    if (!atlas.loaded)
+    {
+        std::unique_ptr<uint32_t[]> texture(new uint32_t[ATLAS_WIDTH * ATLAS_HEIGHT]);
+
+        for (glyph = 0; glyph < CHARSET_GLYPHS; glyph++)
+        {
+            glyph_position(static_cast<uint8_t>(glyph), rect.x, rect.y);
+
+            for (row = 0; row < CHARSET_ROWS; row++)
+            {
+                raster_row(texture.get() + (rect.y + row) * ATLAS_WIDTH + rect.x, glyphs[glyph * CHARSET_ROWS + row],
+                           ATLAS_INK, ATLAS_CLEAR);
+            }
+        }
+
+        SDL_UpdateTexture(atlas.texture, nullptr, texture.get(), ATLAS_WIDTH * sizeof(uint32_t));
+        memcpy(atlas.rows, glyphs, CHARSET_SIZE);
+        atlas.loaded = true;
+        return CHARSET_GLYPHS;
+    }
+
+    for (glyph = 0; glyph < CHARSET_GLYPHS; glyph++)
+    {
+        const uint8_t *source = glyphs + glyph * CHARSET_ROWS;
+        uint8_t *shown = atlas.rows + glyph * CHARSET_ROWS;
+
+        if (memcmp(shown, source, CHARSET_ROWS) == 0) continue;
+
+        for (row = 0; row < CHARSET_ROWS; row++)
+        {
+            raster_row(pixels + row * 8, source[row], ATLAS_INK, ATLAS_CLEAR);
+        }
+
+        glyph_position(static_cast<uint8_t>(glyph), rect.x, rect.y);
+        rect.w = 8;
+        rect.h = CHARSET_ROWS;
+
+        SDL_UpdateTexture(atlas.texture, &rect, pixels, 8 * sizeof(uint32_t));
+        memcpy(shown, source, CHARSET_ROWS);
+        uploaded++;
+    }
+
+    return uploaded;
+}
+
+/**
+ *
+ * Draws a glyph scaled to the target rectangle in the color (ARGB8888, see
+ * raster_palette). Its clear pixels leave what is below them.
+ *
+ */
+void atlas_draw(const glyph_atlas &atlas, SDL_Renderer *renderer, const uint8_t glyph, const SDL_Rect &target,
+                const uint32_t color)
+{
+    SDL_Rect source;
+
+    glyph_position(glyph, source.x, source.y);
+    source.w = 8;
+    source.h = CHARSET_ROWS;
+
+    SDL_SetTextureColorMod(atlas.texture, static_cast<uint8_t>(color >> 16), static_cast<uint8_t>(color >> 8),
+                           static_cast<uint8_t>(color));
+    SDL_RenderCopy(renderer, atlas.texture, &source, &target);
+}
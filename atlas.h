@@ -0,0 +1,47 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    atlas.h                                                          */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Texture with all 256 glyphs of a character set (16 x 16 glyphs of 8 x 8   */
+/* pixels), white where a glyph has its pixels and transparent else. A       */
+/* glyph is drawn by one SDL_RenderCopy in any size and, through the color   */
+/* modulation, in any foreground color over whatever was drawn below it.     */
+/* The texture keeps a copy of the rows it shows and only uploads the        */
+/* glyphs which changed, so it can follow the editor or CHAR_MEM of a        */
+/* running machine every frame.                                              */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef __ATLAS_H_
+#define __ATLAS_H_
+
+/* INCLUDES ******************************************************************/
+
+#include <cstdint>
+
+#include "SDL.h"
+#include "charset.h"
+
+/* ATLAS *********************************************************************/
+
+#define ATLAS_COLUMNS       16          /* glyphs in a row of the texture    */
+#define ATLAS_WIDTH         (ATLAS_COLUMNS * 8)
+#define ATLAS_HEIGHT        (CHARSET_GLYPHS / ATLAS_COLUMNS * CHARSET_ROWS)
+
+struct glyph_atlas
+{
+    SDL_Texture *texture = nullptr;
+    uint8_t      rows[CHARSET_SIZE];    /* glyphs in the texture             */
+    bool         loaded = false;        /* rows hold the texture content     */
+};
+
+bool atlas_open(glyph_atlas &atlas, SDL_Renderer *renderer);
+void atlas_close(glyph_atlas &atlas);
+uint32_t atlas_update(glyph_atlas &atlas, const uint8_t *glyphs);
+void atlas_draw(const glyph_atlas &atlas, SDL_Renderer *renderer, uint8_t glyph, const SDL_Rect &target,
+                uint32_t color);
+
+#endif
@@ -0,0 +1,593 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    batch.cpp                                                        */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Batch runner. Every worker owns a deque of jobs which were not started    */
+/* yet and a queue of started machines which yielded after their time        */
+/* slice. A worker takes new jobs from the back of its own deque and, when   */
+/* it runs out of work, steals from the front of the deques of the others.   */
+/* Machines of finished jobs are reused for the next job of the worker.      */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "batch.h"
+#include "golden.h"
+#include "machine.h"
+
+/* SCHEDULER *****************************************************************/
+
+/**
+ *
+ * Job being run together with its machine (nullptr until started).
+ *
+ */
+struct batch_task
+{
+    batch_job *job = nullptr;
+    std::unique_ptr<Machine> machine;
+    uint64_t executed = 0;
+};
+
+struct batch_worker
+{
+    std::mutex lock;                            /* guards the queues         */
+    std::deque<batch_job *> pending;            /* jobs not started yet      */
+    std::deque<batch_task> ready;               /* started, yielded jobs     */
+    std::vector<std::unique_ptr<Machine>> pool; /* machines for reuse        */
+};
+
+struct batch_state
+{
+    const batch_options &options;
+    const std::vector<batch_image> &images;
+    std::vector<std::unique_ptr<batch_worker>> workers;
+    std::atomic<size_t> remaining;              /* jobs not finished yet     */
+    std::atomic<size_t> resident;               /* started machines          */
+    size_t max_resident;
+    batch_pool *pool;                           /* kept machines or nullptr  */
+
+    batch_state(const batch_options &options, const std::vector<batch_image> &images, batch_pool *pool)
+        : options(options), images(images), remaining(0), resident(0), max_resident(0), pool(pool)
+    {
+    }
+};
+
+/**
+ *
+ * Takes a task from the queues of a worker. The owner takes the newest job
+ * (back of the deque), thieves take the oldest one (front). Started machines
+ * are preferred when there are too many of them, so the memory stays bounded.
+ *
+ */
+bool take_task(batch_state &state, batch_worker &worker, const bool owner, batch_task &task)
+{
+    std::lock_guard<std::mutex> guard(worker.lock);
+    const bool crowded = state.resident.load(std::memory_order_relaxed) >= state.max_resident;
+
+    if (!worker.ready.empty() && (worker.pending.empty() || crowded))
+    {
+        if (owner)
+        {
+            task = std::move(worker.ready.front());
+            worker.ready.pop_front();
+        }
+        else
+        {
+            task = std::move(worker.ready.back());
+            worker.ready.pop_back();
+        }
+        return true;
+    }
+
+    if (!worker.pending.empty())
+    {
+        if (owner)
+        {
+            task.job = worker.pending.back();
+            worker.pending.pop_back();
+        }
+        else
+        {
+            task.job = worker.pending.front();
+            worker.pending.pop_front();
+        }
+        task.machine.reset();
+        task.executed = 0;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ *
+ * Takes a task from the own queues or steals one from the other workers.
+ *
+ */
+bool next_task(batch_state &state, const size_t self, batch_task &task)
+{
+    const size_t count = state.workers.size();
+    size_t i;
+
+    if (take_task(state, *state.workers[self], true, task)) return true;
+
+    for (i = 1; i < count; i++)
+    {
+        if (take_task(state, *state.workers[(self + i) % count], false, task)) return true;
+    }
+
+    return false;
+}
+
+/**
+ *
+ * Takes a machine which last ran from the snapshot out of a list, or with
+ * any set the newest machine when none did.
+ *
+ */
+bool take_machine(std::vector<std::unique_ptr<Machine>> &machines, const machine_snapshot *snapshot, const bool any,
+                  std::unique_ptr<Machine> &m)
+{
+    size_t i = machines.size();
+
+    while (i > 0 && machines[i - 1]->origin.get() != snapshot)
+    {
+        i--;
+    }
+
+    if (i == 0)
+    {
+        if (!any || machines.empty()) return false;
+        i = machines.size();
+    }
+
+    m = std::move(machines[i - 1]);
+    machines.erase(machines.begin() + static_cast<std::ptrdiff_t>(i - 1));
+    return true;
+}
+
+/**
+ *
+ * Prepares a machine for a job, a machine of a finished job is reused when
+ * there is one. Machines which ran the same image are preferred, they only
+ * get their dirty pages restored.
+ *
+ */
+void start_task(batch_state &state, batch_worker &worker, batch_task &task)
+{
+    const batch_image &image = state.images[task.job->image];
+    const batch_job &job = *task.job;
+    bool found = take_machine(worker.pool, image.snapshot.get(), false, task.machine);
+
+    if (!found && state.pool)
+    {
+        std::lock_guard<std::mutex> guard(state.pool->lock);
+        found = take_machine(state.pool->machines, image.snapshot.get(), true, task.machine);
+    }
+
+    if (!found && !take_machine(worker.pool, image.snapshot.get(), true, task.machine))
+    {
+        task.machine.reset(new Machine());
+    }
+
+    Machine &m = *task.machine;
+    uint32_t i;
+
+    restore_snapshot(m, image.snapshot);
+    m.r[0] = static_cast<uint8_t>(job.seed & 0x00FF);
+    m.r[1] = static_cast<uint8_t>((job.seed & 0xFF00) >> 8);
+
+    for (i = 0; i < job.input_size; i++)
+    {
+        host_write(m, static_cast<uint16_t>(job.input_address + i), job.input[i]);
+    }
+
+    state.resident++;
+}
+
+/**
+ *
+ * Hashes the memory of a machine started from an image. Only the pages
+ * written since the start are hashed, the others still have the hashes of
+ * the image.
+ *
+ */
+uint64_t hash_dirty_memory(const Machine &m, const batch_image &image)
+{
+    uint64_t hashes[GOLDEN_PAGES];
+    uint32_t page;
+
+    for (page = 0; page < GOLDEN_PAGES; page++)
+    {
+        hashes[page] = m.dirty[page] ? xxh64(m.mem + page * 256, 256, 0) : image.page_hashes[page];
+    }
+
+    return hash_memory(hashes);
+}
+
+/**
+ *
+ * Stores the final state of a machine to its job and returns the machine to
+ * the pool.
+ *
+ */
+void finish_task(batch_state &state, batch_worker &worker, batch_task &task)
+{
+    const Machine &m = *task.machine;
+    batch_job &job = *task.job;
+
+    uint8_t *output = job.output;
+    uint32_t i;
+
+    memcpy(job.r, m.r, sizeof(job.r));
+    job.ip = m.ip;
+    job.sp = m.sp;
+    job.bp = m.bp;
+    job.c = m.c;
+    job.reason = m.stop ? m.stop : STOP_BUDGET;
+    job.instructions = task.executed;
+
+    for (i = 0; i < job.range_count; i++)
+    {
+        memcpy(output, m.mem + job.ranges[i].address, job.ranges[i].size);
+        output += job.ranges[i].size;
+    }
+
+    if (state.options.hash)
+    {
+        job.memory_hash = hash_dirty_memory(m, state.images[job.image]);
+    }
+
+    worker.pool.push_back(std::move(task.machine));
+    state.resident--;
+    state.remaining--;
+}
+
+void batch_worker_main(batch_state &state, const size_t self)
+{
+    batch_worker &worker = *state.workers[self];
+    batch_task task;
+
+    while (state.remaining.load() > 0)
+    {
+        if (!next_task(state, self, task))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        if (!task.machine)
+        {
+            start_task(state, worker, task);
+        }
+
+        const uint64_t limit = task.job->budget ? task.job->budget : state.options.limit;
+        uint64_t slice = state.options.slice;
+        if (limit && limit - task.executed < slice)
+        {
+            slice = limit - task.executed;
+        }
+
+        run_budget(*task.machine, slice, task.executed);
+
+        if (task.machine->stop || (limit && task.executed >= limit))
+        {
+            finish_task(state, worker, task);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> guard(worker.lock);
+            worker.ready.push_back(std::move(task));
+        }
+    }
+}
+
+void run_batch(const batch_options &options, const std::vector<batch_image> &images, std::vector<batch_job> &jobs,
+               batch_pool *pool)
+{
+    batch_state state(options, images, pool);
+    std::vector<std::thread> threads;
+    size_t count = options.workers ? options.workers : std::thread::hardware_concurrency();
+    size_t i;
+
+    if (count == 0) count = 1;
+    if (count > jobs.size()) count = jobs.size();
+    if (count == 0) return;
+
+    state.max_resident = count * BATCH_RESIDENT;
+    state.remaining = jobs.size();
+
+    /* every worker starts with a contiguous range of the jobs */
+
+    for (i = 0; i < count; i++)
+    {
+        state.workers.emplace_back(new batch_worker());
+    }
+
+    for (i = 0; i < jobs.size(); i++)
+    {
+        state.workers[i * count / jobs.size()]->pending.push_back(&jobs[i]);
+    }
+
+    for (i = 1; i < count; i++)
+    {
+        threads.emplace_back(batch_worker_main, std::ref(state), i);
+    }
+
+    batch_worker_main(state, 0);
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    if (pool)
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+
+        for (auto &worker : state.workers)
+        {
+            for (auto &m : worker->pool)
+            {
+                pool->machines.push_back(std::move(m));
+            }
+        }
+    }
+}
+
+/* BATCH MODE ****************************************************************/
+
+void print_batch_usage()
+{
+    printf("usage: sophia8 --batch [options] image...\n");
+    printf("  --jobs N       worker threads (default: one per core)\n");
+    printf("  --slice N      instructions per time slice (default: %d)\n", BATCH_SLICE);
+    printf("  --limit N      instructions per job, checked at block ends (default: no limit)\n");
+    printf("  --seeds N      run every image with seeds 0 .. N-1 (default: 1)\n");
+    printf("  --list FILE    read image paths from a file, one per line\n");
+    printf("  --hashes FILE  write the hashes of the final memories to a file\n");
+    printf("  --check FILE   compare the final memories with the hashes of a file\n");
+}
+
+bool load_batch_image(const std::string &path, std::vector<batch_image> &images)
+{
+    std::unique_ptr<Machine> m(new Machine());
+
+    if (!load_program(*m, path))
+    {
+        fprintf(stderr, "can not load image %s\n", path.c_str());
+        return false;
+    }
+
+    batch_image image;
+    image.name = path;
+    image.snapshot = take_snapshot(*m);
+    image.page_hashes.resize(GOLDEN_PAGES);
+    hash_pages(m->mem, image.page_hashes.data());
+
+    images.push_back(std::move(image));
+    return true;
+}
+
+/**
+ *
+ * Loads the images named by a file, one path per line.
+ *
+ */
+bool load_batch_list(const std::string &filename, std::vector<batch_image> &images)
+{
+    std::ifstream list(filename);
+    std::string path;
+
+    if (!list)
+    {
+        fprintf(stderr, "can not open list %s\n", filename.c_str());
+        return false;
+    }
+
+    while (std::getline(list, path))
+    {
+        if (!path.empty() && !load_batch_image(path, images)) return false;
+    }
+
+    return true;
+}
+
+/**
+ *
+ * Writes the memory hashes of the jobs, one line per job:
+ *
+ *     image seed hash
+ *
+ */
+bool write_hash_list(const std::string &filename, const std::vector<batch_image> &images,
+                     const std::vector<batch_job> &jobs)
+{
+    FILE *file = fopen(filename.c_str(), "w");
+    bool ok;
+
+    if (!file) return false;
+
+    for (const batch_job &job : jobs)
+    {
+        fprintf(file, "%s %u %016llx\n", images[job.image].name.c_str(), job.seed,
+                static_cast<unsigned long long>(job.memory_hash));
+    }
+
+    ok = ferror(file) == 0;
+    return fclose(file) == 0 && ok;
+}
+
+/**
+ *
+ * Compares the memory hashes of the jobs with a list written by
+ * write_hash_list and prints the jobs which differ or are not on it.
+ * Returns true if all of them matched.
+ *
+ */
+bool check_hash_list(const std::string &filename, const std::vector<batch_image> &images,
+                     const std::vector<batch_job> &jobs)
+{
+    std::ifstream list(filename);
+    std::unordered_map<std::string, uint64_t> expected;
+    std::string line;
+    uint32_t failed = 0;
+
+    if (!list)
+    {
+        fprintf(stderr, "can not open hashes %s\n", filename.c_str());
+        return false;
+    }
+
+    while (std::getline(list, line))
+    {
+        const size_t split = line.rfind(' ');
+
+        if (split != std::string::npos)
+        {
+            expected[line.substr(0, split)] = strtoull(line.c_str() + split + 1, nullptr, 16);
+        }
+    }
+
+    for (const batch_job &job : jobs)
+    {
+        const std::string key = images[job.image].name + " " + std::to_string(job.seed);
+        const auto found = expected.find(key);
+
+        if (found == expected.end())
+        {
+            printf("%s missing\n", key.c_str());
+            failed++;
+        }
+        else if (found->second != job.memory_hash)
+        {
+            printf("%s memory differs\n", key.c_str());
+            failed++;
+        }
+    }
+
+    printf("%u of %u jobs differ\n", failed, static_cast<uint32_t>(jobs.size()));
+    return failed == 0;
+}
+
+int batch_main(int argc, char *argv[])
+{
+    batch_options options = {0, BATCH_SLICE, 0, false};
+    std::vector<batch_image> images;
+    std::vector<batch_job> jobs;
+    const char *hashes = nullptr;
+    const char *check = nullptr;
+    uint32_t seeds = 1;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if (arg == "--batch")
+        {
+            continue;
+        }
+        else if (arg == "--jobs" && has_value)
+        {
+            options.workers = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        }
+        else if (arg == "--slice" && has_value)
+        {
+            options.slice = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        }
+        else if (arg == "--limit" && has_value)
+        {
+            options.limit = strtoull(argv[++i], nullptr, 0);
+        }
+        else if (arg == "--seeds" && has_value)
+        {
+            seeds = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        }
+        else if (arg == "--list" && has_value)
+        {
+            if (!load_batch_list(argv[++i], images)) return 1;
+        }
+        else if (arg == "--hashes" && has_value)
+        {
+            hashes = argv[++i];
+            options.hash = true;
+        }
+        else if (arg == "--check" && has_value)
+        {
+            check = argv[++i];
+            options.hash = true;
+        }
+        else if (arg.compare(0, 2, "--") == 0)
+        {
+            print_batch_usage();
+            return 1;
+        }
+        else if (!load_batch_image(arg, images))
+        {
+            return 1;
+        }
+    }
+
+    if (images.empty() || options.slice == 0 || seeds == 0 || seeds > 0x10000)
+    {
+        print_batch_usage();
+        return 1;
+    }
+
+    for (uint32_t image = 0; image < images.size(); image++)
+    {
+        for (uint32_t seed = 0; seed < seeds; seed++)
+        {
+            batch_job job = {};
+            job.image = image;
+            job.seed = static_cast<uint16_t>(seed);
+            jobs.push_back(job);
+        }
+    }
+
+    run_batch(options, images, jobs);
+
+    for (const batch_job &job : jobs)
+    {
+        printf("%s %u IP = 0x%04x", images[job.image].name.c_str(), job.seed, job.ip);
+        for (uint8_t k = 0; k < 8; k++)
+        {
+            printf(" R%d = 0x%02x", k, job.r[k]);
+        }
+        printf(" C = %d %llu %s\n", job.c ? 1 : 0, static_cast<unsigned long long>(job.instructions),
+               job.reason == STOP_BUDGET ? "limit" : stop_reason(job.reason));
+    }
+
+    if (hashes && !write_hash_list(hashes, images, jobs))
+    {
+        fprintf(stderr, "can not write hashes %s\n", hashes);
+        return 1;
+    }
+
+    if (check)
+    {
+        return check_hash_list(check, images, jobs) ? 0 : 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    batch.h                                                          */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Batch runner executing many short programs in one process. Jobs are       */
+/* spread over worker threads with a work-stealing deque per worker, every   */
+/* machine is run for a time slice of instructions before it yields.         */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef __BATCH_H_
+#define __BATCH_H_
+
+/* INCLUDES ******************************************************************/
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "machine.h"
+
+/* BATCH RUNNER **************************************************************/
+
+#define BATCH_SLICE     10000   /* default instructions per time slice       */
+#define BATCH_RESIDENT  16      /* started machines per worker at most       */
+
+/**
+ *
+ * Program image shared by all jobs running it. The image (see
+ * load_program) is loaded once and the jobs start from a snapshot of it.
+ *
+ */
+struct batch_image
+{
+    std::string name;
+    std::shared_ptr<const machine_snapshot> snapshot;
+    std::vector<uint64_t> page_hashes;  /* of the snapshot (see hash_pages) */
+};
+
+/**
+ *
+ * Range of the memory copied out of a finished job.
+ *
+ */
+struct batch_range
+{
+    uint16_t address;           /* first address                             */
+    uint32_t size;              /* bytes (up to 0x10000 - address)           */
+};
+
+/**
+ *
+ * One run of an image. The seed is passed to the program in R0 (low byte)
+ * and R1 (high byte) and the input is written to the memory at its address,
+ * the final state is stored to the job when it is done. The output gets
+ * the memory ranges one after another, so it needs their total size.
+ *
+ */
+struct batch_job
+{
+    uint32_t image;             /* index to the image list                   */
+    uint16_t seed;              /* input seed                                */
+    uint64_t budget;            /* instructions at most, 0 - the limit       */
+
+    const uint8_t *input;       /* written to the memory, nullptr - none     */
+    uint16_t input_address;
+    uint32_t input_size;
+
+    const batch_range *ranges;  /* memory copied out, nullptr - none         */
+    uint32_t range_count;
+    uint8_t *output;
+
+    /* results */
+
+    uint8_t  r[8];
+    uint16_t ip;
+    uint16_t sp;
+    uint16_t bp;
+    uint8_t  c;
+    uint8_t  reason;            /* STOP_*, STOP_BUDGET - by the limit        */
+    uint64_t instructions;      /* executed instructions                     */
+    uint64_t memory_hash;       /* final memory (see hash_memory) if hashed  */
+};
+
+struct batch_options
+{
+    uint32_t workers;           /* worker threads, 0 - one per core          */
+    uint32_t slice;             /* instructions per time slice               */
+    uint64_t limit;             /* instructions per job, 0 - no limit        */
+    bool     hash;              /* hash the final memory of the jobs         */
+};
+
+/**
+ *
+ * Machines kept over several batches. The workers take their machines from
+ * the pool and put them back when the batch is done, so a machine which ran
+ * an image before only has its dirty pages restored for the next job.
+ *
+ */
+struct batch_pool
+{
+    std::mutex lock;
+    std::vector<std::unique_ptr<Machine>> machines;
+};
+
+/**
+ *
+ * Runs all jobs and fills in their results. Without a pool the machines
+ * are created for this batch only.
+ *
+ */
+void run_batch(const batch_options &options, const std::vector<batch_image> &images, std::vector<batch_job> &jobs,
+               batch_pool *pool = nullptr);
+
+/**
+ *
+ * Loads a program image (or the images of a list file) to a snapshot
+ * appended to the image list.
+ *
+ */
+bool load_batch_image(const std::string &path, std::vector<batch_image> &images);
+bool load_batch_list(const std::string &filename, std::vector<batch_image> &images);
+
+/**
+ *
+ * Entry of the batch mode of sophia8 (sophia8 --batch ...). Returns the exit
+ * code of the process.
+ *
+ */
+int batch_main(int argc, char *argv[]);
+
+#endif
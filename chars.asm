@@ -1,2304 +1,256 @@
-0xE069: db 0b00000000
-0xE071: db 0b00000000
-0xE079: db 0b00000000
-0xE081: db 0b00000000
-0xE089: db 0b00000000
-0xE091: db 0b00000000
-0xE099: db 0b00000000
-0xE0A1: db 0b00000000
-
-0xE0A9: db 0b00000000
-0xE0B1: db 0b00000000
-0xE0B9: db 0b00000000
-0xE0C1: db 0b00000000
-0xE0C9: db 0b00000000
-0xE0D1: db 0b00000000
-0xE0D9: db 0b00000000
-0xE0E1: db 0b00000000
-
-0xE0E9: db 0b00000000
-0xE0F1: db 0b00000000
-0xE0F9: db 0b00000000
-0xE101: db 0b00000000
-0xE109: db 0b00000000
-0xE111: db 0b00000000
-0xE119: db 0b00000000
-0xE121: db 0b00000000
-
-0xE129: db 0b00000000
-0xE131: db 0b00000000
-0xE139: db 0b00000000
-0xE141: db 0b00000000
-0xE149: db 0b00000000
-0xE151: db 0b00000000
-0xE159: db 0b00000000
-0xE161: db 0b00000000
-
-0xE169: db 0b00000000
-0xE171: db 0b00000000
-0xE179: db 0b00000000
-0xE181: db 0b00000000
-0xE189: db 0b00000000
-0xE191: db 0b00000000
-0xE199: db 0b00000000
-0xE1A1: db 0b00000000
-
-0xE1A9: db 0b00000000
-0xE1B1: db 0b00000000
-0xE1B9: db 0b00000000
-0xE1C1: db 0b00000000
-0xE1C9: db 0b00000000
-0xE1D1: db 0b00000000
-0xE1D9: db 0b00000000
-0xE1E1: db 0b00000000
-
-0xE1E9: db 0b00000000
-0xE1F1: db 0b00000000
-0xE1F9: db 0b00000000
-0xE201: db 0b00000000
-0xE209: db 0b00000000
-0xE211: db 0b00000000
-0xE219: db 0b00000000
-0xE221: db 0b00000000
-
-0xE229: db 0b00000000
-0xE231: db 0b00000000
-0xE239: db 0b00000000
-0xE241: db 0b00000000
-0xE249: db 0b00000000
-0xE251: db 0b00000000
-0xE259: db 0b00000000
-0xE261: db 0b00000000
-
-0xE269: db 0b00000000
-0xE271: db 0b00000000
-0xE279: db 0b00000000
-0xE281: db 0b00000000
-0xE289: db 0b00000000
-0xE291: db 0b00000000
-0xE299: db 0b00000000
-0xE2A1: db 0b00000000
-
-0xE2A9: db 0b00000000
-0xE2B1: db 0b00000000
-0xE2B9: db 0b00000000
-0xE2C1: db 0b00000000
-0xE2C9: db 0b00000000
-0xE2D1: db 0b00000000
-0xE2D9: db 0b00000000
-0xE2E1: db 0b00000000
-
-0xE2E9: db 0b00000000
-0xE2F1: db 0b00000000
-0xE2F9: db 0b00000000
-0xE301: db 0b00000000
-0xE309: db 0b00000000
-0xE311: db 0b00000000
-0xE319: db 0b00000000
-0xE321: db 0b00000000
-
-0xE329: db 0b00000000
-0xE331: db 0b00000000
-0xE339: db 0b00000000
-0xE341: db 0b00000000
-0xE349: db 0b00000000
-0xE351: db 0b00000000
-0xE359: db 0b00000000
-0xE361: db 0b00000000
-
-0xE369: db 0b00000000
-0xE371: db 0b00000000
-0xE379: db 0b00000000
-0xE381: db 0b00000000
-0xE389: db 0b00000000
-0xE391: db 0b00000000
-0xE399: db 0b00000000
-0xE3A1: db 0b00000000
-
-0xE3A9: db 0b00000000
-0xE3B1: db 0b00000000
-0xE3B9: db 0b00000000
-0xE3C1: db 0b00000000
-0xE3C9: db 0b00000000
-0xE3D1: db 0b00000000
-0xE3D9: db 0b00000000
-0xE3E1: db 0b00000000
-
-0xE3E9: db 0b00000000
-0xE3F1: db 0b00000000
-0xE3F9: db 0b00000000
-0xE401: db 0b00000000
-0xE409: db 0b00000000
-0xE411: db 0b00000000
-0xE419: db 0b00000000
-0xE421: db 0b00000000
-
-0xE429: db 0b00000000
-0xE431: db 0b00000000
-0xE439: db 0b00000000
-0xE441: db 0b00000000
-0xE449: db 0b00000000
-0xE451: db 0b00000000
-0xE459: db 0b00000000
-0xE461: db 0b00000000
-
-0xE469: db 0b00000000
-0xE471: db 0b00000000
-0xE479: db 0b00000000
-0xE481: db 0b00000000
-0xE489: db 0b00000000
-0xE491: db 0b00000000
-0xE499: db 0b00000000
-0xE4A1: db 0b00000000
-
-0xE4A9: db 0b00000000
-0xE4B1: db 0b00000000
-0xE4B9: db 0b00000000
-0xE4C1: db 0b00000000
-0xE4C9: db 0b00000000
-0xE4D1: db 0b00000000
-0xE4D9: db 0b00000000
-0xE4E1: db 0b00000000
-
-0xE4E9: db 0b00000000
-0xE4F1: db 0b00000000
-0xE4F9: db 0b00000000
-0xE501: db 0b00000000
-0xE509: db 0b00000000
-0xE511: db 0b00000000
-0xE519: db 0b00000000
-0xE521: db 0b00000000
-
-0xE529: db 0b00000000
-0xE531: db 0b00000000
-0xE539: db 0b00000000
-0xE541: db 0b00000000
-0xE549: db 0b00000000
-0xE551: db 0b00000000
-0xE559: db 0b00000000
-0xE561: db 0b00000000
-
-0xE569: db 0b00000000
-0xE571: db 0b00000000
-0xE579: db 0b00000000
-0xE581: db 0b00000000
-0xE589: db 0b00000000
-0xE591: db 0b00000000
-0xE599: db 0b00000000
-0xE5A1: db 0b00000000
-
-0xE5A9: db 0b00000000
-0xE5B1: db 0b00000000
-0xE5B9: db 0b00000000
-0xE5C1: db 0b00000000
-0xE5C9: db 0b00000000
-0xE5D1: db 0b00000000
-0xE5D9: db 0b00000000
-0xE5E1: db 0b00000000
-
-0xE5E9: db 0b00000000
-0xE5F1: db 0b00000000
-0xE5F9: db 0b00000000
-0xE601: db 0b00000000
-0xE609: db 0b00000000
-0xE611: db 0b00000000
-0xE619: db 0b00000000
-0xE621: db 0b00000000
-
-0xE629: db 0b00000000
-0xE631: db 0b00000000
-0xE639: db 0b00000000
-0xE641: db 0b00000000
-0xE649: db 0b00000000
-0xE651: db 0b00000000
-0xE659: db 0b00000000
-0xE661: db 0b00000000
-
-0xE669: db 0b00000000
-0xE671: db 0b00000000
-0xE679: db 0b00000000
-0xE681: db 0b00000000
-0xE689: db 0b00000000
-0xE691: db 0b00000000
-0xE699: db 0b00000000
-0xE6A1: db 0b00000000
-
-0xE6A9: db 0b00000000
-0xE6B1: db 0b00000000
-0xE6B9: db 0b00000000
-0xE6C1: db 0b00000000
-0xE6C9: db 0b00000000
-0xE6D1: db 0b00000000
-0xE6D9: db 0b00000000
-0xE6E1: db 0b00000000
-
-0xE6E9: db 0b00000000
-0xE6F1: db 0b00000000
-0xE6F9: db 0b00000000
-0xE701: db 0b00000000
-0xE709: db 0b00000000
-0xE711: db 0b00000000
-0xE719: db 0b00000000
-0xE721: db 0b00000000
-
-0xE729: db 0b00000000
-0xE731: db 0b00000000
-0xE739: db 0b00000000
-0xE741: db 0b00000000
-0xE749: db 0b00000000
-0xE751: db 0b00000000
-0xE759: db 0b00000000
-0xE761: db 0b00000000
-
-0xE769: db 0b00000000
-0xE771: db 0b00000000
-0xE779: db 0b00000000
-0xE781: db 0b00000000
-0xE789: db 0b00000000
-0xE791: db 0b00000000
-0xE799: db 0b00000000
-0xE7A1: db 0b00000000
-
-0xE7A9: db 0b00000000
-0xE7B1: db 0b00000000
-0xE7B9: db 0b00000000
-0xE7C1: db 0b00000000
-0xE7C9: db 0b00000000
-0xE7D1: db 0b00000000
-0xE7D9: db 0b00000000
-0xE7E1: db 0b00000000
-
-0xE7E9: db 0b00000000
-0xE7F1: db 0b00000000
-0xE7F9: db 0b00000000
-0xE801: db 0b00000000
-0xE809: db 0b00000000
-0xE811: db 0b00000000
-0xE819: db 0b00000000
-0xE821: db 0b00000000
-
-0xE829: db 0b00000000
-0xE831: db 0b00000000
-0xE839: db 0b00000000
-0xE841: db 0b00000000
-0xE849: db 0b00000000
-0xE851: db 0b00000000
-0xE859: db 0b00000000
-0xE861: db 0b00000000
-
-0xE869: db 0b00000000
-0xE871: db 0b00000000
-0xE879: db 0b00000000
-0xE881: db 0b00000000
-0xE889: db 0b00000000
-0xE891: db 0b00000000
-0xE899: db 0b00000000
-0xE8A1: db 0b00000000
-
-0xE8A9: db 0b00011000
-0xE8B1: db 0b00011000
-0xE8B9: db 0b00011000
-0xE8C1: db 0b00011000
-0xE8C9: db 0b00000000
-0xE8D1: db 0b00011000
-0xE8D9: db 0b00011000
-0xE8E1: db 0b00000000
-
-0xE8E9: db 0b01101100
-0xE8F1: db 0b01101100
-0xE8F9: db 0b00100100
-0xE901: db 0b00000000
-0xE909: db 0b00000000
-0xE911: db 0b00000000
-0xE919: db 0b00000000
-0xE921: db 0b00000000
-
-0xE929: db 0b01101100
-0xE931: db 0b01101100
-0xE939: db 0b11111110
-0xE941: db 0b01101100
-0xE949: db 0b11111110
-0xE951: db 0b01101100
-0xE959: db 0b01101100
-0xE961: db 0b00000000
-
-0xE969: db 0b01000010
-0xE971: db 0b10100100
-0xE979: db 0b01001000
-0xE981: db 0b00010000
-0xE989: db 0b00100100
-0xE991: db 0b01001010
-0xE999: db 0b10000100
-0xE9A1: db 0b00000000
-
-0xE9A9: db 0b00111000
-0xE9B1: db 0b01101100
-0xE9B9: db 0b00111000
-0xE9C1: db 0b01101000
-0xE9C9: db 0b11001110
-0xE9D1: db 0b11001100
-0xE9D9: db 0b01110110
-0xE9E1: db 0b00000000
-
-0xE9E9: db 0b00011000
-0xE9F1: db 0b00011000
-0xE9F9: db 0b00001000
-0xEA01: db 0b00000000
-0xEA09: db 0b00000000
-0xEA11: db 0b00000000
-0xEA19: db 0b00000000
-0xEA21: db 0b00000000
-
-0xEA29: db 0b00011000
-0xEA31: db 0b00110000
-0xEA39: db 0b01100000
-0xEA41: db 0b01100000
-0xEA49: db 0b01100000
-0xEA51: db 0b00110000
-0xEA59: db 0b00011000
-0xEA61: db 0b00000000
-
-0xEA69: db 0b00110000
-0xEA71: db 0b00011000
-0xEA79: db 0b00001100
-0xEA81: db 0b00001100
-0xEA89: db 0b00001100
-0xEA91: db 0b00011000
-0xEA99: db 0b00110000
-0xEAA1: db 0b00000000
-
-0xEAA9: db 0b00000000
-0xEAB1: db 0b00010000
-0xEAB9: db 0b01010100
-0xEAC1: db 0b00111000
-0xEAC9: db 0b00111000
-0xEAD1: db 0b01010100
-0xEAD9: db 0b00010000
-0xEAE1: db 0b00000000
-
-0xEAE9: db 0b00000000
-0xEAF1: db 0b00010000
-0xEAF9: db 0b00010000
-0xEB01: db 0b01111100
-0xEB09: db 0b00010000
-0xEB11: db 0b00010000
-0xEB19: db 0b00000000
-0xEB21: db 0b00000000
-
-0xEB29: db 0b00000000
-0xEB31: db 0b00000000
-0xEB39: db 0b00000000
-0xEB41: db 0b00000000
-0xEB49: db 0b00000000
-0xEB51: db 0b00011000
-0xEB59: db 0b00011000
-0xEB61: db 0b00010000
-
-0xEB69: db 0b00000000
-0xEB71: db 0b00000000
-0xEB79: db 0b00000000
-0xEB81: db 0b00000000
-0xEB89: db 0b00000000
-0xEB91: db 0b00000000
-0xEB99: db 0b00011000
-0xEBA1: db 0b00000000
-
-0xEBA9: db 0b00000000
-0xEBB1: db 0b00000000
-0xEBB9: db 0b00000000
-0xEBC1: db 0b00000000
-0xEBC9: db 0b00000000
-0xEBD1: db 0b00011000
-0xEBD9: db 0b00011000
-0xEBE1: db 0b00000000
-
-0xEBE9: db 0b00000010
-0xEBF1: db 0b00000110
-0xEBF9: db 0b00001100
-0xEC01: db 0b00011000
-0xEC09: db 0b00110000
-0xEC11: db 0b01100000
-0xEC19: db 0b11000000
-0xEC21: db 0b00000000
-
-0xEC29: db 0b01111100
-0xEC31: db 0b11001110
-0xEC39: db 0b11010110
-0xEC41: db 0b11010110
-0xEC49: db 0b11010110
-0xEC51: db 0b11100110
-0xEC59: db 0b01111100
-0xEC61: db 0b00000000
-
-0xEC69: db 0b00111000
-0xEC71: db 0b01111000
-0xEC79: db 0b00011000
-0xEC81: db 0b00011000
-0xEC89: db 0b00011000
-0xEC91: db 0b00011000
-0xEC99: db 0b00011000
-0xECA1: db 0b00000000
-
-0xECA9: db 0b01111100
-0xECB1: db 0b11000110
-0xECB9: db 0b11000110
-0xECC1: db 0b00011100
-0xECC9: db 0b01110000
-0xECD1: db 0b11000000
-0xECD9: db 0b11111110
-0xECE1: db 0b00000000
-
-0xECE9: db 0b01111100
-0xECF1: db 0b11000110
-0xECF9: db 0b00000110
-0xED01: db 0b00011100
-0xED09: db 0b00000110
-0xED11: db 0b11000110
-0xED19: db 0b01111100
-0xED21: db 0b00000000
-
-0xED29: db 0b00110000
-0xED31: db 0b00110000
-0xED39: db 0b01100000
-0xED41: db 0b01101100
-0xED49: db 0b11001100
-0xED51: db 0b11111110
-0xED59: db 0b00001100
-0xED61: db 0b00000000
-
-0xED69: db 0b01111110
-0xED71: db 0b01100000
-0xED79: db 0b01100000
-0xED81: db 0b00111100
-0xED89: db 0b10000110
-0xED91: db 0b11000110
-0xED99: db 0b01111100
-0xEDA1: db 0b00000000
-
-0xEDA9: db 0b01111100
-0xEDB1: db 0b11000110
-0xEDB9: db 0b11000000
-0xEDC1: db 0b11111100
-0xEDC9: db 0b11000110
-0xEDD1: db 0b11000110
-0xEDD9: db 0b01111100
-0xEDE1: db 0b00000000
-
-0xEDE9: db 0b11111110
-0xEDF1: db 0b11000110
-0xEDF9: db 0b00001100
-0xEE01: db 0b00001100
-0xEE09: db 0b00011000
-0xEE11: db 0b00011000
-0xEE19: db 0b00110000
-0xEE21: db 0b00000000
-
-0xEE29: db 0b01111100
-0xEE31: db 0b11000110
-0xEE39: db 0b11000110
-0xEE41: db 0b01111100
-0xEE49: db 0b11000110
-0xEE51: db 0b11000110
-0xEE59: db 0b01111100
-0xEE61: db 0b00000000
-
-0xEE69: db 0b01111100
-0xEE71: db 0b11000110
-0xEE79: db 0b11000110
-0xEE81: db 0b01111110
-0xEE89: db 0b00000110
-0xEE91: db 0b11000110
-0xEE99: db 0b01111100
-0xEEA1: db 0b00000000
-
-0xEEA9: db 0b00000000
-0xEEB1: db 0b00011000
-0xEEB9: db 0b00011000
-0xEEC1: db 0b00000000
-0xEEC9: db 0b00011000
-0xEED1: db 0b00011000
-0xEED9: db 0b00000000
-0xEEE1: db 0b00000000
-
-0xEEE9: db 0b00000000
-0xEEF1: db 0b00011000
-0xEEF9: db 0b00011000
-0xEF01: db 0b00000000
-0xEF09: db 0b00011000
-0xEF11: db 0b00011000
-0xEF19: db 0b00001000
-0xEF21: db 0b00000000
-
-0xEF29: db 0b00000110
-0xEF31: db 0b00011100
-0xEF39: db 0b01110000
-0xEF41: db 0b11000000
-0xEF49: db 0b01110000
-0xEF51: db 0b00011100
-0xEF59: db 0b00000110
-0xEF61: db 0b00000000
-
-0xEF69: db 0b00000000
-0xEF71: db 0b11111110
-0xEF79: db 0b11111110
-0xEF81: db 0b00000000
-0xEF89: db 0b11111110
-0xEF91: db 0b11111110
-0xEF99: db 0b00000000
-0xEFA1: db 0b00000000
-
-0xEFA9: db 0b11000000
-0xEFB1: db 0b01110000
-0xEFB9: db 0b00011100
-0xEFC1: db 0b00000110
-0xEFC9: db 0b00011100
-0xEFD1: db 0b01110000
-0xEFD9: db 0b11000000
-0xEFE1: db 0b00000000
-
-0xEFE9: db 0b01111100
-0xEFF1: db 0b11000110
-0xEFF9: db 0b11000110
-0xF001: db 0b00001100
-0xF009: db 0b00011000
-0xF011: db 0b00000000
-0xF019: db 0b00011000
-0xF021: db 0b00000000
-
-0xF029: db 0b01111100
-0xF031: db 0b11000110
-0xF039: db 0b11011010
-0xF041: db 0b11010110
-0xF049: db 0b11011100
-0xF051: db 0b11000000
-0xF059: db 0b01111110
-0xF061: db 0b00000000
-
-0xF069: db 0b00111000
-0xF071: db 0b01101100
-0xF079: db 0b11000110
-0xF081: db 0b11000110
-0xF089: db 0b11111110
-0xF091: db 0b11000110
-0xF099: db 0b11000110
-0xF0A1: db 0b00000000
-
-0xF0A9: db 0b11111100
-0xF0B1: db 0b11000110
-0xF0B9: db 0b11000110
-0xF0C1: db 0b11111000
-0xF0C9: db 0b11000110
-0xF0D1: db 0b11000110
-0xF0D9: db 0b11111100
-0xF0E1: db 0b00000000
-
-0xF0E9: db 0b01111100
-0xF0F1: db 0b11000110
-0xF0F9: db 0b11000000
-0xF101: db 0b11000000
-0xF109: db 0b11000000
-0xF111: db 0b11000110
-0xF119: db 0b01111100
-0xF121: db 0b00000000
-
-0xF129: db 0b11111000
-0xF131: db 0b11001100
-0xF139: db 0b11000110
-0xF141: db 0b11000110
-0xF149: db 0b11000110
-0xF151: db 0b11001100
-0xF159: db 0b11111000
-0xF161: db 0b00000000
-
-0xF169: db 0b11111110
-0xF171: db 0b11000000
-0xF179: db 0b11000000
-0xF181: db 0b11111000
-0xF189: db 0b11000000
-0xF191: db 0b11000000
-0xF199: db 0b11111110
-0xF1A1: db 0b00000000
-
-0xF1A9: db 0b11111110
-0xF1B1: db 0b11000000
-0xF1B9: db 0b11000000
-0xF1C1: db 0b11111000
-0xF1C9: db 0b11000000
-0xF1D1: db 0b11000000
-0xF1D9: db 0b11000000
-0xF1E1: db 0b00000000
-
-0xF1E9: db 0b01111110
-0xF1F1: db 0b11000011
-0xF1F9: db 0b11000000
-0xF201: db 0b11001111
-0xF209: db 0b11000011
-0xF211: db 0b11000011
-0xF219: db 0b01111110
-0xF221: db 0b00000000
-
-0xF229: db 0b11000110
-0xF231: db 0b11000110
-0xF239: db 0b11000110
-0xF241: db 0b11111110
-0xF249: db 0b11000110
-0xF251: db 0b11000110
-0xF259: db 0b11000110
-0xF261: db 0b00000000
-
-0xF269: db 0b00111100
-0xF271: db 0b00011000
-0xF279: db 0b00011000
-0xF281: db 0b00011000
-0xF289: db 0b00011000
-0xF291: db 0b00011000
-0xF299: db 0b00111100
-0xF2A1: db 0b00000000
-
-0xF2A9: db 0b00001110
-0xF2B1: db 0b00000110
-0xF2B9: db 0b00000110
-0xF2C1: db 0b00000110
-0xF2C9: db 0b11000110
-0xF2D1: db 0b11000110
-0xF2D9: db 0b01111100
-0xF2E1: db 0b00000000
-
-0xF2E9: db 0b11000110
-0xF2F1: db 0b11001100
-0xF2F9: db 0b11011000
-0xF301: db 0b11110000
-0xF309: db 0b11011000
-0xF311: db 0b11001100
-0xF319: db 0b11000110
-0xF321: db 0b00000000
-
-0xF329: db 0b11000000
-0xF331: db 0b11000000
-0xF339: db 0b11000000
-0xF341: db 0b11000000
-0xF349: db 0b11000000
-0xF351: db 0b11000000
-0xF359: db 0b11111110
-0xF361: db 0b00000000
-
-0xF369: db 0b11000110
-0xF371: db 0b11101110
-0xF379: db 0b11111110
-0xF381: db 0b11010110
-0xF389: db 0b11000110
-0xF391: db 0b11000110
-0xF399: db 0b11000110
-0xF3A1: db 0b00000000
-
-0xF3A9: db 0b11000110
-0xF3B1: db 0b11100110
-0xF3B9: db 0b11110110
-0xF3C1: db 0b11011110
-0xF3C9: db 0b11001110
-0xF3D1: db 0b11000110
-0xF3D9: db 0b11000110
-0xF3E1: db 0b00000000
-
-0xF3E9: db 0b01111100
-0xF3F1: db 0b11000110
-0xF3F9: db 0b11000110
-0xF401: db 0b11000110
-0xF409: db 0b11000110
-0xF411: db 0b11000110
-0xF419: db 0b01111100
-0xF421: db 0b00000000
-
-0xF429: db 0b11111100
-0xF431: db 0b11000110
-0xF439: db 0b11000110
-0xF441: db 0b11111100
-0xF449: db 0b11000000
-0xF451: db 0b11000000
-0xF459: db 0b11000000
-0xF461: db 0b00000000
-
-0xF469: db 0b01111100
-0xF471: db 0b11000110
-0xF479: db 0b11000110
-0xF481: db 0b11010110
-0xF489: db 0b11011010
-0xF491: db 0b11001100
-0xF499: db 0b01110110
-0xF4A1: db 0b00000000
-
-0xF4A9: db 0b11111100
-0xF4B1: db 0b11000110
-0xF4B9: db 0b11000110
-0xF4C1: db 0b11111100
-0xF4C9: db 0b11000110
-0xF4D1: db 0b11000110
-0xF4D9: db 0b11000110
-0xF4E1: db 0b00000000
-
-0xF4E9: db 0b01111100
-0xF4F1: db 0b11000110
-0xF4F9: db 0b11000000
-0xF501: db 0b01111100
-0xF509: db 0b00000110
-0xF511: db 0b11000110
-0xF519: db 0b01111100
-0xF521: db 0b00000000
-
-0xF529: db 0b11111100
-0xF531: db 0b00110000
-0xF539: db 0b00110000
-0xF541: db 0b00110000
-0xF549: db 0b00110000
-0xF551: db 0b00110000
-0xF559: db 0b00110000
-0xF561: db 0b00000000
-
-0xF569: db 0b11000110
-0xF571: db 0b11000110
-0xF579: db 0b11000110
-0xF581: db 0b11000110
-0xF589: db 0b11000110
-0xF591: db 0b11000110
-0xF599: db 0b01111100
-0xF5A1: db 0b00000000
-
-0xF5A9: db 0b11000110
-0xF5B1: db 0b11000110
-0xF5B9: db 0b11000110
-0xF5C1: db 0b11000110
-0xF5C9: db 0b01101100
-0xF5D1: db 0b00111000
-0xF5D9: db 0b00010000
-0xF5E1: db 0b00000000
-
-0xF5E9: db 0b11000110
-0xF5F1: db 0b11000110
-0xF5F9: db 0b11000110
-0xF601: db 0b11010110
-0xF609: db 0b11111110
-0xF611: db 0b11101110
-0xF619: db 0b11000110
-0xF621: db 0b00000000
-
-0xF629: db 0b11000110
-0xF631: db 0b11000110
-0xF639: db 0b01101100
-0xF641: db 0b00111000
-0xF649: db 0b01101100
-0xF651: db 0b11000110
-0xF659: db 0b11000110
-0xF661: db 0b00000000
-
-0xF669: db 0b11001100
-0xF671: db 0b11001100
-0xF679: db 0b11001100
-0xF681: db 0b01111000
-0xF689: db 0b00110000
-0xF691: db 0b00110000
-0xF699: db 0b00110000
-0xF6A1: db 0b00000000
-
-0xF6A9: db 0b11111110
-0xF6B1: db 0b00001100
-0xF6B9: db 0b00011000
-0xF6C1: db 0b00110000
-0xF6C9: db 0b01100000
-0xF6D1: db 0b11000000
-0xF6D9: db 0b11111110
-0xF6E1: db 0b00000000
-
-0xF6E9: db 0b11110000
-0xF6F1: db 0b11000000
-0xF6F9: db 0b11000000
-0xF701: db 0b11000000
-0xF709: db 0b11000000
-0xF711: db 0b11000000
-0xF719: db 0b11110000
-0xF721: db 0b00000000
-
-0xF729: db 0b10000000
-0xF731: db 0b11000000
-0xF739: db 0b01100000
-0xF741: db 0b00110000
-0xF749: db 0b00011000
-0xF751: db 0b00001100
-0xF759: db 0b00000110
-0xF761: db 0b00000000
-
-0xF769: db 0b00011110
-0xF771: db 0b00000110
-0xF779: db 0b00000110
-0xF781: db 0b00000110
-0xF789: db 0b00000110
-0xF791: db 0b00000110
-0xF799: db 0b00011110
-0xF7A1: db 0b00000000
-
-0xF7A9: db 0b00111000
-0xF7B1: db 0b01101100
-0xF7B9: db 0b11000110
-0xF7C1: db 0b00000000
-0xF7C9: db 0b00000000
-0xF7D1: db 0b00000000
-0xF7D9: db 0b00000000
-0xF7E1: db 0b00000000
-
-0xF7E9: db 0b00000000
-0xF7F1: db 0b00000000
-0xF7F9: db 0b00000000
-0xF801: db 0b00000000
-0xF809: db 0b00000000
-0xF811: db 0b00000000
-0xF819: db 0b01111100
-0xF821: db 0b00000000
-
-0xF829: db 0b00110000
-0xF831: db 0b00011000
-0xF839: db 0b00011000
-0xF841: db 0b00000000
-0xF849: db 0b00000000
-0xF851: db 0b00000000
-0xF859: db 0b00000000
-0xF861: db 0b00000000
-
-0xF869: db 0b00000000
-0xF871: db 0b00000000
-0xF879: db 0b01111000
-0xF881: db 0b11001100
-0xF889: db 0b11001100
-0xF891: db 0b11001100
-0xF899: db 0b01110110
-0xF8A1: db 0b00000000
-
-0xF8A9: db 0b01100000
-0xF8B1: db 0b01100000
-0xF8B9: db 0b01111100
-0xF8C1: db 0b01100110
-0xF8C9: db 0b01100110
-0xF8D1: db 0b01100110
-0xF8D9: db 0b10111100
-0xF8E1: db 0b00000000
-
-0xF8E9: db 0b00000000
-0xF8F1: db 0b00000000
-0xF8F9: db 0b01111000
-0xF901: db 0b11001100
-0xF909: db 0b11000000
-0xF911: db 0b11001100
-0xF919: db 0b01111000
-0xF921: db 0b00000000
-
-0xF929: db 0b00001100
-0xF931: db 0b00001100
-0xF939: db 0b01111100
-0xF941: db 0b11001100
-0xF949: db 0b11001100
-0xF951: db 0b11001100
-0xF959: db 0b01111010
-0xF961: db 0b00000000
-
-0xF969: db 0b00000000
-0xF971: db 0b00000000
-0xF979: db 0b01111100
-0xF981: db 0b11000110
-0xF989: db 0b11111100
-0xF991: db 0b11000000
-0xF999: db 0b01111100
-0xF9A1: db 0b00000000
-
-0xF9A9: db 0b00011100
-0xF9B1: db 0b00110110
-0xF9B9: db 0b00110000
-0xF9C1: db 0b01111100
-0xF9C9: db 0b00110000
-0xF9D1: db 0b00110000
-0xF9D9: db 0b00110000
-0xF9E1: db 0b00000000
-
-0xF9E9: db 0b00000000
-0xF9F1: db 0b00111010
-0xF9F9: db 0b01100110
-0xFA01: db 0b01100110
-0xFA09: db 0b00011100
-0xFA11: db 0b01000110
-0xFA19: db 0b00111100
-0xFA21: db 0b00000000
-
-0xFA29: db 0b11000000
-0xFA31: db 0b11000000
-0xFA39: db 0b11111100
-0xFA41: db 0b11000110
-0xFA49: db 0b11000110
-0xFA51: db 0b11000110
-0xFA59: db 0b11000110
-0xFA61: db 0b00000000
-
-0xFA69: db 0b00110000
-0xFA71: db 0b00000000
-0xFA79: db 0b00110000
-0xFA81: db 0b00110000
-0xFA89: db 0b00110000
-0xFA91: db 0b00110000
-0xFA99: db 0b00110000
-0xFAA1: db 0b00000000
-
-0xFAA9: db 0b00011000
-0xFAB1: db 0b00000000
-0xFAB9: db 0b00011000
-0xFAC1: db 0b00011000
-0xFAC9: db 0b00011000
-0xFAD1: db 0b11011000
-0xFAD9: db 0b01110000
-0xFAE1: db 0b00000000
-
-0xFAE9: db 0b11000000
-0xFAF1: db 0b11000000
-0xFAF9: db 0b11001100
-0xFB01: db 0b11011000
-0xFB09: db 0b11110000
-0xFB11: db 0b11011000
-0xFB19: db 0b11001100
-0xFB21: db 0b00000000
-
-0xFB29: db 0b00110000
-0xFB31: db 0b00110000
-0xFB39: db 0b00110000
-0xFB41: db 0b00110000
-0xFB49: db 0b00110000
-0xFB51: db 0b00110000
-0xFB59: db 0b00011000
-0xFB61: db 0b00000000
-
-0xFB69: db 0b00000000
-0xFB71: db 0b00000000
-0xFB79: db 0b01101100
-0xFB81: db 0b11111110
-0xFB89: db 0b11010110
-0xFB91: db 0b11010110
-0xFB99: db 0b11010110
-0xFBA1: db 0b00000000
-
-0xFBA9: db 0b00000000
-0xFBB1: db 0b00000000
-0xFBB9: db 0b11011100
-0xFBC1: db 0b11111110
-0xFBC9: db 0b11100110
-0xFBD1: db 0b11000110
-0xFBD9: db 0b11000110
-0xFBE1: db 0b00000000
-
-0xFBE9: db 0b00000000
-0xFBF1: db 0b00000000
-0xFBF9: db 0b01111100
-0xFC01: db 0b11000110
-0xFC09: db 0b11000110
-0xFC11: db 0b11000110
-0xFC19: db 0b01111100
-0xFC21: db 0b00000000
-
-0xFC29: db 0b00000000
-0xFC31: db 0b00000000
-0xFC39: db 0b11111100
-0xFC41: db 0b11000110
-0xFC49: db 0b11000110
-0xFC51: db 0b11111100
-0xFC59: db 0b11000000
-0xFC61: db 0b00000000
-
-0xFC69: db 0b00000000
-0xFC71: db 0b00000000
-0xFC79: db 0b01111110
-0xFC81: db 0b11000110
-0xFC89: db 0b11000110
-0xFC91: db 0b01111110
-0xFC99: db 0b00000110
-0xFCA1: db 0b00000000
-
-0xFCA9: db 0b00000000
-0xFCB1: db 0b00000000
-0xFCB9: db 0b10111100
-0xFCC1: db 0b11111110
-0xFCC9: db 0b11100110
-0xFCD1: db 0b11000000
-0xFCD9: db 0b11000000
-0xFCE1: db 0b00000000
-
-0xFCE9: db 0b00000000
-0xFCF1: db 0b00000000
-0xFCF9: db 0b00111100
-0xFD01: db 0b01100110
-0xFD09: db 0b00010000
-0xFD11: db 0b11001100
-0xFD19: db 0b01111000
-0xFD21: db 0b00000000
-
-0xFD29: db 0b00110000
-0xFD31: db 0b00110000
-0xFD39: db 0b01111100
-0xFD41: db 0b00110000
-0xFD49: db 0b00110000
-0xFD51: db 0b00110110
-0xFD59: db 0b00011100
-0xFD61: db 0b00000000
-
-0xFD69: db 0b00000000
-0xFD71: db 0b00000000
-0xFD79: db 0b11001100
-0xFD81: db 0b11001100
-0xFD89: db 0b11001100
-0xFD91: db 0b11001100
-0xFD99: db 0b01111010
-0xFDA1: db 0b00000000
-
-0xFDA9: db 0b00000000
-0xFDB1: db 0b00000000
-0xFDB9: db 0b11000110
-0xFDC1: db 0b11000110
-0xFDC9: db 0b01101100
-0xFDD1: db 0b00111000
-0xFDD9: db 0b00010000
-0xFDE1: db 0b00000000
-
-0xFDE9: db 0b00000000
-0xFDF1: db 0b00000000
-0xFDF9: db 0b11000110
-0xFE01: db 0b11000110
-0xFE09: db 0b11010110
-0xFE11: db 0b11010110
-0xFE19: db 0b00101000
-0xFE21: db 0b00000000
-
-0xFE29: db 0b00000000
-0xFE31: db 0b00000000
-0xFE39: db 0b11000110
-0xFE41: db 0b11101110
-0xFE49: db 0b00111000
-0xFE51: db 0b11101110
-0xFE59: db 0b11000110
-0xFE61: db 0b00000000
-
-0xFE69: db 0b00000000
-0xFE71: db 0b00000000
-0xFE79: db 0b01100110
-0xFE81: db 0b00110110
-0xFE89: db 0b00011100
-0xFE91: db 0b00001100
-0xFE99: db 0b00111000
-0xFEA1: db 0b00000000
-
-0xFEA9: db 0b00000000
-0xFEB1: db 0b00000000
-0xFEB9: db 0b11111110
-0xFEC1: db 0b00001110
-0xFEC9: db 0b00111000
-0xFED1: db 0b11100000
-0xFED9: db 0b11111110
-0xFEE1: db 0b00000000
-
-0xFEE9: db 0b00011000
-0xFEF1: db 0b00110000
-0xFEF9: db 0b00110000
-0xFF01: db 0b01100000
-0xFF09: db 0b00110000
-0xFF11: db 0b00110000
-0xFF19: db 0b00011000
-0xFF21: db 0b00000000
-
-0xFF29: db 0b00011000
-0xFF31: db 0b00011000
-0xFF39: db 0b00011000
-0xFF41: db 0b00011000
-0xFF49: db 0b00011000
-0xFF51: db 0b00011000
-0xFF59: db 0b00011000
-0xFF61: db 0b00000000
-
-0xFF69: db 0b00011000
-0xFF71: db 0b00001100
-0xFF79: db 0b00001100
-0xFF81: db 0b00000110
-0xFF89: db 0b00001100
-0xFF91: db 0b00001100
-0xFF99: db 0b00011000
-0xFFA1: db 0b00000000
-
-0xFFA9: db 0b01100010
-0xFFB1: db 0b11111110
-0xFFB9: db 0b10001100
-0xFFC1: db 0b00000000
-0xFFC9: db 0b00000000
-0xFFD1: db 0b00000000
-0xFFD9: db 0b00000000
-0xFFE1: db 0b00000000
-
-0xFFE9: db 0b00000000
-0xFFF1: db 0b00000000
-0xFFF9: db 0b00000000
-0x1: db 0b00000000
-0x9: db 0b00000000
-0x11: db 0b00000000
-0x19: db 0b00000000
-0x21: db 0b00000000
-
-0x29: db 0b00000000
-0x31: db 0b00000000
-0x39: db 0b00000000
-0x41: db 0b00000000
-0x49: db 0b00000000
-0x51: db 0b00000000
-0x59: db 0b00000000
-0x61: db 0b00000000
-
-0x69: db 0b00000000
-0x71: db 0b00000000
-0x79: db 0b00000000
-0x81: db 0b00000000
-0x89: db 0b00000000
-0x91: db 0b00000000
-0x99: db 0b00000000
-0xA1: db 0b00000000
-
-0xA9: db 0b00000000
-0xB1: db 0b00000000
-0xB9: db 0b00000000
-0xC1: db 0b00000000
-0xC9: db 0b00000000
-0xD1: db 0b00000000
-0xD9: db 0b00000000
-0xE1: db 0b00000000
-
-0xE9: db 0b00000000
-0xF1: db 0b00000000
-0xF9: db 0b00000000
-0x101: db 0b00000000
-0x109: db 0b00000000
-0x111: db 0b00000000
-0x119: db 0b00000000
-0x121: db 0b00000000
-
-0x129: db 0b00000000
-0x131: db 0b00000000
-0x139: db 0b00000000
-0x141: db 0b00000000
-0x149: db 0b00000000
-0x151: db 0b00000000
-0x159: db 0b00000000
-0x161: db 0b00000000
-
-0x169: db 0b00000000
-0x171: db 0b00000000
-0x179: db 0b00000000
-0x181: db 0b00000000
-0x189: db 0b00000000
-0x191: db 0b00000000
-0x199: db 0b00000000
-0x1A1: db 0b00000000
-
-0x1A9: db 0b00000000
-0x1B1: db 0b00000000
-0x1B9: db 0b00000000
-0x1C1: db 0b00000000
-0x1C9: db 0b00000000
-0x1D1: db 0b00000000
-0x1D9: db 0b00000000
-0x1E1: db 0b00000000
-
-0x1E9: db 0b00000000
-0x1F1: db 0b00000000
-0x1F9: db 0b00000000
-0x201: db 0b00000000
-0x209: db 0b00000000
-0x211: db 0b00000000
-0x219: db 0b00000000
-0x221: db 0b00000000
-
-0x229: db 0b00000000
-0x231: db 0b00000000
-0x239: db 0b00000000
-0x241: db 0b00000000
-0x249: db 0b00000000
-0x251: db 0b00000000
-0x259: db 0b00000000
-0x261: db 0b00000000
-
-0x269: db 0b00000000
-0x271: db 0b00000000
-0x279: db 0b00000000
-0x281: db 0b00000000
-0x289: db 0b00000000
-0x291: db 0b00000000
-0x299: db 0b00000000
-0x2A1: db 0b00000000
-
-0x2A9: db 0b00000000
-0x2B1: db 0b00000000
-0x2B9: db 0b00000000
-0x2C1: db 0b00000000
-0x2C9: db 0b00000000
-0x2D1: db 0b00000000
-0x2D9: db 0b00000000
-0x2E1: db 0b00000000
-
-0x2E9: db 0b00000000
-0x2F1: db 0b00000000
-0x2F9: db 0b00000000
-0x301: db 0b00000000
-0x309: db 0b00000000
-0x311: db 0b00000000
-0x319: db 0b00000000
-0x321: db 0b00000000
-
-0x329: db 0b00000000
-0x331: db 0b00000000
-0x339: db 0b00000000
-0x341: db 0b00000000
-0x349: db 0b00000000
-0x351: db 0b00000000
-0x359: db 0b00000000
-0x361: db 0b00000000
-
-0x369: db 0b00000000
-0x371: db 0b00000000
-0x379: db 0b00000000
-0x381: db 0b00000000
-0x389: db 0b00000000
-0x391: db 0b00000000
-0x399: db 0b00000000
-0x3A1: db 0b00000000
-
-0x3A9: db 0b00000000
-0x3B1: db 0b00000000
-0x3B9: db 0b00000000
-0x3C1: db 0b00000000
-0x3C9: db 0b00000000
-0x3D1: db 0b00000000
-0x3D9: db 0b00000000
-0x3E1: db 0b00000000
-
-0x3E9: db 0b00000000
-0x3F1: db 0b00000000
-0x3F9: db 0b00000000
-0x401: db 0b00000000
-0x409: db 0b00000000
-0x411: db 0b00000000
-0x419: db 0b00000000
-0x421: db 0b00000000
-
-0x429: db 0b00000000
-0x431: db 0b00000000
-0x439: db 0b00000000
-0x441: db 0b00000000
-0x449: db 0b00000000
-0x451: db 0b00000000
-0x459: db 0b00000000
-0x461: db 0b00000000
-
-0x469: db 0b00000000
-0x471: db 0b00000000
-0x479: db 0b00000000
-0x481: db 0b00000000
-0x489: db 0b00000000
-0x491: db 0b00000000
-0x499: db 0b00000000
-0x4A1: db 0b00000000
-
-0x4A9: db 0b00000000
-0x4B1: db 0b00000000
-0x4B9: db 0b00000000
-0x4C1: db 0b00000000
-0x4C9: db 0b00000000
-0x4D1: db 0b00000000
-0x4D9: db 0b00000000
-0x4E1: db 0b00000000
-
-0x4E9: db 0b00000000
-0x4F1: db 0b00000000
-0x4F9: db 0b00000000
-0x501: db 0b00000000
-0x509: db 0b00000000
-0x511: db 0b00000000
-0x519: db 0b00000000
-0x521: db 0b00000000
-
-0x529: db 0b00000000
-0x531: db 0b00000000
-0x539: db 0b00000000
-0x541: db 0b00000000
-0x549: db 0b00000000
-0x551: db 0b00000000
-0x559: db 0b00000000
-0x561: db 0b00000000
-
-0x569: db 0b00000000
-0x571: db 0b00000000
-0x579: db 0b00000000
-0x581: db 0b00000000
-0x589: db 0b00000000
-0x591: db 0b00000000
-0x599: db 0b00000000
-0x5A1: db 0b00000000
-
-0x5A9: db 0b00000000
-0x5B1: db 0b00000000
-0x5B9: db 0b00000000
-0x5C1: db 0b00000000
-0x5C9: db 0b00000000
-0x5D1: db 0b00000000
-0x5D9: db 0b00000000
-0x5E1: db 0b00000000
-
-0x5E9: db 0b00000000
-0x5F1: db 0b00000000
-0x5F9: db 0b00000000
-0x601: db 0b00000000
-0x609: db 0b00000000
-0x611: db 0b00000000
-0x619: db 0b00000000
-0x621: db 0b00000000
-
-0x629: db 0b00000000
-0x631: db 0b00000000
-0x639: db 0b00000000
-0x641: db 0b00000000
-0x649: db 0b00000000
-0x651: db 0b00000000
-0x659: db 0b00000000
-0x661: db 0b00000000
-
-0x669: db 0b00000000
-0x671: db 0b00000000
-0x679: db 0b00000000
-0x681: db 0b00000000
-0x689: db 0b00000000
-0x691: db 0b00000000
-0x699: db 0b00000000
-0x6A1: db 0b00000000
-
-0x6A9: db 0b00000000
-0x6B1: db 0b00000000
-0x6B9: db 0b00000000
-0x6C1: db 0b00000000
-0x6C9: db 0b00000000
-0x6D1: db 0b00000000
-0x6D9: db 0b00000000
-0x6E1: db 0b00000000
-
-0x6E9: db 0b00000000
-0x6F1: db 0b00000000
-0x6F9: db 0b00000000
-0x701: db 0b00000000
-0x709: db 0b00000000
-0x711: db 0b00000000
-0x719: db 0b00000000
-0x721: db 0b00000000
-
-0x729: db 0b00000000
-0x731: db 0b00000000
-0x739: db 0b00000000
-0x741: db 0b00000000
-0x749: db 0b00000000
-0x751: db 0b00000000
-0x759: db 0b00000000
-0x761: db 0b00000000
-
-0x769: db 0b00000000
-0x771: db 0b00000000
-0x779: db 0b00000000
-0x781: db 0b00000000
-0x789: db 0b00000000
-0x791: db 0b00000000
-0x799: db 0b00000000
-0x7A1: db 0b00000000
-
-0x7A9: db 0b00000000
-0x7B1: db 0b00000000
-0x7B9: db 0b00000000
-0x7C1: db 0b00000000
-0x7C9: db 0b00000000
-0x7D1: db 0b00000000
-0x7D9: db 0b00000000
-0x7E1: db 0b00000000
-
-0x7E9: db 0b00000000
-0x7F1: db 0b00000000
-0x7F9: db 0b00000000
-0x801: db 0b00000000
-0x809: db 0b00000000
-0x811: db 0b00000000
-0x819: db 0b00000000
-0x821: db 0b00000000
-
-0x829: db 0b00000000
-0x831: db 0b00000000
-0x839: db 0b00000000
-0x841: db 0b00000000
-0x849: db 0b00000000
-0x851: db 0b00000000
-0x859: db 0b00000000
-0x861: db 0b00000000
-
-0x869: db 0b00000000
-0x871: db 0b00000000
-0x879: db 0b00000000
-0x881: db 0b00000000
-0x889: db 0b00000000
-0x891: db 0b00000000
-0x899: db 0b00000000
-0x8A1: db 0b00000000
-
-0x8A9: db 0b00000000
-0x8B1: db 0b00000000
-0x8B9: db 0b00000000
-0x8C1: db 0b00000000
-0x8C9: db 0b00000000
-0x8D1: db 0b00000000
-0x8D9: db 0b00000000
-0x8E1: db 0b00000000
-
-0x8E9: db 0b00000000
-0x8F1: db 0b00000000
-0x8F9: db 0b00000000
-0x901: db 0b00000000
-0x909: db 0b00000000
-0x911: db 0b00000000
-0x919: db 0b00000000
-0x921: db 0b00000000
-
-0x929: db 0b00000000
-0x931: db 0b00000000
-0x939: db 0b00000000
-0x941: db 0b00000000
-0x949: db 0b00000000
-0x951: db 0b00000000
-0x959: db 0b00000000
-0x961: db 0b00000000
-
-0x969: db 0b00000000
-0x971: db 0b00000000
-0x979: db 0b00000000
-0x981: db 0b00000000
-0x989: db 0b00000000
-0x991: db 0b00000000
-0x999: db 0b00000000
-0x9A1: db 0b00000000
-
-0x9A9: db 0b00000000
-0x9B1: db 0b00000000
-0x9B9: db 0b00000000
-0x9C1: db 0b00000000
-0x9C9: db 0b00000000
-0x9D1: db 0b00000000
-0x9D9: db 0b00000000
-0x9E1: db 0b00000000
-
-0x9E9: db 0b00000000
-0x9F1: db 0b00000000
-0x9F9: db 0b00000000
-0xA01: db 0b00000000
-0xA09: db 0b00000000
-0xA11: db 0b00000000
-0xA19: db 0b00000000
-0xA21: db 0b00000000
-
-0xA29: db 0b00000000
-0xA31: db 0b00000000
-0xA39: db 0b00000000
-0xA41: db 0b00000000
-0xA49: db 0b00000000
-0xA51: db 0b00000000
-0xA59: db 0b00000000
-0xA61: db 0b00000000
-
-0xA69: db 0b00000000
-0xA71: db 0b00000000
-0xA79: db 0b00000000
-0xA81: db 0b00000000
-0xA89: db 0b00000000
-0xA91: db 0b00000000
-0xA99: db 0b00000000
-0xAA1: db 0b00000000
-
-0xAA9: db 0b00000000
-0xAB1: db 0b00000000
-0xAB9: db 0b00000000
-0xAC1: db 0b00000000
-0xAC9: db 0b00000000
-0xAD1: db 0b00000000
-0xAD9: db 0b00000000
-0xAE1: db 0b00000000
-
-0xAE9: db 0b00000000
-0xAF1: db 0b00000000
-0xAF9: db 0b00000000
-0xB01: db 0b00000000
-0xB09: db 0b00000000
-0xB11: db 0b00000000
-0xB19: db 0b00000000
-0xB21: db 0b00000000
-
-0xB29: db 0b00000000
-0xB31: db 0b00000000
-0xB39: db 0b00000000
-0xB41: db 0b00000000
-0xB49: db 0b00000000
-0xB51: db 0b00000000
-0xB59: db 0b00000000
-0xB61: db 0b00000000
-
-0xB69: db 0b00000000
-0xB71: db 0b00000000
-0xB79: db 0b00000000
-0xB81: db 0b00000000
-0xB89: db 0b00000000
-0xB91: db 0b00000000
-0xB99: db 0b00000000
-0xBA1: db 0b00000000
-
-0xBA9: db 0b00000000
-0xBB1: db 0b00000000
-0xBB9: db 0b00000000
-0xBC1: db 0b00000000
-0xBC9: db 0b00000000
-0xBD1: db 0b00000000
-0xBD9: db 0b00000000
-0xBE1: db 0b00000000
-
-0xBE9: db 0b00000000
-0xBF1: db 0b00000000
-0xBF9: db 0b00000000
-0xC01: db 0b00000000
-0xC09: db 0b00000000
-0xC11: db 0b00000000
-0xC19: db 0b00000000
-0xC21: db 0b00000000
-
-0xC29: db 0b00000000
-0xC31: db 0b00000000
-0xC39: db 0b00000000
-0xC41: db 0b00000000
-0xC49: db 0b00000000
-0xC51: db 0b00000000
-0xC59: db 0b00000000
-0xC61: db 0b00000000
-
-0xC69: db 0b00000000
-0xC71: db 0b00000000
-0xC79: db 0b00000000
-0xC81: db 0b00000000
-0xC89: db 0b00000000
-0xC91: db 0b00000000
-0xC99: db 0b00000000
-0xCA1: db 0b00000000
-
-0xCA9: db 0b00000000
-0xCB1: db 0b00000000
-0xCB9: db 0b00000000
-0xCC1: db 0b00000000
-0xCC9: db 0b00000000
-0xCD1: db 0b00000000
-0xCD9: db 0b00000000
-0xCE1: db 0b00000000
-
-0xCE9: db 0b00000000
-0xCF1: db 0b00000000
-0xCF9: db 0b00000000
-0xD01: db 0b00000000
-0xD09: db 0b00000000
-0xD11: db 0b00000000
-0xD19: db 0b00000000
-0xD21: db 0b00000000
-
-0xD29: db 0b00000000
-0xD31: db 0b00000000
-0xD39: db 0b00000000
-0xD41: db 0b00000000
-0xD49: db 0b00000000
-0xD51: db 0b00000000
-0xD59: db 0b00000000
-0xD61: db 0b00000000
-
-0xD69: db 0b00000000
-0xD71: db 0b00000000
-0xD79: db 0b00000000
-0xD81: db 0b00000000
-0xD89: db 0b00000000
-0xD91: db 0b00000000
-0xD99: db 0b00000000
-0xDA1: db 0b00000000
-
-0xDA9: db 0b00000000
-0xDB1: db 0b00000000
-0xDB9: db 0b00000000
-0xDC1: db 0b00000000
-0xDC9: db 0b00000000
-0xDD1: db 0b00000000
-0xDD9: db 0b00000000
-0xDE1: db 0b00000000
-
-0xDE9: db 0b00000000
-0xDF1: db 0b00000000
-0xDF9: db 0b00000000
-0xE01: db 0b00000000
-0xE09: db 0b00000000
-0xE11: db 0b00000000
-0xE19: db 0b00000000
-0xE21: db 0b00000000
-
-0xE29: db 0b00000000
-0xE31: db 0b00000000
-0xE39: db 0b00000000
-0xE41: db 0b00000000
-0xE49: db 0b00000000
-0xE51: db 0b00000000
-0xE59: db 0b00000000
-0xE61: db 0b00000000
-
-0xE69: db 0b00000000
-0xE71: db 0b00000000
-0xE79: db 0b00000000
-0xE81: db 0b00000000
-0xE89: db 0b00000000
-0xE91: db 0b00000000
-0xE99: db 0b00000000
-0xEA1: db 0b00000000
-
-0xEA9: db 0b00000000
-0xEB1: db 0b00000000
-0xEB9: db 0b00000000
-0xEC1: db 0b00000000
-0xEC9: db 0b00000000
-0xED1: db 0b00000000
-0xED9: db 0b00000000
-0xEE1: db 0b00000000
-
-0xEE9: db 0b00000000
-0xEF1: db 0b00000000
-0xEF9: db 0b00000000
-0xF01: db 0b00000000
-0xF09: db 0b00000000
-0xF11: db 0b00000000
-0xF19: db 0b00000000
-0xF21: db 0b00000000
-
-0xF29: db 0b00000000
-0xF31: db 0b00000000
-0xF39: db 0b00000000
-0xF41: db 0b00000000
-0xF49: db 0b00000000
-0xF51: db 0b00000000
-0xF59: db 0b00000000
-0xF61: db 0b00000000
-
-0xF69: db 0b00000000
-0xF71: db 0b00000000
-0xF79: db 0b00000000
-0xF81: db 0b00000000
-0xF89: db 0b00000000
-0xF91: db 0b00000000
-0xF99: db 0b00000000
-0xFA1: db 0b00000000
-
-0xFA9: db 0b00000000
-0xFB1: db 0b00000000
-0xFB9: db 0b00000000
-0xFC1: db 0b00000000
-0xFC9: db 0b00000000
-0xFD1: db 0b00000000
-0xFD9: db 0b00000000
-0xFE1: db 0b00000000
-
-0xFE9: db 0b00000000
-0xFF1: db 0b00000000
-0xFF9: db 0b00000000
-0x1001: db 0b00000000
-0x1009: db 0b00000000
-0x1011: db 0b00000000
-0x1019: db 0b00000000
-0x1021: db 0b00000000
-
-0x1029: db 0b00000000
-0x1031: db 0b00000000
-0x1039: db 0b00000000
-0x1041: db 0b00000000
-0x1049: db 0b00000000
-0x1051: db 0b00000000
-0x1059: db 0b00000000
-0x1061: db 0b00000000
-
-0x1069: db 0b00000000
-0x1071: db 0b00000000
-0x1079: db 0b00000000
-0x1081: db 0b00000000
-0x1089: db 0b00000000
-0x1091: db 0b00000000
-0x1099: db 0b00000000
-0x10A1: db 0b00000000
-
-0x10A9: db 0b00000000
-0x10B1: db 0b00000000
-0x10B9: db 0b00000000
-0x10C1: db 0b00000000
-0x10C9: db 0b00000000
-0x10D1: db 0b00000000
-0x10D9: db 0b00000000
-0x10E1: db 0b00000000
-
-0x10E9: db 0b00000000
-0x10F1: db 0b00000000
-0x10F9: db 0b00000000
-0x1101: db 0b00000000
-0x1109: db 0b00000000
-0x1111: db 0b00000000
-0x1119: db 0b00000000
-0x1121: db 0b00000000
-
-0x1129: db 0b00000000
-0x1131: db 0b00000000
-0x1139: db 0b00000000
-0x1141: db 0b00000000
-0x1149: db 0b00000000
-0x1151: db 0b00000000
-0x1159: db 0b00000000
-0x1161: db 0b00000000
-
-0x1169: db 0b00000000
-0x1171: db 0b00000000
-0x1179: db 0b00000000
-0x1181: db 0b00000000
-0x1189: db 0b00000000
-0x1191: db 0b00000000
-0x1199: db 0b00000000
-0x11A1: db 0b00000000
-
-0x11A9: db 0b00000000
-0x11B1: db 0b00000000
-0x11B9: db 0b00000000
-0x11C1: db 0b00000000
-0x11C9: db 0b00000000
-0x11D1: db 0b00000000
-0x11D9: db 0b00000000
-0x11E1: db 0b00000000
-
-0x11E9: db 0b00000000
-0x11F1: db 0b00000000
-0x11F9: db 0b00000000
-0x1201: db 0b00000000
-0x1209: db 0b00000000
-0x1211: db 0b00000000
-0x1219: db 0b00000000
-0x1221: db 0b00000000
-
-0x1229: db 0b00000000
-0x1231: db 0b00000000
-0x1239: db 0b00000000
-0x1241: db 0b00000000
-0x1249: db 0b00000000
-0x1251: db 0b00000000
-0x1259: db 0b00000000
-0x1261: db 0b00000000
-
-0x1269: db 0b00000000
-0x1271: db 0b00000000
-0x1279: db 0b00000000
-0x1281: db 0b00000000
-0x1289: db 0b00000000
-0x1291: db 0b00000000
-0x1299: db 0b00000000
-0x12A1: db 0b00000000
-
-0x12A9: db 0b00000000
-0x12B1: db 0b00000000
-0x12B9: db 0b00000000
-0x12C1: db 0b00000000
-0x12C9: db 0b00000000
-0x12D1: db 0b00000000
-0x12D9: db 0b00000000
-0x12E1: db 0b00000000
-
-0x12E9: db 0b00000000
-0x12F1: db 0b00000000
-0x12F9: db 0b00000000
-0x1301: db 0b00000000
-0x1309: db 0b00000000
-0x1311: db 0b00000000
-0x1319: db 0b00000000
-0x1321: db 0b00000000
-
-0x1329: db 0b00000000
-0x1331: db 0b00000000
-0x1339: db 0b00000000
-0x1341: db 0b00000000
-0x1349: db 0b00000000
-0x1351: db 0b00000000
-0x1359: db 0b00000000
-0x1361: db 0b00000000
-
-0x1369: db 0b00000000
-0x1371: db 0b00000000
-0x1379: db 0b00000000
-0x1381: db 0b00000000
-0x1389: db 0b00000000
-0x1391: db 0b00000000
-0x1399: db 0b00000000
-0x13A1: db 0b00000000
-
-0x13A9: db 0b00000000
-0x13B1: db 0b00000000
-0x13B9: db 0b00000000
-0x13C1: db 0b00000000
-0x13C9: db 0b00000000
-0x13D1: db 0b00000000
-0x13D9: db 0b00000000
-0x13E1: db 0b00000000
-
-0x13E9: db 0b00000000
-0x13F1: db 0b00000000
-0x13F9: db 0b00000000
-0x1401: db 0b00000000
-0x1409: db 0b00000000
-0x1411: db 0b00000000
-0x1419: db 0b00000000
-0x1421: db 0b00000000
-
-0x1429: db 0b00000000
-0x1431: db 0b00000000
-0x1439: db 0b00000000
-0x1441: db 0b00000000
-0x1449: db 0b00000000
-0x1451: db 0b00000000
-0x1459: db 0b00000000
-0x1461: db 0b00000000
-
-0x1469: db 0b00000000
-0x1471: db 0b00000000
-0x1479: db 0b00000000
-0x1481: db 0b00000000
-0x1489: db 0b00000000
-0x1491: db 0b00000000
-0x1499: db 0b00000000
-0x14A1: db 0b00000000
-
-0x14A9: db 0b00000000
-0x14B1: db 0b00000000
-0x14B9: db 0b00000000
-0x14C1: db 0b00000000
-0x14C9: db 0b00000000
-0x14D1: db 0b00000000
-0x14D9: db 0b00000000
-0x14E1: db 0b00000000
-
-0x14E9: db 0b00000000
-0x14F1: db 0b00000000
-0x14F9: db 0b00000000
-0x1501: db 0b00000000
-0x1509: db 0b00000000
-0x1511: db 0b00000000
-0x1519: db 0b00000000
-0x1521: db 0b00000000
-
-0x1529: db 0b00000000
-0x1531: db 0b00000000
-0x1539: db 0b00000000
-0x1541: db 0b00000000
-0x1549: db 0b00000000
-0x1551: db 0b00000000
-0x1559: db 0b00000000
-0x1561: db 0b00000000
-
-0x1569: db 0b00000000
-0x1571: db 0b00000000
-0x1579: db 0b00000000
-0x1581: db 0b00000000
-0x1589: db 0b00000000
-0x1591: db 0b00000000
-0x1599: db 0b00000000
-0x15A1: db 0b00000000
-
-0x15A9: db 0b00000000
-0x15B1: db 0b00000000
-0x15B9: db 0b00000000
-0x15C1: db 0b00000000
-0x15C9: db 0b00000000
-0x15D1: db 0b00000000
-0x15D9: db 0b00000000
-0x15E1: db 0b00000000
-
-0x15E9: db 0b00000000
-0x15F1: db 0b00000000
-0x15F9: db 0b00000000
-0x1601: db 0b00000000
-0x1609: db 0b00000000
-0x1611: db 0b00000000
-0x1619: db 0b00000000
-0x1621: db 0b00000000
-
-0x1629: db 0b00000000
-0x1631: db 0b00000000
-0x1639: db 0b00000000
-0x1641: db 0b00000000
-0x1649: db 0b00000000
-0x1651: db 0b00000000
-0x1659: db 0b00000000
-0x1661: db 0b00000000
-
-0x1669: db 0b00000000
-0x1671: db 0b00000000
-0x1679: db 0b00000000
-0x1681: db 0b00000000
-0x1689: db 0b00000000
-0x1691: db 0b00000000
-0x1699: db 0b00000000
-0x16A1: db 0b00000000
-
-0x16A9: db 0b00000000
-0x16B1: db 0b00000000
-0x16B9: db 0b00000000
-0x16C1: db 0b00000000
-0x16C9: db 0b00000000
-0x16D1: db 0b00000000
-0x16D9: db 0b00000000
-0x16E1: db 0b00000000
-
-0x16E9: db 0b00000000
-0x16F1: db 0b00000000
-0x16F9: db 0b00000000
-0x1701: db 0b00000000
-0x1709: db 0b00000000
-0x1711: db 0b00000000
-0x1719: db 0b00000000
-0x1721: db 0b00000000
-
-0x1729: db 0b00000000
-0x1731: db 0b00000000
-0x1739: db 0b00000000
-0x1741: db 0b00000000
-0x1749: db 0b00000000
-0x1751: db 0b00000000
-0x1759: db 0b00000000
-0x1761: db 0b00000000
-
-0x1769: db 0b00000000
-0x1771: db 0b00000000
-0x1779: db 0b00000000
-0x1781: db 0b00000000
-0x1789: db 0b00000000
-0x1791: db 0b00000000
-0x1799: db 0b00000000
-0x17A1: db 0b00000000
-
-0x17A9: db 0b00000000
-0x17B1: db 0b00000000
-0x17B9: db 0b00000000
-0x17C1: db 0b00000000
-0x17C9: db 0b00000000
-0x17D1: db 0b00000000
-0x17D9: db 0b00000000
-0x17E1: db 0b00000000
-
-0x17E9: db 0b00000000
-0x17F1: db 0b00000000
-0x17F9: db 0b00000000
-0x1801: db 0b00000000
-0x1809: db 0b00000000
-0x1811: db 0b00000000
-0x1819: db 0b00000000
-0x1821: db 0b00000000
-
-0x1829: db 0b00000000
-0x1831: db 0b00000000
-0x1839: db 0b00000000
-0x1841: db 0b00000000
-0x1849: db 0b00000000
-0x1851: db 0b00000000
-0x1859: db 0b00000000
-0x1861: db 0b00000000
-
-0x1869: db 0b00000000
-0x1871: db 0b00000000
-0x1879: db 0b00000000
-0x1881: db 0b00000000
-0x1889: db 0b00000000
-0x1891: db 0b00000000
-0x1899: db 0b00000000
-0x18A1: db 0b00000000
-
-0x18A9: db 0b00000000
-0x18B1: db 0b00000000
-0x18B9: db 0b00000000
-0x18C1: db 0b00000000
-0x18C9: db 0b00000000
-0x18D1: db 0b00000000
-0x18D9: db 0b00000000
-0x18E1: db 0b00000000
-
-0x18E9: db 0b00000000
-0x18F1: db 0b00000000
-0x18F9: db 0b00000000
-0x1901: db 0b00000000
-0x1909: db 0b00000000
-0x1911: db 0b00000000
-0x1919: db 0b00000000
-0x1921: db 0b00000000
-
-0x1929: db 0b00000000
-0x1931: db 0b00000000
-0x1939: db 0b00000000
-0x1941: db 0b00000000
-0x1949: db 0b00000000
-0x1951: db 0b00000000
-0x1959: db 0b00000000
-0x1961: db 0b00000000
-
-0x1969: db 0b00000000
-0x1971: db 0b00000000
-0x1979: db 0b00000000
-0x1981: db 0b00000000
-0x1989: db 0b00000000
-0x1991: db 0b00000000
-0x1999: db 0b00000000
-0x19A1: db 0b00000000
-
-0x19A9: db 0b00000000
-0x19B1: db 0b00000000
-0x19B9: db 0b00000000
-0x19C1: db 0b00000000
-0x19C9: db 0b00000000
-0x19D1: db 0b00000000
-0x19D9: db 0b00000000
-0x19E1: db 0b00000000
-
-0x19E9: db 0b00000000
-0x19F1: db 0b00000000
-0x19F9: db 0b00000000
-0x1A01: db 0b00000000
-0x1A09: db 0b00000000
-0x1A11: db 0b00000000
-0x1A19: db 0b00000000
-0x1A21: db 0b00000000
-
-0x1A29: db 0b00000000
-0x1A31: db 0b00000000
-0x1A39: db 0b00000000
-0x1A41: db 0b00000000
-0x1A49: db 0b00000000
-0x1A51: db 0b00000000
-0x1A59: db 0b00000000
-0x1A61: db 0b00000000
-
-0x1A69: db 0b00000000
-0x1A71: db 0b00000000
-0x1A79: db 0b00000000
-0x1A81: db 0b00000000
-0x1A89: db 0b00000000
-0x1A91: db 0b00000000
-0x1A99: db 0b00000000
-0x1AA1: db 0b00000000
-
-0x1AA9: db 0b00000000
-0x1AB1: db 0b00000000
-0x1AB9: db 0b00000000
-0x1AC1: db 0b00000000
-0x1AC9: db 0b00000000
-0x1AD1: db 0b00000000
-0x1AD9: db 0b00000000
-0x1AE1: db 0b00000000
-
-0x1AE9: db 0b00000000
-0x1AF1: db 0b00000000
-0x1AF9: db 0b00000000
-0x1B01: db 0b00000000
-0x1B09: db 0b00000000
-0x1B11: db 0b00000000
-0x1B19: db 0b00000000
-0x1B21: db 0b00000000
-
-0x1B29: db 0b00000000
-0x1B31: db 0b00000000
-0x1B39: db 0b00000000
-0x1B41: db 0b00000000
-0x1B49: db 0b00000000
-0x1B51: db 0b00000000
-0x1B59: db 0b00000000
-0x1B61: db 0b00000000
-
-0x1B69: db 0b00000000
-0x1B71: db 0b00000000
-0x1B79: db 0b00000000
-0x1B81: db 0b00000000
-0x1B89: db 0b00000000
-0x1B91: db 0b00000000
-0x1B99: db 0b00000000
-0x1BA1: db 0b00000000
-
-0x1BA9: db 0b00000000
-0x1BB1: db 0b00000000
-0x1BB9: db 0b00000000
-0x1BC1: db 0b00000000
-0x1BC9: db 0b00000000
-0x1BD1: db 0b00000000
-0x1BD9: db 0b00000000
-0x1BE1: db 0b00000000
-
-0x1BE9: db 0b00000000
-0x1BF1: db 0b00000000
-0x1BF9: db 0b00000000
-0x1C01: db 0b00000000
-0x1C09: db 0b00000000
-0x1C11: db 0b00000000
-0x1C19: db 0b00000000
-0x1C21: db 0b00000000
-
-0x1C29: db 0b00000000
-0x1C31: db 0b00000000
-0x1C39: db 0b00000000
-0x1C41: db 0b00000000
-0x1C49: db 0b00000000
-0x1C51: db 0b00000000
-0x1C59: db 0b00000000
-0x1C61: db 0b00000000
-
-0x1C69: db 0b00000000
-0x1C71: db 0b00000000
-0x1C79: db 0b00000000
-0x1C81: db 0b00000000
-0x1C89: db 0b00000000
-0x1C91: db 0b00000000
-0x1C99: db 0b00000000
-0x1CA1: db 0b00000000
-
-0x1CA9: db 0b00000000
-0x1CB1: db 0b00000000
-0x1CB9: db 0b00000000
-0x1CC1: db 0b00000000
-0x1CC9: db 0b00000000
-0x1CD1: db 0b00000000
-0x1CD9: db 0b00000000
-0x1CE1: db 0b00000000
-
-0x1CE9: db 0b00000000
-0x1CF1: db 0b00000000
-0x1CF9: db 0b00000000
-0x1D01: db 0b00000000
-0x1D09: db 0b00000000
-0x1D11: db 0b00000000
-0x1D19: db 0b00000000
-0x1D21: db 0b00000000
-
-0x1D29: db 0b00000000
-0x1D31: db 0b00000000
-0x1D39: db 0b00000000
-0x1D41: db 0b00000000
-0x1D49: db 0b00000000
-0x1D51: db 0b00000000
-0x1D59: db 0b00000000
-0x1D61: db 0b00000000
-
-0x1D69: db 0b00000000
-0x1D71: db 0b00000000
-0x1D79: db 0b00000000
-0x1D81: db 0b00000000
-0x1D89: db 0b00000000
-0x1D91: db 0b00000000
-0x1D99: db 0b00000000
-0x1DA1: db 0b00000000
-
-0x1DA9: db 0b00000000
-0x1DB1: db 0b00000000
-0x1DB9: db 0b00000000
-0x1DC1: db 0b00000000
-0x1DC9: db 0b00000000
-0x1DD1: db 0b00000000
-0x1DD9: db 0b00000000
-0x1DE1: db 0b00000000
-
-0x1DE9: db 0b00000000
-0x1DF1: db 0b00000000
-0x1DF9: db 0b00000000
-0x1E01: db 0b00000000
-0x1E09: db 0b00000000
-0x1E11: db 0b00000000
-0x1E19: db 0b00000000
-0x1E21: db 0b00000000
-
-0x1E29: db 0b00000000
-0x1E31: db 0b00000000
-0x1E39: db 0b00000000
-0x1E41: db 0b00000000
-0x1E49: db 0b00000000
-0x1E51: db 0b00000000
-0x1E59: db 0b00000000
-0x1E61: db 0b00000000
-
-0x1E69: db 0b00000000
-0x1E71: db 0b00000000
-0x1E79: db 0b00000000
-0x1E81: db 0b00000000
-0x1E89: db 0b00000000
-0x1E91: db 0b00000000
-0x1E99: db 0b00000000
-0x1EA1: db 0b00000000
-
-0x1EA9: db 0b00000000
-0x1EB1: db 0b00000000
-0x1EB9: db 0b00000000
-0x1EC1: db 0b00000000
-0x1EC9: db 0b00000000
-0x1ED1: db 0b00000000
-0x1ED9: db 0b00000000
-0x1EE1: db 0b00000000
-
-0x1EE9: db 0b00000000
-0x1EF1: db 0b00000000
-0x1EF9: db 0b00000000
-0x1F01: db 0b00000000
-0x1F09: db 0b00000000
-0x1F11: db 0b00000000
-0x1F19: db 0b00000000
-0x1F21: db 0b00000000
-
-0x1F29: db 0b00000000
-0x1F31: db 0b00000000
-0x1F39: db 0b00000000
-0x1F41: db 0b00000000
-0x1F49: db 0b00000000
-0x1F51: db 0b00000000
-0x1F59: db 0b00000000
-0x1F61: db 0b00000000
-
-0x1F69: db 0b00000000
-0x1F71: db 0b00000000
-0x1F79: db 0b00000000
-0x1F81: db 0b00000000
-0x1F89: db 0b00000000
-0x1F91: db 0b00000000
-0x1F99: db 0b00000000
-0x1FA1: db 0b00000000
-
-0x1FA9: db 0b00000000
-0x1FB1: db 0b00000000
-0x1FB9: db 0b00000000
-0x1FC1: db 0b00000000
-0x1FC9: db 0b00000000
-0x1FD1: db 0b00000000
-0x1FD9: db 0b00000000
-0x1FE1: db 0b00000000
-
-0x1FE9: db 0b00000000
-0x1FF1: db 0b00000000
-0x1FF9: db 0b00000000
-0x2001: db 0b00000000
-0x2009: db 0b00000000
-0x2011: db 0b00000000
-0x2019: db 0b00000000
-0x2021: db 0b00000000
-
-0x2029: db 0b00000000
-0x2031: db 0b00000000
-0x2039: db 0b00000000
-0x2041: db 0b00000000
-0x2049: db 0b00000000
-0x2051: db 0b00000000
-0x2059: db 0b00000000
-0x2061: db 0b00000000
-
+0xE069: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE071: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE079: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE081: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE089: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE091: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE099: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE0A1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE0A9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE0B1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE0B9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE0C1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE0C9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE0D1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE0D9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE0E1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE0E9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE0F1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE0F9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE101: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE109: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE111: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE119: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE121: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE129: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE131: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE139: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE141: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE149: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE151: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE159: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE161: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE169: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE171: db 0b00011000, 0b00011000, 0b00011000, 0b00011000, 0b00000000, 0b00011000, 0b00011000, 0b00000000
+0xE179: db 0b01101100, 0b01101100, 0b00100100, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE181: db 0b01101100, 0b01101100, 0b11111110, 0b01101100, 0b11111110, 0b01101100, 0b01101100, 0b00000000
+0xE189: db 0b01000010, 0b10100100, 0b01001000, 0b00010000, 0b00100100, 0b01001010, 0b10000100, 0b00000000
+0xE191: db 0b00111000, 0b01101100, 0b00111000, 0b01101000, 0b11001110, 0b11001100, 0b01110110, 0b00000000
+0xE199: db 0b00011000, 0b00011000, 0b00001000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE1A1: db 0b00011000, 0b00110000, 0b01100000, 0b01100000, 0b01100000, 0b00110000, 0b00011000, 0b00000000
+0xE1A9: db 0b00110000, 0b00011000, 0b00001100, 0b00001100, 0b00001100, 0b00011000, 0b00110000, 0b00000000
+0xE1B1: db 0b00000000, 0b00010000, 0b01010100, 0b00111000, 0b00111000, 0b01010100, 0b00010000, 0b00000000
+0xE1B9: db 0b00000000, 0b00010000, 0b00010000, 0b01111100, 0b00010000, 0b00010000, 0b00000000, 0b00000000
+0xE1C1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00011000, 0b00011000, 0b00010000
+0xE1C9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00011000, 0b00000000
+0xE1D1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00011000, 0b00011000, 0b00000000
+0xE1D9: db 0b00000010, 0b00000110, 0b00001100, 0b00011000, 0b00110000, 0b01100000, 0b11000000, 0b00000000
+0xE1E1: db 0b01111100, 0b11001110, 0b11010110, 0b11010110, 0b11010110, 0b11100110, 0b01111100, 0b00000000
+0xE1E9: db 0b00111000, 0b01111000, 0b00011000, 0b00011000, 0b00011000, 0b00011000, 0b00011000, 0b00000000
+0xE1F1: db 0b01111100, 0b11000110, 0b11000110, 0b00011100, 0b01110000, 0b11000000, 0b11111110, 0b00000000
+0xE1F9: db 0b01111100, 0b11000110, 0b00000110, 0b00011100, 0b00000110, 0b11000110, 0b01111100, 0b00000000
+0xE201: db 0b00110000, 0b00110000, 0b01100000, 0b01101100, 0b11001100, 0b11111110, 0b00001100, 0b00000000
+0xE209: db 0b01111110, 0b01100000, 0b01100000, 0b00111100, 0b10000110, 0b11000110, 0b01111100, 0b00000000
+0xE211: db 0b01111100, 0b11000110, 0b11000000, 0b11111100, 0b11000110, 0b11000110, 0b01111100, 0b00000000
+0xE219: db 0b11111110, 0b11000110, 0b00001100, 0b00001100, 0b00011000, 0b00011000, 0b00110000, 0b00000000
+0xE221: db 0b01111100, 0b11000110, 0b11000110, 0b01111100, 0b11000110, 0b11000110, 0b01111100, 0b00000000
+0xE229: db 0b01111100, 0b11000110, 0b11000110, 0b01111110, 0b00000110, 0b11000110, 0b01111100, 0b00000000
+0xE231: db 0b00000000, 0b00011000, 0b00011000, 0b00000000, 0b00011000, 0b00011000, 0b00000000, 0b00000000
+0xE239: db 0b00000000, 0b00011000, 0b00011000, 0b00000000, 0b00011000, 0b00011000, 0b00001000, 0b00000000
+0xE241: db 0b00000110, 0b00011100, 0b01110000, 0b11000000, 0b01110000, 0b00011100, 0b00000110, 0b00000000
+0xE249: db 0b00000000, 0b11111110, 0b11111110, 0b00000000, 0b11111110, 0b11111110, 0b00000000, 0b00000000
+0xE251: db 0b11000000, 0b01110000, 0b00011100, 0b00000110, 0b00011100, 0b01110000, 0b11000000, 0b00000000
+0xE259: db 0b01111100, 0b11000110, 0b11000110, 0b00001100, 0b00011000, 0b00000000, 0b00011000, 0b00000000
+0xE261: db 0b01111100, 0b11000110, 0b11011010, 0b11010110, 0b11011100, 0b11000000, 0b01111110, 0b00000000
+0xE269: db 0b00111000, 0b01101100, 0b11000110, 0b11000110, 0b11111110, 0b11000110, 0b11000110, 0b00000000
+0xE271: db 0b11111100, 0b11000110, 0b11000110, 0b11111000, 0b11000110, 0b11000110, 0b11111100, 0b00000000
+0xE279: db 0b01111100, 0b11000110, 0b11000000, 0b11000000, 0b11000000, 0b11000110, 0b01111100, 0b00000000
+0xE281: db 0b11111000, 0b11001100, 0b11000110, 0b11000110, 0b11000110, 0b11001100, 0b11111000, 0b00000000
+0xE289: db 0b11111110, 0b11000000, 0b11000000, 0b11111000, 0b11000000, 0b11000000, 0b11111110, 0b00000000
+0xE291: db 0b11111110, 0b11000000, 0b11000000, 0b11111000, 0b11000000, 0b11000000, 0b11000000, 0b00000000
+0xE299: db 0b01111110, 0b11000011, 0b11000000, 0b11001111, 0b11000011, 0b11000011, 0b01111110, 0b00000000
+0xE2A1: db 0b11000110, 0b11000110, 0b11000110, 0b11111110, 0b11000110, 0b11000110, 0b11000110, 0b00000000
+0xE2A9: db 0b00111100, 0b00011000, 0b00011000, 0b00011000, 0b00011000, 0b00011000, 0b00111100, 0b00000000
+0xE2B1: db 0b00001110, 0b00000110, 0b00000110, 0b00000110, 0b11000110, 0b11000110, 0b01111100, 0b00000000
+0xE2B9: db 0b11000110, 0b11001100, 0b11011000, 0b11110000, 0b11011000, 0b11001100, 0b11000110, 0b00000000
+0xE2C1: db 0b11000000, 0b11000000, 0b11000000, 0b11000000, 0b11000000, 0b11000000, 0b11111110, 0b00000000
+0xE2C9: db 0b11000110, 0b11101110, 0b11111110, 0b11010110, 0b11000110, 0b11000110, 0b11000110, 0b00000000
+0xE2D1: db 0b11000110, 0b11100110, 0b11110110, 0b11011110, 0b11001110, 0b11000110, 0b11000110, 0b00000000
+0xE2D9: db 0b01111100, 0b11000110, 0b11000110, 0b11000110, 0b11000110, 0b11000110, 0b01111100, 0b00000000
+0xE2E1: db 0b11111100, 0b11000110, 0b11000110, 0b11111100, 0b11000000, 0b11000000, 0b11000000, 0b00000000
+0xE2E9: db 0b01111100, 0b11000110, 0b11000110, 0b11010110, 0b11011010, 0b11001100, 0b01110110, 0b00000000
+0xE2F1: db 0b11111100, 0b11000110, 0b11000110, 0b11111100, 0b11000110, 0b11000110, 0b11000110, 0b00000000
+0xE2F9: db 0b01111100, 0b11000110, 0b11000000, 0b01111100, 0b00000110, 0b11000110, 0b01111100, 0b00000000
+0xE301: db 0b11111100, 0b00110000, 0b00110000, 0b00110000, 0b00110000, 0b00110000, 0b00110000, 0b00000000
+0xE309: db 0b11000110, 0b11000110, 0b11000110, 0b11000110, 0b11000110, 0b11000110, 0b01111100, 0b00000000
+0xE311: db 0b11000110, 0b11000110, 0b11000110, 0b11000110, 0b01101100, 0b00111000, 0b00010000, 0b00000000
+0xE319: db 0b11000110, 0b11000110, 0b11000110, 0b11010110, 0b11111110, 0b11101110, 0b11000110, 0b00000000
+0xE321: db 0b11000110, 0b11000110, 0b01101100, 0b00111000, 0b01101100, 0b11000110, 0b11000110, 0b00000000
+0xE329: db 0b11001100, 0b11001100, 0b11001100, 0b01111000, 0b00110000, 0b00110000, 0b00110000, 0b00000000
+0xE331: db 0b11111110, 0b00001100, 0b00011000, 0b00110000, 0b01100000, 0b11000000, 0b11111110, 0b00000000
+0xE339: db 0b11110000, 0b11000000, 0b11000000, 0b11000000, 0b11000000, 0b11000000, 0b11110000, 0b00000000
+0xE341: db 0b10000000, 0b11000000, 0b01100000, 0b00110000, 0b00011000, 0b00001100, 0b00000110, 0b00000000
+0xE349: db 0b00011110, 0b00000110, 0b00000110, 0b00000110, 0b00000110, 0b00000110, 0b00011110, 0b00000000
+0xE351: db 0b00111000, 0b01101100, 0b11000110, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE359: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b01111100, 0b00000000
+0xE361: db 0b00110000, 0b00011000, 0b00011000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE369: db 0b00000000, 0b00000000, 0b01111000, 0b11001100, 0b11001100, 0b11001100, 0b01110110, 0b00000000
+0xE371: db 0b01100000, 0b01100000, 0b01111100, 0b01100110, 0b01100110, 0b01100110, 0b10111100, 0b00000000
+0xE379: db 0b00000000, 0b00000000, 0b01111000, 0b11001100, 0b11000000, 0b11001100, 0b01111000, 0b00000000
+0xE381: db 0b00001100, 0b00001100, 0b01111100, 0b11001100, 0b11001100, 0b11001100, 0b01111010, 0b00000000
+0xE389: db 0b00000000, 0b00000000, 0b01111100, 0b11000110, 0b11111100, 0b11000000, 0b01111100, 0b00000000
+0xE391: db 0b00011100, 0b00110110, 0b00110000, 0b01111100, 0b00110000, 0b00110000, 0b00110000, 0b00000000
+0xE399: db 0b00000000, 0b00111010, 0b01100110, 0b01100110, 0b00011100, 0b01000110, 0b00111100, 0b00000000
+0xE3A1: db 0b11000000, 0b11000000, 0b11111100, 0b11000110, 0b11000110, 0b11000110, 0b11000110, 0b00000000
+0xE3A9: db 0b00110000, 0b00000000, 0b00110000, 0b00110000, 0b00110000, 0b00110000, 0b00110000, 0b00000000
+0xE3B1: db 0b00011000, 0b00000000, 0b00011000, 0b00011000, 0b00011000, 0b11011000, 0b01110000, 0b00000000
+0xE3B9: db 0b11000000, 0b11000000, 0b11001100, 0b11011000, 0b11110000, 0b11011000, 0b11001100, 0b00000000
+0xE3C1: db 0b00110000, 0b00110000, 0b00110000, 0b00110000, 0b00110000, 0b00110000, 0b00011000, 0b00000000
+0xE3C9: db 0b00000000, 0b00000000, 0b01101100, 0b11111110, 0b11010110, 0b11010110, 0b11010110, 0b00000000
+0xE3D1: db 0b00000000, 0b00000000, 0b11011100, 0b11111110, 0b11100110, 0b11000110, 0b11000110, 0b00000000
+0xE3D9: db 0b00000000, 0b00000000, 0b01111100, 0b11000110, 0b11000110, 0b11000110, 0b01111100, 0b00000000
+0xE3E1: db 0b00000000, 0b00000000, 0b11111100, 0b11000110, 0b11000110, 0b11111100, 0b11000000, 0b00000000
+0xE3E9: db 0b00000000, 0b00000000, 0b01111110, 0b11000110, 0b11000110, 0b01111110, 0b00000110, 0b00000000
+0xE3F1: db 0b00000000, 0b00000000, 0b10111100, 0b11111110, 0b11100110, 0b11000000, 0b11000000, 0b00000000
+0xE3F9: db 0b00000000, 0b00000000, 0b00111100, 0b01100110, 0b00010000, 0b11001100, 0b01111000, 0b00000000
+0xE401: db 0b00110000, 0b00110000, 0b01111100, 0b00110000, 0b00110000, 0b00110110, 0b00011100, 0b00000000
+0xE409: db 0b00000000, 0b00000000, 0b11001100, 0b11001100, 0b11001100, 0b11001100, 0b01111010, 0b00000000
+0xE411: db 0b00000000, 0b00000000, 0b11000110, 0b11000110, 0b01101100, 0b00111000, 0b00010000, 0b00000000
+0xE419: db 0b00000000, 0b00000000, 0b11000110, 0b11000110, 0b11010110, 0b11010110, 0b00101000, 0b00000000
+0xE421: db 0b00000000, 0b00000000, 0b11000110, 0b11101110, 0b00111000, 0b11101110, 0b11000110, 0b00000000
+0xE429: db 0b00000000, 0b00000000, 0b01100110, 0b00110110, 0b00011100, 0b00001100, 0b00111000, 0b00000000
+0xE431: db 0b00000000, 0b00000000, 0b11111110, 0b00001110, 0b00111000, 0b11100000, 0b11111110, 0b00000000
+0xE439: db 0b00011000, 0b00110000, 0b00110000, 0b01100000, 0b00110000, 0b00110000, 0b00011000, 0b00000000
+0xE441: db 0b00011000, 0b00011000, 0b00011000, 0b00011000, 0b00011000, 0b00011000, 0b00011000, 0b00000000
+0xE449: db 0b00011000, 0b00001100, 0b00001100, 0b00000110, 0b00001100, 0b00001100, 0b00011000, 0b00000000
+0xE451: db 0b01100010, 0b11111110, 0b10001100, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE459: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE461: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE469: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE471: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE479: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE481: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE489: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE491: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE499: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE4A1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE4A9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE4B1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE4B9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE4C1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE4C9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE4D1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE4D9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE4E1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE4E9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE4F1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE4F9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE501: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE509: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE511: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE519: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE521: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE529: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE531: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE539: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE541: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE549: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE551: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE559: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE561: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE569: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE571: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE579: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE581: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE589: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE591: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE599: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE5A1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE5A9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE5B1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE5B9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE5C1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE5C9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE5D1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE5D9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE5E1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE5E9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE5F1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE5F9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE601: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE609: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE611: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE619: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE621: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE629: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE631: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE639: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE641: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE649: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE651: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE659: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE661: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE669: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE671: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE679: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE681: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE689: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE691: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE699: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE6A1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE6A9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE6B1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE6B9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE6C1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE6C9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE6D1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE6D9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE6E1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE6E9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE6F1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE6F9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE701: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE709: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE711: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE719: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE721: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE729: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE731: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE739: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE741: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE749: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE751: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE759: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE761: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE769: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE771: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE779: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE781: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE789: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE791: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE799: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE7A1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE7A9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE7B1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE7B9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE7C1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE7C9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE7D1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE7D9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE7E1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE7E9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE7F1: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE7F9: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE801: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE809: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE811: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE819: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE821: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE829: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE831: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE839: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE841: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE849: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE851: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE859: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
+0xE861: db 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000, 0b00000000
@@ -0,0 +1,260 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    charset.cpp                                                      */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Reading and writing of the character sets (see charset.h). The binary     */
+/* files are mapped read only and copied to the glyph rows in one go, the    */
+/* text files are read whole and scanned for their digits.                   */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "charset.h"
+
+/* BINARY CHARSETS ***********************************************************/
+
+/**
+ *
+ * Determines if a file starts with the charset magic number.
+ *
+ */
+bool is_charset_file(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    uint32_t magic = 0;
+
+    file.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    return file.good() && magic == CHARSET_MAGIC;
+}
+
+static bool valid_charset(const uint8_t *base, const size_t size)
+{
+    const charset_header *header = reinterpret_cast<const charset_header *>(base);
+
+    return size == sizeof(charset_header) + CHARSET_SIZE && header->magic == CHARSET_MAGIC &&
+           header->version == CHARSET_VERSION && header->glyphs_minus_1 == CHARSET_GLYPHS - 1 &&
+           header->rows == CHARSET_ROWS;
+}
+
+/**
+ *
+ * Maps a .chr file (read only) and copies its CHARSET_SIZE bytes of rows to
+ * glyphs, which is usually m.mem + CHAR_MEM_ADDRESS.
+ *
+ */
+bool load_charset(const std::string &filename, uint8_t *glyphs)
+{
+    bool ok;
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size;
+
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    const uint8_t *base = static_cast<const uint8_t *>(view);
+
+    ok = view && valid_charset(base, static_cast<size_t>(size.QuadPart));
+    if (ok) memcpy(glyphs, base + sizeof(charset_header), CHARSET_SIZE);
+
+    if (view) UnmapViewOfFile(view);
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+#else
+    struct stat status;
+    const int file = open(filename.c_str(), O_RDONLY);
+
+    if (file < 0) return false;
+
+    if (fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+
+    void *view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+
+    if (view == MAP_FAILED) return false;
+
+    const uint8_t *base = static_cast<const uint8_t *>(view);
+
+    ok = valid_charset(base, static_cast<size_t>(status.st_size));
+    if (ok) memcpy(glyphs, base + sizeof(charset_header), CHARSET_SIZE);
+
+    munmap(view, static_cast<size_t>(status.st_size));
+#endif
+
+    return ok;
+}
+
+bool write_charset(const std::string &filename, const uint8_t *glyphs)
+{
+    std::ofstream file(filename, std::ios::binary);
+    charset_header header = {};
+
+    if (!file.is_open()) return false;
+
+    header.magic = CHARSET_MAGIC;
+    header.version = CHARSET_VERSION;
+    header.glyphs_minus_1 = CHARSET_GLYPHS - 1;
+    header.rows = CHARSET_ROWS;
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(glyphs), CHARSET_SIZE);
+
+    return file.good();
+}
+
+/* TEXT CHARSETS *************************************************************/
+
+/**
+ *
+ * Reads the text format of the editor: the pixels of all rows as digits
+ * separated by white space, '1' for a set pixel. The file is read at once
+ * and every other character is a pixel, like the editor always read it.
+ *
+ */
+bool read_charset_text(const std::string &filename, uint8_t *glyphs)
+{
+    std::ifstream file(filename, std::ios::binary);
+    const std::vector<char> text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    uint32_t pixel = 0;
+
+    if (!file.is_open()) return false;
+
+    memset(glyphs, 0, CHARSET_SIZE);
+
+    for (const char c : text)
+    {
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') continue;
+        if (pixel == CHARSET_SIZE * 8) break;
+
+        if (c == '1') glyphs[pixel >> 3] |= static_cast<uint8_t>(0x80 >> (pixel & 7));
+        pixel++;
+    }
+
+    return pixel == CHARSET_SIZE * 8;
+}
+
+bool write_charset_text(const std::string &filename, const uint8_t *glyphs)
+{
+    std::ofstream file(filename, std::ios::binary);
+    std::string text;
+    uint32_t row, x;
+
+    if (!file.is_open()) return false;
+
+    text.reserve(CHARSET_SIZE * 17 + CHARSET_GLYPHS);
+
+    for (row = 0; row < CHARSET_SIZE; row++)
+    {
+        for (x = 0; x < 8; x++)
+        {
+            text += glyphs[row] & (0x80 >> x) ? "1 " : "0 ";
+        }
+        text += '\n';
+
+        if (row % CHARSET_ROWS == CHARSET_ROWS - 1) text += '\n';
+    }
+
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    return file.good();
+}
+
+/**
+ *
+ * Writes the rows as DB lines for the assembler, one line per glyph at its
+ * address in CHAR_MEM:
+ *
+ *     0xE069: db 0b00000000, 0b00000000, ...
+ *
+ */
+bool write_charset_asm(const std::string &filename, const uint8_t *glyphs)
+{
+    std::ofstream file(filename, std::ios::binary);
+    std::string text;
+    char line[16];
+    uint32_t glyph, row, x;
+
+    if (!file.is_open()) return false;
+
+    for (glyph = 0; glyph < CHARSET_GLYPHS; glyph++)
+    {
+        snprintf(line, sizeof(line), "0x%04X: db ", CHAR_MEM_ADDRESS + glyph * CHARSET_ROWS);
+        text += line;
+
+        for (row = 0; row < CHARSET_ROWS; row++)
+        {
+            const uint8_t bits = glyphs[glyph * CHARSET_ROWS + row];
+
+            text += row ? ", 0b" : "0b";
+            for (x = 0; x < 8; x++)
+            {
+                text += bits & (0x80 >> x) ? '1' : '0';
+            }
+        }
+        text += '\n';
+    }
+
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    return file.good();
+}
+
+/* CONVERSION ****************************************************************/
+
+static bool has_extension(const std::string &filename, const char *extension)
+{
+    const size_t length = strlen(extension);
+
+    return filename.size() >= length && filename.compare(filename.size() - length, length, extension) == 0;
+}
+
+/**
+ *
+ * Converts a charset by the file names: a .chr or text source to a .chr,
+ * text (.dat) or assembler (.asm) target.
+ *
+ */
+bool convert_charset(const std::string &source, const std::string &target)
+{
+    std::unique_ptr<uint8_t[]> glyphs(new uint8_t[CHARSET_SIZE]);
+
+    if (is_charset_file(source) ? !load_charset(source, glyphs.get()) : !read_charset_text(source, glyphs.get()))
+    {
+        return false;
+    }
+
+    if (has_extension(target, ".chr")) return write_charset(target, glyphs.get());
+    if (has_extension(target, ".asm")) return write_charset_asm(target, glyphs.get());
+
+    return write_charset_text(target, glyphs.get());
+}
@@ -0,0 +1,68 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    charset.h                                                        */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Character sets of the text mode: 256 glyphs of 8 rows, a row is a byte    */
+/* with the leftmost pixel in the highest bit, exactly as CHAR_MEM holds     */
+/* them. The binary .chr file is a header followed by the CHAR_MEM_SIZE      */
+/* bytes, so loading it is mapping the file and one copy:                    */
+/*                                                                           */
+/*     charset_header                                                        */
+/*     glyph rows (uint8_t[CHARSET_GLYPHS][CHARSET_ROWS])                    */
+/*                                                                           */
+/* The text format of the editor (chars.dat, one line of 0/1 digits per      */
+/* row) and the DB listing for the assembler (chars.asm) are converted to    */
+/* and from the same rows. All numbers are little endian.                    */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef __CHARSET_H_
+#define __CHARSET_H_
+
+/* INCLUDES ******************************************************************/
+
+#include <cstdint>
+#include <string>
+
+#include "definitions.h"
+
+/* CHARSET FORMAT ************************************************************/
+
+#define CHARSET_MAGIC       0x48433853  /* "S8CH"                            */
+#define CHARSET_VERSION     1
+
+#define CHARSET_GLYPHS      256
+#define CHARSET_ROWS        8
+#define CHARSET_SIZE        (CHARSET_GLYPHS * CHARSET_ROWS)
+
+#pragma pack(push, 1)
+
+struct charset_header
+{
+    uint32_t magic;             /* CHARSET_MAGIC                             */
+    uint16_t version;           /* CHARSET_VERSION                           */
+    uint8_t  glyphs_minus_1;    /* CHARSET_GLYPHS - 1                        */
+    uint8_t  rows;              /* CHARSET_ROWS                              */
+    uint64_t reserved;
+};
+
+#pragma pack(pop)
+
+static_assert(CHARSET_SIZE == CHAR_MEM_SIZE, "a charset fills the whole CHAR_MEM");
+
+/* CHARSET FILES *************************************************************/
+
+bool is_charset_file(const std::string &filename);
+bool load_charset(const std::string &filename, uint8_t *glyphs);
+bool write_charset(const std::string &filename, const uint8_t *glyphs);
+
+bool read_charset_text(const std::string &filename, uint8_t *glyphs);
+bool write_charset_text(const std::string &filename, const uint8_t *glyphs);
+bool write_charset_asm(const std::string &filename, const uint8_t *glyphs);
+
+bool convert_charset(const std::string &source, const std::string &target);
+
+#endif
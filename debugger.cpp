@@ -0,0 +1,681 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    debugger.cpp                                                     */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Debugger (see debugger.h). The machine is run by predecoded blocks, the   */
+/* breakpoint bit of ip is tested before each of them. A block may pass a    */
+/* breakpoint in its middle, so the pages close before a breakpoint are run  */
+/* by single instructions, which are blocks of their own. A watchpoint hit   */
+/* is reported by the device handlers in the stop trigger (STOP_BREAK), the  */
+/* engine stops behind the instruction which made the access.                */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <sstream>
+
+#include "debugger.h"
+#include "image.h"
+#include "profiler.h"
+
+/* WATCHPOINTS ***************************************************************/
+
+/**
+ *
+ * Records a hit if a watchpoint covers the access and stops the machine
+ * behind the instruction making it.
+ *
+ */
+static void check_watch(debugger &d, Machine &m, const uint16_t address, const uint8_t access, const uint8_t value)
+{
+    for (const debug_watch &watch : d.watches)
+    {
+        if ((watch.access & access) && static_cast<uint16_t>(address - watch.address) < watch.size)
+        {
+            d.hit = true;
+            d.hit_address = address;
+            d.hit_access = access;
+            d.hit_value = value;
+            m.stop |= STOP_BREAK;
+            return;
+        }
+    }
+}
+
+/**
+ *
+ * Handlers of the device mapped over the watched pages. The access goes on
+ * to the device the page had before or to the memory.
+ *
+ */
+static uint8_t watch_read(Machine &m, void *context, const uint16_t address)
+{
+    debugger &d = *static_cast<debugger *>(context);
+    const io_device *device = d.devices[address >> 8];
+    const uint8_t value = device && device->read ? device->read(m, device->context, address) : m.mem[address];
+
+    check_watch(d, m, address, WATCH_READ, value);
+    return value;
+}
+
+static void watch_write(Machine &m, void *context, const uint16_t address, const uint8_t value)
+{
+    debugger &d = *static_cast<debugger *>(context);
+    const io_device *device = d.devices[address >> 8];
+
+    if (device && device->write)
+    {
+        device->write(m, device->context, address, value);
+    }
+    else
+    {
+        ram_write(m, address, value);
+    }
+
+    check_watch(d, m, address, WATCH_WRITE, value);
+}
+
+/**
+ *
+ * Maps the watch device over the pages with a watchpoint and gives the
+ * other pages back their own devices.
+ *
+ */
+static void map_watches(debugger &d)
+{
+    Machine &m = *d.m;
+    uint8_t watched[256] = {};
+    uint32_t page, address;
+
+    for (const debug_watch &watch : d.watches)
+    {
+        for (address = watch.address; address < watch.address + watch.size; address += 256)
+        {
+            watched[(address & MEM_SIZE) >> 8] = 1;
+        }
+
+        watched[((watch.address + watch.size - 1) & MEM_SIZE) >> 8] = 1;
+    }
+
+    for (page = 0; page < 256; page++)
+    {
+        const uint16_t first = static_cast<uint16_t>(page << 8);
+        const bool mapped = m.io[page] == &d.watch_device;
+
+        if (watched[page] && !mapped)
+        {
+            d.devices[page] = m.io[page];
+            map_io(m, first, first, &d.watch_device);
+        }
+        else if (!watched[page] && mapped)
+        {
+            map_io(m, first, first, d.devices[page]);
+            d.devices[page] = nullptr;
+        }
+    }
+}
+
+void add_watch(debugger &d, const uint16_t address, const uint32_t size, const uint8_t access)
+{
+    d.watches.push_back({address, size, access});
+    map_watches(d);
+}
+
+bool remove_watch(debugger &d, const uint16_t address)
+{
+    for (auto watch = d.watches.begin(); watch != d.watches.end(); ++watch)
+    {
+        if (watch->address == address)
+        {
+            d.watches.erase(watch);
+            map_watches(d);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* BREAKPOINTS ***************************************************************/
+
+/**
+ *
+ * Marks the pages the blocks reaching a breakpoint can start in.
+ *
+ */
+static void mark_near_pages(debugger &d)
+{
+    uint32_t i, k;
+
+    memset(d.near_pages, 0, sizeof(d.near_pages));
+
+    for (i = 0; i < sizeof(d.breakpoints); i++)
+    {
+        if (!d.breakpoints[i]) continue;
+
+        const uint32_t page = i / 32;
+
+        for (k = 0; k <= DEBUG_REACH_PAGES; k++)
+        {
+            d.near_pages[(page - k) & 0xFF] = 1;
+        }
+    }
+}
+
+void set_breakpoint(debugger &d, const uint16_t address, const bool set)
+{
+    if (set)
+    {
+        d.breakpoints[address >> 3] |= static_cast<uint8_t>(1 << (address & 7));
+    }
+    else
+    {
+        d.breakpoints[address >> 3] &= static_cast<uint8_t>(~(1 << (address & 7)));
+    }
+
+    mark_near_pages(d);
+}
+
+bool has_breakpoint(const debugger &d, const uint16_t address)
+{
+    return (d.breakpoints[address >> 3] >> (address & 7) & 1) != 0;
+}
+
+/* SYMBOLS *******************************************************************/
+
+void init_debugger(debugger &d, Machine &m)
+{
+    d.m = &m;
+    memset(d.breakpoints, 0, sizeof(d.breakpoints));
+    memset(d.near_pages, 0, sizeof(d.near_pages));
+    memset(d.devices, 0, sizeof(d.devices));
+    d.watches.clear();
+    d.watch_device = {watch_read, watch_write, &d};
+    d.hit = false;
+    d.executed = 0;
+}
+
+/**
+ *
+ * Fills the symbol table from the symbols of a program image: its labels
+ * and DEF constants.
+ *
+ */
+bool load_debug_symbols(debugger &d, const std::string &filename)
+{
+    image_file image;
+    uint32_t i;
+
+    if (!is_image_file(filename) || !map_image(filename, image)) return false;
+
+    for (i = 0; i < image.header->symbol_count; i++)
+    {
+        const image_symbol &entry = image.symbols[i];
+        bool inserted = false;
+        assembler::symbol &symbol = d.symbols.insert(image.strings + entry.name, inserted);
+
+        symbol.name = image.strings + entry.name;
+        symbol.kind = entry.flags & IMAGE_SYMBOL_LABEL ? assembler::symbol_kind::label
+                                                       : assembler::symbol_kind::constant;
+        symbol.value = entry.value;
+        symbol.resolved = true;
+    }
+
+    unmap_image(image);
+    return load_labels(filename, d.labels);
+}
+
+/**
+ *
+ * Parses an address: a number, a symbol with an optional +N or -N offset
+ * or one of the 16 bit registers (ip, sp, bp).
+ *
+ */
+static bool parse_address(debugger &d, const std::string &text, uint16_t &address)
+{
+    const size_t offset = text.find_first_of("+-", 1);
+    const std::string name = text.substr(0, offset);
+    char *end = nullptr;
+    long value = 0;
+
+    if (name == "ip") value = d.m->ip;
+    else if (name == "sp") value = d.m->sp;
+    else if (name == "bp") value = d.m->bp;
+    else if (const assembler::symbol *symbol = d.symbols.find(name)) value = symbol->value;
+    else
+    {
+        value = strtol(name.c_str(), &end, 0);
+        if (name.empty() || *end) return false;
+    }
+
+    if (offset != std::string::npos)
+    {
+        const long delta = strtol(text.c_str() + offset, &end, 0);
+
+        if (*end || offset + 1 == text.size()) return false;
+        value += delta;
+    }
+
+    address = static_cast<uint16_t>(value);
+    return true;
+}
+
+/* EXECUTION *****************************************************************/
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void on_interrupt(int)
+{
+    interrupted = 1;
+}
+
+/**
+ *
+ * Runs one block, or one instruction close before a breakpoint.
+ *
+ */
+static void run_block(debugger &d)
+{
+    Machine &m = *d.m;
+
+    if (d.near_pages[m.ip >> 8])
+    {
+        d.executed += run_slice(m, 1);
+    }
+    else
+    {
+        run_budget(m, 1, d.executed);
+    }
+}
+
+/**
+ *
+ * Prints an address with its label and the instruction there.
+ *
+ */
+static void print_instruction(const debugger &d, const uint16_t address)
+{
+    const uint8_t opcode = d.m->mem[address];
+    const uint8_t length = instruction_length(opcode);
+    uint8_t i;
+
+    printf("0x%04x <%s>: %s", address, label_location(d.labels, address).c_str(), instruction_name(opcode));
+
+    for (i = 1; i < length; i++)
+    {
+        printf(" %02x", d.m->mem[static_cast<uint16_t>(address + i)]);
+    }
+
+    printf("\n");
+}
+
+/**
+ *
+ * Tells why the machine stopped and clears a watchpoint break, so it can
+ * be resumed.
+ *
+ */
+static void report_stop(debugger &d, const bool breakpoint)
+{
+    Machine &m = *d.m;
+
+    if (m.stop & STOP_BREAK)
+    {
+        printf("watchpoint: %s 0x%04x <%s> = 0x%02x\n", d.hit_access == WATCH_READ ? "read" : "write",
+               d.hit_address, label_location(d.labels, d.hit_address).c_str(), d.hit_value);
+        m.stop &= static_cast<uint8_t>(~STOP_BREAK);
+        d.hit = false;
+    }
+    else if (breakpoint)
+    {
+        printf("breakpoint: ");
+    }
+
+    if (m.stop)
+    {
+        printf("stopped by %s, IP = 0x%04x\n", stop_reason(m.stop), m.ip);
+        return;
+    }
+
+    if (interrupted) printf("interrupted: ");
+
+    print_instruction(d, m.ip);
+}
+
+static bool check_running(const debugger &d)
+{
+    if (!d.m->stop) return true;
+
+    printf("the machine is stopped by %s\n", stop_reason(d.m->stop));
+    return false;
+}
+
+/**
+ *
+ * Runs until a breakpoint, a watchpoint, a stop of the machine or ^C. The
+ * breakpoint at ip itself is passed, so it can be continued from.
+ *
+ */
+void debug_continue(debugger &d)
+{
+    Machine &m = *d.m;
+    bool first = true, breakpoint = false;
+
+    if (!check_running(d)) return;
+
+    interrupted = 0;
+    void (*previous)(int) = signal(SIGINT, on_interrupt);
+
+    while (!m.stop && !interrupted)
+    {
+        if (!first && has_breakpoint(d, m.ip))
+        {
+            breakpoint = true;
+            break;
+        }
+
+        first = false;
+        run_block(d);
+    }
+
+    signal(SIGINT, previous);
+    report_stop(d, breakpoint);
+}
+
+/**
+ *
+ * Runs count instructions, stopped earlier by the breakpoints behind the
+ * first one and by the watchpoints.
+ *
+ */
+void debug_step(debugger &d, const uint32_t count)
+{
+    Machine &m = *d.m;
+    bool breakpoint = false;
+    uint32_t i;
+
+    if (!check_running(d)) return;
+
+    interrupted = 0;
+
+    for (i = 0; i < count && !m.stop; i++)
+    {
+        if (i && has_breakpoint(d, m.ip))
+        {
+            breakpoint = true;
+            break;
+        }
+
+        d.executed += run_slice(m, 1);
+    }
+
+    report_stop(d, breakpoint);
+}
+
+/**
+ *
+ * Steps over a CALL by a breakpoint behind it, any other instruction is
+ * stepped.
+ *
+ */
+void debug_next(debugger &d)
+{
+    Machine &m = *d.m;
+
+    if (m.stop || m.mem[m.ip] != CALL)
+    {
+        debug_step(d, 1);
+        return;
+    }
+
+    const uint16_t back = static_cast<uint16_t>(m.ip + CALL_LEN);
+    const bool kept = has_breakpoint(d, back);
+
+    set_breakpoint(d, back, true);
+    debug_continue(d);
+    set_breakpoint(d, back, kept);
+}
+
+/* COMMANDS ******************************************************************/
+
+/**
+ *
+ * Dumps a memory range, 16 bytes per line with their characters.
+ *
+ */
+static void dump_memory(const debugger &d, const uint16_t address, const uint32_t size)
+{
+    uint32_t line, i;
+
+    for (line = 0; line < size; line += 16)
+    {
+        const uint32_t count = size - line < 16 ? size - line : 16;
+        char text[17] = {};
+
+        printf("0x%04x:", static_cast<uint16_t>(address + line));
+
+        for (i = 0; i < 16; i++)
+        {
+            const uint8_t value = d.m->mem[static_cast<uint16_t>(address + line + i)];
+
+            if (i < count)
+            {
+                printf(" %02x", value);
+                text[i] = value >= 0x20 && value < 0x7F ? static_cast<char>(value) : '.';
+            }
+            else
+            {
+                printf("   ");
+            }
+        }
+
+        printf("  %s\n", text);
+    }
+}
+
+static void print_info(const debugger &d)
+{
+    uint32_t address;
+
+    for (address = 0; address <= MEM_SIZE; address++)
+    {
+        if (has_breakpoint(d, static_cast<uint16_t>(address)))
+        {
+            printf("breakpoint ");
+            print_instruction(d, static_cast<uint16_t>(address));
+        }
+    }
+
+    for (const debug_watch &watch : d.watches)
+    {
+        printf("watchpoint 0x%04x <%s> %u bytes %s%s\n", watch.address,
+               label_location(d.labels, watch.address).c_str(), watch.size,
+               watch.access & WATCH_READ ? "r" : "", watch.access & WATCH_WRITE ? "w" : "");
+    }
+
+    printf("executed instructions: %llu\n", static_cast<unsigned long long>(d.executed));
+}
+
+static void print_symbols(const debugger &d, const std::string &filter)
+{
+    for (const assembler::symbol &symbol : d.symbols.symbols())
+    {
+        if (symbol.name.find(filter) == std::string::npos) continue;
+
+        printf("0x%04x %s %s\n", static_cast<uint16_t>(symbol.value),
+               symbol.kind == assembler::symbol_kind::label ? "label" : "def  ", symbol.name.c_str());
+    }
+}
+
+static void print_debug_help()
+{
+    printf("  break ADDR           set a breakpoint (b)\n");
+    printf("  delete ADDR          delete a breakpoint (d)\n");
+    printf("  watch ADDR [N] [rw]  stop after reading or writing N bytes (w, default: 1 w)\n");
+    printf("  unwatch ADDR         delete the watchpoint at ADDR\n");
+    printf("  continue             run to the next breakpoint or watchpoint (c)\n");
+    printf("  step [N]             run N instructions (s)\n");
+    printf("  next                 step over a CALL (n)\n");
+    printf("  regs                 print the registers (r)\n");
+    printf("  x ADDR [N]           dump N bytes of the memory (default: %d)\n", DEBUG_DUMP);
+    printf("  info                 list the breakpoints and watchpoints (i)\n");
+    printf("  symbols [TEXT]       list the symbols containing TEXT\n");
+    printf("  quit                 leave the debugger (q)\n");
+    printf("ADDR is a number, a symbol (label+N) or ip, sp, bp.\n");
+}
+
+/**
+ *
+ * Runs one command line. Returns false to leave the debugger.
+ *
+ */
+static bool debug_command(debugger &d, const std::string &line)
+{
+    std::istringstream stream(line);
+    std::vector<std::string> words;
+    std::string word;
+    uint16_t address = 0;
+
+    while (stream >> word)
+    {
+        words.push_back(word);
+    }
+
+    if (words.empty()) return true;
+
+    const std::string &command = words[0];
+    const bool has_address = words.size() > 1 && parse_address(d, words[1], address);
+
+    if (words.size() > 1 && !has_address && command != "symbols")
+    {
+        printf("unknown address %s\n", words[1].c_str());
+        return true;
+    }
+
+    if (command == "break" || command == "b")
+    {
+        if (!has_address) address = d.m->ip;
+        set_breakpoint(d, address, true);
+        printf("breakpoint ");
+        print_instruction(d, address);
+    }
+    else if ((command == "delete" || command == "d") && has_address)
+    {
+        set_breakpoint(d, address, false);
+    }
+    else if ((command == "watch" || command == "w") && has_address)
+    {
+        const uint32_t size = words.size() > 2 ? static_cast<uint32_t>(strtoul(words[2].c_str(), nullptr, 0)) : 1;
+        const std::string access = words.size() > 3 ? words[3] : "w";
+        const uint8_t mode = (access.find('r') != std::string::npos ? WATCH_READ : 0) |
+                             (access.find('w') != std::string::npos ? WATCH_WRITE : 0);
+
+        if (size == 0 || size > MEM_SIZE + 1 || mode == 0)
+        {
+            printf("bad watchpoint\n");
+            return true;
+        }
+
+        add_watch(d, address, size, mode);
+    }
+    else if (command == "unwatch" && has_address)
+    {
+        if (!remove_watch(d, address)) printf("no watchpoint at 0x%04x\n", address);
+    }
+    else if (command == "continue" || command == "c")
+    {
+        debug_continue(d);
+    }
+    else if (command == "step" || command == "s")
+    {
+        debug_step(d, words.size() > 1 ? static_cast<uint32_t>(strtoul(words[1].c_str(), nullptr, 0)) : 1);
+    }
+    else if (command == "next" || command == "n")
+    {
+        debug_next(d);
+    }
+    else if (command == "regs" || command == "r")
+    {
+        print_registers(*d.m);
+    }
+    else if (command == "x" && has_address)
+    {
+        const uint32_t size = words.size() > 2 ? static_cast<uint32_t>(strtoul(words[2].c_str(), nullptr, 0)) : DEBUG_DUMP;
+
+        dump_memory(d, address, size < MEM_SIZE + 1 ? size : MEM_SIZE + 1);
+    }
+    else if (command == "info" || command == "i")
+    {
+        print_info(d);
+    }
+    else if (command == "symbols")
+    {
+        print_symbols(d, words.size() > 1 ? words[1] : "");
+    }
+    else if (command == "quit" || command == "q")
+    {
+        return false;
+    }
+    else
+    {
+        print_debug_help();
+    }
+
+    return true;
+}
+
+/* DEBUGGER MODE *************************************************************/
+
+int debug_main(int argc, char *argv[])
+{
+    std::unique_ptr<Machine> m(new Machine());
+    std::unique_ptr<debugger> d(new debugger());
+    char line[256];
+
+    if (argc != 3)
+    {
+        printf("usage: sophia8 --debug image\n");
+        print_debug_help();
+        return 1;
+    }
+
+    if (!load_program(*m, argv[2]))
+    {
+        fprintf(stderr, "can not load %s\n", argv[2]);
+        return 1;
+    }
+
+    init_debugger(*d, *m);
+
+    if (!load_debug_symbols(*d, argv[2]))
+    {
+        printf("no symbols in %s\n", argv[2]);
+    }
+
+    print_instruction(*d, m->ip);
+
+    for (;;)
+    {
+        printf("(s8db) ");
+        fflush(stdout);
+
+        if (!fgets(line, sizeof(line), stdin))
+        {
+            printf("\n");
+            break;
+        }
+
+        if (!debug_command(*d, line)) break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    debugger.h                                                       */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Interactive debugger of one program image run by the predecoded engine.   */
+/* Breakpoints are bits of a bitmap of the whole memory tested when a block  */
+/* is entered, only the pages a breakpoint can be reached from are run an    */
+/* instruction at a time. Watchpoints map a device over the watched pages,   */
+/* so the accesses of all the other pages keep the plain memory path.        */
+/* Addresses are named by the symbols of the image.                          */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef __DEBUGGER_H_
+#define __DEBUGGER_H_
+
+/* INCLUDES ******************************************************************/
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "definitions.h"
+#include "machine.h"
+#include "symbol_table.h"
+
+/* DEBUGGER ******************************************************************/
+
+#define WATCH_READ          0x01        /* stop after a read of the range    */
+#define WATCH_WRITE         0x02        /* stop after a write to the range   */
+
+#define DEBUG_DUMP          64          /* bytes dumped by default           */
+
+/* pages before a breakpoint a block may start in and still reach it (one
+   block runs BLOCK_LIMIT instructions and a fused one at most) */
+
+#define DEBUG_REACH_PAGES   (((BLOCK_LIMIT + 1) * MAX_INSTRUCTION_LEN + 255) / 256)
+
+struct debug_watch
+{
+    uint16_t address;           /* first watched address                     */
+    uint32_t size;              /* watched bytes                             */
+    uint8_t  access;            /* WATCH_READ, WATCH_WRITE or both           */
+};
+
+struct debugger
+{
+    Machine *m;
+
+    /* code breakpoints, one bit per address, and the pages whose blocks
+       can reach one (run an instruction at a time) */
+
+    uint8_t breakpoints[(MEM_SIZE + 1) / 8];
+    uint8_t near_pages[256];
+
+    /* watchpoints, the device mapped over their pages and the devices it
+       took the pages from (its handlers pass the accesses on to them) */
+
+    std::vector<debug_watch> watches;
+    io_device watch_device;
+    const io_device *devices[256];
+
+    /* last watchpoint hit */
+
+    bool     hit;
+    uint16_t hit_address;
+    uint8_t  hit_access;
+    uint8_t  hit_value;
+
+    /* symbols of the image and its labels sorted by address */
+
+    assembler::symbol_table symbols;
+    std::vector<std::pair<uint16_t, std::string>> labels;
+
+    uint64_t executed;          /* instructions run under the debugger       */
+};
+
+void init_debugger(debugger &d, Machine &m);
+bool load_debug_symbols(debugger &d, const std::string &filename);
+
+/* breakpoints and watchpoints */
+
+void set_breakpoint(debugger &d, uint16_t address, bool set);
+bool has_breakpoint(const debugger &d, uint16_t address);
+void add_watch(debugger &d, uint16_t address, uint32_t size, uint8_t access);
+bool remove_watch(debugger &d, uint16_t address);
+
+/* execution */
+
+void debug_continue(debugger &d);
+void debug_step(debugger &d, uint32_t count);
+void debug_next(debugger &d);
+
+/**
+ *
+ * Entry of the debugger mode of sophia8 (sophia8 --debug image.s8i), reads
+ * the commands from stdin. Returns the exit code of the process.
+ *
+ */
+int debug_main(int argc, char *argv[]);
+
+#endif
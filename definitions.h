@@ -35,6 +35,12 @@
 #define SHL     0x1A            /* shifts register to the left          A    */
 #define SHR     0x1B            /* shifts register to the right         A    */
 
+/* block instructions (addresses and counts in register pairs H, L) */
+
+#define MEMCPY  0x1C            /* copies count bytes (as memmove)      A    */
+#define MEMSET  0x1D            /* fills count bytes with register      A    */
+#define MEMCMP  0x1E            /* compares count bytes                 A    */
+
 /* special instructions */
 
 #define HALT    0x00            /* no operation                         A    */
@@ -70,11 +76,64 @@
 #define SHL_LEN     3
 #define SHR_LEN     3
 
+/* block instructions */
+
+#define MEMCPY_LEN  7
+#define MEMSET_LEN  6
+#define MEMCMP_LEN  8
+
 /* special instructions */
 
 #define HALT_LEN    1
 #define NOP_LEN     1
 
+#define MAX_INSTRUCTION_LEN 8   /* longest instruction (MEMCMP)              */
+
+/* INSTRUCTIONS CYCLES *******************************************************/
+
+/* one cycle per memory access (instruction bytes included), more for the    */
+/* arithmetic which would take several steps of an 8 bit ALU                 */
+
+#define LOAD_CYC    5
+#define STORE_CYC   5
+#define STORER_CYC  5
+#define SET_CYC     3
+#define INC_CYC     2
+#define DEC_CYC     2
+#define JMP_CYC     3
+#define CMP_CYC     3
+#define CMPR_CYC    3
+#define JZ_CYC      4
+#define JNZ_CYC     4
+#define JC_CYC      3
+#define JNC_CYC     3
+#define ADD_CYC     3
+#define ADDR_CYC    3
+#define PUSH_CYC    3
+#define POP_CYC     3
+#define CALL_CYC    5
+#define RET_CYC     3
+#define SUB_CYC     3
+#define SUBR_CYC    3
+#define MUL_CYC     12
+#define MULR_CYC    12
+#define DIV_CYC     20
+#define DIVR_CYC    20
+#define SHL_CYC     4
+#define SHR_CYC     4
+
+/* block instructions move the bytes like a DMA controller, only their own   */
+/* bytes are counted                                                         */
+
+#define MEMCPY_CYC  7
+#define MEMSET_CYC  6
+#define MEMCMP_CYC  8
+
+/* special instructions */
+
+#define HALT_CYC    1
+#define NOP_CYC     1
+
 /* REGISTERS CODES ***********************************************************/
 
 #define IR0     0xF2            /* R0                                        */
@@ -100,6 +159,10 @@
 #define LEX_LABEL           0xFFFF0006
 #define LEX_COMMENT         0xFFFF0007
 #define LEX_COMMA           0xFFFF0008
+#define LEX_STRING          0xFFFF0009
+#define LEX_CHAR            0xFFFF000A
+#define LEX_OPEN_BRACKET    0xFFFF000B
+#define LEX_CLOSE_BRACKET   0xFFFF000C
 
 /* MEMORY MAPPINGS ***********************************************************/
 
@@ -113,4 +176,24 @@
 #define KEY_BUFFER_ADDRESS 0xE005
 #define CHAR_MEM_ADDRESS 0xE069
 
+#define KEY_BUF_MAX_SIZE 100   /* keys the key buffer holds                 */
+
+/* VIDEO *********************************************************************/
+
+#define VIDEO_WIDTH     320     /* screen width in pixels                    */
+#define VIDEO_HEIGHT    200     /* screen height in pixels                   */
+#define VIDEO_COLUMNS   40      /* columns of 8x8 cells                      */
+#define VIDEO_ROWS      25      /* rows of 8x8 cells                         */
+#define VIDEO_CELLS     1000    /* 8x8 cells of the screen                   */
+
+#define VIDEO_TEXT_MODE     0   /* VIDEO_MEM holds character codes           */
+#define VIDEO_BW_MODE       1   /* VIDEO_MEM holds 1 bit pixels              */
+#define VIDEO_COLOR_MODE    2   /* pixels colored by COLOR_MEM cells         */
+
+#define CHAR_MEM_SIZE       0x0800  /* 256 characters, 8 bytes each          */
+
+/* memory read by the display, tracked by 8 byte blocks */
+#define VIDEO_RANGE_SIZE    (CHAR_MEM_ADDRESS + CHAR_MEM_SIZE - VIDEO_MEM_ADDRESS)
+#define VIDEO_BLOCKS        ((VIDEO_RANGE_SIZE + 7) >> 3)
+
 #endif
\ No newline at end of file
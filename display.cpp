@@ -0,0 +1,610 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    display.cpp                                                      */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Display of the video memory. Writes of the machine mark 8 byte blocks of  */
+/* the memory read by the display (see write_byte), a frame turns the marked */
+/* blocks into dirty 8x8 cells, rasterizes only them to the pixel buffer and */
+/* uploads the rectangle bounding them to the texture with one call.         */
+/*                                                                           */
+/* The machine runs on a thread of its own and only copies the video range   */
+/* to a frame once per DISPLAY_FRAME_MS, so neither vsync nor the window     */
+/* events slow it down.                                                      */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#define SDL_MAIN_HANDLED
+#include "SDL.h"
+
+#include "charset.h"
+#include "display.h"
+#include "raster.h"
+#include "scheduler.h"
+
+/* FRAME EXCHANGE ************************************************************/
+
+void init_exchange(frame_exchange &exchange)
+{
+    uint32_t i;
+
+    for (i = 0; i < 3; i++)
+    {
+        memset(exchange.frames[i].mem, 0, sizeof(exchange.frames[i].mem));
+        memset(exchange.frames[i].dirty, 0, sizeof(exchange.frames[i].dirty));
+    }
+
+    memset(exchange.unseen, 0, sizeof(exchange.unseen));
+    exchange.back = 0;
+    exchange.middle.store(1);
+    exchange.front = 2;
+}
+
+/**
+ *
+ * Copies the video range and the written blocks of the machine to the back
+ * frame and makes it the middle one (machine thread).
+ *
+ * A frame carries all the blocks written since the frame the render thread
+ * took last, so no write is lost when it skips frames. The middle frame
+ * replaced tells which case it is: if it was taken, only the blocks of
+ * this frame are still unseen, else all of them are.
+ *
+ */
+void publish_frame(frame_exchange &exchange, Machine &m)
+{
+    video_frame &frame = exchange.frames[exchange.back];
+    uint8_t previous;
+    uint32_t i;
+
+    memcpy(frame.mem + VIDEO_MEM_ADDRESS, m.mem + VIDEO_MEM_ADDRESS, VIDEO_RANGE_SIZE);
+
+    for (i = 0; i < VIDEO_BLOCKS; i++)
+    {
+        exchange.unseen[i] |= m.video_dirty[i];
+    }
+
+    memcpy(frame.dirty, exchange.unseen, VIDEO_BLOCKS);
+
+    previous = exchange.middle.exchange(static_cast<uint8_t>(exchange.back | FRAME_FRESH),
+                                        std::memory_order_acq_rel);
+    exchange.back = previous & 0x03;
+
+    if (!(previous & FRAME_FRESH))
+    {
+        memcpy(exchange.unseen, m.video_dirty, VIDEO_BLOCKS);
+    }
+
+    memset(m.video_dirty, 0, VIDEO_BLOCKS);
+}
+
+/**
+ *
+ * Takes the latest frame published (render thread) or returns nullptr when
+ * there is no new one. The frame stays valid until the next call.
+ *
+ */
+video_frame *acquire_frame(frame_exchange &exchange)
+{
+    uint8_t previous;
+
+    if (!(exchange.middle.load(std::memory_order_acquire) & FRAME_FRESH))
+    {
+        return nullptr;
+    }
+
+    previous = exchange.middle.exchange(exchange.front, std::memory_order_acq_rel);
+    exchange.front = previous & 0x03;
+
+    return &exchange.frames[exchange.front];
+}
+
+/* KEYS **********************************************************************/
+
+void init_keys(key_ring &keys)
+{
+    keys.head.store(0);
+    keys.tail.store(0);
+}
+
+/**
+ *
+ * Adds a key to the ring (render thread), returns false when it is full.
+ *
+ */
+bool push_key(key_ring &keys, const uint8_t key)
+{
+    const uint32_t head = keys.head.load(std::memory_order_relaxed);
+
+    if (head - keys.tail.load(std::memory_order_acquire) >= DISPLAY_KEYS)
+    {
+        return false;
+    }
+
+    keys.keys[head % DISPLAY_KEYS] = key;
+    keys.head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ *
+ * Takes the oldest key from the ring (machine thread).
+ *
+ */
+bool pop_key(key_ring &keys, uint8_t &key)
+{
+    const uint32_t tail = keys.tail.load(std::memory_order_relaxed);
+
+    if (tail == keys.head.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    key = keys.keys[tail % DISPLAY_KEYS];
+    keys.tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ *
+ * Appends the waiting keys to __KEY_BUFFER and updates __KEY_BUF_SIZE
+ * (machine thread). Keys stay in the ring while the buffer is full.
+ *
+ */
+void feed_keys(key_ring &keys, Machine &m)
+{
+    uint8_t size = m.mem[KEY_BUF_SIZE_ADDRESS];
+    uint8_t key;
+
+    if (size >= KEY_BUF_MAX_SIZE || keys.tail.load(std::memory_order_relaxed) ==
+                                    keys.head.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    while (size < KEY_BUF_MAX_SIZE && pop_key(keys, key))
+    {
+        host_write(m, static_cast<uint16_t>(KEY_BUFFER_ADDRESS + size), key);
+        size++;
+    }
+
+    host_write(m, KEY_BUF_SIZE_ADDRESS, size);
+}
+
+/**
+ *
+ * Keyboard device. Reading __KEY_BUF_SIZE first moves the waiting keys to
+ * the buffer, so the program gets every key typed until it looks.
+ *
+ */
+static uint8_t keyboard_read(Machine &m, void *context, const uint16_t address)
+{
+    if (address == KEY_BUF_SIZE_ADDRESS)
+    {
+        feed_keys(*static_cast<key_ring *>(context), m);
+    }
+
+    return m.mem[address];
+}
+
+/* DIRTY CELLS ***************************************************************/
+
+/**
+ *
+ * Marks the cells showing the byte at the given offset from VIDEO_MEM.
+ * One byte is a character code in the text mode and 8 pixels of one cell
+ * in the graphics modes. The video memory overlaps the color memory and
+ * the console registers, so one byte may mark more cells.
+ *
+ */
+static void mark_byte(display &d, const uint32_t offset, const uint8_t mode)
+{
+    const uint32_t address = VIDEO_MEM_ADDRESS + offset;
+
+    if (offset < VIDEO_WIDTH * VIDEO_HEIGHT / 8)
+    {
+        if (mode == VIDEO_TEXT_MODE)
+        {
+            if (offset < VIDEO_CELLS) d.cells[offset] = 1;
+        }
+        else
+        {
+            const uint32_t y = offset / VIDEO_COLUMNS;
+            const uint32_t x = offset % VIDEO_COLUMNS;
+
+            d.cells[(y >> 3) * VIDEO_COLUMNS + x] = 1;
+        }
+    }
+
+    if (address >= COLOR_MEM_ADDRESS && address < COLOR_MEM_ADDRESS + VIDEO_CELLS)
+    {
+        d.cells[address - COLOR_MEM_ADDRESS] = 1;
+    }
+
+    if (address >= CHAR_MEM_ADDRESS && address < CHAR_MEM_ADDRESS + CHAR_MEM_SIZE)
+    {
+        d.glyphs[(address - CHAR_MEM_ADDRESS) >> 3] = 1;
+    }
+}
+
+/**
+ *
+ * Turns the blocks written before the frame into dirty cells and clears
+ * the marks of the frame. A change of the video mode redraws everything, a
+ * changed character redraws the cells showing it in the text mode.
+ *
+ */
+static void collect_cells(display &d, video_frame &frame)
+{
+    const uint8_t mode = frame.mem[VIDEO_MODE_ADDRESS];
+    const uint16_t cursor = raster_cursor(frame.mem);
+
+    bool glyphs = false;
+    uint32_t block, i;
+
+    for (block = 0; block < VIDEO_BLOCKS; block++)
+    {
+        if (!frame.dirty[block]) continue;
+
+        frame.dirty[block] = 0;
+
+        for (i = block << 3; i < (block << 3) + 8 && i < VIDEO_RANGE_SIZE; i++)
+        {
+            mark_byte(d, i, mode);
+        }
+    }
+
+    if (mode != d.mode)
+    {
+        memset(d.cells, 1, sizeof(d.cells));
+        d.mode = mode;
+    }
+
+    if (cursor != d.cursor)
+    {
+        if (d.cursor != RASTER_NO_CURSOR) d.cells[d.cursor] = 1;
+        if (cursor != RASTER_NO_CURSOR) d.cells[cursor] = 1;
+        d.cursor = cursor;
+    }
+
+    for (i = 0; i < 256; i++)
+    {
+        glyphs = glyphs || d.glyphs[i];
+    }
+
+    if (!glyphs) return;
+
+    if (mode == VIDEO_TEXT_MODE)
+    {
+        for (i = 0; i < VIDEO_CELLS; i++)
+        {
+            if (d.glyphs[frame.mem[VIDEO_MEM_ADDRESS + i]]) d.cells[i] = 1;
+        }
+    }
+
+    memset(d.glyphs, 0, sizeof(d.glyphs));
+}
+
+/* DISPLAY *******************************************************************/
+
+/**
+ *
+ * Opens the window with a streaming texture of the screen size. Every cell
+ * is dirty, so the first frame draws the whole screen.
+ *
+ */
+bool display_open(display &d, const int scale)
+{
+    d.window = nullptr;
+    d.renderer = nullptr;
+    d.texture = nullptr;
+    memset(d.pixels, 0, sizeof(d.pixels));
+    memset(d.cells, 1, sizeof(d.cells));
+    memset(d.glyphs, 0, sizeof(d.glyphs));
+    d.mode = VIDEO_TEXT_MODE;
+    d.cursor = RASTER_NO_CURSOR;
+
+    SDL_SetMainReady();
+
+    if (SDL_Init(SDL_INIT_VIDEO) != 0)
+    {
+        fprintf(stderr, "can not initialize SDL: %s\n", SDL_GetError());
+        return false;
+    }
+
+    d.window = SDL_CreateWindow("Sophia8", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+                                VIDEO_WIDTH * scale, VIDEO_HEIGHT * scale, 0);
+    if (d.window)
+    {
+        d.renderer = SDL_CreateRenderer(d.window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    }
+    if (d.renderer)
+    {
+        d.texture = SDL_CreateTexture(d.renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                      VIDEO_WIDTH, VIDEO_HEIGHT);
+    }
+
+    if (!d.texture)
+    {
+        fprintf(stderr, "can not open the display: %s\n", SDL_GetError());
+        display_close(d);
+        return false;
+    }
+
+    SDL_StartTextInput();
+    return true;
+}
+
+void display_close(display &d)
+{
+    if (d.texture) SDL_DestroyTexture(d.texture);
+    if (d.renderer) SDL_DestroyRenderer(d.renderer);
+    if (d.window) SDL_DestroyWindow(d.window);
+
+    d.texture = nullptr;
+    d.renderer = nullptr;
+    d.window = nullptr;
+
+    SDL_Quit();
+}
+
+/**
+ *
+ * Handles the pending window events and passes the typed characters to
+ * the key ring (ASCII only, Return as 13 and Backspace as 8). Returns
+ * false once the window is closed or Escape is pressed.
+ *
+ */
+bool display_poll(display &d, key_ring &keys)
+{
+    SDL_Event event;
+    bool open = d.window != nullptr;
+    const char *text;
+
+    while (SDL_PollEvent(&event))
+    {
+        if (event.type == SDL_QUIT)
+        {
+            open = false;
+        }
+        else if (event.type == SDL_KEYDOWN)
+        {
+            switch (event.key.keysym.sym)
+            {
+                case SDLK_ESCAPE:    open = false; break;
+                case SDLK_RETURN:    push_key(keys, 13); break;
+                case SDLK_BACKSPACE: push_key(keys, 8); break;
+                default: break;
+            }
+        }
+        else if (event.type == SDL_TEXTINPUT)
+        {
+            for (text = event.text.text; *text; text++)
+            {
+                if (static_cast<uint8_t>(*text) < 0x80) push_key(keys, static_cast<uint8_t>(*text));
+            }
+        }
+    }
+
+    return open;
+}
+
+/**
+ *
+ * Draws the cells changed since the previous frame and presents the
+ * screen.
+ * The texture is updated once per frame, only over the rectangle bounding
+ * the drawn cells, and not at all when nothing changed.
+ *
+ */
+void display_frame(display &d, video_frame &frame)
+{
+    uint32_t left = VIDEO_COLUMNS, top = VIDEO_ROWS, right = 0, bottom = 0;
+    uint32_t cell;
+
+    collect_cells(d, frame);
+
+    for (cell = 0; cell < VIDEO_CELLS; cell++)
+    {
+        const uint32_t column = cell % VIDEO_COLUMNS;
+        const uint32_t row = cell / VIDEO_COLUMNS;
+
+        if (!d.cells[cell]) continue;
+
+        d.cells[cell] = 0;
+        raster_cell(&d.pixels[0][0], frame.mem, d.mode, cell, d.cursor);
+
+        if (column < left) left = column;
+        if (column > right) right = column;
+        if (row < top) top = row;
+        if (row > bottom) bottom = row;
+    }
+
+    if (left <= right)
+    {
+        const SDL_Rect rect = {
+            static_cast<int>(left * 8), static_cast<int>(top * 8),
+            static_cast<int>((right - left + 1) * 8), static_cast<int>((bottom - top + 1) * 8)
+        };
+
+        SDL_UpdateTexture(d.texture, &rect, &d.pixels[top * 8][left * 8], VIDEO_WIDTH * sizeof(uint32_t));
+    }
+
+    SDL_RenderCopy(d.renderer, d.texture, nullptr, nullptr);
+    SDL_RenderPresent(d.renderer);
+}
+
+/* MAIN **********************************************************************/
+
+/**
+ *
+ * Vblank event of the clocked machine, publishes a frame.
+ *
+ */
+static void vblank(Machine &m, void *context)
+{
+    publish_frame(*static_cast<frame_exchange *>(context), m);
+}
+
+/**
+ *
+ * Runs the machine on the calling thread until it halts or quit is set.
+ * The typed keys come through the keyboard device.
+ *
+ * Unclocked (hz 0) the machine runs at full speed and publishes a frame
+ * every DISPLAY_FRAME_MS (the clock is read once per DISPLAY_SLICE
+ * instructions), clocked it runs at hz cycles per second and publishes a
+ * frame on the vblank every hz / DISPLAY_VBLANK_HZ cycles. A frame is also
+ * published when the machine halts.
+ *
+ */
+static void machine_thread(Machine &m, frame_exchange &exchange, key_ring &keys, const std::atomic<bool> &quit,
+                           const uint64_t hz)
+{
+    typedef std::chrono::steady_clock clock;
+
+    const clock::duration frame_time = std::chrono::milliseconds(DISPLAY_FRAME_MS);
+    const io_device keyboard = {keyboard_read, nullptr, &keys};
+    clock::time_point next_frame = clock::now() + frame_time;
+    scheduler s;
+
+    map_io(m, KEY_BUF_SIZE_ADDRESS, KEY_BUF_SIZE_ADDRESS, &keyboard);
+    publish_frame(exchange, m);
+
+    if (hz)
+    {
+        init_scheduler(s, hz);
+        add_clock_event(s, m, hz / DISPLAY_VBLANK_HZ, vblank, &exchange);
+
+        while (!m.stop && !quit.load(std::memory_order_relaxed))
+        {
+            run_scheduled(s, m, m.cycles + s.batch);
+        }
+
+        publish_frame(exchange, m);
+    }
+
+    while (!m.stop && !quit.load(std::memory_order_relaxed))
+    {
+        run_slice(m, DISPLAY_SLICE);
+
+        if (m.stop || clock::now() >= next_frame)
+        {
+            publish_frame(exchange, m);
+            next_frame = clock::now() + frame_time;
+        }
+    }
+
+    map_io(m, KEY_BUF_SIZE_ADDRESS, KEY_BUF_SIZE_ADDRESS, nullptr);
+}
+
+/**
+ *
+ * Runs a program image with the display. The machine runs on its own
+ * thread, the calling thread handles the window and draws the frames the
+ * machine publishes. The window stays open after the machine halts until
+ * it is closed.
+ *
+ *     sophia8 --display [--scale n] [--clock hz] [--charset chars.chr] image.s8i
+ *
+ */
+int display_main(int argc, char *argv[])
+{
+    std::unique_ptr<Machine> m(new Machine());
+    std::unique_ptr<display> d(new display());
+    std::unique_ptr<frame_exchange> exchange(new frame_exchange());
+    std::unique_ptr<key_ring> keys(new key_ring());
+    std::atomic<bool> quit(false);
+    const char *image = nullptr;
+    const char *charset = nullptr;
+    int scale = DISPLAY_SCALE;
+    uint64_t hz = 0;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--display") == 0)
+        {
+            continue;
+        }
+        else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+        {
+            scale = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--clock") == 0 && i + 1 < argc)
+        {
+            hz = strtoull(argv[++i], nullptr, 0);
+        }
+        else if (strcmp(argv[i], "--charset") == 0 && i + 1 < argc)
+        {
+            charset = argv[++i];
+        }
+        else if (!image && argv[i][0] != '-')
+        {
+            image = argv[i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: sophia8 --display [--scale n] [--clock hz] [--charset chars.chr] image.s8i\n");
+            return 1;
+        }
+    }
+
+    if (!image || scale < 1)
+    {
+        fprintf(stderr, "usage: sophia8 --display [--scale n] [--clock hz] [--charset chars.chr] image.s8i\n");
+        return 1;
+    }
+
+    if (!load_program(*m, image))
+    {
+        fprintf(stderr, "can not load image %s\n", image);
+        return 1;
+    }
+
+    if (charset && !load_charset(charset, m->mem + CHAR_MEM_ADDRESS))
+    {
+        fprintf(stderr, "can not load charset %s\n", charset);
+        return 1;
+    }
+
+    if (!display_open(*d, scale)) return 1;
+
+    init_exchange(*exchange);
+    init_keys(*keys);
+
+    std::thread machine(machine_thread, std::ref(*m), std::ref(*exchange), std::ref(*keys), std::cref(quit), hz);
+
+    while (display_poll(*d, *keys))
+    {
+        video_frame *frame = acquire_frame(*exchange);
+
+        if (frame)
+        {
+            display_frame(*d, *frame);
+        }
+        else
+        {
+            SDL_Delay(1);
+        }
+    }
+
+    quit.store(true);
+    machine.join();
+
+    display_close(*d);
+    print_registers(*m);
+    return 0;
+}
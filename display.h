@@ -0,0 +1,124 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    display.h                                                        */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* SDL display of the video memory. The screen is kept as 40x25 cells of 8x8 */
+/* pixels, only the cells whose memory was written since the last frame are  */
+/* rasterized again and uploaded to a streaming texture in one update.       */
+/*                                                                           */
+/* The machine runs on its own thread and hands frames to the render thread  */
+/* through a lock-free triple buffer, keys go the other way through a single */
+/* producer, single consumer ring.                                           */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef __DISPLAY_H_
+#define __DISPLAY_H_
+
+/* INCLUDES ******************************************************************/
+
+#include <atomic>
+#include <cstdint>
+
+#include "definitions.h"
+#include "machine.h"
+
+struct SDL_Window;
+struct SDL_Renderer;
+struct SDL_Texture;
+
+/* DISPLAY SETTINGS **********************************************************/
+
+#define DISPLAY_SCALE       3       /* default window pixels per VM pixel    */
+#define DISPLAY_FRAME_MS    16      /* VM time between two frames            */
+#define DISPLAY_SLICE       10000   /* instructions run between clock checks */
+#define DISPLAY_VBLANK_HZ   60      /* frames per second when clocked        */
+#define DISPLAY_KEYS        256     /* entries of the key ring               */
+
+/* FRAME EXCHANGE ************************************************************/
+
+/**
+ *
+ * Copy of the video range of the memory (the rest of mem is not used) and
+ * the 8 byte blocks written since the frame the render thread took last.
+ *
+ */
+struct video_frame
+{
+    uint8_t  mem[MEM_SIZE + 1];
+    uint8_t  dirty[VIDEO_BLOCKS];
+};
+
+#define FRAME_FRESH         0x04    /* middle frame was not taken yet        */
+
+/**
+ *
+ * Triple buffer of frames. The machine thread fills the back frame and
+ * swaps it with the middle one, the render thread swaps the middle frame
+ * with its front frame when it is fresh. Neither of them ever waits.
+ *
+ */
+struct frame_exchange
+{
+    video_frame frames[3];
+    std::atomic<uint8_t> middle;    /* frame index | FRAME_FRESH             */
+    uint8_t  back;                  /* owned by the machine thread           */
+    uint8_t  front;                 /* owned by the render thread            */
+    uint8_t  unseen[VIDEO_BLOCKS];  /* blocks written since the frame taken  */
+};
+
+/**
+ *
+ * Keys typed in the window on their way to __KEY_BUFFER.
+ *
+ */
+struct key_ring
+{
+    uint8_t  keys[DISPLAY_KEYS];
+    std::atomic<uint32_t> head;     /* next key to write (render thread)     */
+    std::atomic<uint32_t> tail;     /* next key to read (machine thread)     */
+};
+
+void init_exchange(frame_exchange &exchange);
+void publish_frame(frame_exchange &exchange, Machine &m);
+video_frame *acquire_frame(frame_exchange &exchange);
+
+void init_keys(key_ring &keys);
+bool push_key(key_ring &keys, uint8_t key);
+bool pop_key(key_ring &keys, uint8_t &key);
+void feed_keys(key_ring &keys, Machine &m);
+
+/* DISPLAY *******************************************************************/
+
+struct display
+{
+    SDL_Window   *window;
+    SDL_Renderer *renderer;
+    SDL_Texture  *texture;
+
+    /* rasterized screen, the texture holds a copy of it */
+
+    uint32_t pixels[VIDEO_HEIGHT][VIDEO_WIDTH];
+
+    /* cells and characters to be rasterized for the next frame */
+
+    uint8_t  cells[VIDEO_CELLS];
+    uint8_t  glyphs[256];
+
+    /* state of the machine drawn last */
+
+    uint8_t  mode;
+    uint16_t cursor;
+};
+
+bool display_open(display &d, int scale);
+void display_close(display &d);
+bool display_poll(display &d, key_ring &keys);
+void display_frame(display &d, video_frame &frame);
+
+int display_main(int argc, char *argv[]);
+
+#endif
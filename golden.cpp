@@ -0,0 +1,375 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    golden.cpp                                                       */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Memory diff and page hashes (see golden.h). The diff kernel turns a chunk */
+/* of both memories to a mask with one bit per differing byte, so equal      */
+/* chunks cost one compare and the ranges are found from the masks without   */
+/* looking at the bytes again.                                               */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define GOLDEN_AVX2
+#define GOLDEN_CHUNK        32
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GOLDEN_SSE2
+#define GOLDEN_CHUNK        16
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define GOLDEN_NEON
+#define GOLDEN_CHUNK        16
+#else
+#define GOLDEN_CHUNK        8
+#endif
+
+#include "golden.h"
+#include "image.h"
+
+/* MEMORY DIFF ***************************************************************/
+
+/**
+ *
+ * Name of the kernel compiled in.
+ *
+ */
+const char *golden_kernel()
+{
+#if defined(GOLDEN_AVX2)
+    return "avx2";
+#elif defined(GOLDEN_SSE2)
+    return "sse2";
+#elif defined(GOLDEN_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+/**
+ *
+ * Returns a mask of the differing bytes of one chunk, bit 0 is the first
+ * byte.
+ *
+ */
+static uint32_t chunk_mask(const uint8_t *a, const uint8_t *b)
+{
+#if defined(GOLDEN_AVX2)
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a));
+    const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b));
+
+    return ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+#elif defined(GOLDEN_SSE2)
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+    const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+
+    return ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y))) & 0xFFFF;
+#elif defined(GOLDEN_NEON)
+    static const uint8_t bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t differs = vmvnq_u8(vceqq_u8(vld1q_u8(a), vld1q_u8(b)));
+    const uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vandq_u8(differs, vld1q_u8(bits)))));
+
+    return static_cast<uint32_t>(vgetq_lane_u64(sums, 0) | vgetq_lane_u64(sums, 1) << 8);
+#else
+    uint64_t x, y;
+    uint32_t mask = 0, i;
+
+    memcpy(&x, a, sizeof(x));
+    memcpy(&y, b, sizeof(y));
+    x ^= y;
+
+    for (i = 0; x && i < 8; i++)
+    {
+        if (x >> (i * 8) & 0xFF) mask |= 1u << i;
+    }
+
+    return mask;
+#endif
+}
+
+/**
+ *
+ * Collects the ranges of differing bytes in address order.
+ *
+ */
+struct range_builder
+{
+    std::vector<diff_range> &ranges;
+    uint32_t start;
+    bool open;
+
+    void step(const bool differs, const uint32_t address)
+    {
+        if (differs && !open)
+        {
+            start = address;
+            open = true;
+        }
+        else if (!differs && open)
+        {
+            close(address);
+        }
+    }
+
+    void close(const uint32_t address)
+    {
+        if (open) ranges.push_back({start, address - start});
+        open = false;
+    }
+};
+
+/**
+ *
+ * Compares two memories of size bytes. Stores the ranges of the differing
+ * bytes and returns their number of bytes, 0 if the memories match.
+ *
+ */
+uint32_t diff_memory(const uint8_t *expected, const uint8_t *actual, const uint32_t size,
+                     std::vector<diff_range> &ranges)
+{
+    range_builder builder = {ranges, 0, false};
+    uint32_t offset = 0, differing = 0, i;
+
+    ranges.clear();
+
+    for (; offset + GOLDEN_CHUNK <= size; offset += GOLDEN_CHUNK)
+    {
+        const uint32_t mask = chunk_mask(expected + offset, actual + offset);
+
+        if (mask == 0)
+        {
+            builder.close(offset);
+            continue;
+        }
+
+        for (i = 0; i < GOLDEN_CHUNK; i++)
+        {
+            const bool differs = (mask >> i & 1) != 0;
+
+            builder.step(differs, offset + i);
+            differing += differs;
+        }
+    }
+
+    for (; offset < size; offset++)
+    {
+        const bool differs = expected[offset] != actual[offset];
+
+        builder.step(differs, offset);
+        differing += differs;
+    }
+
+    builder.close(size);
+    return differing;
+}
+
+/**
+ *
+ * Prints one line per range, its address, size and the first GOLDEN_SHOWN
+ * bytes expected and found:
+ *
+ *     0x0100 4: 00 01 02 03 -> 01 01 02 05
+ *
+ */
+void print_diff(const uint8_t *expected, const uint8_t *actual, const std::vector<diff_range> &ranges)
+{
+    uint32_t i;
+
+    for (const diff_range &range : ranges)
+    {
+        const uint32_t shown = range.size < GOLDEN_SHOWN ? range.size : GOLDEN_SHOWN;
+        const char *more = range.size > shown ? " ..." : "";
+
+        printf("0x%04x %u:", range.address, range.size);
+        for (i = 0; i < shown; i++)
+        {
+            printf(" %02x", expected[range.address + i]);
+        }
+        printf("%s ->", more);
+        for (i = 0; i < shown; i++)
+        {
+            printf(" %02x", actual[range.address + i]);
+        }
+        printf("%s\n", more);
+    }
+}
+
+/* GOLDEN IMAGES *************************************************************/
+
+/**
+ *
+ * Loads a golden image, either a whole memory written by write_golden or a
+ * program image whose segments are the expected memory (the rest zero).
+ *
+ */
+bool load_golden(const std::string &filename, uint8_t *mem)
+{
+    if (is_image_file(filename))
+    {
+        image_file image;
+
+        if (!map_image(filename, image)) return false;
+
+        memset(mem, 0, GOLDEN_SIZE);
+        load_image(image, mem);
+        unmap_image(image);
+        return true;
+    }
+
+    std::ifstream file(filename, std::ios::binary);
+
+    if (!file) return false;
+
+    file.read(reinterpret_cast<char *>(mem), GOLDEN_SIZE);
+    return file.gcount() == GOLDEN_SIZE && file.peek() == EOF;
+}
+
+bool write_golden(const std::string &filename, const uint8_t *mem)
+{
+    std::ofstream file(filename, std::ios::binary);
+
+    if (!file.is_open()) return false;
+
+    file.write(reinterpret_cast<const char *>(mem), GOLDEN_SIZE);
+    return file.good();
+}
+
+/* PAGE HASHES ***************************************************************/
+
+#define XXH_PRIME1          0x9E3779B185EBCA87ull
+#define XXH_PRIME2          0xC2B2AE3D27D4EB4Full
+#define XXH_PRIME3          0x165667B19E3779F9ull
+#define XXH_PRIME4          0x85EBCA77C2B2AE63ull
+#define XXH_PRIME5          0x27D4EB2F165667C5ull
+
+static inline uint64_t rotate(const uint64_t value, const int bits)
+{
+    return value << bits | value >> (64 - bits);
+}
+
+static inline uint64_t read64(const uint8_t *bytes)
+{
+    uint64_t value;
+
+    memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+static inline uint64_t xxh_round(uint64_t accumulator, const uint64_t input)
+{
+    accumulator += input * XXH_PRIME2;
+    return rotate(accumulator, 31) * XXH_PRIME1;
+}
+
+static inline uint64_t xxh_merge(const uint64_t accumulator, const uint64_t value)
+{
+    return (accumulator ^ xxh_round(0, value)) * XXH_PRIME1 + XXH_PRIME4;
+}
+
+/**
+ *
+ * XXH64 hash of the bytes (the reference algorithm, so the hashes can be
+ * checked by other tools).
+ *
+ */
+uint64_t xxh64(const void *data, const size_t size, const uint64_t seed)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    const uint8_t *end = bytes + size;
+    uint64_t hash;
+
+    if (size >= 32)
+    {
+        uint64_t v1 = seed + XXH_PRIME1 + XXH_PRIME2;
+        uint64_t v2 = seed + XXH_PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - XXH_PRIME1;
+
+        for (; end - bytes >= 32; bytes += 32)
+        {
+            v1 = xxh_round(v1, read64(bytes));
+            v2 = xxh_round(v2, read64(bytes + 8));
+            v3 = xxh_round(v3, read64(bytes + 16));
+            v4 = xxh_round(v4, read64(bytes + 24));
+        }
+
+        hash = rotate(v1, 1) + rotate(v2, 7) + rotate(v3, 12) + rotate(v4, 18);
+        hash = xxh_merge(hash, v1);
+        hash = xxh_merge(hash, v2);
+        hash = xxh_merge(hash, v3);
+        hash = xxh_merge(hash, v4);
+    }
+    else
+    {
+        hash = seed + XXH_PRIME5;
+    }
+
+    hash += size;
+
+    for (; end - bytes >= 8; bytes += 8)
+    {
+        hash ^= xxh_round(0, read64(bytes));
+        hash = rotate(hash, 27) * XXH_PRIME1 + XXH_PRIME4;
+    }
+
+    if (end - bytes >= 4)
+    {
+        uint32_t value;
+
+        memcpy(&value, bytes, sizeof(value));
+        hash ^= value * XXH_PRIME1;
+        hash = rotate(hash, 23) * XXH_PRIME2 + XXH_PRIME3;
+        bytes += 4;
+    }
+
+    for (; bytes < end; bytes++)
+    {
+        hash ^= *bytes * XXH_PRIME5;
+        hash = rotate(hash, 11) * XXH_PRIME1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= XXH_PRIME2;
+    hash ^= hash >> 29;
+    hash *= XXH_PRIME3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+/**
+ *
+ * Hashes the GOLDEN_PAGES pages of a memory.
+ *
+ */
+void hash_pages(const uint8_t *mem, uint64_t *hashes)
+{
+    uint32_t page;
+
+    for (page = 0; page < GOLDEN_PAGES; page++)
+    {
+        hashes[page] = xxh64(mem + page * 256, 256, 0);
+    }
+}
+
+/**
+ *
+ * Hash of a whole memory from the hashes of its pages, so a memory with a
+ * few pages written only needs those hashed again.
+ *
+ */
+uint64_t hash_memory(const uint64_t *page_hashes)
+{
+    return xxh64(page_hashes, GOLDEN_PAGES * sizeof(uint64_t), 0);
+}
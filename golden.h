@@ -0,0 +1,57 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    golden.h                                                         */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Regression checks of the final memory. A golden image is the memory of a  */
+/* known good run (a raw dump of the whole memory or a program image), the   */
+/* memory of a run is compared with it and only the ranges which differ are  */
+/* reported. The compare finds the differing bytes 16 or 32 at a time with   */
+/* SSE2, AVX2 or NEON when the compiler targets them and by 64 bit words     */
+/* else. Large batches are checked by hashes of the 256 byte pages instead   */
+/* (XXH64), combined to one hash of the whole memory.                        */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef __GOLDEN_H_
+#define __GOLDEN_H_
+
+/* INCLUDES ******************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "definitions.h"
+
+/* MEMORY DIFF ***************************************************************/
+
+#define GOLDEN_SIZE         (MEM_SIZE + 1)  /* bytes of a golden image       */
+#define GOLDEN_PAGES        256             /* 256 byte pages of the memory  */
+#define GOLDEN_SHOWN        16              /* bytes printed per range       */
+
+struct diff_range
+{
+    uint32_t address;           /* first differing byte                      */
+    uint32_t size;              /* differing bytes in a row                  */
+};
+
+const char *golden_kernel();
+uint32_t diff_memory(const uint8_t *expected, const uint8_t *actual, uint32_t size, std::vector<diff_range> &ranges);
+void print_diff(const uint8_t *expected, const uint8_t *actual, const std::vector<diff_range> &ranges);
+
+/* GOLDEN IMAGES *************************************************************/
+
+bool load_golden(const std::string &filename, uint8_t *mem);
+bool write_golden(const std::string &filename, const uint8_t *mem);
+
+/* PAGE HASHES ***************************************************************/
+
+uint64_t xxh64(const void *data, size_t size, uint64_t seed);
+void hash_pages(const uint8_t *mem, uint64_t *hashes);
+uint64_t hash_memory(const uint64_t *page_hashes);
+
+#endif
@@ -0,0 +1,290 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    image.cpp                                                        */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Writing and loading of the binary program images (see image.h). Images    */
+/* are mapped to the memory read only and their segments are copied (or      */
+/* filled) directly from the mapping to the machine memory.                  */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "image.h"
+
+/* IMAGE BUILDING ************************************************************/
+
+/**
+ *
+ * Adds a segment with data. Continues the previous segment when it ends at
+ * the address, so consecutive instructions end up in one segment.
+ *
+ */
+void image_add_data(image_builder &builder, const uint16_t address, const uint8_t *bytes, const uint32_t size, const bool fixed)
+{
+    const uint16_t flags = fixed ? IMAGE_SEGMENT_FIXED : 0;
+
+    if (size == 0) return;
+
+    if (!builder.segments.empty())
+    {
+        image_segment &last = builder.segments.back();
+
+        if (last.flags == flags && last.address + last.size == address &&
+            last.offset + last.size == builder.data.size())
+        {
+            last.size += size;
+            builder.data.insert(builder.data.end(), bytes, bytes + size);
+            return;
+        }
+    }
+
+    image_segment segment;
+    segment.address = address;
+    segment.flags = flags;
+    segment.size = size;
+    segment.offset = static_cast<uint32_t>(builder.data.size());
+
+    builder.segments.push_back(segment);
+    builder.data.insert(builder.data.end(), bytes, bytes + size);
+}
+
+/**
+ *
+ * Adds a segment filled with one value, which takes no data in the file.
+ *
+ */
+void image_add_fill(image_builder &builder, const uint16_t address, const uint8_t value, const uint32_t size, const bool fixed)
+{
+    if (size == 0) return;
+
+    image_segment segment;
+    segment.address = address;
+    segment.flags = static_cast<uint16_t>(IMAGE_SEGMENT_FILL | (fixed ? IMAGE_SEGMENT_FIXED : 0));
+    segment.size = size;
+    segment.offset = value;
+
+    builder.segments.push_back(segment);
+}
+
+void image_add_symbol(image_builder &builder, const std::string &name, const uint16_t value, const uint16_t flags)
+{
+    image_symbol symbol;
+    symbol.name = static_cast<uint32_t>(builder.strings.size());
+    symbol.value = value;
+    symbol.flags = flags;
+
+    builder.symbols.push_back(symbol);
+    builder.strings.insert(builder.strings.end(), name.begin(), name.end());
+    builder.strings.push_back('\0');
+}
+
+bool write_image(const image_builder &builder, const std::string &filename)
+{
+    std::ofstream file(filename, std::ios::binary);
+    image_header header;
+
+    if (!file.is_open()) return false;
+
+    header.magic = IMAGE_MAGIC;
+    header.version = IMAGE_VERSION;
+    header.entry = builder.entry;
+    header.segment_count = static_cast<uint32_t>(builder.segments.size());
+    header.symbol_count = static_cast<uint32_t>(builder.symbols.size());
+    header.strings_size = static_cast<uint32_t>(builder.strings.size());
+    header.data_offset = static_cast<uint32_t>(sizeof(image_header) +
+                                               builder.segments.size() * sizeof(image_segment) +
+                                               builder.symbols.size() * sizeof(image_symbol) +
+                                               builder.strings.size());
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(builder.segments.data()), builder.segments.size() * sizeof(image_segment));
+    file.write(reinterpret_cast<const char *>(builder.symbols.data()), builder.symbols.size() * sizeof(image_symbol));
+    file.write(builder.strings.data(), builder.strings.size());
+    file.write(reinterpret_cast<const char *>(builder.data.data()), builder.data.size());
+
+    return file.good();
+}
+
+/* IMAGE LOADING *************************************************************/
+
+/**
+ *
+ * Determines if a file starts with the image magic number, other files are
+ * raw memory dumps.
+ *
+ */
+bool is_image_file(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    uint32_t magic = 0;
+
+    file.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    return file.good() && magic == IMAGE_MAGIC;
+}
+
+/**
+ *
+ * Checks that all tables and segments of a mapped image lie in the file and
+ * in the 16 bit address space.
+ *
+ */
+bool validate_image(image_file &image)
+{
+    const image_header *header = reinterpret_cast<const image_header *>(image.base);
+    uint64_t position = sizeof(image_header);
+    uint32_t i;
+
+    if (image.size < sizeof(image_header)) return false;
+    if (header->magic != IMAGE_MAGIC || header->version != IMAGE_VERSION) return false;
+
+    image.header = header;
+    image.segments = reinterpret_cast<const image_segment *>(image.base + position);
+    position += static_cast<uint64_t>(header->segment_count) * sizeof(image_segment);
+    image.symbols = reinterpret_cast<const image_symbol *>(image.base + position);
+    position += static_cast<uint64_t>(header->symbol_count) * sizeof(image_symbol);
+    image.strings = reinterpret_cast<const char *>(image.base + position);
+    position += header->strings_size;
+
+    if (position > image.size || header->data_offset < position || header->data_offset > image.size) return false;
+    if (header->strings_size > 0 && image.strings[header->strings_size - 1] != '\0') return false;
+
+    image.data = image.base + header->data_offset;
+
+    for (i = 0; i < header->segment_count; i++)
+    {
+        const image_segment &segment = image.segments[i];
+
+        if (segment.address + static_cast<uint64_t>(segment.size) > 0x10000) return false;
+
+        if (!(segment.flags & IMAGE_SEGMENT_FILL) &&
+            header->data_offset + static_cast<uint64_t>(segment.offset) + segment.size > image.size) return false;
+    }
+
+    for (i = 0; i < header->symbol_count; i++)
+    {
+        if (image.symbols[i].name >= header->strings_size) return false;
+    }
+
+    return true;
+}
+
+/**
+ *
+ * Maps an image file to the memory (read only) and validates it.
+ *
+ */
+bool map_image(const std::string &filename, image_file &image)
+{
+    image = image_file();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size;
+
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+    if (!view)
+    {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    image.base = static_cast<const uint8_t *>(view);
+    image.size = static_cast<size_t>(size.QuadPart);
+    image.file = file;
+    image.mapping = mapping;
+#else
+    struct stat status;
+    const int file = open(filename.c_str(), O_RDONLY);
+
+    if (file < 0) return false;
+
+    if (fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+
+    void *view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+
+    if (view == MAP_FAILED) return false;
+
+    image.base = static_cast<const uint8_t *>(view);
+    image.size = static_cast<size_t>(status.st_size);
+#endif
+
+    if (!validate_image(image))
+    {
+        unmap_image(image);
+        return false;
+    }
+
+    return true;
+}
+
+void unmap_image(image_file &image)
+{
+    if (!image.base) return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(image.base);
+    CloseHandle(image.mapping);
+    CloseHandle(image.file);
+#else
+    munmap(const_cast<uint8_t *>(image.base), image.size);
+#endif
+
+    image = image_file();
+}
+
+/**
+ *
+ * Copies the data segments from the mapping to the memory and fills the
+ * fill segments. The memory has to hold 0x10000 bytes.
+ *
+ */
+void load_image(const image_file &image, uint8_t *mem)
+{
+    uint32_t i;
+
+    for (i = 0; i < image.header->segment_count; i++)
+    {
+        const image_segment &segment = image.segments[i];
+
+        if (segment.flags & IMAGE_SEGMENT_FILL)
+        {
+            memset(mem + segment.address, static_cast<uint8_t>(segment.offset), segment.size);
+        }
+        else
+        {
+            memcpy(mem + segment.address, image.data + segment.offset, segment.size);
+        }
+    }
+}
@@ -0,0 +1,123 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    image.h                                                          */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Binary program image written by sophia8asm and loaded by sophia8. The     */
+/* file starts with a header followed by the segment table, the symbol       */
+/* table, the string table and the raw segment data:                         */
+/*                                                                           */
+/*     image_header                                                          */
+/*     image_segment[segment_count]                                          */
+/*     image_symbol[symbol_count]                                            */
+/*     names of the symbols (zero terminated)                                */
+/*     data of the data segments                                             */
+/*                                                                           */
+/* Fill segments (DB 0[8000]) only store their value and size, so they take  */
+/* no space in the file. All numbers are little endian.                      */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef __IMAGE_H_
+#define __IMAGE_H_
+
+/* INCLUDES ******************************************************************/
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* IMAGE FORMAT **************************************************************/
+
+#define IMAGE_MAGIC         0x4D493853  /* "S8IM"                            */
+#define IMAGE_VERSION       1
+
+#define IMAGE_SEGMENT_FILL  0x0001      /* size bytes of value, no data      */
+#define IMAGE_SEGMENT_FIXED 0x0002      /* placed at its address by source   */
+
+#define IMAGE_SYMBOL_LABEL  0x0001      /* address of a label                */
+#define IMAGE_SYMBOL_DEF    0x0002      /* DEF constant                      */
+
+#pragma pack(push, 1)
+
+struct image_header
+{
+    uint32_t magic;             /* IMAGE_MAGIC                               */
+    uint16_t version;           /* IMAGE_VERSION                             */
+    uint16_t entry;             /* initial instruction pointer               */
+    uint32_t segment_count;     /* records in the segment table              */
+    uint32_t symbol_count;      /* records in the symbol table               */
+    uint32_t strings_size;      /* size of the string table                  */
+    uint32_t data_offset;       /* file offset of the segment data           */
+};
+
+struct image_segment
+{
+    uint16_t address;           /* first address in the memory               */
+    uint16_t flags;             /* IMAGE_SEGMENT_*                           */
+    uint32_t size;              /* size in the memory (up to 0x10000)        */
+    uint32_t offset;            /* data offset (from data_offset) or value   */
+};
+
+struct image_symbol
+{
+    uint32_t name;              /* offset to the string table                */
+    uint16_t value;             /* address or constant value                 */
+    uint16_t flags;             /* IMAGE_SYMBOL_*                            */
+};
+
+#pragma pack(pop)
+
+/* IMAGE BUILDING ************************************************************/
+
+/**
+ *
+ * Image being put together by the assembler.
+ *
+ */
+struct image_builder
+{
+    uint16_t entry = 0;
+    std::vector<image_segment> segments;
+    std::vector<image_symbol> symbols;
+    std::vector<char> strings;
+    std::vector<uint8_t> data;
+};
+
+void image_add_data(image_builder &builder, uint16_t address, const uint8_t *bytes, uint32_t size, bool fixed);
+void image_add_fill(image_builder &builder, uint16_t address, uint8_t value, uint32_t size, bool fixed);
+void image_add_symbol(image_builder &builder, const std::string &name, uint16_t value, uint16_t flags);
+bool write_image(const image_builder &builder, const std::string &filename);
+
+/* IMAGE LOADING *************************************************************/
+
+/**
+ *
+ * Image file mapped to the memory. All the pointers point into the mapping,
+ * nothing is copied.
+ *
+ */
+struct image_file
+{
+    const uint8_t *base = nullptr;      /* start of the mapping              */
+    size_t size = 0;                    /* size of the mapping               */
+    const image_header *header = nullptr;
+    const image_segment *segments = nullptr;
+    const image_symbol *symbols = nullptr;
+    const char *strings = nullptr;
+    const uint8_t *data = nullptr;
+#if defined(_WIN32)
+    void *file = nullptr;
+    void *mapping = nullptr;
+#endif
+};
+
+bool is_image_file(const std::string &filename);
+bool map_image(const std::string &filename, image_file &image);
+void unmap_image(image_file &image);
+void load_image(const image_file &image, uint8_t *mem);
+
+#endif
@@ -0,0 +1,993 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    jit.cpp                                                          */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Basic block compiler translating the machine code to x86-64. Every        */
+/* machine owns its own code buffer, see jit_context.                        */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include "machine.h"
+#include "jit.h"
+
+/* JIT COMPILER **************************************************************/
+
+/*
+ * Basic block compiler to x86-64. Hot blocks (entered JIT_THRESHOLD times)
+ * are translated to native code which keeps the machine state in the host
+ * registers:
+ *
+ *     r[0] .. r[7]    r8b .. r15b
+ *     c               bl
+ *     sp              si (zero extended rsi)
+ *     bp              di (zero extended rdi)
+ *     mem             rbp
+ *     ip              only known at the block exit, returned in eax
+ *
+ * rax, rcx and rdx are scratch registers. Blocks end at JMP, JZ, JNZ, JC,
+ * JNC, CALL and RET or before an instruction the compiler can not translate
+ * (HALT, wide PUSH/POP, invalid operands, ...), which is then left to the
+ * predecoded interpreter. Block exits with a constant target are patched to
+ * jump directly to the target block once it is compiled (chaining).
+ *
+ * In lockstep mode (run_jit_block) the blocks are compiled on their first
+ * entry and never chained, so every entry runs exactly one block.
+ *
+ * Every write in the native code checks the page of the written address
+ * first. If the page holds decoded code, the block exits before the write
+ * and the interpreter performs it, so the decode cache stays coherent.
+ * Writes into compiled pages drop the whole code cache and the page is
+ * interpreted from then on.
+ *
+ */
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SOPHIA8_HAS_JIT
+#endif
+
+#if defined(SOPHIA8_HAS_JIT)
+
+#ifndef JIT_THRESHOLD
+#define JIT_THRESHOLD     32        /* block entries before compilation      */
+#endif
+#define JIT_MAX_BLOCK     64        /* max instructions in one block         */
+#define JIT_CODE_SIZE     0x400000  /* native code buffer size               */
+#define JIT_BLOCK_RESERVE 0x4000    /* free space needed to compile a block  */
+#define JIT_NEVER         0xFFFF    /* counter value of uncompilable blocks  */
+#define JIT_EXIT_WRITE    0x01      /* stopped before write to code/device   */
+#define JIT_EXIT_FAULT    0x02      /* stopped before a division by zero     */
+
+#define HOST_RAX    0
+#define HOST_RCX    1
+#define HOST_RDX    2
+#define HOST_RBX    3
+
+typedef uint64_t (*jit_trampoline)(uint8_t *entry);
+
+/**
+ *
+ * Compiled code of one machine. The emitted code refers to the registers and
+ * the memory of its machine by their absolute addresses, so the context can
+ * not be shared by two machines.
+ *
+ */
+struct jit_context
+{
+    uint8_t  *code;                     /* native code buffer                */
+    uint8_t  *blocks;                   /* first block in the buffer         */
+    uint8_t  *pos;                      /* current emit position             */
+    uint8_t  *epilogue;                 /* stores the state back             */
+    jit_trampoline enter;               /* loads the state, enters a block   */
+    uint8_t  *entry[MEM_SIZE + 1];      /* compiled block per address        */
+    uint16_t  counter[MEM_SIZE + 1];    /* block entry counters              */
+    uint8_t   pages[256];               /* pages with compiled code          */
+    uint8_t   blacklist[256];           /* pages written as code             */
+    uint8_t   io_writes[256];           /* pages of devices handling writes  */
+    uint8_t   io_write_pages;           /* any of them (when compiled)       */
+    uint8_t   io_reads;                 /* any device handles reads          */
+    uint8_t   lockstep;                 /* one block per entry, no chaining  */
+    uint8_t   jumps[MEM_SIZE + 1];      /* block ends with its jump          */
+    std::vector<std::pair<uint16_t, uint8_t *>> links; /* unchained exits   */
+};
+
+inline void emit8(jit_context &j, const uint8_t value)
+{
+    *j.pos++ = value;
+}
+
+inline void emit32(jit_context &j, const uint32_t value)
+{
+    memcpy(j.pos, &value, 4);
+    j.pos += 4;
+}
+
+inline void emit64(jit_context &j, const uint64_t value)
+{
+    memcpy(j.pos, &value, 8);
+    j.pos += 8;
+}
+
+/**
+ *
+ * Host register holding a general purpose register of the machine.
+ *
+ */
+inline uint8_t host_register(const uint8_t vm_register)
+{
+    return static_cast<uint8_t>(8 + vm_register);
+}
+
+/**
+ *
+ * Emits byte register to byte register operation ("op rm, reg"). The REX
+ * prefix is always present, so al, cl, dl and bl are the low byte registers
+ * and never ah, ch, dh or bh.
+ *
+ */
+void emit_rr8(jit_context &j, const uint8_t opcode, const uint8_t reg, const uint8_t rm)
+{
+    emit8(j, static_cast<uint8_t>(0x40 | (reg >= 8 ? 0x04 : 0x00) | (rm >= 8 ? 0x01 : 0x00)));
+    emit8(j, opcode);
+    emit8(j, static_cast<uint8_t>(0xC0 | (reg & 7) << 3 | (rm & 7)));
+}
+
+/**
+ *
+ * Emits byte register, immediate operation (group 0x80 and shifts 0xC0).
+ *
+ */
+void emit_ri8(jit_context &j, const uint8_t opcode, const uint8_t digit, const uint8_t rm, const uint8_t value)
+{
+    emit8(j, static_cast<uint8_t>(0x40 | (rm >= 8 ? 0x01 : 0x00)));
+    emit8(j, opcode);
+    emit8(j, static_cast<uint8_t>(0xC0 | digit << 3 | (rm & 7)));
+    emit8(j, value);
+}
+
+void emit_mov_ri8(jit_context &j, const uint8_t rm, const uint8_t value)
+{
+    emit8(j, static_cast<uint8_t>(0x40 | (rm >= 8 ? 0x01 : 0x00)));
+    emit8(j, static_cast<uint8_t>(0xB0 + (rm & 7)));
+    emit8(j, value);
+}
+
+/**
+ *
+ * movzx r32, r8
+ *
+ */
+void emit_movzx_r8(jit_context &j, const uint8_t reg, const uint8_t rm)
+{
+    emit8(j, static_cast<uint8_t>(0x40 | (reg >= 8 ? 0x04 : 0x00) | (rm >= 8 ? 0x01 : 0x00)));
+    emit8(j, 0x0F);
+    emit8(j, 0xB6);
+    emit8(j, static_cast<uint8_t>(0xC0 | (reg & 7) << 3 | (rm & 7)));
+}
+
+void emit_mov_r64_imm(jit_context &j, const uint8_t reg, const void *pointer)
+{
+    emit8(j, 0x48);
+    emit8(j, static_cast<uint8_t>(0xB8 + reg));
+    emit64(j, reinterpret_cast<uint64_t>(pointer));
+}
+
+void emit_setc_bl(jit_context &j)
+{
+    emit8(j, 0x0F); emit8(j, 0x92); emit8(j, 0xC3);
+}
+
+/**
+ *
+ * Emits "mov eax, target; jmp epilogue" which is patched to "jmp block" as
+ * soon as the target block gets compiled. If it already is, jumps directly.
+ * Lockstep blocks always return.
+ *
+ */
+void emit_exit(jit_context &j, const uint16_t target)
+{
+    if (j.entry[target] && !j.lockstep)
+    {
+        emit8(j, 0xE9);
+        emit32(j, static_cast<uint32_t>(j.entry[target] - (j.pos + 4)));
+        return;
+    }
+
+    if (!j.lockstep) j.links.emplace_back(target, j.pos);
+    emit8(j, 0xB8);
+    emit32(j, target);
+    emit8(j, 0xE9);
+    emit32(j, static_cast<uint32_t>(j.epilogue - (j.pos + 4)));
+}
+
+/**
+ *
+ * Emits the exit before an instruction dividing by cl when cl is zero. The
+ * interpreter runs the instruction then and stops the machine.
+ *
+ */
+void emit_fault_check(jit_context &j, const uint16_t address)
+{
+    emit8(j, 0x84); emit8(j, 0xC9);                               /* test cl, cl              */
+    emit8(j, 0x75); emit8(j, 0x0A);                               /* jnz divide               */
+    emit8(j, 0xB8);
+    emit32(j, address | JIT_EXIT_FAULT << 16);
+    emit8(j, 0xE9);
+    emit32(j, static_cast<uint32_t>(j.epilogue - (j.pos + 4)));
+}
+
+/**
+ *
+ * Emits both exits of a conditional jump. Expects the short jcc opcode to be
+ * emitted already, its displacement skips the not taken exit.
+ *
+ */
+void emit_branch_exits(jit_context &j, const uint16_t not_taken, const uint16_t taken)
+{
+    uint8_t *displacement = j.pos;
+
+    emit8(j, 0x00);
+    emit_exit(j, not_taken);
+    *displacement = static_cast<uint8_t>(j.pos - (displacement + 1));
+    emit_exit(j, taken);
+}
+
+/**
+ *
+ * Emits exit with the target address in eax (RET). Looks the target block
+ * up in the entry table and jumps to it directly when it exists.
+ *
+ */
+void emit_dynamic_exit(jit_context &j)
+{
+    if (j.lockstep)
+    {
+        emit8(j, 0xE9);                                        /* jmp epilogue             */
+        emit32(j, static_cast<uint32_t>(j.epilogue - (j.pos + 4)));
+        return;
+    }
+
+    emit_mov_r64_imm(j, HOST_RCX, j.entry);
+    emit8(j, 0x48); emit8(j, 0x8B); emit8(j, 0x0C); emit8(j, 0xC1);    /* mov rcx, [rcx + rax * 8] */
+    emit8(j, 0x48); emit8(j, 0x85); emit8(j, 0xC9);                  /* test rcx, rcx            */
+    emit8(j, 0x0F); emit8(j, 0x84);                               /* jz epilogue              */
+    emit32(j, static_cast<uint32_t>(j.epilogue - (j.pos + 4)));
+    emit8(j, 0xFF); emit8(j, 0xE1);                               /* jmp rcx                  */
+}
+
+/**
+ *
+ * Emits the check of the address in edx against the pages of devices and
+ * the pages holding decoded code and marks the page dirty (and the video
+ * block for the display). Positions of the jumps to the side exits, which
+ * are emitted at the end of the block, are added to the writes vector.
+ *
+ */
+void emit_write_check(jit_context &j, Machine &m, std::vector<std::pair<uint8_t *, uint16_t>> &writes,
+                      const uint16_t address)
+{
+    uint8_t *skip;
+
+    emit8(j, 0x89); emit8(j, 0xD1);                               /* mov ecx, edx             */
+    emit8(j, 0xC1); emit8(j, 0xE9); emit8(j, 0x08);                  /* shr ecx, 8               */
+    if (j.io_write_pages)
+    {
+        emit_mov_r64_imm(j, HOST_RAX, j.io_writes);
+        emit8(j, 0x80); emit8(j, 0x3C); emit8(j, 0x08); emit8(j, 0x00);    /* cmp byte [rax + rcx], 0  */
+        emit8(j, 0x0F); emit8(j, 0x85);                           /* jne side exit            */
+        writes.emplace_back(j.pos, address);
+        emit32(j, 0);
+    }
+    emit_mov_r64_imm(j, HOST_RAX, m.decoded->pages);
+    emit8(j, 0x80); emit8(j, 0x3C); emit8(j, 0x08); emit8(j, 0x00);    /* cmp byte [rax + rcx], 0  */
+    emit8(j, 0x0F); emit8(j, 0x85);                               /* jne side exit            */
+    writes.emplace_back(j.pos, address);
+    emit32(j, 0);
+    emit_mov_r64_imm(j, HOST_RAX, m.dirty);
+    emit8(j, 0xC6); emit8(j, 0x04); emit8(j, 0x08); emit8(j, 0x01);    /* mov byte [rax + rcx], 1  */
+
+    emit8(j, 0x89); emit8(j, 0xD0);                               /* mov eax, edx             */
+    emit8(j, 0x2D); emit32(j, VIDEO_MEM_ADDRESS);                 /* sub eax, video           */
+    emit8(j, 0x3D); emit32(j, VIDEO_RANGE_SIZE);                  /* cmp eax, size            */
+    emit8(j, 0x73);                                               /* jae skip                 */
+    skip = j.pos;
+    emit8(j, 0);
+    emit8(j, 0xC1); emit8(j, 0xE8); emit8(j, 0x03);                  /* shr eax, 3               */
+    emit_mov_r64_imm(j, HOST_RCX, m.video_dirty);
+    emit8(j, 0xC6); emit8(j, 0x04); emit8(j, 0x01); emit8(j, 0x01);    /* mov byte [rcx + rax], 1  */
+    *skip = static_cast<uint8_t>(j.pos - (skip + 1));
+}
+
+/**
+ *
+ * Emits edx = sp - delta (16 bit).
+ *
+ */
+void emit_stack_address(jit_context &j, const uint8_t delta)
+{
+    emit8(j, 0x89); emit8(j, 0xF2);                               /* mov edx, esi             */
+    emit8(j, 0x66); emit8(j, 0x83); emit8(j, 0xEA); emit8(j, delta);    /* sub dx, delta            */
+}
+
+/**
+ *
+ * Emits "mov [rbp + rdx], reg".
+ *
+ */
+void emit_store_rdx(jit_context &j, const uint8_t reg)
+{
+    emit8(j, static_cast<uint8_t>(0x40 | (reg >= 8 ? 0x04 : 0x00)));
+    emit8(j, 0x88);
+    emit8(j, static_cast<uint8_t>(0x44 | (reg & 7) << 3));
+    emit8(j, 0x15);
+    emit8(j, 0x00);
+}
+
+/**
+ *
+ * Emits the shared code entering a block and leaving it. The trampoline
+ * loads the machine state to the host registers and jumps to the block, the
+ * epilogue stores the state back and returns eax | (rdx << 32) - next ip,
+ * exit reason and address of the write which stopped the block.
+ *
+ */
+void jit_emit_runtime(jit_context &j, Machine &m)
+{
+    uint8_t k;
+
+    j.epilogue = j.pos;
+    emit_mov_r64_imm(j, HOST_RCX, m.r);
+    for (k = 0; k < 8; k++)
+    {
+        emit8(j, 0x44); emit8(j, 0x88); emit8(j, static_cast<uint8_t>(0x41 | k << 3)); emit8(j, k);
+    }
+    emit_mov_r64_imm(j, HOST_RCX, &m.c);
+    emit8(j, 0x88); emit8(j, 0x19);                               /* mov [rcx], bl            */
+    emit_mov_r64_imm(j, HOST_RCX, &m.sp);
+    emit8(j, 0x66); emit8(j, 0x89); emit8(j, 0x31);                  /* mov [rcx], si            */
+    emit_mov_r64_imm(j, HOST_RCX, &m.bp);
+    emit8(j, 0x66); emit8(j, 0x89); emit8(j, 0x39);                  /* mov [rcx], di            */
+    emit_mov_r64_imm(j, HOST_RCX, &m.ip);
+    emit8(j, 0x66); emit8(j, 0x89); emit8(j, 0x01);                  /* mov [rcx], ax            */
+    emit8(j, 0x48); emit8(j, 0xC1); emit8(j, 0xE2); emit8(j, 0x20);    /* shl rdx, 32              */
+    emit8(j, 0x48); emit8(j, 0x09); emit8(j, 0xD0);                  /* or rax, rdx              */
+    emit8(j, 0x41); emit8(j, 0x5F);                               /* pop r15                  */
+    emit8(j, 0x41); emit8(j, 0x5E);                               /* pop r14                  */
+    emit8(j, 0x41); emit8(j, 0x5D);                               /* pop r13                  */
+    emit8(j, 0x41); emit8(j, 0x5C);                               /* pop r12                  */
+    emit8(j, 0x5F);                                            /* pop rdi                  */
+    emit8(j, 0x5E);                                            /* pop rsi                  */
+    emit8(j, 0x5D);                                            /* pop rbp                  */
+    emit8(j, 0x5B);                                            /* pop rbx                  */
+    emit8(j, 0xC3);                                            /* ret                      */
+
+    j.enter = reinterpret_cast<jit_trampoline>(j.pos);
+    emit8(j, 0x53);                                            /* push rbx                 */
+    emit8(j, 0x55);                                            /* push rbp                 */
+    emit8(j, 0x56);                                            /* push rsi                 */
+    emit8(j, 0x57);                                            /* push rdi                 */
+    emit8(j, 0x41); emit8(j, 0x54);                               /* push r12                 */
+    emit8(j, 0x41); emit8(j, 0x55);                               /* push r13                 */
+    emit8(j, 0x41); emit8(j, 0x56);                               /* push r14                 */
+    emit8(j, 0x41); emit8(j, 0x57);                               /* push r15                 */
+#if defined(_WIN32)
+    emit8(j, 0x48); emit8(j, 0x89); emit8(j, 0xCA);                  /* mov rdx, rcx             */
+#else
+    emit8(j, 0x48); emit8(j, 0x89); emit8(j, 0xFA);                  /* mov rdx, rdi             */
+#endif
+    emit_mov_r64_imm(j, HOST_RCX, m.r);
+    for (k = 0; k < 8; k++)
+    {
+        emit8(j, 0x44); emit8(j, 0x0F); emit8(j, 0xB6); emit8(j, static_cast<uint8_t>(0x41 | k << 3)); emit8(j, k);
+    }
+    emit_mov_r64_imm(j, HOST_RCX, &m.c);
+    emit8(j, 0x0F); emit8(j, 0xB6); emit8(j, 0x19);                  /* movzx ebx, byte [rcx]    */
+    emit_mov_r64_imm(j, HOST_RCX, &m.sp);
+    emit8(j, 0x0F); emit8(j, 0xB7); emit8(j, 0x31);                  /* movzx esi, word [rcx]    */
+    emit_mov_r64_imm(j, HOST_RCX, &m.bp);
+    emit8(j, 0x0F); emit8(j, 0xB7); emit8(j, 0x39);                  /* movzx edi, word [rcx]    */
+    emit8(j, 0x48); emit8(j, 0xBD);                               /* mov rbp, mem             */
+    emit64(j, reinterpret_cast<uint64_t>(m.mem));
+    emit8(j, 0xFF); emit8(j, 0xE2);                               /* jmp rdx                  */
+
+    j.blocks = j.pos;
+}
+
+/**
+ *
+ * Drops all compiled blocks.
+ *
+ */
+void jit_flush(jit_context &j)
+{
+    uint32_t i;
+
+    for (i = 0; i <= MEM_SIZE; i++)
+    {
+        j.entry[i] = nullptr;
+        j.counter[i] = 0;
+    }
+
+    for (i = 0; i < 256; i++)
+    {
+        j.pages[i] = 0;
+    }
+
+    j.links.clear();
+    j.pos = j.blocks;
+}
+
+/**
+ *
+ * Allocates the executable code buffer of a machine. Returns false if the
+ * host does not allow it, the interpreter is used then.
+ *
+ */
+bool jit_init(Machine &m)
+{
+    uint8_t *code;
+
+    if (m.jit) return true;
+
+#if defined(_WIN32)
+    code = static_cast<uint8_t *>(VirtualAlloc(nullptr, JIT_CODE_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE));
+#else
+    void *buffer = mmap(nullptr, JIT_CODE_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    code = buffer == MAP_FAILED ? nullptr : static_cast<uint8_t *>(buffer);
+#endif
+
+    if (!code) return false;
+
+    m.jit.reset(new jit_context());
+
+    jit_context &j = *m.jit;
+
+    ensure_decode_cache(m);
+
+    j.code = code;
+    j.pos = j.code;
+    jit_emit_runtime(j, m);
+    jit_flush(j);
+
+    return true;
+}
+
+/**
+ *
+ * Called when a decoded instruction byte gets overwritten. If it belongs to
+ * compiled code, all blocks are dropped and the page is not compiled again.
+ *
+ */
+void jit_code_written(Machine &m, const uint16_t address)
+{
+    const uint8_t page = static_cast<uint8_t>(address >> 8);
+
+    if (!m.jit || !m.jit->pages[page]) return;
+
+    jit_context &j = *m.jit;
+
+    j.blacklist[page] = 1;
+    jit_flush(j);
+}
+
+void jit_reset(Machine &m)
+{
+    uint16_t i;
+
+    if (!m.jit) return;
+
+    for (i = 0; i < 256; i++)
+    {
+        m.jit->blacklist[i] = 0;
+    }
+
+    jit_flush(*m.jit);
+}
+
+void jit_page_changed(Machine &m, const uint8_t page)
+{
+    if (m.jit && m.jit->pages[page])
+    {
+        jit_flush(*m.jit);
+    }
+}
+
+/**
+ *
+ * Determines if a decoded instruction can be translated. Loads from the
+ * pages of devices are left to the interpreter, so are all the stack reads
+ * when any device handles reads.
+ *
+ */
+bool jit_supported(const jit_context &j, const Machine &m, const decoded_instruction &d, const uint16_t address)
+{
+    if (d.fallback) return false;
+
+    if (j.blacklist[address >> 8] || j.blacklist[static_cast<uint16_t>(address + d.length - 1) >> 8]) return false;
+
+    switch (d.opcode)
+    {
+        case STORE: case STORER: case SET: case INC: case DEC:
+        case CMP: case CMPR: case ADD: case ADDR: case SUB: case SUBR:
+        case MUL: case MULR: case DIVR: case NOP:
+        case JMP: case JZ: case JNZ: case JC: case JNC: case CALL:
+            return true;
+        case LOAD:
+            return !m.io[d.address >> 8] || !m.io[d.address >> 8]->read;
+        case RET:
+            return !j.io_reads;
+        case DIV:
+            return d.value != 0;
+        case SHL:
+        case SHR:
+            return d.value >= 1 && d.value <= 31;
+        case PUSH:
+            return d.reg[0] < 8;
+        case POP:
+            return d.reg[0] < 8 && !j.io_reads;
+        default:
+            return false;
+    }
+}
+
+/**
+ *
+ * Translates one instruction. Returns true if the instruction ends the block.
+ * Positions of side exit jumps are collected to the writes vector.
+ *
+ */
+bool jit_emit_instruction(jit_context &j, Machine &m, const decoded_instruction &d,
+                          const uint16_t address, std::vector<std::pair<uint8_t *, uint16_t>> &writes)
+{
+    const uint8_t ra = host_register(d.reg[0]);
+    const uint8_t rb = host_register(d.reg[1]);
+    const uint8_t rc = host_register(d.reg[2]);
+    const uint16_t next = static_cast<uint16_t>(address + d.length);
+
+    switch (d.opcode)
+    {
+        case LOAD:
+            emit8(j, static_cast<uint8_t>(0x40 | (ra >= 8 ? 0x04 : 0x00)));
+            emit8(j, 0x8A);                                    /* mov ra, [rbp + address]  */
+            emit8(j, static_cast<uint8_t>(0x85 | (ra & 7) << 3));
+            emit32(j, d.address);
+            return false;
+        case STORE:
+            emit8(j, 0xBA);                                    /* mov edx, address         */
+            emit32(j, d.address);
+            emit_write_check(j, m, writes, address);
+            emit_store_rdx(j, ra);
+            return false;
+        case STORER:
+            emit_movzx_r8(j, HOST_RDX, rb);
+            emit8(j, 0xC1); emit8(j, 0xE2); emit8(j, 0x08);          /* shl edx, 8               */
+            emit_movzx_r8(j, HOST_RCX, rc);
+            emit8(j, 0x01); emit8(j, 0xCA);                       /* add edx, ecx             */
+            emit_write_check(j, m, writes, address);
+            emit_store_rdx(j, ra);
+            return false;
+        case SET:
+            emit_mov_ri8(j, ra, d.value);
+            return false;
+        case INC:
+            emit_ri8(j, 0x80, 0, ra, 1);
+            emit_setc_bl(j);
+            return false;
+        case DEC:
+            emit_ri8(j, 0x80, 5, ra, 1);
+            emit_setc_bl(j);
+            return false;
+        case CMP:
+        case SUB:
+            emit_ri8(j, 0x80, 5, ra, d.value);
+            emit_setc_bl(j);
+            return false;
+        case ADD:
+            emit_ri8(j, 0x80, 0, ra, d.value);
+            emit_setc_bl(j);
+            return false;
+        case CMPR:
+            emit_rr8(j, 0x28, rb, ra);
+            emit_setc_bl(j);
+            return false;
+        case ADDR:
+            emit_rr8(j, 0x00, ra, rb);
+            emit_setc_bl(j);
+            return false;
+        case SUBR:
+            emit_rr8(j, 0x28, ra, rb);
+            emit_setc_bl(j);
+            return false;
+        case MUL:
+        case MULR:
+            emit_rr8(j, 0x88, rc, HOST_RAX);                   /* mov al, low              */
+            if (d.opcode == MUL)
+            {
+                emit_mov_ri8(j, HOST_RCX, d.value);
+            }
+            else
+            {
+                emit_rr8(j, 0x88, ra, HOST_RCX);
+            }
+            emit8(j, 0xF6); emit8(j, 0xE1);                       /* mul cl                   */
+            emit_setc_bl(j);
+            emit_rr8(j, 0x88, HOST_RAX, rc);                   /* mov low, al              */
+            emit8(j, 0x0F); emit8(j, 0xB6); emit8(j, 0xCC);          /* movzx ecx, ah            */
+            emit_rr8(j, 0x88, HOST_RCX, rb);                   /* mov high, cl             */
+            return false;
+        case DIV:
+        case DIVR:
+            emit_movzx_r8(j, HOST_RAX, rb);
+            if (d.opcode == DIV)
+            {
+                emit_mov_ri8(j, HOST_RCX, d.value);
+            }
+            else
+            {
+                emit_rr8(j, 0x88, ra, HOST_RCX);
+                emit_fault_check(j, address);
+            }
+            emit8(j, 0xF6); emit8(j, 0xF1);                       /* div cl                   */
+            emit_rr8(j, 0x88, HOST_RAX, rb);                   /* mov result, al           */
+            emit8(j, 0x0F); emit8(j, 0xB6); emit8(j, 0xCC);          /* movzx ecx, ah            */
+            emit_rr8(j, 0x88, HOST_RCX, rc);                   /* mov rest, cl             */
+            return false;
+        case SHL:
+            emit_ri8(j, 0x80, 7, ra, static_cast<uint8_t>(127 >> (d.value - 1)));
+            emit8(j, 0x0F); emit8(j, 0x97); emit8(j, 0xC3);          /* seta bl                  */
+            if (d.value < 8)
+            {
+                emit_ri8(j, 0xC0, 4, ra, d.value);
+            }
+            else
+            {
+                emit_mov_ri8(j, ra, 0);
+            }
+            return false;
+        case SHR:
+            if (d.value <= 8)
+            {
+                emit_movzx_r8(j, HOST_RCX, ra);
+                emit8(j, 0xC1); emit8(j, 0xE9); emit8(j, static_cast<uint8_t>(d.value - 1)); /* shr ecx */
+                emit8(j, 0x83); emit8(j, 0xE1); emit8(j, 0x01);      /* and ecx, 1               */
+                emit_rr8(j, 0x88, HOST_RCX, HOST_RBX);         /* mov bl, cl               */
+            }
+            else
+            {
+                emit_mov_ri8(j, HOST_RBX, 0);
+            }
+            if (d.value < 8)
+            {
+                emit_ri8(j, 0xC0, 5, ra, d.value);
+            }
+            else
+            {
+                emit_mov_ri8(j, ra, 0);
+            }
+            return false;
+        case PUSH:
+            emit_stack_address(j, 1);
+            emit_write_check(j, m, writes, address);
+            emit_store_rdx(j, ra);
+            emit8(j, 0x89); emit8(j, 0xD6);                       /* mov esi, edx             */
+            return false;
+        case POP:
+            emit8(j, static_cast<uint8_t>(0x40 | (ra >= 8 ? 0x04 : 0x00)));
+            emit8(j, 0x8A);                                    /* mov ra, [rbp + rsi]      */
+            emit8(j, static_cast<uint8_t>(0x44 | (ra & 7) << 3));
+            emit8(j, 0x35);
+            emit8(j, 0x00);
+            emit8(j, 0x66); emit8(j, 0x83); emit8(j, 0xC6); emit8(j, 0x01); /* add si, 1            */
+            return false;
+        case NOP:
+            return false;
+        case JMP:
+            emit_exit(j, d.address);
+            return true;
+        case JZ:
+        case JNZ:
+            emit_rr8(j, 0x84, ra, ra);                         /* test ra, ra              */
+            emit8(j, d.opcode == JZ ? 0x74 : 0x75);            /* jz/jnz taken             */
+            emit_branch_exits(j, next, d.address);
+            return true;
+        case JC:
+        case JNC:
+            emit8(j, 0x84); emit8(j, 0xDB);                       /* test bl, bl              */
+            emit8(j, d.opcode == JC ? 0x75 : 0x74);            /* jnz/jz taken             */
+            emit_branch_exits(j, next, d.address);
+            return true;
+        case CALL:
+            emit_stack_address(j, 2);
+            emit_write_check(j, m, writes, address);
+            emit_stack_address(j, 1);
+            emit_write_check(j, m, writes, address);
+            emit_stack_address(j, 2);
+            emit8(j, 0xC6); emit8(j, 0x44); emit8(j, 0x15); emit8(j, 0x00); /* mov byte [rbp + rdx]     */
+            emit8(j, static_cast<uint8_t>((next & 0xFF00) >> 8));
+            emit_stack_address(j, 1);
+            emit8(j, 0xC6); emit8(j, 0x44); emit8(j, 0x15); emit8(j, 0x00);
+            emit8(j, static_cast<uint8_t>(next & 0x00FF));
+            emit8(j, 0x66); emit8(j, 0x83); emit8(j, 0xEE); emit8(j, 0x02); /* sub si, 2            */
+            emit_exit(j, d.address);
+            return true;
+        case RET:
+            emit8(j, 0x0F); emit8(j, 0xB6); emit8(j, 0x44); emit8(j, 0x35); emit8(j, 0x00); /* movzx eax, [rbp + rsi]     */
+            emit8(j, 0xC1); emit8(j, 0xE0); emit8(j, 0x08);          /* shl eax, 8               */
+            emit8(j, 0x89); emit8(j, 0xF2);                       /* mov edx, esi             */
+            emit8(j, 0x66); emit8(j, 0x83); emit8(j, 0xC2); emit8(j, 0x01); /* add dx, 1 (wraps)    */
+            emit8(j, 0x0F); emit8(j, 0xB6); emit8(j, 0x4C); emit8(j, 0x15); emit8(j, 0x00); /* movzx ecx, [rbp + rdx]     */
+            emit8(j, 0x01); emit8(j, 0xC8);                       /* add eax, ecx             */
+            emit8(j, 0x66); emit8(j, 0x83); emit8(j, 0xC6); emit8(j, 0x02); /* add si, 2            */
+            emit_dynamic_exit(j);
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ *
+ * Compiles the basic block starting at a specific address. Returns the
+ * native entry of the block or nullptr if the first instruction can not be
+ * translated.
+ *
+ */
+uint8_t *jit_compile(jit_context &j, Machine &m, const uint16_t start)
+{
+    std::vector<std::pair<uint8_t *, uint16_t>> writes;
+    uint8_t *entry;
+    uint16_t address = start;
+    uint16_t count = 0;
+    bool ended = false;
+    uint16_t i;
+
+    if (j.code + JIT_CODE_SIZE - j.pos < JIT_BLOCK_RESERVE)
+    {
+        jit_flush(j);
+    }
+
+    entry = j.pos;
+
+    j.io_write_pages = 0;
+    j.io_reads = has_io_reads(m) ? 1 : 0;
+    for (i = 0; i < 256; i++)
+    {
+        j.io_writes[i] = m.io[i] && m.io[i]->write ? 1 : 0;
+        j.io_write_pages |= j.io_writes[i];
+    }
+
+    while (count < JIT_MAX_BLOCK && !ended)
+    {
+        const decoded_instruction &d = predecode(m, address);
+
+        if (!jit_supported(j, m, d, address)) break;
+
+        for (i = 0; i < d.length; i++)
+        {
+            j.pages[(address + i) >> 8] = 1;
+        }
+
+        ended = jit_emit_instruction(j, m, d, address, writes);
+        address = static_cast<uint16_t>(address + d.length);
+        count++;
+    }
+
+    if (count == 0)
+    {
+        j.counter[start] = JIT_NEVER;
+        return nullptr;
+    }
+
+    if (!ended)
+    {
+        emit_exit(j, address);
+    }
+
+    for (auto &write : writes)
+    {
+        const uint32_t offset = static_cast<uint32_t>(j.pos - (write.first + 4));
+        memcpy(write.first, &offset, 4);
+        emit8(j, 0xB8);
+        emit32(j, write.second | JIT_EXIT_WRITE << 16);
+        emit8(j, 0xE9);
+        emit32(j, static_cast<uint32_t>(j.epilogue - (j.pos + 4)));
+    }
+
+    j.entry[start] = entry;
+    j.jumps[start] = ended ? 1 : 0;
+
+    for (i = 0; i < j.links.size(); )
+    {
+        if (j.links[i].first == start)
+        {
+            uint8_t *stub = j.links[i].second;
+            stub[0] = 0xE9;
+            const uint32_t offset = static_cast<uint32_t>(entry - (stub + 5));
+            memcpy(stub + 1, &offset, 4);
+            j.links[i] = j.links.back();
+            j.links.pop_back();
+            continue;
+        }
+        i++;
+    }
+
+    return entry;
+}
+
+/**
+ *
+ * Handles the exit of a native block. Returns true if the block stopped
+ * before a write to a device or to decoded code or before a division by
+ * zero, which is then left to the interpreter.
+ *
+ */
+static bool jit_side_exit(jit_context &j, Machine &m, const uint64_t result)
+{
+    const uint32_t reason = result >> 16 & 0xFFFF;
+
+    if (reason == JIT_EXIT_FAULT) return true;
+    if (reason != JIT_EXIT_WRITE) return false;
+
+    const uint8_t page = static_cast<uint8_t>(result >> 40);
+
+    if (!j.io_writes[page])
+    {
+        if (j.pages[page])
+        {
+            j.blacklist[page] = 1;
+            jit_flush(j);
+        }
+        flush_decode_page(m, page);
+    }
+
+    return true;
+}
+
+/**
+ *
+ * JIT engine. Interprets the code with the predecoded engine, counts entries
+ * of the blocks and runs the hot ones natively. Results in exactly the same
+ * state as run_switch().
+ *
+ */
+void run_jit(Machine &m)
+{
+    bool leader = true;
+
+    if (!jit_init(m))
+    {
+        run_predecoded(m);
+        return;
+    }
+
+    jit_context &j = *m.jit;
+
+    if (j.lockstep)
+    {
+        j.lockstep = 0;
+        jit_flush(j);
+    }
+
+    while (!m.stop)
+    {
+        if (leader)
+        {
+            uint8_t *entry = j.entry[m.ip];
+
+            if (!entry && j.counter[m.ip] != JIT_NEVER && ++j.counter[m.ip] >= JIT_THRESHOLD)
+            {
+                entry = jit_compile(j, m, m.ip);
+            }
+
+            if (entry)
+            {
+                leader = !jit_side_exit(j, m, j.enter(entry));
+                continue;
+            }
+        }
+
+        run_predecoded_block(m);
+        leader = true;
+    }
+}
+
+/**
+ *
+ * Runs the JIT engine up to (and including) the next jump, call or return.
+ * Blocks are compiled on their first entry and not chained, the rest of a
+ * block the compiler stopped in is interpreted.
+ *
+ */
+void run_jit_block(Machine &m)
+{
+    if (!jit_init(m))
+    {
+        run_predecoded_block(m);
+        return;
+    }
+
+    jit_context &j = *m.jit;
+
+    if (!j.lockstep)
+    {
+        j.lockstep = 1;
+        jit_flush(j);
+    }
+
+    while (!m.stop)
+    {
+        const uint16_t start = m.ip;
+        uint8_t *entry = j.entry[start];
+
+        if (!entry && j.counter[start] != JIT_NEVER)
+        {
+            entry = jit_compile(j, m, start);
+        }
+
+        if (!entry || jit_side_exit(j, m, j.enter(entry))) break;
+
+        if (j.jumps[start]) return;
+    }
+
+    run_predecoded_block(m);
+}
+
+/**
+ *
+ * Releases the native code buffer of a machine.
+ *
+ */
+void jit_context_deleter::operator()(jit_context *context) const
+{
+#if defined(_WIN32)
+    VirtualFree(context->code, 0, MEM_RELEASE);
+#else
+    munmap(context->code, JIT_CODE_SIZE);
+#endif
+    delete context;
+}
+
+#else
+
+struct jit_context
+{
+};
+
+void jit_code_written(Machine &, const uint16_t) {}
+
+void jit_reset(Machine &) {}
+
+void jit_page_changed(Machine &, const uint8_t) {}
+
+void run_jit(Machine &m)
+{
+    run_predecoded(m);
+}
+
+void run_jit_block(Machine &m)
+{
+    run_predecoded_block(m);
+}
+
+void jit_context_deleter::operator()(jit_context *context) const
+{
+    delete context;
+}
+
+#endif
+
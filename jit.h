@@ -0,0 +1,48 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    jit.h                                                            */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Interface between the interpreter engines and the x86-64 compiler.        */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef __JIT_H_
+#define __JIT_H_
+
+/* INCLUDES ******************************************************************/
+
+#include <cstdint>
+
+#include "machine.h"
+
+/* JIT COMPILER **************************************************************/
+
+/**
+ *
+ * Called when a decoded instruction byte gets overwritten. If it belongs to
+ * compiled code, all blocks of the machine are dropped and the page is not
+ * compiled again.
+ *
+ */
+void jit_code_written(Machine &m, uint16_t address);
+
+/**
+ *
+ * Drops all compiled blocks of a machine and forgets its written pages, so
+ * the machine can be reused for another program.
+ *
+ */
+void jit_reset(Machine &m);
+
+/**
+ *
+ * Called when a whole page of the memory gets replaced (snapshot restore).
+ * Drops all compiled blocks if the page holds compiled code.
+ *
+ */
+void jit_page_changed(Machine &m, uint8_t page);
+
+#endif
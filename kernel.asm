@@ -64,7 +64,7 @@ __CHAR_MEM:     DB      0[2048]                     ; characters memory 8*8*256
 
 ; character set include
 
-#include "charset.asm"
+#include "chars.asm"
 
 ; console input/output methods
 
@@ -80,6 +80,24 @@ __cputs:        RET                                 ; writes a string to a conso
 
 __cprintf:      RET                                 ; writes formated string to console
 
-__clrsrc:       RET                                 ; clears screen
+__clrsrc:       PUSH    R0                          ; clears screen
+                PUSH    R1
+                PUSH    R2
+                PUSH    R3
+                PUSH    R4
+                SET     0x00, R0                    ; fill value
+                SET     0xC0, R1                    ; __VIDEO_MEM high byte
+                SET     0x00, R2                    ; __VIDEO_MEM low byte
+                SET     0x1F, R3                    ; 8000 bytes high byte
+                SET     0x40, R4                    ; 8000 bytes low byte
+                MEMSET  R0, R1, R2, R3, R4          ; whole video memory at once
+                STORE   R0, __CONSOLE_X             ; cursor to the top left
+                STORE   R0, __CONSOLE_Y
+                POP     R4
+                POP     R3
+                POP     R2
+                POP     R1
+                POP     R0
+                RET
 
 __getch:        RET                                 ; reads character from keyboard
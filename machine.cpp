@@ -0,0 +1,2578 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* Author:  Karel Mozdren                                                    */
+/* File:    machine.cpp                                                      */
+/* Date:    06.04.2017                                                       */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* This is a simple virtual machine which simulates 8 bit computer with      */
+/* 16 bit addressing, and random access memory (not a plain stack machine).  */
+/* The machine has 8 general purpose registers and a stack which starts      */
+/* pointing at the end of memory and goes down as being pushed upon.         */
+/*                                                                           */
+/* Every handler works on the Machine passed to it and keeps its temporary   */
+/* values in locals, so machines do not share any mutable state.             */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "image.h"
+#include "machine.h"
+#include "jit.h"
+#include "profiler.h"
+#include "trace.h"
+
+/* MACHINE CODE **************************************************************/
+
+/**
+ *
+ * Writes a byte to the memory and marks its page as dirty, so restoring a
+ * snapshot only has to copy the written pages back. Writes to the memory
+ * read by the display also mark their 8 byte block for it.
+ *
+ */
+inline void write_ram(Machine &m, const uint16_t address, const uint8_t value)
+{
+    const uint16_t video = static_cast<uint16_t>(address - VIDEO_MEM_ADDRESS);
+
+    m.mem[address] = value;
+    m.dirty[address >> 8] = 1;
+
+    if (video < VIDEO_RANGE_SIZE)
+    {
+        m.video_dirty[video >> 3] = 1;
+    }
+}
+
+/**
+ *
+ * Writes a byte for the program. Pages of plain memory cost one well
+ * predicted branch, a device mapped to the page gets the write instead.
+ *
+ */
+inline void write_byte(Machine &m, const uint16_t address, const uint8_t value)
+{
+    const io_device *device = m.io[address >> 8];
+
+    if (device && device->write)
+    {
+        device->write(m, device->context, address, value);
+        return;
+    }
+
+    write_ram(m, address, value);
+}
+
+/**
+ *
+ * Reads a data byte for the program (instructions are fetched from the
+ * memory directly), same as write_byte.
+ *
+ */
+inline uint8_t read_byte(Machine &m, const uint16_t address)
+{
+    const io_device *device = m.io[address >> 8];
+
+    if (device && device->read)
+    {
+        return device->read(m, device->context, address);
+    }
+
+    return m.mem[address];
+}
+
+/* REGISTER OPERANDS *********************************************************/
+
+/**
+ *
+ * Register file index (REG_*) of every operand code, shared by all machines
+ * and filled once.
+ *
+ */
+struct register_table
+{
+    uint8_t index[256];
+
+    register_table()
+    {
+        uint8_t i;
+
+        for (auto &entry : index)
+        {
+            entry = REG_INVALID;
+        }
+
+        for (i = 0; i < 8; i++)
+        {
+            index[IR0 + i] = i;
+        }
+
+        index[IIP] = REG_IP;
+        index[ISP] = REG_SP;
+        index[IBP] = REG_BP;
+        index[IC] = REG_C;
+    }
+};
+
+static const register_table &registers()
+{
+    static const register_table instance;
+    return instance;
+}
+
+inline uint8_t register_index(const uint8_t code)
+{
+    return registers().index[code];
+}
+
+/**
+ *
+ * Returns the general purpose register of an operand code. Any other code
+ * stops the machine and gets the sink register instead, so the handler
+ * does not branch on its operands and still leaves the registers alone.
+ * The machine stops after such an instruction, with the carry flag set
+ * from whatever the sink held.
+ *
+ */
+inline uint8_t &general_register(Machine &m, const uint8_t code)
+{
+    const uint8_t index = register_index(code);
+
+    m.stop |= index < 8 ? STOP_RUNNING : STOP_INVALID_REGISTER;
+    return index < 8 ? m.r[index] : m.sink;
+}
+
+inline bool word_register_index(const uint8_t index)
+{
+    return index >= REG_IP && index <= REG_BP;
+}
+
+/**
+ *
+ * Returns the 16 bit register of a REG_IP, REG_SP or REG_BP index.
+ *
+ */
+inline uint16_t &word_register(Machine &m, const uint8_t index)
+{
+    static uint16_t Machine::* const words[] = { &Machine::ip, &Machine::sp, &Machine::bp };
+
+    return m.*words[index - REG_IP];
+}
+
+/**
+ *
+ * initializes memory and registers to a startup values.
+ * 
+ * All ram values are set to 0x00 (HALT) and sets stack pointer and block
+ * pointer to top of the memory.
+ *
+ */
+void init_machine(Machine &m)
+{
+    uint32_t i;
+    m.stop = 0;
+
+    /* clean all memory */
+    for (i = 0; i <= MEM_SIZE; i++)
+    {
+        m.mem[i] = HALT;
+    }
+
+    /* initialize registers */
+    m.ip = 0;
+    m.sp = MEM_SIZE;
+    m.bp = MEM_SIZE;
+    m.c = 0;
+    m.sink = 0;
+    m.cycles = 0;
+
+    for (i = 0; i < 8; i++)
+    {
+        m.r[i] = 0;
+    }
+
+    /* the memory does not come from any snapshot */
+    m.origin.reset();
+    for (i = 0; i < 256; i++)
+    {
+        m.dirty[i] = 1;
+    }
+
+    /* the display redraws everything */
+    for (i = 0; i < VIDEO_BLOCKS; i++)
+    {
+        m.video_dirty[i] = 1;
+    }
+
+    flush_decode_cache(m);
+    jit_reset(m);
+}
+
+/**
+ * Processing a load instruction. This instruction loads data from a 16bit
+ * memory location and saves it to a defined register.
+ * 
+ * LOAD 0x1A2B, R0 -> 00 1A 2B 00
+ */
+void load_instruction(Machine &m)
+{
+    uint16_t memory_source = 0;
+    uint8_t value = 0;
+
+    memory_source = static_cast<uint16_t>(m.mem[m.ip + 1]);
+    memory_source <<= 8;
+    memory_source += static_cast<uint16_t>(m.mem[m.ip + 2]);
+
+    value = read_byte(m, memory_source);
+
+    general_register(m, m.mem[m.ip + 3]) = value;
+
+    m.ip += 4;
+}
+
+/**
+ * Processing a store instruction. This instruction stores data from a specific
+ * register to a 16bit memory location.
+ * 
+ * STORE 0x1A2B, R0 -> 01 1A 2B 00
+ */
+void store_instruction(Machine &m)
+{
+    uint16_t memory_destination = 0;
+    uint8_t value = 0;
+
+    value = general_register(m, m.mem[m.ip + 1]);
+
+    memory_destination = static_cast<uint16_t>(m.mem[m.ip + 2]);
+    memory_destination <<= 8;
+    memory_destination += static_cast<uint16_t>(m.mem[m.ip + 3]);
+
+    write_byte(m, memory_destination, value);
+
+    m.ip += 4;
+}
+
+/**
+ * Processing a store instruction. This instruction stores data from a specific
+ * register to a 16bit memory location defined by two additional registers.
+ * 
+ * STORER R0, R1, R2 -> 02 00 01 02
+ */
+void storer_instruction(Machine &m)
+{
+    uint8_t value = 0;
+    uint16_t destinationAddress = 0;
+
+    value = general_register(m, m.mem[m.ip + 1]);
+
+    destinationAddress = static_cast<uint16_t>(general_register(m, m.mem[m.ip + 2])) << 8;
+    destinationAddress += static_cast<uint16_t>(general_register(m, m.mem[m.ip + 3]));
+
+    write_byte(m, destinationAddress, value);
+
+    m.ip += 4;
+}
+
+/**
+ * Processing a set instruction. This instruction stores imidiate value to a
+ * specific register.
+ * 
+ * SET 0x1A, R0 -> 03 1A 00
+ */
+void set_instruction(Machine &m)
+{
+    uint8_t value = 0;
+
+    value = m.mem[m.ip + 1];
+    general_register(m, m.mem[m.ip + 2]) = value;
+
+    m.ip += 3;
+}
+
+/**
+ * Processing a push instruction. This instruction stores a register value to
+ * a top of the stack.
+ *
+ * PUSH R0 -> 10 00
+ */
+void push_instruction(Machine &m)
+{
+    const uint8_t source = register_index(m.mem[m.ip + 1]);
+    uint16_t value = 0;
+
+    m.sp--;
+
+    if (word_register_index(source))
+    {
+        value = word_register(m, source);
+        write_byte(m, m.sp, static_cast<uint8_t>(value & 0x00FF));
+        write_byte(m, static_cast<uint16_t>(m.sp - 1), static_cast<uint8_t>((value & 0xFF00) >> 8));
+        m.sp--;
+        m.ip += 2;
+        return;
+    }
+
+    write_byte(m, m.sp, general_register(m, m.mem[m.ip + 1]));
+
+    m.ip += 2;
+}
+
+/**
+ * Processing a pop instruction. This instruction stores value on top of the
+ * stack to a specific register.
+ *
+ * POP R0 -> 11 00
+ */
+void pop_instruction(Machine &m)
+{
+    const uint8_t source = register_index(m.mem[m.ip + 1]);
+    uint16_t value = 0;
+
+    if (word_register_index(source))
+    {
+        value = (static_cast<uint16_t>(read_byte(m, m.sp)) << 8) + read_byte(m, static_cast<uint16_t>(m.sp + 1));
+        word_register(m, source) = value;
+        m.sp += 2;
+        m.ip += 2;
+        return;
+    }
+
+    general_register(m, m.mem[m.ip + 1]) = read_byte(m, m.sp);
+
+    m.sp++;
+    m.ip += 2;
+}
+
+/*
+ *
+ * Increase Instruction. Increases register value by 1.
+ *
+ */
+void inc_instruction(Machine &m)
+{
+    uint8_t &what = general_register(m, m.mem[m.ip + 1]);
+
+    what++;
+    m.c = what == 0x00 ? 1 : 0;
+
+    m.ip += 2;
+}
+
+/*
+ *
+ * Decrease Instruction. Decreases register value by 1.
+ *
+ */
+void dec_instruction(Machine &m)
+{
+    uint8_t &what = general_register(m, m.mem[m.ip + 1]);
+
+    what--;
+    m.c = what == 0xFF ? 1 : 0;
+
+    m.ip += 2;
+}
+
+/**
+ *
+ * JMP instruction. Jumps to a specific 16 bit address.
+ *
+ */
+void jmp_instruction(Machine &m)
+{
+    uint16_t jump_address = 0;
+
+    jump_address = static_cast<uint16_t>(m.mem[m.ip + 1]) << 8;
+    jump_address += static_cast<uint16_t>(m.mem[m.ip + 2]);
+
+    m.ip = jump_address;
+}
+
+/**
+ *
+ * compares register to a value. If register value is less than imediate value
+ * it sets the carry bit to true. Does subtraction on the backend. Subtracted
+ * value is set in the register that has been used for comparison.
+ *
+ */
+void cmp_instruction(Machine &m)
+{
+    uint8_t value = 0;
+
+    value = m.mem[m.ip + 2];
+
+    uint8_t &source = general_register(m, m.mem[m.ip + 1]);
+
+    m.c = source >= value ? 0 : 1;
+    source -= value;
+
+    m.ip += 3;
+}
+
+/**
+ *
+ * compares register to another register. If register value is less than
+ * imediate value it sets the carry bit to true. Does subtraction on the
+ * backend. Subtracted value is set in the register that has been used 
+ * for comparison.
+ *
+ */
+void cmpr_instruction(Machine &m)
+{
+    uint8_t value = 0;
+
+    value = general_register(m, m.mem[m.ip + 2]);
+
+    uint8_t &register0 = general_register(m, m.mem[m.ip + 1]);
+
+    m.c = register0 >= value ? 0 : 1;
+    register0 -= value;
+
+    m.ip += 3;
+}
+
+/**
+ *
+ * "Jump if zero" instruction. Jumps to a specific 16 bit address if selected
+ * register is set to zero.
+ *
+ */
+void jz_instruction(Machine &m)
+{
+    uint16_t jumpAddress = 0;
+
+    jumpAddress = static_cast<uint16_t>(m.mem[m.ip + 2]) << 8;
+    jumpAddress += static_cast<uint16_t>(m.mem[m.ip + 3]);
+
+    if (general_register(m, m.mem[m.ip + 1]) == 0 && !m.stop)
+    {
+        m.ip = jumpAddress;
+        return;
+    }
+
+    m.ip += 4;
+}
+
+/**
+ *
+ * "Jump if not zero" instruction. Jumps to a specific 16 bit address if
+ * selected register is not set to zero.
+ *
+ */
+void jnz_instruction(Machine &m)
+{
+    uint16_t jump_address = 0;
+
+    jump_address = static_cast<uint16_t>(m.mem[m.ip + 2]) << 8;
+    jump_address += static_cast<uint16_t>(m.mem[m.ip + 3]);
+
+    if (general_register(m, m.mem[m.ip + 1]) != 0 && !m.stop)
+    {
+        m.ip = jump_address;
+        return;
+    }
+
+    m.ip += 4;
+}
+
+/**
+ *
+ * "Jump if carry set" instruction. Jumps to a specific 16 bit address if
+ * carry is set.
+ *
+ */
+void jc_instruction(Machine &m)
+{
+    uint16_t jumpAddress = 0;
+    
+    jumpAddress = static_cast<uint16_t>(m.mem[m.ip + 1]) << 8;
+    jumpAddress += static_cast<uint16_t>(m.mem[m.ip + 2]);
+    
+    if (m.c != 0)
+    {
+        m.ip = jumpAddress;
+        return;
+    }
+    
+    m.ip += 3;
+}
+
+/**
+ *
+ * "Jump if carry not set" instruction. Jumps to a specific 16 bit address if
+ * carry is not set.
+ *
+ */
+void jnc_instruction(Machine &m)
+{
+    uint16_t jumpAddress = 0;
+    
+    jumpAddress = static_cast<uint16_t>(m.mem[m.ip + 1]) << 8;
+    jumpAddress += static_cast<uint16_t>(m.mem[m.ip + 2]);
+    
+    if (m.c == 0)
+    {
+        m.ip = jumpAddress;
+        return;
+    }
+    
+    m.ip += 3;
+}
+
+/**
+ *
+ * Add instruction. Adds a value to a register.
+ *
+ */
+void add_instruction(Machine &m)
+{
+    uint8_t value = 0;
+
+    value = m.mem[m.ip + 1];
+
+    uint8_t &destination = general_register(m, m.mem[m.ip + 2]);
+
+    m.c = static_cast<uint16_t>(destination) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0;
+    destination += value;
+
+    m.ip += 3;
+}
+
+/**
+ *
+ * Addr instruction. Adds a value of a specific register to a value in destination register.
+ *
+ */
+void addr_instruction(Machine &m)
+{
+    uint8_t value = 0;
+
+    value = general_register(m, m.mem[m.ip + 1]);
+
+    uint8_t &destination = general_register(m, m.mem[m.ip + 2]);
+
+    m.c = static_cast<uint16_t>(destination) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0;
+    destination += value;
+
+    m.ip += 3;
+}
+
+/**
+ *
+ * Call instruction. Jumps to a specified address and pushes return instruction
+ * address onto a stack.
+ *
+ */
+void call_instruction(Machine &m)
+{
+    uint16_t callAddress = 0;
+    uint16_t returnAddress = 0;
+    
+    callAddress = static_cast<uint16_t>(m.mem[m.ip + 1]) << 8;
+    callAddress += static_cast<uint16_t>(m.mem[m.ip + 2]);
+    
+    returnAddress = m.ip + 3;
+    
+    write_byte(m, static_cast<uint16_t>(m.sp - 2), static_cast<uint8_t>((returnAddress & 0xFF00) >> 8));
+    write_byte(m, static_cast<uint16_t>(m.sp - 1), static_cast<uint8_t>(returnAddress & 0x00FF));
+    m.sp -= 2;
+    
+    m.ip = callAddress;
+}
+
+/**
+ *
+ * Ret instruction. Returns from a procedure using the top of the stack as a
+ * return address.
+ *
+ */
+void ret_instruction(Machine &m)
+{
+    m.ip = static_cast<uint16_t>(read_byte(m, m.sp) << 8);
+    m.ip += static_cast<uint16_t>(read_byte(m, static_cast<uint16_t>(m.sp + 1)));
+    m.sp += 2;
+}
+
+/**
+ *
+ * Sub instruction. Subtracts a value from a register.
+ *
+ */
+void sub_instruction(Machine &m)
+{
+    uint8_t value = 0;
+
+    value = m.mem[m.ip + 1];
+
+    uint8_t &destination = general_register(m, m.mem[m.ip + 2]);
+
+    m.c = destination < value ? 1 : 0;
+    destination -= value;
+
+    m.ip += 3;
+}
+
+/**
+ *
+ * Subr instruction. Subtracts a value of a specific register from a value in destination register.
+ *
+ */
+void subr_instruction(Machine &m)
+{
+    uint8_t value = 0;
+
+    value = general_register(m, m.mem[m.ip + 1]);
+
+    uint8_t &destination = general_register(m, m.mem[m.ip + 2]);
+
+    m.c = destination < value ? 1 : 0;
+    destination -= value;
+
+    m.ip += 3;
+}
+
+/**
+ *
+ * Mul instruction. multiplies a register by value. Saves result into two
+ * registers.
+ *
+ */
+void mul_instruction(Machine &m)
+{
+    uint16_t value = 0;
+    uint16_t result = 0;
+
+    value = static_cast<uint16_t>(m.mem[m.ip + 1]);
+
+    uint8_t &low = general_register(m, m.mem[m.ip + 3]);
+
+    result = static_cast<uint16_t>(low) * value;
+    low = static_cast<uint8_t>(result & 0x00FF);
+
+    m.c = result > 0xFF ? 1 : 0;
+
+    general_register(m, m.mem[m.ip + 2]) = static_cast<uint8_t>((result & 0xFF00) >> 8);
+
+    m.ip += 4;
+}
+
+/**
+ *
+ * Mulr instruction. Multiplies register value by a register value. Saves 
+ * result into two registers.
+ *
+ */
+void mulr_instruction(Machine &m)
+{
+    uint16_t value = 0;
+    uint16_t result = 0;
+
+    value = static_cast<uint16_t>(general_register(m, m.mem[m.ip + 1]));
+
+    uint8_t &low = general_register(m, m.mem[m.ip + 3]);
+
+    result = static_cast<uint16_t>(low) * value;
+    low = static_cast<uint8_t>(result & 0x00FF);
+
+    m.c = result > 0xFF ? 1 : 0;
+
+    general_register(m, m.mem[m.ip + 2]) = static_cast<uint8_t>((result & 0xFF00) >> 8);
+
+    m.ip += 4;
+}
+
+/**
+ *
+ * Div instruction. divides a register by value. Saves results into two
+ * registers. First register holds rusult of the dision, and the second
+ * the rest of the division.
+ *
+ */
+void divInstruction(Machine &m)
+{
+    uint8_t value = 0;
+    uint8_t rest = 0;
+
+    value = m.mem[m.ip + 1];
+
+    uint8_t &result = general_register(m, m.mem[m.ip + 2]);
+
+    if (m.stop)
+    {
+        /* the sink is no divisor */
+        m.ip += 4;
+        return;
+    }
+
+    if (value == 0)
+    {
+        m.stop = STOP_DIVIDE_BY_ZERO;
+        return;
+    }
+
+    rest = result % value;
+    result = result / value;
+
+    general_register(m, m.mem[m.ip + 3]) = rest;
+
+    m.ip += 4;
+}
+
+/**
+ *
+ * Divr instruction. divides a register by another register. Saves results into
+ * two registers. First register holds rusult of the dision, and the second
+ * the rest of the division.
+ *
+ */
+void divr_instruction(Machine &m)
+{
+    uint8_t value = 0;
+    uint8_t rest = 0;
+
+    value = general_register(m, m.mem[m.ip + 1]);
+
+    uint8_t &result = general_register(m, m.mem[m.ip + 2]);
+
+    if (m.stop)
+    {
+        /* the sink is no divisor */
+        m.ip += 4;
+        return;
+    }
+
+    if (value == 0)
+    {
+        m.stop = STOP_DIVIDE_BY_ZERO;
+        return;
+    }
+
+    rest = result % value;
+    result = result / value;
+
+    general_register(m, m.mem[m.ip + 3]) = rest;
+
+    m.ip += 4;
+}
+
+/*
+ *
+ * Shifts value to the right. If last shifted bit was 1, then sets carry to 1.
+ *
+ */
+void shrInstruction(Machine &m)
+{
+    uint8_t val = 0;
+
+    val = m.mem[m.ip + 1];
+
+    uint8_t &what = general_register(m, m.mem[m.ip + 2]);
+
+    m.c = (what >> (val - 1)) % 2;
+    what >>= val;
+
+    m.ip += 3;
+}
+
+/*
+ *
+ * Shifts value to the left. If last shifted bit was 1, then sets carry to 1.
+ *
+ */
+void shl_instruction(Machine &m)
+{
+    uint8_t val = 0;
+
+    val = m.mem[m.ip + 1];
+
+    uint8_t &what = general_register(m, m.mem[m.ip + 2]);
+
+    m.c = what << (val - 1) > 127 ? 1 : 0;
+    what <<= val;
+
+    m.ip += 3;
+}
+
+/* BLOCK INSTRUCTIONS ********************************************************/
+
+void invalidate_decoded(Machine &m, uint16_t address);
+
+/**
+ *
+ * Reads the register operands of a block instruction to values. Returns
+ * false (and stops the machine) if any of them is not a general purpose
+ * register; the instruction then does nothing.
+ *
+ */
+static bool block_operands(Machine &m, const uint8_t count, uint8_t *values)
+{
+    uint8_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        const uint8_t index = register_index(m.mem[static_cast<uint16_t>(m.ip + 1 + i)]);
+
+        if (index >= 8)
+        {
+            m.stop |= STOP_INVALID_REGISTER;
+            return false;
+        }
+
+        values[i] = m.r[index];
+    }
+
+    return true;
+}
+
+/**
+ *
+ * Length of the part of a block up to the end of the memory, where the
+ * addresses wrap around to 0x0000.
+ *
+ */
+static uint32_t block_part(const uint16_t address, const uint32_t count)
+{
+    const uint32_t left = MEM_SIZE + 1 - static_cast<uint32_t>(address);
+
+    return count < left ? count : left;
+}
+
+/**
+ *
+ * Determines if a block lies in plain memory (no wrapping around, no device
+ * handling the reads or the writes of its pages).
+ *
+ */
+static bool plain_block(const Machine &m, const uint16_t address, const uint32_t count, const bool write)
+{
+    uint32_t page;
+
+    if (block_part(address, count) != count) return false;
+
+    for (page = address >> 8; page <= (address + count - 1) >> 8; page++)
+    {
+        const io_device *device = m.io[page];
+
+        if (device && (write ? device->write != nullptr : device->read != nullptr)) return false;
+    }
+
+    return true;
+}
+
+/**
+ *
+ * Does the bookkeeping of write_ram() and of the decode cache for a block
+ * written at once: marks the pages dirty, the video blocks for the display
+ * and drops the decoded and compiled code covering the block.
+ *
+ */
+static void block_written(Machine &m, const uint16_t address, const uint32_t count)
+{
+    uint32_t done = 0;
+
+    while (done < count)
+    {
+        const uint16_t first = static_cast<uint16_t>(address + done);
+        const uint32_t part = block_part(first, count - done);
+        const uint32_t end = first + part;
+        const uint32_t video_first = first > VIDEO_MEM_ADDRESS ? first : VIDEO_MEM_ADDRESS;
+        const uint32_t video_end = end < VIDEO_MEM_ADDRESS + VIDEO_RANGE_SIZE ? end : VIDEO_MEM_ADDRESS + VIDEO_RANGE_SIZE;
+        uint32_t page;
+        uint32_t i;
+
+        if (video_first < video_end)
+        {
+            const uint32_t block = (video_first - VIDEO_MEM_ADDRESS) >> 3;
+            const uint32_t last = (video_end - 1 - VIDEO_MEM_ADDRESS) >> 3;
+
+            memset(m.video_dirty + block, 1, last - block + 1);
+        }
+
+        for (page = first >> 8; page <= (end - 1) >> 8; page++)
+        {
+            m.dirty[page] = 1;
+
+            if (!m.decoded)
+            {
+                jit_code_written(m, static_cast<uint16_t>(page << 8));
+                continue;
+            }
+
+            if (!m.decoded->pages[page]) continue;
+
+            const uint32_t from = page << 8 > first ? page << 8 : first;
+            const uint32_t to = (page + 1) << 8 < end ? (page + 1) << 8 : end;
+
+            for (i = from; i < to; i++)
+            {
+                if (m.decoded->bytes[i]) invalidate_decoded(m, static_cast<uint16_t>(i));
+            }
+        }
+
+        done += part;
+    }
+}
+
+/**
+ *
+ * Memcpy instruction. Copies a block of bytes as memmove does (overlapping
+ * blocks too), wrapping around at the end of the memory. Registers are left
+ * as they are. A block wrapping around or touching a device is copied byte
+ * by byte, backwards when the target starts inside the source, and only
+ * a block overlapping the source at both of its ends (more than half the
+ * memory) is read to a buffer first.
+ *
+ * MEMCPY Rdh, Rdl, Rsh, Rsl, Rnh, Rnl -> 1C F2 F3 F4 F5 F6 F7
+ *
+ */
+void memcpy_instruction(Machine &m)
+{
+    uint8_t operand[6];
+    uint32_t i;
+
+    if (block_operands(m, 6, operand))
+    {
+        const uint16_t target = static_cast<uint16_t>(operand[0] << 8 | operand[1]);
+        const uint16_t source = static_cast<uint16_t>(operand[2] << 8 | operand[3]);
+        const uint32_t count = static_cast<uint32_t>(operand[4] << 8 | operand[5]);
+
+        if (count && plain_block(m, source, count, false) && plain_block(m, target, count, true))
+        {
+            memmove(m.mem + target, m.mem + source, count);
+            block_written(m, target, count);
+        }
+        else if (count)
+        {
+            const uint32_t distance = static_cast<uint16_t>(target - source);
+
+            if (distance && distance < count && MEM_SIZE + 1 - distance < count)
+            {
+                std::vector<uint8_t> buffer(count);
+
+                for (i = 0; i < count; i++)
+                {
+                    buffer[i] = read_byte(m, static_cast<uint16_t>(source + i));
+                }
+
+                for (i = 0; i < count; i++)
+                {
+                    write_byte(m, static_cast<uint16_t>(target + i), buffer[i]);
+                }
+            }
+            else if (distance && distance < count)
+            {
+                for (i = count; i > 0; i--)
+                {
+                    write_byte(m, static_cast<uint16_t>(target + i - 1),
+                               read_byte(m, static_cast<uint16_t>(source + i - 1)));
+                }
+            }
+            else
+            {
+                for (i = 0; i < count; i++)
+                {
+                    write_byte(m, static_cast<uint16_t>(target + i), read_byte(m, static_cast<uint16_t>(source + i)));
+                }
+            }
+
+            block_written(m, target, count);
+        }
+    }
+
+    m.ip += MEMCPY_LEN;
+}
+
+/**
+ *
+ * Memset instruction. Fills a block with the value of a register, wrapping
+ * around at the end of the memory.
+ *
+ * MEMSET Rv, Rdh, Rdl, Rnh, Rnl -> 1D F2 F3 F4 F5 F6
+ *
+ */
+void memset_instruction(Machine &m)
+{
+    uint8_t operand[5];
+    uint32_t i;
+
+    if (block_operands(m, 5, operand))
+    {
+        const uint16_t target = static_cast<uint16_t>(operand[1] << 8 | operand[2]);
+        const uint32_t count = static_cast<uint32_t>(operand[3] << 8 | operand[4]);
+
+        if (count && plain_block(m, target, count, true))
+        {
+            memset(m.mem + target, operand[0], count);
+            block_written(m, target, count);
+        }
+        else if (count)
+        {
+            for (i = 0; i < count; i++)
+            {
+                write_byte(m, static_cast<uint16_t>(target + i), operand[0]);
+            }
+
+            block_written(m, target, count);
+        }
+    }
+
+    m.ip += MEMSET_LEN;
+}
+
+/**
+ *
+ * Memcmp instruction. Compares two blocks the way CMPR compares registers:
+ * the result register gets the difference of the first two bytes that are
+ * not the same (0 for equal blocks) and the carry is set if the byte of the
+ * first block is the lower one.
+ *
+ * MEMCMP Rr, Rah, Ral, Rbh, Rbl, Rnh, Rnl -> 1E F2 F3 F4 F5 F6 F7 F8
+ *
+ */
+void memcmp_instruction(Machine &m)
+{
+    uint8_t operand[7];
+    uint8_t a = 0;
+    uint8_t b = 0;
+    uint32_t i;
+
+    if (block_operands(m, 7, operand))
+    {
+        const uint16_t first = static_cast<uint16_t>(operand[1] << 8 | operand[2]);
+        const uint16_t second = static_cast<uint16_t>(operand[3] << 8 | operand[4]);
+        const uint32_t count = static_cast<uint32_t>(operand[5] << 8 | operand[6]);
+
+        if (count && plain_block(m, first, count, false) && plain_block(m, second, count, false))
+        {
+            const auto difference = std::mismatch(m.mem + first, m.mem + first + count, m.mem + second);
+
+            if (difference.first != m.mem + first + count)
+            {
+                a = *difference.first;
+                b = *difference.second;
+            }
+        }
+        else
+        {
+            for (i = 0; i < count && a == b; i++)
+            {
+                a = read_byte(m, static_cast<uint16_t>(first + i));
+                b = read_byte(m, static_cast<uint16_t>(second + i));
+            }
+        }
+
+        m.r[m.mem[static_cast<uint16_t>(m.ip + 1)] - IR0] = static_cast<uint8_t>(a - b);
+        m.c = a < b ? 1 : 0;
+    }
+
+    m.ip += MEMCMP_LEN;
+}
+
+/**
+ *
+ * Processes instruction. If unknown instruction or halt, then the VM stops.
+ *
+ */
+void process_instruction(Machine &m)
+{
+    switch (m.mem[m.ip])
+    {
+        case LOAD: load_instruction(m); break;
+        case STORE: store_instruction(m); break;
+        case STORER: storer_instruction(m); break;
+        case SET: set_instruction(m); break;
+        case PUSH: push_instruction(m); break;
+        case POP: pop_instruction(m); break;
+        case INC: inc_instruction(m); break;
+        case DEC: dec_instruction(m); break;
+        case JMP: jmp_instruction(m); break;
+        case CMP: cmp_instruction(m); break;
+        case CMPR: cmpr_instruction(m); break;
+        case JZ: jz_instruction(m); break;
+        case JNZ: jnz_instruction(m); break;
+        case JC: jc_instruction(m); break;
+        case JNC: jnc_instruction(m); break;
+        case ADD: add_instruction(m); break;
+        case ADDR: addr_instruction(m); break;
+        case CALL: call_instruction(m); break;
+        case RET: ret_instruction(m); break;
+        case SUB: sub_instruction(m); break;
+        case SUBR: subr_instruction(m); break;
+        case MUL: mul_instruction(m); break;
+        case MULR: mulr_instruction(m); break;
+        case DIV: divInstruction(m); break;
+        case DIVR: divr_instruction(m); break;
+        case SHL: shl_instruction(m); break;
+        case SHR: shrInstruction(m); break;
+        case MEMCPY: memcpy_instruction(m); break;
+        case MEMSET: memset_instruction(m); break;
+        case MEMCMP: memcmp_instruction(m); break;
+        case NOP: m.ip++; break;
+        case HALT: m.stop = STOP_HALT; break;
+        default: m.stop = STOP_INVALID_OPCODE; break;
+    }
+}
+
+/* DISPATCH ******************************************************************/
+
+typedef void (*instruction_handler)(Machine &m);
+
+/**
+ *
+ * Handler for every opcode the machine does not know. Stops the VM the same
+ * way as the default branch of process_instruction().
+ *
+ */
+void invalid_instruction(Machine &m)
+{
+    m.stop = STOP_INVALID_OPCODE;
+}
+
+/**
+ *
+ * HALT instruction. Stops the VM.
+ *
+ */
+void halt_instruction(Machine &m)
+{
+    m.stop = STOP_HALT;
+}
+
+/**
+ *
+ * NOP instruction. Just moves to the next instruction.
+ *
+ */
+void nop_instruction(Machine &m)
+{
+    m.ip += NOP_LEN;
+}
+
+/**
+ *
+ * Opcode tables shared by all machines. They are filled once (thread safe)
+ * and never written again.
+ *
+ */
+struct instruction_tables
+{
+    instruction_handler handler[256];   /* handlers for table dispatch       */
+    uint8_t length[256];                /* instruction lengths (*_LEN)       */
+    uint8_t cycles[256];                /* instruction cycles (*_CYC)        */
+
+    instruction_tables()
+    {
+        for (auto &h : handler)
+        {
+            h = invalid_instruction;
+        }
+
+        for (auto &l : length)
+        {
+            l = 1;
+        }
+
+        for (auto &c : cycles)
+        {
+            c = 1;
+        }
+
+        add(LOAD, load_instruction, LOAD_LEN, LOAD_CYC);
+        add(STORE, store_instruction, STORE_LEN, STORE_CYC);
+        add(STORER, storer_instruction, STORER_LEN, STORER_CYC);
+        add(SET, set_instruction, SET_LEN, SET_CYC);
+        add(PUSH, push_instruction, PUSH_LEN, PUSH_CYC);
+        add(POP, pop_instruction, POP_LEN, POP_CYC);
+        add(INC, inc_instruction, INC_LEN, INC_CYC);
+        add(DEC, dec_instruction, DEC_LEN, DEC_CYC);
+        add(JMP, jmp_instruction, JMP_LEN, JMP_CYC);
+        add(CMP, cmp_instruction, CMP_LEN, CMP_CYC);
+        add(CMPR, cmpr_instruction, CMPR_LEN, CMPR_CYC);
+        add(JZ, jz_instruction, JZ_LEN, JZ_CYC);
+        add(JNZ, jnz_instruction, JNZ_LEN, JNZ_CYC);
+        add(JC, jc_instruction, JC_LEN, JC_CYC);
+        add(JNC, jnc_instruction, JNC_LEN, JNC_CYC);
+        add(ADD, add_instruction, ADD_LEN, ADD_CYC);
+        add(ADDR, addr_instruction, ADDR_LEN, ADDR_CYC);
+        add(CALL, call_instruction, CALL_LEN, CALL_CYC);
+        add(RET, ret_instruction, RET_LEN, RET_CYC);
+        add(SUB, sub_instruction, SUB_LEN, SUB_CYC);
+        add(SUBR, subr_instruction, SUBR_LEN, SUBR_CYC);
+        add(MUL, mul_instruction, MUL_LEN, MUL_CYC);
+        add(MULR, mulr_instruction, MULR_LEN, MULR_CYC);
+        add(DIV, divInstruction, DIV_LEN, DIV_CYC);
+        add(DIVR, divr_instruction, DIVR_LEN, DIVR_CYC);
+        add(SHL, shl_instruction, SHL_LEN, SHL_CYC);
+        add(SHR, shrInstruction, SHR_LEN, SHR_CYC);
+        add(MEMCPY, memcpy_instruction, MEMCPY_LEN, MEMCPY_CYC);
+        add(MEMSET, memset_instruction, MEMSET_LEN, MEMSET_CYC);
+        add(MEMCMP, memcmp_instruction, MEMCMP_LEN, MEMCMP_CYC);
+        add(HALT, halt_instruction, HALT_LEN, HALT_CYC);
+        add(NOP, nop_instruction, NOP_LEN, NOP_CYC);
+    }
+
+    void add(const uint8_t opcode, const instruction_handler h, const uint8_t l, const uint8_t c)
+    {
+        handler[opcode] = h;
+        length[opcode] = l;
+        cycles[opcode] = c;
+    }
+};
+
+static const instruction_tables &tables()
+{
+    static const instruction_tables instance;
+    return instance;
+}
+
+/**
+ *
+ * Returns length of an instruction. Unknown opcodes stop the machine, so they
+ * are one byte long.
+ *
+ */
+uint8_t instruction_length(const uint8_t opcode)
+{
+    return tables().length[opcode];
+}
+
+/**
+ *
+ * Mnemonic of an opcode, "?" for the unknown ones.
+ *
+ */
+const char *instruction_name(const uint8_t opcode)
+{
+    switch (opcode)
+    {
+        case LOAD:   return "LOAD";
+        case STORE:  return "STORE";
+        case STORER: return "STORER";
+        case SET:    return "SET";
+        case INC:    return "INC";
+        case DEC:    return "DEC";
+        case JMP:    return "JMP";
+        case CMP:    return "CMP";
+        case CMPR:   return "CMPR";
+        case JZ:     return "JZ";
+        case JNZ:    return "JNZ";
+        case JC:     return "JC";
+        case JNC:    return "JNC";
+        case ADD:    return "ADD";
+        case ADDR:   return "ADDR";
+        case PUSH:   return "PUSH";
+        case POP:    return "POP";
+        case CALL:   return "CALL";
+        case RET:    return "RET";
+        case SUB:    return "SUB";
+        case SUBR:   return "SUBR";
+        case MUL:    return "MUL";
+        case MULR:   return "MULR";
+        case DIV:    return "DIV";
+        case DIVR:   return "DIVR";
+        case SHL:    return "SHL";
+        case SHR:    return "SHR";
+        case MEMCPY: return "MEMCPY";
+        case MEMSET: return "MEMSET";
+        case MEMCMP: return "MEMCMP";
+        case HALT:   return "HALT";
+        case NOP:    return "NOP";
+        default:     return "?";
+    }
+}
+
+/**
+ *
+ * Returns the name of a stop reason (see STOP_*).
+ *
+ */
+const char *stop_reason(const uint8_t reason)
+{
+    switch (reason)
+    {
+        case STOP_RUNNING: return "running";
+        case STOP_HALT: return "halt";
+        case STOP_INVALID_OPCODE: return "invalid-opcode";
+        case STOP_INVALID_REGISTER: return "invalid-register";
+        case STOP_BREAK: return "break";
+        case STOP_DIVIDE_BY_ZERO: return "divide-by-zero";
+        case STOP_BUDGET: return "budget";
+        default: return "fault";
+    }
+}
+
+/**
+ *
+ * Runs process_instruction() until the machine stops, calling the hook
+ * before and after every instruction. The hook is a template parameter, so
+ * the loop without one has no trace of it left.
+ *
+ */
+template <typename HOOK>
+static void switch_loop(Machine &m, HOOK &hook)
+{
+    while (!m.stop)
+    {
+        hook.before(m);
+        process_instruction(m);
+        hook.after(m);
+    }
+}
+
+struct no_hook
+{
+    void before(Machine &) {}
+    void after(Machine &) {}
+};
+
+struct profile_hook
+{
+    profile &p;
+    uint8_t opcode;
+
+    void before(Machine &m)
+    {
+        opcode = m.mem[m.ip];
+        p.hits[m.ip]++;
+        p.executed++;
+    }
+
+    void after(Machine &m)
+    {
+        if (opcode == CALL) profile_call(p, m.ip);
+        else if (opcode == RET) profile_return(p);
+    }
+};
+
+struct trace_hook
+{
+    trace_writer &t;
+    trace_step step;
+
+    void before(Machine &m)
+    {
+        if (t.executed == t.next_checkpoint) trace_checkpoint(t, m);
+        begin_step(step, m);
+    }
+
+    void after(Machine &m)
+    {
+        trace_instruction(t, step, m);
+    }
+};
+
+/**
+ *
+ * Switch engine. Runs process_instruction() until the machine stops.
+ *
+ */
+void run_switch(Machine &m)
+{
+    no_hook hook;
+
+    switch_loop(m, hook);
+}
+
+/**
+ *
+ * Profiled switch engine. Runs like run_switch() and counts every
+ * executed instruction and every CALL and RET into the profile (see
+ * init_profile).
+ *
+ */
+void run_profiled(Machine &m, profile &p)
+{
+    profile_hook hook = {p, 0};
+
+    switch_loop(m, hook);
+}
+
+/**
+ *
+ * Traced switch engine. Runs like run_switch() and records every executed
+ * instruction into the trace (see open_trace).
+ *
+ */
+void run_traced(Machine &m, trace_writer &t)
+{
+    trace_hook hook = {t, {}};
+
+    switch_loop(m, hook);
+}
+
+/**
+ *
+ * Determines if an opcode ends a basic block (jumps, calls and returns).
+ *
+ */
+inline bool block_end(const uint8_t opcode)
+{
+    switch (opcode)
+    {
+        case JMP: case JZ: case JNZ: case JC: case JNC: case CALL: case RET:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ *
+ * Runs process_instruction() up to (and including) the next jump, call or
+ * return, one basic block of run_switch().
+ *
+ */
+void run_switch_block(Machine &m)
+{
+    while (!m.stop)
+    {
+        const uint8_t opcode = m.mem[m.ip];
+
+        process_instruction(m);
+
+        if (block_end(opcode)) return;
+    }
+}
+
+/**
+ *
+ * Threaded engine. Every handler jumps directly to the handler of the next
+ * opcode, so there is no central switch and each opcode gets its own
+ * indirect branch (which predicts a lot better). GCC and Clang get a
+ * computed goto version, other compilers call through the handler table.
+ * Both end in exactly the same state as run_switch(). With BLOCK set the
+ * jumps, calls and returns leave the loop, so the same dispatch can be run
+ * one basic block at a time.
+ *
+ */
+template <bool BLOCK>
+static void threaded_loop(Machine &m)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    void *labels[256];
+
+    for (auto &label : labels)
+    {
+        label = &&op_invalid;
+    }
+
+    labels[LOAD] = &&op_load;
+    labels[STORE] = &&op_store;
+    labels[STORER] = &&op_storer;
+    labels[SET] = &&op_set;
+    labels[PUSH] = &&op_push;
+    labels[POP] = &&op_pop;
+    labels[INC] = &&op_inc;
+    labels[DEC] = &&op_dec;
+    labels[JMP] = &&op_jmp;
+    labels[CMP] = &&op_cmp;
+    labels[CMPR] = &&op_cmpr;
+    labels[JZ] = &&op_jz;
+    labels[JNZ] = &&op_jnz;
+    labels[JC] = &&op_jc;
+    labels[JNC] = &&op_jnc;
+    labels[ADD] = &&op_add;
+    labels[ADDR] = &&op_addr;
+    labels[CALL] = &&op_call;
+    labels[RET] = &&op_ret;
+    labels[SUB] = &&op_sub;
+    labels[SUBR] = &&op_subr;
+    labels[MUL] = &&op_mul;
+    labels[MULR] = &&op_mulr;
+    labels[DIV] = &&op_div;
+    labels[DIVR] = &&op_divr;
+    labels[SHL] = &&op_shl;
+    labels[SHR] = &&op_shr;
+    labels[MEMCPY] = &&op_memcpy;
+    labels[MEMSET] = &&op_memset;
+    labels[MEMCMP] = &&op_memcmp;
+    labels[NOP] = &&op_nop;
+    labels[HALT] = &&op_halt;
+
+#define DISPATCH() do { if (m.stop) return; goto *labels[m.mem[m.ip]]; } while (0)
+#define BRANCH() do { if (BLOCK) return; DISPATCH(); } while (0)
+
+    DISPATCH();
+
+op_load:    load_instruction(m);     DISPATCH();
+op_store:   store_instruction(m);    DISPATCH();
+op_storer:  storer_instruction(m);   DISPATCH();
+op_set:     set_instruction(m);      DISPATCH();
+op_push:    push_instruction(m);     DISPATCH();
+op_pop:     pop_instruction(m);      DISPATCH();
+op_inc:     inc_instruction(m);      DISPATCH();
+op_dec:     dec_instruction(m);      DISPATCH();
+op_jmp:     jmp_instruction(m);      BRANCH();
+op_cmp:     cmp_instruction(m);      DISPATCH();
+op_cmpr:    cmpr_instruction(m);     DISPATCH();
+op_jz:      jz_instruction(m);       BRANCH();
+op_jnz:     jnz_instruction(m);      BRANCH();
+op_jc:      jc_instruction(m);       BRANCH();
+op_jnc:     jnc_instruction(m);      BRANCH();
+op_add:     add_instruction(m);      DISPATCH();
+op_addr:    addr_instruction(m);     DISPATCH();
+op_call:    call_instruction(m);     BRANCH();
+op_ret:     ret_instruction(m);      BRANCH();
+op_sub:     sub_instruction(m);      DISPATCH();
+op_subr:    subr_instruction(m);     DISPATCH();
+op_mul:     mul_instruction(m);      DISPATCH();
+op_mulr:    mulr_instruction(m);     DISPATCH();
+op_div:     divInstruction(m);       DISPATCH();
+op_divr:    divr_instruction(m);     DISPATCH();
+op_shl:     shl_instruction(m);      DISPATCH();
+op_shr:     shrInstruction(m);       DISPATCH();
+op_memcpy:  memcpy_instruction(m);   DISPATCH();
+op_memset:  memset_instruction(m);   DISPATCH();
+op_memcmp:  memcmp_instruction(m);   DISPATCH();
+op_nop:     nop_instruction(m);      DISPATCH();
+op_halt:    halt_instruction(m);     return;
+op_invalid: invalid_instruction(m);  return;
+
+#undef BRANCH
+#undef DISPATCH
+#else
+    const instruction_handler *handler = tables().handler;
+
+    while (!m.stop)
+    {
+        const uint8_t opcode = m.mem[m.ip];
+
+        handler[opcode](m);
+
+        if (BLOCK && block_end(opcode)) return;
+    }
+#endif
+}
+
+void run_threaded(Machine &m)
+{
+    threaded_loop<false>(m);
+}
+
+/**
+ *
+ * Runs the threaded engine up to (and including) the next jump, call or
+ * return.
+ *
+ */
+void run_threaded_block(Machine &m)
+{
+    threaded_loop<true>(m);
+}
+
+/* PREDECODED INSTRUCTIONS ***************************************************/
+
+/**
+ *
+ * Drops all predecoded instructions. Has to be called whenever the memory is
+ * changed behind the back of the machine (loading a program etc.).
+ *
+ */
+void flush_decode_cache(Machine &m)
+{
+    uint16_t page;
+
+    if (!m.decoded) return;
+
+    for (page = 0; page < 256; page++)
+    {
+        if (m.decoded->pages[page])
+        {
+            flush_decode_page(m, static_cast<uint8_t>(page));
+        }
+    }
+}
+
+/**
+ *
+ * Drops predecoded instructions covering a specific 256 byte page.
+ *
+ */
+void flush_decode_page(Machine &m, const uint8_t page)
+{
+    decode_cache &cache = *m.decoded;
+    const uint16_t start = static_cast<uint16_t>(page << 8);
+    uint16_t i;
+
+    for (i = 1; i < MAX_INSTRUCTION_LEN && i <= start; i++)
+    {
+        cache.instructions[start - i].length = 0;
+    }
+
+    for (i = 0; i < 256; i++)
+    {
+        cache.instructions[start + i].length = 0;
+        cache.bytes[start + i] = 0;
+    }
+
+    cache.pages[page] = 0;
+}
+
+/**
+ *
+ * Translates a register code to an index to r[]. Returns REG_INVALID for codes
+ * that are not general purpose registers.
+ *
+ */
+uint8_t decode_register(const uint8_t code)
+{
+    const uint8_t index = register_index(code);
+
+    return index < 8 ? index : REG_INVALID;
+}
+
+/**
+ *
+ * Decodes instruction at a specific address into the cache. Instructions with
+ * invalid operands (or reaching behind the end of memory) and DIV by zero
+ * are marked as fallback and are executed by the original handler, which
+ * also stops the machine the same way.
+ *
+ */
+static decoded_instruction &decode_instruction(Machine &m, const uint16_t address)
+{
+    decode_cache &cache = *m.decoded;
+    decoded_instruction &d = cache.instructions[address];
+    uint8_t operand[MAX_INSTRUCTION_LEN - 1] = {};
+    uint8_t i;
+
+    d.opcode = m.mem[address];
+    d.length = instruction_length(d.opcode);
+    d.fallback = 0;
+    d.value = 0;
+    d.address = 0;
+    d.reg[0] = d.reg[1] = d.reg[2] = 0;
+    d.fused = 0;
+    d.partner = 0;
+
+    for (i = 0; i < d.length && address + i <= MEM_SIZE; i++)
+    {
+        cache.bytes[address + i] = 1;
+        cache.pages[(address + i) >> 8] = 1;
+    }
+
+    if (static_cast<uint32_t>(address) + d.length > MEM_SIZE + 1)
+    {
+        d.fallback = 1;
+        return d;
+    }
+
+    for (i = 1; i < d.length; i++)
+    {
+        operand[i - 1] = m.mem[address + i];
+    }
+
+    switch (d.opcode)
+    {
+        case LOAD:
+            d.address = static_cast<uint16_t>((operand[0] << 8) + operand[1]);
+            d.reg[0] = decode_register(operand[2]);
+            break;
+        case STORE:
+            d.reg[0] = decode_register(operand[0]);
+            d.address = static_cast<uint16_t>((operand[1] << 8) + operand[2]);
+            break;
+        case STORER:
+        case MULR:
+        case DIVR:
+            d.reg[0] = decode_register(operand[0]);
+            d.reg[1] = decode_register(operand[1]);
+            d.reg[2] = decode_register(operand[2]);
+            break;
+        case MUL:
+        case DIV:
+            d.value = operand[0];
+            d.reg[1] = decode_register(operand[1]);
+            d.reg[2] = decode_register(operand[2]);
+            if (d.opcode == DIV && d.value == 0) d.fallback = 1;
+            break;
+        case SET:
+        case ADD:
+        case SUB:
+        case SHL:
+        case SHR:
+            d.value = operand[0];
+            d.reg[0] = decode_register(operand[1]);
+            break;
+        case CMP:
+            d.reg[0] = decode_register(operand[0]);
+            d.value = operand[1];
+            break;
+        case CMPR:
+        case ADDR:
+        case SUBR:
+            d.reg[0] = decode_register(operand[0]);
+            d.reg[1] = decode_register(operand[1]);
+            break;
+        case INC:
+        case DEC:
+            d.reg[0] = decode_register(operand[0]);
+            break;
+        case PUSH:
+        case POP:
+            d.reg[0] = register_index(operand[0]);
+            if (d.reg[0] == REG_C) d.reg[0] = REG_INVALID;
+            break;
+        case JZ:
+        case JNZ:
+            d.reg[0] = decode_register(operand[0]);
+            d.address = static_cast<uint16_t>((operand[1] << 8) + operand[2]);
+            break;
+        case JMP:
+        case JC:
+        case JNC:
+        case CALL:
+            d.address = static_cast<uint16_t>((operand[0] << 8) + operand[1]);
+            break;
+        case RET:
+        case NOP:
+            break;
+        default:
+            d.fallback = 1;
+            break;
+    }
+
+    if (d.reg[0] == REG_INVALID || d.reg[1] == REG_INVALID || d.reg[2] == REG_INVALID)
+    {
+        d.fallback = 1;
+    }
+
+    return d;
+}
+
+/**
+ *
+ * Determines if an instruction can be fused with a next instruction of the
+ * opcode (see execute_fused). PUSH and POP are only fused with general
+ * purpose registers, as IP, SP and BP change what the other one does.
+ *
+ */
+static bool fusable(const decoded_instruction &d, const uint8_t opcode)
+{
+    if (d.fallback) return false;
+
+    switch (d.opcode)
+    {
+        case DEC:
+            return opcode == JNZ;           /* of the same register */
+        case CMP:
+        case CMPR:
+            return opcode == JC || opcode == JNC;
+        case SET:
+            return opcode == STORER;
+        case PUSH:
+        case POP:
+            return opcode == d.opcode && d.reg[0] < 8;
+        default:
+            return false;
+    }
+}
+
+/**
+ *
+ * Decodes instruction at a specific address into the cache and fuses it with
+ * the next one where possible. DEC, CMP and CMPR do not use the address,
+ * so a fused one takes the target of its jump and the pair runs from its
+ * own record alone. The next instruction is decoded on its own
+ * (unless it already is), so a run of fusable instructions is fused in
+ * pairs as the execution reaches them. It is only decoded when the opcode
+ * fits, so an instruction is never left unfused just because the one in
+ * front of it looked at it. A fused pair covers at most MAX_INSTRUCTION_LEN
+ * bytes, so overwriting the second instruction drops the first one too.
+ *
+ */
+decoded_instruction &predecode(Machine &m, const uint16_t address)
+{
+    decoded_instruction &d = decode_instruction(m, address);
+    const uint32_t next = static_cast<uint32_t>(address) + d.length;
+
+    if (next + MAX_INSTRUCTION_LEN > MEM_SIZE + 1 || !fusable(d, m.mem[next])) return d;
+
+    const decoded_instruction &n = m.decoded->instructions[next].length
+        ? m.decoded->instructions[next]
+        : decode_instruction(m, static_cast<uint16_t>(next));
+
+    if (n.fallback || n.reg[0] >= 8 || d.length + n.length > MAX_INSTRUCTION_LEN) return d;
+    if (d.opcode == DEC && n.reg[0] != d.reg[0]) return d;
+
+    d.fused = n.length;
+    d.partner = n.opcode;
+
+    if (d.opcode == DEC || d.opcode == CMP || d.opcode == CMPR)
+    {
+        d.address = n.address;
+    }
+
+    return d;
+}
+
+/**
+ *
+ * Drops every predecoded instruction which covers the given address. An
+ * instruction (or a fused pair) is at most MAX_INSTRUCTION_LEN bytes long,
+ * so only the entries that many bytes up to the address have to be checked.
+ *
+ */
+void invalidate_decoded(Machine &m, const uint16_t address)
+{
+    decode_cache &cache = *m.decoded;
+
+    for (uint16_t i = 0; i < MAX_INSTRUCTION_LEN && i <= address; i++)
+    {
+        decoded_instruction &d = cache.instructions[address - i];
+        if (d.length + d.fused > i)
+        {
+            d.length = 0;
+        }
+    }
+
+    cache.bytes[address] = 0;
+
+    if (m.jit)
+    {
+        jit_code_written(m, address);
+    }
+}
+
+/**
+ *
+ * Writes a byte to the memory and keeps the decode cache coherent, so the
+ * self modifying code works.
+ *
+ */
+inline void write_memory(Machine &m, const uint16_t address, const uint8_t value)
+{
+    write_byte(m, address, value);
+
+    if (m.decoded->bytes[address])
+    {
+        invalidate_decoded(m, address);
+    }
+}
+
+/**
+ *
+ * Writes a byte to the memory of a machine from outside of its program
+ * (devices, the display), keeping the decoded and compiled code coherent
+ * the same way the writes of the program do. host_write goes through the
+ * mapped devices like the program does, ram_write always writes the
+ * memory (for the device handlers themselves).
+ *
+ */
+static void code_written(Machine &m, const uint16_t address)
+{
+    if (m.decoded)
+    {
+        if (m.decoded->bytes[address])
+        {
+            invalidate_decoded(m, address);
+        }
+    }
+    else
+    {
+        jit_code_written(m, address);
+    }
+}
+
+void host_write(Machine &m, const uint16_t address, const uint8_t value)
+{
+    write_byte(m, address, value);
+    code_written(m, address);
+}
+
+void ram_write(Machine &m, const uint16_t address, const uint8_t value)
+{
+    write_ram(m, address, value);
+    code_written(m, address);
+}
+
+/**
+ *
+ * Returns the record of the instruction at ip, decoding it first if needed.
+ * Every address is decoded only once (until it is overwritten) and the
+ * instruction is then executed from the cached record.
+ *
+ */
+inline const decoded_instruction &fetch_decoded(Machine &m)
+{
+    return m.decoded->instructions[m.ip].length
+        ? m.decoded->instructions[m.ip]
+        : predecode(m, m.ip);
+}
+
+/**
+ *
+ * Executes a record of the decode cache on its own (ignoring a fused next
+ * instruction) and returns its opcode.
+ *
+ */
+inline uint8_t execute_decoded(Machine &m, const decoded_instruction &d)
+{
+    uint16_t value;
+
+    const uint8_t opcode = d.opcode;
+
+    if (d.fallback)
+    {
+        tables().handler[opcode](m);
+        return opcode;
+    }
+
+    switch (d.opcode)
+    {
+        case LOAD:
+            m.r[d.reg[0]] = read_byte(m, d.address);
+            m.ip += LOAD_LEN;
+            break;
+        case STORE:
+            write_memory(m, d.address, m.r[d.reg[0]]);
+            m.ip += STORE_LEN;
+            break;
+        case STORER:
+            write_memory(m, static_cast<uint16_t>((m.r[d.reg[1]] << 8) + m.r[d.reg[2]]), m.r[d.reg[0]]);
+            m.ip += STORER_LEN;
+            break;
+        case SET:
+            m.r[d.reg[0]] = d.value;
+            m.ip += SET_LEN;
+            break;
+        case PUSH:
+            m.sp--;
+            if (d.reg[0] < 8)
+            {
+                write_memory(m, m.sp, m.r[d.reg[0]]);
+            }
+            else
+            {
+                value = word_register(m, d.reg[0]);
+                write_memory(m, m.sp, static_cast<uint8_t>(value & 0x00FF));
+                write_memory(m, static_cast<uint16_t>(m.sp - 1), static_cast<uint8_t>((value & 0xFF00) >> 8));
+                m.sp--;
+            }
+            m.ip += PUSH_LEN;
+            break;
+        case POP:
+            if (d.reg[0] < 8)
+            {
+                m.r[d.reg[0]] = read_byte(m, m.sp);
+                m.sp++;
+                m.ip += POP_LEN;
+                break;
+            }
+            value = (static_cast<uint16_t>(read_byte(m, m.sp)) << 8) + read_byte(m, static_cast<uint16_t>(m.sp + 1));
+            word_register(m, d.reg[0]) = value;
+            m.sp += 2;
+            m.ip += POP_LEN;
+            break;
+        case INC:
+            m.r[d.reg[0]]++;
+            m.c = m.r[d.reg[0]] == 0x00 ? 1 : 0;
+            m.ip += INC_LEN;
+            break;
+        case DEC:
+            m.r[d.reg[0]]--;
+            m.c = m.r[d.reg[0]] == 0xFF ? 1 : 0;
+            m.ip += DEC_LEN;
+            break;
+        case JMP:
+            m.ip = d.address;
+            break;
+        case CMP:
+            m.c = m.r[d.reg[0]] >= d.value ? 0 : 1;
+            m.r[d.reg[0]] -= d.value;
+            m.ip += CMP_LEN;
+            break;
+        case CMPR:
+            m.c = m.r[d.reg[0]] >= m.r[d.reg[1]] ? 0 : 1;
+            m.r[d.reg[0]] -= m.r[d.reg[1]];
+            m.ip += CMPR_LEN;
+            break;
+        case JZ:
+            m.ip = m.r[d.reg[0]] == 0 ? d.address : static_cast<uint16_t>(m.ip + JZ_LEN);
+            break;
+        case JNZ:
+            m.ip = m.r[d.reg[0]] != 0 ? d.address : static_cast<uint16_t>(m.ip + JNZ_LEN);
+            break;
+        case JC:
+            m.ip = m.c != 0 ? d.address : static_cast<uint16_t>(m.ip + JC_LEN);
+            break;
+        case JNC:
+            m.ip = m.c == 0 ? d.address : static_cast<uint16_t>(m.ip + JNC_LEN);
+            break;
+        case ADD:
+            m.c = static_cast<uint16_t>(m.r[d.reg[0]]) + static_cast<uint16_t>(d.value) > 0xFF ? 1 : 0;
+            m.r[d.reg[0]] += d.value;
+            m.ip += ADD_LEN;
+            break;
+        case ADDR:
+            m.c = static_cast<uint16_t>(m.r[d.reg[1]]) + static_cast<uint16_t>(m.r[d.reg[0]]) > 0xFF ? 1 : 0;
+            m.r[d.reg[1]] += m.r[d.reg[0]];
+            m.ip += ADDR_LEN;
+            break;
+        case CALL:
+            value = m.ip + CALL_LEN;
+            write_memory(m, static_cast<uint16_t>(m.sp - 2), static_cast<uint8_t>((value & 0xFF00) >> 8));
+            write_memory(m, static_cast<uint16_t>(m.sp - 1), static_cast<uint8_t>(value & 0x00FF));
+            m.sp -= 2;
+            m.ip = d.address;
+            break;
+        case RET:
+            m.ip = static_cast<uint16_t>(read_byte(m, m.sp) << 8);
+            m.ip += static_cast<uint16_t>(read_byte(m, static_cast<uint16_t>(m.sp + 1)));
+            m.sp += 2;
+            break;
+        case SUB:
+            m.c = m.r[d.reg[0]] < d.value ? 1 : 0;
+            m.r[d.reg[0]] -= d.value;
+            m.ip += SUB_LEN;
+            break;
+        case SUBR:
+            m.c = m.r[d.reg[1]] < m.r[d.reg[0]] ? 1 : 0;
+            m.r[d.reg[1]] -= m.r[d.reg[0]];
+            m.ip += SUBR_LEN;
+            break;
+        case MUL:
+            value = static_cast<uint16_t>(m.r[d.reg[2]]) * static_cast<uint16_t>(d.value);
+            m.r[d.reg[2]] = static_cast<uint8_t>(value & 0x00FF);
+            m.c = value > 0xFF ? 1 : 0;
+            m.r[d.reg[1]] = static_cast<uint8_t>((value & 0xFF00) >> 8);
+            m.ip += MUL_LEN;
+            break;
+        case MULR:
+            value = static_cast<uint16_t>(m.r[d.reg[2]]) * static_cast<uint16_t>(m.r[d.reg[0]]);
+            m.r[d.reg[2]] = static_cast<uint8_t>(value & 0x00FF);
+            m.c = value > 0xFF ? 1 : 0;
+            m.r[d.reg[1]] = static_cast<uint8_t>((value & 0xFF00) >> 8);
+            m.ip += MULR_LEN;
+            break;
+        case DIV:
+            value = m.r[d.reg[1]] % d.value;
+            m.r[d.reg[1]] = m.r[d.reg[1]] / d.value;
+            m.r[d.reg[2]] = static_cast<uint8_t>(value);
+            m.ip += DIV_LEN;
+            break;
+        case DIVR:
+            value = m.r[d.reg[0]];
+            if (value == 0)
+            {
+                m.stop = STOP_DIVIDE_BY_ZERO;
+                break;
+            }
+            {
+                const uint8_t rest = m.r[d.reg[1]] % value;
+                m.r[d.reg[1]] = m.r[d.reg[1]] / value;
+                m.r[d.reg[2]] = rest;
+            }
+            m.ip += DIVR_LEN;
+            break;
+        case SHL:
+            m.c = m.r[d.reg[0]] << (d.value - 1) > 127 ? 1 : 0;
+            m.r[d.reg[0]] <<= d.value;
+            m.ip += SHL_LEN;
+            break;
+        case SHR:
+            m.c = (m.r[d.reg[0]] >> (d.value - 1)) % 2;
+            m.r[d.reg[0]] >>= d.value;
+            m.ip += SHR_LEN;
+            break;
+        case NOP:
+            m.ip += NOP_LEN;
+            break;
+        case HALT:
+            m.stop = STOP_HALT;
+            break;
+        default:
+            m.stop = STOP_INVALID_OPCODE;
+            break;
+    }
+
+    return opcode;
+}
+
+/**
+ *
+ * Executes a fused pair (see predecode) with one dispatch. Registers, flags,
+ * the memory and ip end up exactly as after the two instructions. A PUSH
+ * writing over the second one stops after the first, so the second is
+ * decoded again, and so does a PUSH or POP whose access stopped the machine
+ * (a device such as a watchpoint). Returns the number of executed
+ * instructions.
+ *
+ */
+inline uint32_t execute_fused(Machine &m, const decoded_instruction &d)
+{
+    const uint16_t second = static_cast<uint16_t>(m.ip + d.length);
+    const uint16_t next = static_cast<uint16_t>(second + d.fused);
+    const decoded_instruction &n = m.decoded->instructions[second];
+    uint8_t value, carry;
+
+    switch (d.opcode)
+    {
+        case DEC:
+            value = static_cast<uint8_t>(m.r[d.reg[0]] - 1);
+            m.r[d.reg[0]] = value;
+            m.c = value == 0xFF ? 1 : 0;
+            m.ip = value != 0 ? d.address : next;
+            break;
+        case CMP:
+            value = m.r[d.reg[0]];
+            carry = value >= d.value ? 0 : 1;
+            m.c = carry;
+            m.r[d.reg[0]] = static_cast<uint8_t>(value - d.value);
+            m.ip = carry == (d.partner == JC ? 1 : 0) ? d.address : next;
+            break;
+        case CMPR:
+            value = m.r[d.reg[0]];
+            carry = value >= m.r[d.reg[1]] ? 0 : 1;
+            m.c = carry;
+            m.r[d.reg[0]] = static_cast<uint8_t>(value - m.r[d.reg[1]]);
+            m.ip = carry == (d.partner == JC ? 1 : 0) ? d.address : next;
+            break;
+        case SET:
+            m.r[d.reg[0]] = d.value;
+            m.ip = second;
+            write_memory(m, static_cast<uint16_t>((m.r[n.reg[1]] << 8) + m.r[n.reg[2]]), m.r[n.reg[0]]);
+            m.ip = next;
+            break;
+        case PUSH:
+            m.sp--;
+            write_memory(m, m.sp, m.r[d.reg[0]]);
+            m.ip = second;
+            if (!d.length || m.stop) return 1;
+            m.sp--;
+            write_memory(m, m.sp, m.r[n.reg[0]]);
+            m.ip = next;
+            break;
+        default:
+            m.r[d.reg[0]] = read_byte(m, m.sp);
+            m.sp++;
+            m.ip = second;
+            if (m.stop) return 1;
+            m.r[n.reg[0]] = read_byte(m, m.sp);
+            m.sp++;
+            m.ip = next;
+            break;
+    }
+
+    return 2;
+}
+
+/**
+ *
+ * Creates the decode cache of the machine if it does not have one yet.
+ *
+ */
+void ensure_decode_cache(Machine &m)
+{
+    if (!m.decoded)
+    {
+        m.decoded.reset(new decode_cache());
+    }
+}
+
+/**
+ *
+ * Predecoded engine. Results in exactly the same state as run_switch().
+ *
+ */
+void run_predecoded(Machine &m)
+{
+    ensure_decode_cache(m);
+
+    while (!m.stop)
+    {
+        const decoded_instruction &d = fetch_decoded(m);
+
+        if (d.fused)
+        {
+            execute_fused(m, d);
+        }
+        else
+        {
+            execute_decoded(m, d);
+        }
+    }
+}
+
+/**
+ *
+ * Runs predecoded instructions up to (and including) the next jump, call or
+ * return, or limit instructions of straight code at most. Returns the
+ * number of executed instructions.
+ *
+ */
+inline uint32_t predecoded_block(Machine &m, const uint32_t limit)
+{
+    uint32_t executed = 0;
+
+    while (!m.stop && executed < limit)
+    {
+        const decoded_instruction &d = fetch_decoded(m);
+        uint8_t opcode;
+
+        if (d.fused)
+        {
+            const uint32_t count = execute_fused(m, d);
+
+            opcode = count == 2 ? d.partner : d.opcode;
+            executed += count;
+        }
+        else
+        {
+            opcode = execute_decoded(m, d);
+            executed++;
+        }
+
+        if (block_end(opcode)) return executed;
+    }
+
+    return executed;
+}
+
+/**
+ *
+ * Runs predecoded instructions up to (and including) the next jump, call or
+ * return, so the caller gets control back at the start of a basic block.
+ *
+ */
+void run_predecoded_block(Machine &m)
+{
+    ensure_decode_cache(m);
+    predecoded_block(m, UINT32_MAX);
+}
+
+/**
+ *
+ * Runs predecoded basic blocks until the machine stops or has executed at
+ * least budget instructions. The budget is only checked when a block ends
+ * (or after BLOCK_LIMIT instructions of straight code), so it may be passed
+ * by the rest of a block, and the machine is always left at the start of
+ * one. Adds the executed instructions to executed and returns the stop
+ * reason, STOP_BUDGET if the machine can be resumed by another call.
+ *
+ */
+uint8_t run_budget(Machine &m, const uint64_t budget, uint64_t &executed)
+{
+    uint64_t done = 0;
+
+    ensure_decode_cache(m);
+
+    while (!m.stop && done < budget)
+    {
+        done += predecoded_block(m, BLOCK_LIMIT);
+    }
+
+    executed += done;
+    return m.stop ? m.stop : STOP_BUDGET;
+}
+
+/**
+ *
+ * Runs at most budget predecoded instructions, so a machine can be resumed
+ * later. Returns the number of executed instructions.
+ *
+ */
+uint32_t run_slice(Machine &m, const uint32_t budget)
+{
+    uint32_t executed = 0;
+
+    ensure_decode_cache(m);
+
+    while (!m.stop && executed < budget)
+    {
+        const decoded_instruction &d = fetch_decoded(m);
+
+        if (d.fused && executed + 1 < budget)
+        {
+            executed += execute_fused(m, d);
+        }
+        else
+        {
+            execute_decoded(m, d);
+            executed++;
+        }
+    }
+
+    return executed;
+}
+
+/**
+ *
+ * Runs predecoded instructions until the cycle counter of the machine
+ * reaches the target (or the machine stops). The instruction reaching it
+ * is completed, so the counter may pass the target by a few cycles at
+ * most. Returns the cycle counter.
+ *
+ */
+uint64_t run_cycles(Machine &m, const uint64_t target)
+{
+    const uint8_t *cycles = tables().cycles;
+
+    ensure_decode_cache(m);
+
+    while (!m.stop && m.cycles < target)
+    {
+        const decoded_instruction &d = fetch_decoded(m);
+
+        if (d.fused)
+        {
+            m.cycles += cycles[d.opcode];
+            if (execute_fused(m, d) == 2) m.cycles += cycles[d.partner];
+        }
+        else
+        {
+            m.cycles += cycles[execute_decoded(m, d)];
+        }
+    }
+
+    return m.cycles;
+}
+
+uint8_t instruction_cycles(const uint8_t opcode)
+{
+    return tables().cycles[opcode];
+}
+
+/* SNAPSHOTS *****************************************************************/
+
+/**
+ *
+ * Copies one 256 byte page to the memory of a machine and drops the code
+ * decoded or compiled from its previous content.
+ *
+ */
+void copy_page(Machine &m, const uint8_t *source, const uint8_t page)
+{
+    const uint16_t start = static_cast<uint16_t>(page << 8);
+
+    uint32_t block;
+
+    memcpy(m.mem + start, source + start, 256);
+
+    for (block = start; block < start + 256u; block += 8)
+    {
+        const uint16_t video = static_cast<uint16_t>(block - VIDEO_MEM_ADDRESS);
+        if (video < VIDEO_RANGE_SIZE) m.video_dirty[video >> 3] = 1;
+    }
+
+    if (m.decoded && m.decoded->pages[page])
+    {
+        flush_decode_page(m, page);
+    }
+
+    jit_page_changed(m, page);
+}
+
+/**
+ *
+ * Takes an immutable snapshot of the machine state. The machine continues
+ * from the snapshot, so its dirty pages are tracked against it from now on.
+ *
+ */
+std::shared_ptr<const machine_snapshot> take_snapshot(Machine &m)
+{
+    std::shared_ptr<machine_snapshot> snapshot(new machine_snapshot());
+    uint16_t i;
+
+    memcpy(snapshot->r, m.r, sizeof(snapshot->r));
+    snapshot->ip = m.ip;
+    snapshot->sp = m.sp;
+    snapshot->bp = m.bp;
+    snapshot->c = m.c;
+    snapshot->cycles = m.cycles;
+    memcpy(snapshot->mem, m.mem, sizeof(m.mem));
+
+    m.origin = snapshot;
+    for (i = 0; i < 256; i++)
+    {
+        m.dirty[i] = 0;
+    }
+
+    return snapshot;
+}
+
+/**
+ *
+ * Puts a machine to the state of a snapshot. If the machine already runs
+ * from the same snapshot, only the pages written since then are copied, all
+ * the other pages (including their decoded code) are kept.
+ *
+ */
+void restore_snapshot(Machine &m, const std::shared_ptr<const machine_snapshot> &snapshot)
+{
+    const bool same = m.origin == snapshot;
+    uint16_t page;
+
+    for (page = 0; page < 256; page++)
+    {
+        if (!same || m.dirty[page])
+        {
+            copy_page(m, snapshot->mem, static_cast<uint8_t>(page));
+        }
+        m.dirty[page] = 0;
+    }
+
+    memcpy(m.r, snapshot->r, sizeof(snapshot->r));
+    m.ip = snapshot->ip;
+    m.sp = snapshot->sp;
+    m.bp = snapshot->bp;
+    m.c = snapshot->c;
+    m.sink = 0;
+    m.cycles = snapshot->cycles;
+    m.stop = 0;
+    m.origin = snapshot;
+}
+
+/**
+ *
+ * Clones a running machine into another one. When both run from the same
+ * snapshot, only the pages dirty in either of them are copied.
+ *
+ */
+void fork_machine(const Machine &parent, Machine &child)
+{
+    const bool same = parent.origin && child.origin == parent.origin;
+    uint16_t page;
+
+    for (page = 0; page < 256; page++)
+    {
+        if (!same || parent.dirty[page] || child.dirty[page])
+        {
+            copy_page(child, parent.mem, static_cast<uint8_t>(page));
+        }
+        child.dirty[page] = parent.dirty[page];
+    }
+
+    memcpy(child.r, parent.r, sizeof(parent.r));
+    child.ip = parent.ip;
+    child.sp = parent.sp;
+    child.bp = parent.bp;
+    child.c = parent.c;
+    child.sink = parent.sink;
+    child.cycles = parent.cycles;
+    child.stop = parent.stop;
+    child.origin = parent.origin;
+}
+
+/* MEMORY MAPPED I/O *********************************************************/
+
+/**
+ *
+ * Maps a device to all the pages between two addresses (both included),
+ * nullptr maps the pages back to plain memory. One page has one device at
+ * most, the later mapping wins. The device has to live as long as it is
+ * mapped. Compiled code is dropped as it may access the pages directly.
+ *
+ */
+void map_io(Machine &m, const uint16_t first, const uint16_t last, const io_device *device)
+{
+    uint32_t page;
+
+    for (page = first >> 8; page <= static_cast<uint32_t>(last >> 8); page++)
+    {
+        m.io[page] = device;
+    }
+
+    jit_reset(m);
+}
+
+/**
+ *
+ * Determines if any mapped device handles reads.
+ *
+ */
+bool has_io_reads(const Machine &m)
+{
+    uint32_t page;
+
+    for (page = 0; page < 256; page++)
+    {
+        if (m.io[page] && m.io[page]->read) return true;
+    }
+
+    return false;
+}
+
+/* PROGRAMS ******************************************************************/
+
+/**
+ *
+ * Initializes the machine and loads a program into it. Binary images (see
+ * image.h) are mapped and their segments copied straight to the memory, any
+ * other file is taken as a raw memory dump loaded from address 0.
+ *
+ */
+bool load_program(Machine &m, const std::string &filename)
+{
+    init_machine(m);
+
+    if (is_image_file(filename))
+    {
+        image_file image;
+
+        if (!map_image(filename, image)) return false;
+
+        load_image(image, m.mem);
+        m.ip = image.header->entry;
+        unmap_image(image);
+        return true;
+    }
+
+    std::ifstream file(filename, std::ios::binary);
+
+    if (!file) return false;
+
+    file.read(reinterpret_cast<char *>(m.mem), sizeof(m.mem));
+    return file.gcount() > 0 && file.peek() == EOF;
+}
+
+/* OUTPUT ********************************************************************/
+
+/**
+ *
+ * Prints Memory
+ *
+ */
+void print_memory(const Machine &m)
+{
+    for (uint16_t i = 0; i < MEM_SIZE; i++)
+    {
+        if (i % 64 == 0)
+        {
+            // ReSharper disable once CppPrintfRiskyFormat
+            printf("\n%#06x:", i);
+        }
+
+        printf(" %02x", m.mem[i]);
+    }
+
+    printf("\n");
+}
+
+/**
+ *
+ * Print registers
+ *
+ */
+void print_registers(const Machine &m)
+{
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        printf("R%d = 0x%02x ", i, m.r[i]);
+    }
+
+    printf("IP = 0x%04x ", m.ip);
+    printf("SP = 0x%04x ", m.sp);
+    printf("BP = 0x%04x ", m.bp);
+    printf("C = %d\n", m.c ? 1 : 0);
+}
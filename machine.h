@@ -0,0 +1,262 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    machine.h                                                        */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* State of one virtual machine and its execution engines. All the state     */
+/* lives in the Machine structure, so any number of machines can be run in   */
+/* one process as long as each of them is run by one thread at a time.       */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef __MACHINE_H_
+#define __MACHINE_H_
+
+/* INCLUDES ******************************************************************/
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "definitions.h"
+
+/* REGISTER OPERANDS *********************************************************/
+
+/**
+ *
+ * Indexes of the register operand codes (IR0 - IC) in the register file:
+ * R0 - R7 are the indexes to r[], then the 16 bit and the flag registers.
+ * The codes are translated by one table lookup, so no handler has to
+ * switch over them.
+ *
+ */
+
+#define REG_IP      8           /* instruction pointer (PUSH/POP)            */
+#define REG_SP      9           /* stack pointer (PUSH/POP)                  */
+#define REG_BP      10          /* stack frame pointer (PUSH/POP)            */
+#define REG_C       11          /* carry flag                                */
+#define REG_INVALID 0xFF        /* not a register                            */
+
+/* STOP REASONS **************************************************************/
+
+/**
+ *
+ * Why a machine stopped, kept in its stop trigger. HALT and the faults stop
+ * the machine for good, an invalid register operand still completes the
+ * instruction (ip is behind it), an invalid opcode and a division by zero
+ * leave ip at it (the registers are not changed). A break
+ * is set by the device handlers of the debugger after the instruction which
+ * hit a watchpoint, the debugger clears it to resume. The budget is only
+ * returned by run_budget, the machine can be resumed.
+ *
+ */
+
+#define STOP_RUNNING            0x00    /* not stopped                       */
+#define STOP_HALT               0x01    /* HALT instruction                  */
+#define STOP_INVALID_OPCODE     0x02    /* unknown instruction               */
+#define STOP_INVALID_REGISTER   0x04    /* invalid register operand          */
+#define STOP_BREAK              0x08    /* watchpoint hit (debugger)         */
+#define STOP_DIVIDE_BY_ZERO     0x10    /* DIV or DIVR by zero               */
+#define STOP_BUDGET             0x80    /* instruction budget used up        */
+
+#define BLOCK_LIMIT             256     /* straight instructions per check   */
+
+/* PREDECODED INSTRUCTIONS ***************************************************/
+
+/**
+ *
+ * An instruction decoded once from the memory. Register operands are already
+ * translated to indexes to r[] and addresses are already put together, so the
+ * predecoded engine does not have to look at the instruction bytes again.
+ * Common pairs (DEC + JNZ, CMP/CMPR + JC/JNC, SET + STORER, PUSH + PUSH and
+ * POP + POP) are fused: the record of the first instruction also runs the
+ * one behind it, whose record is then read directly without a dispatch.
+ *
+ */
+struct decoded_instruction
+{
+    uint8_t  opcode;            /* instruction opcode                        */
+    uint8_t  length;            /* instruction length, 0 - not decoded yet   */
+    uint8_t  fallback;          /* run the original handler instead         */
+    uint8_t  value;             /* 8 bit immediate value                     */
+    uint8_t  reg[3];            /* register operands (REG_* indexes)         */
+    uint16_t address;           /* 16 bit address operand                    */
+    uint8_t  fused;             /* length of the fused next one, 0 - none    */
+    uint8_t  partner;           /* opcode of the fused next one              */
+};
+
+
+/**
+ *
+ * Decoded instructions of one machine, one record per address.
+ *
+ */
+struct decode_cache
+{
+    decoded_instruction instructions[MEM_SIZE + 1];
+    uint8_t bytes[MEM_SIZE + 1];        /* covered by a decoded instruction  */
+    uint8_t pages[256];                 /* pages with decoded bytes          */
+};
+
+/* SNAPSHOTS *****************************************************************/
+
+/**
+ *
+ * Immutable state of a machine shared by any number of machines started or
+ * restored from it.
+ *
+ */
+struct machine_snapshot
+{
+    uint8_t  r[8];
+    uint16_t ip;
+    uint16_t sp;
+    uint16_t bp;
+    uint8_t  c;
+    uint64_t cycles;
+    uint8_t  mem[MEM_SIZE + 1];
+};
+
+/* MEMORY MAPPED I/O *********************************************************/
+
+struct Machine;
+
+typedef uint8_t (*io_read_handler)(Machine &m, void *context, uint16_t address);
+typedef void (*io_write_handler)(Machine &m, void *context, uint16_t address, uint8_t value);
+
+/**
+ *
+ * Device mapped to one or more 256 byte pages of the memory. Accesses of
+ * its pages call its handlers instead of touching the memory, a missing
+ * handler leaves that kind of access to the memory. The handlers run on
+ * the thread running the machine.
+ *
+ */
+struct io_device
+{
+    io_read_handler  read;      /* value read from an address or nullptr     */
+    io_write_handler write;     /* value written to an address or nullptr    */
+    void            *context;   /* passed to the handlers                    */
+};
+
+/* MACHINE *******************************************************************/
+
+struct jit_context;
+struct profile;
+struct trace_writer;
+
+struct jit_context_deleter
+{
+    void operator()(jit_context *context) const;
+};
+
+struct Machine
+{
+    /* registers */
+
+    uint8_t  r[8];              /* general purpose registers                 */
+    uint16_t ip;                /* instruction pointer                       */
+    uint16_t sp;                /* stack pointer                             */
+    uint16_t bp;                /* stack frame pointer                       */
+    uint8_t  sink;              /* read and written by invalid operands      */
+
+    /* flags registers */
+
+    uint8_t  c;                 /* carry flag                                */
+
+    /* special triggers */
+
+    uint8_t  stop;              /* should stop the machine? (STOP_*)         */
+
+    /* cycles executed by run_cycles (see the *_CYC definitions) */
+
+    uint64_t cycles;
+
+    /* memory (one byte more, so every 16 bit address is valid) */
+
+    uint8_t  mem[MEM_SIZE + 1]; /* random access memory                      */
+
+    /* snapshot the memory comes from and 256 byte pages written since */
+
+    std::shared_ptr<const machine_snapshot> origin;
+    uint8_t  dirty[256];
+
+    /* 8 byte blocks of the video memory written since the display drew them */
+
+    uint8_t  video_dirty[VIDEO_BLOCKS];
+
+    /* devices mapped to the pages, nullptr for plain memory (not part of
+       the state of the machine, so it is kept over init and restore) */
+
+    const io_device *io[256] = {};
+
+    /* engine caches, created by the engines when needed */
+
+    std::unique_ptr<decode_cache> decoded;
+    std::unique_ptr<jit_context, jit_context_deleter> jit;
+};
+
+/* MACHINE CODE **************************************************************/
+
+void init_machine(Machine &m);
+void process_instruction(Machine &m);
+uint8_t instruction_length(uint8_t opcode);
+const char *instruction_name(uint8_t opcode);
+const char *stop_reason(uint8_t reason);
+
+/* engines */
+
+void run_switch(Machine &m);
+void run_threaded(Machine &m);
+void run_predecoded(Machine &m);
+void run_jit(Machine &m);
+void run_profiled(Machine &m, profile &p);
+void run_traced(Machine &m, trace_writer &t);
+uint32_t run_slice(Machine &m, uint32_t budget);
+uint8_t run_budget(Machine &m, uint64_t budget, uint64_t &executed);
+uint64_t run_cycles(Machine &m, uint64_t target);
+uint8_t instruction_cycles(uint8_t opcode);
+
+/* engines run one basic block at a time (up to and including the next
+   jump, call or return), all of them stopping at the same points */
+
+void run_switch_block(Machine &m);
+void run_threaded_block(Machine &m);
+void run_predecoded_block(Machine &m);
+void run_jit_block(Machine &m);
+
+/* decode cache */
+
+void ensure_decode_cache(Machine &m);
+void flush_decode_cache(Machine &m);
+void flush_decode_page(Machine &m, uint8_t page);
+decoded_instruction &predecode(Machine &m, uint16_t address);
+
+/* snapshots */
+
+std::shared_ptr<const machine_snapshot> take_snapshot(Machine &m);
+void restore_snapshot(Machine &m, const std::shared_ptr<const machine_snapshot> &snapshot);
+void fork_machine(const Machine &parent, Machine &child);
+
+/* host access */
+
+void host_write(Machine &m, uint16_t address, uint8_t value);
+void ram_write(Machine &m, uint16_t address, uint8_t value);
+
+/* memory mapped I/O */
+
+void map_io(Machine &m, uint16_t first, uint16_t last, const io_device *device);
+bool has_io_reads(const Machine &m);
+
+/* programs */
+
+bool load_program(Machine &m, const std::string &filename);
+
+/* output */
+
+void print_memory(const Machine &m);
+void print_registers(const Machine &m);
+
+#endif
@@ -26,11 +26,11 @@ namespace my_string {
     std::string trim_right(const std::string &str)
     {
         if (str.empty()) return "";
-        for (auto i = str.size() - 1; i > 0; i--)
+        for (auto i = str.size(); i > 0; i--)
         {
-            if (!std::isspace(str[i]))
+            if (!std::isspace(str[i - 1]))
             {
-                return str.substr(0, i + 1);
+                return str.substr(0, i);
             }
         }
         return "";
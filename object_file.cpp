@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "assembly_parser.h"
+#include "object_file.h"
+
+namespace assembler {
+
+    const uint32_t object_magic = 0x424F3853;  // "S8OB"
+    const uint16_t object_version = 2;
+
+    const uint8_t flag_known = 0x01;
+    const uint8_t flag_fixed = 0x02;
+    const uint8_t flag_instruction = 0x08;
+
+    /**
+     * FNV-1a hash (64 bit).
+     */
+    uint64_t hash_bytes(const char *bytes, const size_t size)
+    {
+        uint64_t value = 14695981039346656037ull;
+        for (size_t i = 0; i < size; i++)
+        {
+            value ^= static_cast<uint8_t>(bytes[i]);
+            value *= 1099511628211ull;
+        }
+        return value;
+    }
+
+    bool hash_file(const std::string &filename, uint64_t &hash)
+    {
+        assembly_parser::mapped_source source;
+
+        if (!assembly_parser::map_source(filename, source)) return false;
+
+        hash = hash_bytes(source.base, source.size);
+        assembly_parser::unmap_source(source);
+        return true;
+    }
+
+    /**
+     * Little endian writer and bounds checked reader of the object files.
+     */
+    class object_writer
+    {
+    public:
+        std::vector<char> data;
+
+        void put(const uint64_t value, const int size)
+        {
+            for (auto i = 0; i < size; i++) data.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+        }
+
+        void put_string(const std::string &text)
+        {
+            put(text.size(), 4);
+            data.insert(data.end(), text.begin(), text.end());
+        }
+    };
+
+    class object_reader
+    {
+    public:
+        const std::vector<char> &data;
+        size_t pos{};
+        bool failed{};
+
+        explicit object_reader(const std::vector<char> &data) : data(data) {}
+
+        uint64_t get(const int size)
+        {
+            uint64_t value = 0;
+
+            if (data.size() - pos < static_cast<size_t>(size))
+            {
+                failed = true;
+                return 0;
+            }
+
+            for (auto i = 0; i < size; i++) value |= static_cast<uint64_t>(static_cast<uint8_t>(data[pos++])) << (i * 8);
+            return value;
+        }
+
+        std::string get_string()
+        {
+            const auto size = static_cast<size_t>(get(4));
+
+            if (failed || data.size() - pos < size)
+            {
+                failed = true;
+                return "";
+            }
+
+            pos += size;
+            return std::string(data.data() + pos - size, size);
+        }
+    };
+
+    object_cache::object_cache(std::string directory) : directory(std::move(directory))
+    {
+    }
+
+    std::string object_path(const std::string &directory, const std::string &source)
+    {
+        std::error_code error;
+        const auto absolute = std::filesystem::absolute(source, error).string();
+        const auto key = error ? source : absolute;
+        char name[32];
+
+        snprintf(name, sizeof(name), "%016llx.s8o", static_cast<unsigned long long>(hash_bytes(key.data(), key.size())));
+        return (std::filesystem::path(directory) / name).string();
+    }
+
+    std::string object_cache::object_path(const std::string &source) const
+    {
+        return assembler::object_path(directory, source);
+    }
+
+    bool read_file(const std::string &filename, std::vector<char> &data)
+    {
+        std::ifstream file(filename, std::ios::binary);
+
+        if (!file.is_open()) return false;
+
+        file.seekg(0, std::ios::end);
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0, std::ios::beg);
+        file.read(data.data(), static_cast<std::streamsize>(data.size()));
+        return static_cast<bool>(file);
+    }
+
+    /**
+     * Reads the header of the object only and compares the content hashes.
+     */
+    bool object_cache::is_current(const std::string &source) const
+    {
+        std::ifstream file(object_path(source), std::ios::binary);
+        std::vector<char> header(16);
+        uint64_t hash = 0;
+
+        if (!file.read(header.data(), static_cast<std::streamsize>(header.size()))) return false;
+
+        object_reader reader(header);
+        if (reader.get(4) != object_magic || reader.get(2) != object_version) return false;
+        reader.get(2);
+
+        return hash_file(source, hash) && reader.get(8) == hash;
+    }
+
+    bool object_cache::load(const std::string &source, const uint64_t content_hash, object_file &object) const
+    {
+        std::vector<char> data;
+
+        if (!read_file(object_path(source), data)) return false;
+
+        object_reader reader(data);
+        if (reader.get(4) != object_magic || reader.get(2) != object_version) return false;
+        reader.get(2);
+
+        object = object_file();
+        object.content_hash = reader.get(8);
+        if (object.content_hash != content_hash) return false;
+
+        const auto count = static_cast<size_t>(reader.get(4));
+        object.entries.reserve(std::min(count, data.size()));
+
+        for (size_t i = 0; i < count && !reader.failed; i++)
+        {
+            object.entries.emplace_back();
+            auto &entry = object.entries.back();
+
+            entry.kind = static_cast<entry_kind>(reader.get(1));
+            const auto flags = static_cast<uint8_t>(reader.get(1));
+            entry.known = (flags & flag_known) != 0;
+            entry.fixed = (flags & flag_fixed) != 0;
+            entry.instruction = (flags & flag_instruction) != 0;
+            entry.line = static_cast<int>(reader.get(4));
+            entry.name = reader.get_string();
+            entry.value = static_cast<int>(static_cast<int32_t>(reader.get(4)));
+            entry.alias = reader.get_string();
+            entry.address = static_cast<uint32_t>(reader.get(4));
+            entry.size = static_cast<uint32_t>(reader.get(4));
+
+            const auto byte_count = static_cast<size_t>(reader.get(4));
+            if (reader.failed || data.size() - reader.pos < byte_count) return false;
+            entry.bytes.assign(data.begin() + static_cast<std::ptrdiff_t>(reader.pos),
+                               data.begin() + static_cast<std::ptrdiff_t>(reader.pos + byte_count));
+            reader.pos += byte_count;
+
+            const auto run_count = static_cast<size_t>(reader.get(4));
+            uint64_t run_bytes = 0;
+            uint64_t run_size = 0;
+
+            for (size_t r = 0; r < run_count && !reader.failed; r++)
+            {
+                data_run run;
+                run.size = static_cast<uint32_t>(reader.get(4));
+                run.count = static_cast<uint32_t>(reader.get(4));
+
+                run_bytes += run.size;
+                run_size += static_cast<uint64_t>(run.size) * run.count;
+                entry.runs.push_back(run);
+            }
+
+            if (run_count && (run_bytes != entry.bytes.size() || run_size != entry.size)) return false;
+
+            const auto relocation_count = static_cast<size_t>(reader.get(4));
+            for (size_t r = 0; r < relocation_count && !reader.failed; r++)
+            {
+                relocation fixup;
+                fixup.offset = static_cast<uint32_t>(reader.get(4));
+                fixup.kind = static_cast<relocation_kind>(reader.get(1));
+                fixup.symbol = reader.get_string();
+
+                if (fixup.offset + (fixup.kind == relocation_kind::address ? 2u : 1u) > entry.bytes.size()) return false;
+                entry.relocations.push_back(fixup);
+            }
+
+            if (entry.kind > entry_kind::check) return false;
+        }
+
+        return !reader.failed && reader.pos == data.size();
+    }
+
+    /**
+     * Writes the object to a temporary file renamed over the old one, so a
+     * concurrent build never reads half an object.
+     */
+    bool object_cache::store(const std::string &source, const object_file &object) const
+    {
+        object_writer writer;
+
+        writer.put(object_magic, 4);
+        writer.put(object_version, 2);
+        writer.put(0, 2);
+        writer.put(object.content_hash, 8);
+        writer.put(object.entries.size(), 4);
+
+        for (const auto &entry : object.entries)
+        {
+            const auto flags = (entry.known ? flag_known : 0) | (entry.fixed ? flag_fixed : 0) |
+                               (entry.instruction ? flag_instruction : 0);
+
+            writer.put(static_cast<uint8_t>(entry.kind), 1);
+            writer.put(static_cast<uint64_t>(flags), 1);
+            writer.put(static_cast<uint32_t>(entry.line), 4);
+            writer.put_string(entry.name);
+            writer.put(static_cast<uint32_t>(entry.value), 4);
+            writer.put_string(entry.alias);
+            writer.put(entry.address, 4);
+            writer.put(entry.size, 4);
+            writer.put(entry.bytes.size(), 4);
+            writer.data.insert(writer.data.end(), entry.bytes.begin(), entry.bytes.end());
+            writer.put(entry.runs.size(), 4);
+
+            for (const auto &run : entry.runs)
+            {
+                writer.put(run.size, 4);
+                writer.put(run.count, 4);
+            }
+
+            writer.put(entry.relocations.size(), 4);
+
+            for (const auto &fixup : entry.relocations)
+            {
+                writer.put(fixup.offset, 4);
+                writer.put(static_cast<uint8_t>(fixup.kind), 1);
+                writer.put_string(fixup.symbol);
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+
+        const auto path = object_path(source);
+        const auto temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.write(writer.data.data(), static_cast<std::streamsize>(writer.data.size()))) return false;
+        }
+
+        std::filesystem::rename(temporary, path, error);
+        return !error;
+    }
+
+}
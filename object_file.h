@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace assembler {
+
+    enum class entry_kind : uint8_t
+    {
+        def,        // DEF constant (known) or alias
+        label,      // label naming the next item
+        item,       // instruction or DB, encoded with relocations
+        include,    // #include of another file (name is the path)
+        check       // symbol looked up by the first pass, must still match
+    };
+
+    enum class relocation_kind : uint8_t
+    {
+        value,      // 8 bit value
+        address     // 16 bit address, high byte first
+    };
+
+    class relocation
+    {
+    public:
+        uint32_t offset{};
+        relocation_kind kind{relocation_kind::value};
+        std::string symbol;
+    };
+
+    /**
+     * Piece of the bytes of a DB item: the next size bytes of the item are
+     * written count times. A reservation like 0[8000] is one byte with a
+     * count of 8000, literals and strings have a count of 1.
+     */
+    class data_run
+    {
+    public:
+        uint32_t size{};
+        uint32_t count{};
+    };
+
+    /**
+     * One step of the first pass over a file. Replaying the entries of an
+     * object has the same effect on the assembly as parsing the file again,
+     * as long as every check entry still holds.
+     */
+    class object_entry
+    {
+    public:
+        entry_kind kind{entry_kind::item};
+        int line{};
+        std::string name;
+        bool known{};                       // def: constant, check: resolved
+        int value{};
+        std::string alias;
+        uint32_t address{};
+        uint32_t size{};
+        bool fixed{};
+        bool instruction{};
+        std::vector<uint8_t> bytes;
+        std::vector<data_run> runs;         // DB pieces, none for instructions
+        std::vector<relocation> relocations;
+    };
+
+    /**
+     * Relocatable result of the first pass over one source file.
+     */
+    class object_file
+    {
+    public:
+        uint64_t content_hash{};
+        std::vector<object_entry> entries;
+    };
+
+    uint64_t hash_bytes(const char *bytes, size_t size);
+    bool hash_file(const std::string &filename, uint64_t &hash);
+
+    /**
+     * Directory of objects, one per source file (named by the hash of its
+     * absolute path). An object is only used while the content hash of the
+     * source matches.
+     */
+    class object_cache
+    {
+    public:
+        explicit object_cache(std::string directory);
+
+        bool is_current(const std::string &source) const;
+        bool load(const std::string &source, uint64_t content_hash, object_file &object) const;
+        bool store(const std::string &source, const object_file &object) const;
+
+    private:
+        std::string object_path(const std::string &source) const;
+
+        std::string directory;
+    };
+
+}
@@ -0,0 +1,342 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    profiler.cpp                                                     */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Profile bookkeeping and the report. The profiled engine counts the hits   */
+/* itself and only calls here on CALL and RET, which keep a shadow stack of  */
+/* the functions entered. The instructions executed between a call and its   */
+/* return are the inclusive count of the callee, less the inclusive counts   */
+/* of its own callees they are its exclusive count.                          */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "image.h"
+#include "profiler.h"
+
+/* PROFILE *******************************************************************/
+
+/**
+ *
+ * Clears the profile and enters the function at the entry address (the
+ * whole program, called once).
+ *
+ */
+void init_profile(profile &p, const uint16_t entry)
+{
+    memset(p.hits, 0, sizeof(p.hits));
+    p.executed = 0;
+    p.stack.clear();
+    p.functions.clear();
+    p.edges.clear();
+
+    p.stack.push_back(profile_frame{entry, 0, 0});
+    p.functions[entry].calls = 1;
+}
+
+/**
+ *
+ * Enters a function, called after the CALL was executed.
+ *
+ */
+void profile_call(profile &p, const uint16_t callee)
+{
+    const uint16_t caller = p.stack.empty() ? callee : p.stack.back().function;
+
+    p.stack.push_back(profile_frame{callee, p.executed, 0});
+    p.functions[callee].calls++;
+    p.edges[static_cast<uint32_t>(caller) << 16 | callee].calls++;
+}
+
+/**
+ *
+ * Leaves the innermost function and charges its instructions to it, to
+ * its edge and to its caller.
+ *
+ */
+static void leave_function(profile &p)
+{
+    const profile_frame frame = p.stack.back();
+    const uint64_t inclusive = p.executed - frame.start;
+    profile_function &function = p.functions[frame.function];
+
+    p.stack.pop_back();
+
+    function.inclusive += inclusive;
+    function.exclusive += inclusive - frame.children;
+
+    if (!p.stack.empty())
+    {
+        profile_frame &parent = p.stack.back();
+
+        p.edges[static_cast<uint32_t>(parent.function) << 16 | frame.function].inclusive += inclusive;
+        parent.children += inclusive;
+    }
+}
+
+/**
+ *
+ * Leaves a function, called after the RET was executed. A RET without a
+ * matching CALL (the program playing with the stack) is ignored.
+ *
+ */
+void profile_return(profile &p)
+{
+    if (p.stack.size() > 1)
+    {
+        leave_function(p);
+    }
+}
+
+/**
+ *
+ * Leaves all the functions still running when the machine stopped.
+ *
+ */
+void finish_profile(profile &p)
+{
+    while (!p.stack.empty())
+    {
+        leave_function(p);
+    }
+}
+
+/* LABELS ********************************************************************/
+
+/**
+ *
+ * Reads the labels of a program image sorted by address. Returns false if
+ * the file is not an image (raw dumps have no labels).
+ *
+ */
+bool load_labels(const std::string &filename, std::vector<std::pair<uint16_t, std::string>> &labels)
+{
+    image_file image;
+    uint32_t i;
+
+    labels.clear();
+
+    if (!is_image_file(filename) || !map_image(filename, image)) return false;
+
+    for (i = 0; i < image.header->symbol_count; i++)
+    {
+        const image_symbol &symbol = image.symbols[i];
+
+        if (symbol.flags & IMAGE_SYMBOL_LABEL)
+        {
+            labels.emplace_back(symbol.value, std::string(image.strings + symbol.name));
+        }
+    }
+
+    unmap_image(image);
+    std::stable_sort(labels.begin(), labels.end(),
+                     [](const std::pair<uint16_t, std::string> &a, const std::pair<uint16_t, std::string> &b)
+                     {
+                         return a.first < b.first;
+                     });
+    return true;
+}
+
+/**
+ *
+ * Names an address by the closest label at or below it ("label+0x0012").
+ *
+ */
+std::string label_location(const std::vector<std::pair<uint16_t, std::string>> &labels, const uint16_t address)
+{
+    char text[64];
+
+    auto label = std::upper_bound(labels.begin(), labels.end(), address,
+                                  [](const uint16_t value, const std::pair<uint16_t, std::string> &entry)
+                                  {
+                                      return value < entry.first;
+                                  });
+
+    if (label == labels.begin())
+    {
+        snprintf(text, sizeof(text), "0x%04x", address);
+        return text;
+    }
+
+    --label;
+    if (label->first == address) return label->second;
+
+    snprintf(text, sizeof(text), "+0x%04x", address - label->first);
+    return label->second + text;
+}
+
+/* REPORT ********************************************************************/
+
+static bool ends_block(const uint8_t opcode)
+{
+    switch (opcode)
+    {
+        case JMP: case JZ: case JNZ: case JC: case JNC: case CALL: case RET: case HALT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static double percent(const uint64_t part, const uint64_t whole)
+{
+    return whole ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+}
+
+/**
+ *
+ * Basic block found in the hit counts: consecutive instructions executed
+ * equally often, up to the next control flow instruction.
+ *
+ */
+struct profile_block
+{
+    uint16_t start;
+    uint32_t instructions;
+    uint64_t hits;
+};
+
+static std::vector<profile_block> find_blocks(const profile &p, const Machine &m)
+{
+    std::vector<profile_block> blocks;
+    uint32_t address = 0;
+
+    while (address <= MEM_SIZE)
+    {
+        if (!p.hits[address])
+        {
+            address++;
+            continue;
+        }
+
+        profile_block block = {static_cast<uint16_t>(address), 0, p.hits[address]};
+
+        for (;;)
+        {
+            const uint8_t opcode = m.mem[address];
+            const uint32_t next = address + instruction_length(opcode);
+
+            block.instructions++;
+            address = next;
+
+            if (ends_block(opcode) || next > MEM_SIZE || p.hits[next] != block.hits) break;
+        }
+
+        blocks.push_back(block);
+    }
+
+    std::sort(blocks.begin(), blocks.end(), [](const profile_block &a, const profile_block &b)
+              {
+                  return a.hits * a.instructions > b.hits * b.instructions;
+              });
+    return blocks;
+}
+
+/**
+ *
+ * Writes the report: hot addresses, hot basic blocks, functions by their
+ * exclusive counts and the call graph edges. Addresses are named by the
+ * labels (see load_labels).
+ *
+ */
+bool write_profile(const profile &p, const Machine &m, const std::vector<std::pair<uint16_t, std::string>> &labels,
+                   const std::string &filename)
+{
+    FILE *file = fopen(filename.c_str(), "w");
+    std::vector<uint16_t> addresses;
+    uint32_t address;
+    size_t i;
+
+    if (!file) return false;
+
+    fprintf(file, "executed instructions: %llu\n\n", static_cast<unsigned long long>(p.executed));
+
+    /* hot addresses */
+
+    for (address = 0; address <= MEM_SIZE; address++)
+    {
+        if (p.hits[address]) addresses.push_back(static_cast<uint16_t>(address));
+    }
+
+    std::sort(addresses.begin(), addresses.end(), [&p](const uint16_t a, const uint16_t b)
+              {
+                  return p.hits[a] > p.hits[b] || (p.hits[a] == p.hits[b] && a < b);
+              });
+
+    fprintf(file, "hot addresses\n\n");
+    fprintf(file, "  address        hits        %%  opcode  location\n");
+    for (i = 0; i < addresses.size() && i < PROFILE_TOP; i++)
+    {
+        const uint16_t a = addresses[i];
+
+        fprintf(file, "  0x%04x  %12llu  %6.2f  %-6s  %s\n", a, static_cast<unsigned long long>(p.hits[a]),
+                percent(p.hits[a], p.executed), instruction_name(m.mem[a]), label_location(labels, a).c_str());
+    }
+
+    /* hot basic blocks */
+
+    const std::vector<profile_block> blocks = find_blocks(p, m);
+
+    fprintf(file, "\nhot basic blocks\n\n");
+    fprintf(file, "  start   instructions        hits  executed        %%  location\n");
+    for (i = 0; i < blocks.size() && i < PROFILE_TOP; i++)
+    {
+        const profile_block &block = blocks[i];
+        const uint64_t executed = block.hits * block.instructions;
+
+        fprintf(file, "  0x%04x  %12u  %10llu  %8llu  %6.2f  %s\n", block.start, block.instructions,
+                static_cast<unsigned long long>(block.hits), static_cast<unsigned long long>(executed),
+                percent(executed, p.executed), label_location(labels, block.start).c_str());
+    }
+
+    /* functions */
+
+    std::vector<std::pair<uint16_t, profile_function>> functions(p.functions.begin(), p.functions.end());
+    std::sort(functions.begin(), functions.end(),
+              [](const std::pair<uint16_t, profile_function> &a, const std::pair<uint16_t, profile_function> &b)
+              {
+                  return a.second.exclusive > b.second.exclusive ||
+                         (a.second.exclusive == b.second.exclusive && a.first < b.first);
+              });
+
+    fprintf(file, "\nfunctions\n\n");
+    fprintf(file, "  address       calls     inclusive     exclusive        %%  function\n");
+    for (const auto &function : functions)
+    {
+        fprintf(file, "  0x%04x  %10llu  %12llu  %12llu  %6.2f  %s\n", function.first,
+                static_cast<unsigned long long>(function.second.calls),
+                static_cast<unsigned long long>(function.second.inclusive),
+                static_cast<unsigned long long>(function.second.exclusive),
+                percent(function.second.exclusive, p.executed), label_location(labels, function.first).c_str());
+    }
+
+    /* call graph */
+
+    std::vector<std::pair<uint32_t, profile_edge>> edges(p.edges.begin(), p.edges.end());
+    std::sort(edges.begin(), edges.end(),
+              [](const std::pair<uint32_t, profile_edge> &a, const std::pair<uint32_t, profile_edge> &b)
+              {
+                  return a.second.inclusive > b.second.inclusive ||
+                         (a.second.inclusive == b.second.inclusive && a.first < b.first);
+              });
+
+    fprintf(file, "\ncall graph\n\n");
+    fprintf(file, "       calls     inclusive  caller -> callee\n");
+    for (const auto &edge : edges)
+    {
+        fprintf(file, "  %10llu  %12llu  %s -> %s\n", static_cast<unsigned long long>(edge.second.calls),
+                static_cast<unsigned long long>(edge.second.inclusive),
+                label_location(labels, static_cast<uint16_t>(edge.first >> 16)).c_str(),
+                label_location(labels, static_cast<uint16_t>(edge.first & 0xFFFF)).c_str());
+    }
+
+    return fclose(file) == 0;
+}
@@ -0,0 +1,77 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    profiler.h                                                       */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Execution profile of a machine run by run_profiled: executions of every   */
+/* address and the CALL/RET graph with inclusive and exclusive instruction   */
+/* counts. The report names the addresses by the labels of the program      */
+/* image. The engines without profiling are not touched by any of it.        */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef __PROFILER_H_
+#define __PROFILER_H_
+
+/* INCLUDES ******************************************************************/
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "definitions.h"
+#include "machine.h"
+
+/* PROFILER ******************************************************************/
+
+#define PROFILE_TOP         32      /* rows of the hot lists in the report   */
+
+struct profile_function
+{
+    uint64_t calls;
+    uint64_t inclusive;         /* instructions including the callees        */
+    uint64_t exclusive;         /* instructions of the function itself       */
+};
+
+struct profile_edge
+{
+    uint64_t calls;
+    uint64_t inclusive;         /* instructions of the callee for the caller */
+};
+
+/**
+ *
+ * Function being executed, one per CALL not returned from yet.
+ *
+ */
+struct profile_frame
+{
+    uint16_t function;          /* address called                            */
+    uint64_t start;             /* executed instructions at the call         */
+    uint64_t children;          /* instructions of the callees               */
+};
+
+struct profile
+{
+    uint64_t hits[MEM_SIZE + 1];        /* executions per address            */
+    uint64_t executed;                  /* all executed instructions         */
+    std::vector<profile_frame> stack;
+    std::unordered_map<uint16_t, profile_function> functions;
+    std::unordered_map<uint32_t, profile_edge> edges;   /* caller << 16 | callee */
+};
+
+void init_profile(profile &p, uint16_t entry);
+void profile_call(profile &p, uint16_t callee);
+void profile_return(profile &p);
+void finish_profile(profile &p);
+
+bool load_labels(const std::string &filename, std::vector<std::pair<uint16_t, std::string>> &labels);
+std::string label_location(const std::vector<std::pair<uint16_t, std::string>> &labels, uint16_t address);
+bool write_profile(const profile &p, const Machine &m, const std::vector<std::pair<uint16_t, std::string>> &labels,
+                   const std::string &filename);
+
+#endif
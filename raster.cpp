@@ -0,0 +1,195 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    raster.cpp                                                       */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Rasterizer of the video memory. Every mode is one byte of 1 bit pixels    */
+/* per row of a cell (a glyph row in the text mode, bitmap bytes in the      */
+/* graphics modes) and a foreground and background color per cell, so all    */
+/* of them share one kernel expanding 8 pixels at a time: the byte is        */
+/* broadcast to the lanes, every lane tests its own bit and the result       */
+/* selects the foreground or the background color.                          */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define RASTER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RASTER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RASTER_NEON
+#endif
+
+#include "raster.h"
+
+/* PALETTE *******************************************************************/
+
+/**
+ *
+ * Colors of the kernel (__BLACK .. __WHITE) as ARGB8888.
+ *
+ */
+const uint32_t raster_palette[16] = {
+    0xFF000000, 0xFF800000, 0xFF008000, 0xFF808000,     /* black .. olive    */
+    0xFF000080, 0xFF800080, 0xFF008080, 0xFFC0C0C0,     /* navy .. silver    */
+    0xFF808080, 0xFFFF0000, 0xFF00FF00, 0xFFFFFF00,     /* gray .. yellow    */
+    0xFF0000FF, 0xFFFF00FF, 0xFF00FFFF, 0xFFFFFFFF      /* blue .. white     */
+};
+
+/* KERNELS *******************************************************************/
+
+/**
+ *
+ * Name of the kernel compiled in.
+ *
+ */
+const char *raster_kernel()
+{
+#if defined(RASTER_AVX2)
+    return "avx2";
+#elif defined(RASTER_SSE2)
+    return "sse2";
+#elif defined(RASTER_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+/**
+ *
+ * Expands 8 pixels of 1 bit (the highest bit on the left) to 32 bit
+ * pixels, set bits get the foreground color, clear bits the background.
+ *
+ */
+void raster_row(uint32_t *pixels, const uint8_t bits, const uint32_t fg, const uint32_t bg)
+{
+#if defined(RASTER_AVX2)
+    const __m256i masks = _mm256_setr_epi32(0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    const __m256i set = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(bits), masks), masks);
+    const __m256i colors = _mm256_blendv_epi8(_mm256_set1_epi32(static_cast<int>(bg)),
+                                              _mm256_set1_epi32(static_cast<int>(fg)), set);
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(pixels), colors);
+#elif defined(RASTER_SSE2)
+    const __m128i high = _mm_setr_epi32(0x80, 0x40, 0x20, 0x10);
+    const __m128i low = _mm_setr_epi32(0x08, 0x04, 0x02, 0x01);
+    const __m128i value = _mm_set1_epi32(bits);
+    const __m128i foreground = _mm_set1_epi32(static_cast<int>(fg));
+    const __m128i background = _mm_set1_epi32(static_cast<int>(bg));
+    const __m128i set_high = _mm_cmpeq_epi32(_mm_and_si128(value, high), high);
+    const __m128i set_low = _mm_cmpeq_epi32(_mm_and_si128(value, low), low);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels),
+                     _mm_or_si128(_mm_and_si128(set_high, foreground), _mm_andnot_si128(set_high, background)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(pixels + 4),
+                     _mm_or_si128(_mm_and_si128(set_low, foreground), _mm_andnot_si128(set_low, background)));
+#elif defined(RASTER_NEON)
+    static const uint32_t high_bits[4] = {0x80, 0x40, 0x20, 0x10};
+    static const uint32_t low_bits[4] = {0x08, 0x04, 0x02, 0x01};
+    const uint32x4_t value = vdupq_n_u32(bits);
+    const uint32x4_t foreground = vdupq_n_u32(fg);
+    const uint32x4_t background = vdupq_n_u32(bg);
+
+    vst1q_u32(pixels, vbslq_u32(vtstq_u32(value, vld1q_u32(high_bits)), foreground, background));
+    vst1q_u32(pixels + 4, vbslq_u32(vtstq_u32(value, vld1q_u32(low_bits)), foreground, background));
+#else
+    uint32_t x;
+
+    for (x = 0; x < 8; x++)
+    {
+        pixels[x] = (bits & (0x80 >> x)) ? fg : bg;
+    }
+#endif
+}
+
+/* RASTERIZER ****************************************************************/
+
+/**
+ *
+ * Cell of the cursor or RASTER_NO_CURSOR when it is off or out of the
+ * screen.
+ *
+ */
+uint16_t raster_cursor(const uint8_t *mem)
+{
+    const uint8_t x = mem[CONSOLE_X_ADDRESS];
+    const uint8_t y = mem[CONSOLE_Y_ADDRESS];
+
+    if (!mem[CURSOR_ON_ADDRESS] || x >= VIDEO_COLUMNS || y >= VIDEO_ROWS)
+    {
+        return RASTER_NO_CURSOR;
+    }
+
+    return static_cast<uint16_t>(y * VIDEO_COLUMNS + x);
+}
+
+/**
+ *
+ * Draws one cell of the given mode to a frame of VIDEO_WIDTH x VIDEO_HEIGHT
+ * pixels.
+ *
+ * In the text mode the cell shows the character of its VIDEO_MEM byte
+ * (8 bytes per character in CHAR_MEM, one per row), in the graphics modes
+ * the 8 bytes of its pixel rows. The colors come from COLOR_MEM (low
+ * nibble foreground, high nibble background) except for the BW mode, the
+ * cursor cell is drawn inverted.
+ *
+ */
+void raster_cell(uint32_t *frame, const uint8_t *mem, const uint8_t mode, const uint32_t cell,
+                 const uint16_t cursor)
+{
+    const uint32_t column = cell % VIDEO_COLUMNS;
+    const uint32_t row = cell / VIDEO_COLUMNS;
+    const uint8_t colors = mode == VIDEO_BW_MODE ? 0x0F : mem[COLOR_MEM_ADDRESS + cell];
+    const uint32_t fg = raster_palette[cell == cursor ? colors >> 4 : colors & 0x0F];
+    const uint32_t bg = raster_palette[cell == cursor ? colors & 0x0F : colors >> 4];
+
+    uint32_t *pixels = frame + row * 8 * VIDEO_WIDTH + column * 8;
+    const uint8_t *bits;
+    uint32_t stride, y;
+
+    if (mode == VIDEO_TEXT_MODE)
+    {
+        bits = mem + CHAR_MEM_ADDRESS + mem[VIDEO_MEM_ADDRESS + cell] * 8;
+        stride = 1;
+    }
+    else
+    {
+        bits = mem + VIDEO_MEM_ADDRESS + row * 8 * VIDEO_COLUMNS + column;
+        stride = VIDEO_COLUMNS;
+    }
+
+    for (y = 0; y < 8; y++)
+    {
+        raster_row(pixels, bits[y * stride], fg, bg);
+        pixels += VIDEO_WIDTH;
+    }
+}
+
+/**
+ *
+ * Draws the whole screen in the mode selected by VIDEO_MODE.
+ *
+ */
+void raster_screen(uint32_t *frame, const uint8_t *mem)
+{
+    const uint8_t mode = mem[VIDEO_MODE_ADDRESS];
+    const uint16_t cursor = raster_cursor(mem);
+
+    uint32_t cell;
+
+    for (cell = 0; cell < VIDEO_CELLS; cell++)
+    {
+        raster_cell(frame, mem, mode, cell, cursor);
+    }
+}
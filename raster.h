@@ -0,0 +1,37 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    raster.h                                                         */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Conversion of the video memory to 32 bit pixels (ARGB8888) for the three  */
+/* video modes. It does not depend on SDL, so machines without a window can  */
+/* capture their frames too. Rows of 1 bit pixels are expanded with SSE2,    */
+/* AVX2 or NEON when the compiler targets them and by a scalar loop else.    */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef __RASTER_H_
+#define __RASTER_H_
+
+/* INCLUDES ******************************************************************/
+
+#include <cstdint>
+
+#include "definitions.h"
+
+/* RASTERIZER ****************************************************************/
+
+#define RASTER_NO_CURSOR    0xFFFF  /* cursor cell when the cursor is off    */
+
+extern const uint32_t raster_palette[16];
+
+const char *raster_kernel();
+uint16_t raster_cursor(const uint8_t *mem);
+
+void raster_row(uint32_t *pixels, uint8_t bits, uint32_t fg, uint32_t bg);
+void raster_cell(uint32_t *frame, const uint8_t *mem, uint8_t mode, uint32_t cell, uint16_t cursor);
+void raster_screen(uint32_t *frame, const uint8_t *mem);
+
+#endif
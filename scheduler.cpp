@@ -0,0 +1,141 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    scheduler.cpp                                                    */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Scheduler running a machine by cycles. The machine runs up to the next    */
+/* event or the end of the batch without looking at the host clock; only     */
+/* between the batches of the real time mode the host clock is read and the  */
+/* thread sleeps until the host time catches up with the machine time.       */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <thread>
+
+#include "scheduler.h"
+
+/* SCHEDULER *****************************************************************/
+
+/**
+ *
+ * Initializes a scheduler running at hz cycles per second, or as fast as
+ * possible with SCHEDULER_UNCAPPED.
+ *
+ */
+void init_scheduler(scheduler &s, const uint64_t hz)
+{
+    s.hz = hz;
+    s.batch = hz / SCHEDULER_SYNC_HZ;
+    if (s.batch == 0) s.batch = 1;
+    s.events.clear();
+    s.started = false;
+    s.origin_cycles = 0;
+}
+
+/**
+ *
+ * Adds an event raised every period cycles, first when the cycle counter of
+ * the machine reaches its current value plus period.
+ *
+ */
+void add_clock_event(scheduler &s, const Machine &m, const uint64_t period, const clock_handler handler,
+                     void *context)
+{
+    clock_event event;
+
+    event.period = period ? period : 1;
+    event.next = m.cycles + event.period;
+    event.handler = handler;
+    event.context = context;
+
+    s.events.push_back(event);
+}
+
+/**
+ *
+ * Sleeps until the host time reaches the time of the current cycle. A host
+ * too slow for the clock rate falls behind by SCHEDULER_MAX_LAG at most,
+ * then the clock starts over instead of running in a burst to catch up.
+ *
+ */
+static void synchronize(scheduler &s, const Machine &m)
+{
+    typedef std::chrono::steady_clock clock;
+
+    const clock::time_point now = clock::now();
+
+    if (!s.started)
+    {
+        s.started = true;
+        s.origin = now;
+        s.origin_cycles = m.cycles;
+        return;
+    }
+
+    const uint64_t elapsed = m.cycles - s.origin_cycles;
+    const clock::time_point due = s.origin + std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(elapsed) / static_cast<double>(s.hz)));
+
+    if (due > now)
+    {
+        std::this_thread::sleep_until(due);
+    }
+    else if (now - due > std::chrono::milliseconds(SCHEDULER_MAX_LAG))
+    {
+        s.origin = now;
+        s.origin_cycles = m.cycles;
+    }
+}
+
+/**
+ *
+ * Runs the machine until it stops or its cycle counter reaches until and
+ * returns the counter. Events due are raised after the instruction which
+ * reaches their cycle, in the order they were added. The function can be
+ * called again to continue, the real time clock keeps running.
+ *
+ */
+uint64_t run_scheduled(scheduler &s, Machine &m, const uint64_t until)
+{
+    if (s.hz != SCHEDULER_UNCAPPED && !s.started)
+    {
+        synchronize(s, m);
+    }
+
+    while (!m.stop && m.cycles < until)
+    {
+        uint64_t target = until;
+
+        for (const clock_event &event : s.events)
+        {
+            if (event.next < target) target = event.next;
+        }
+
+        if (s.hz != SCHEDULER_UNCAPPED && m.cycles + s.batch < target)
+        {
+            target = m.cycles + s.batch;
+        }
+
+        run_cycles(m, target);
+
+        for (clock_event &event : s.events)
+        {
+            while (event.next <= m.cycles)
+            {
+                event.handler(m, event.context);
+                event.next += event.period;
+            }
+        }
+
+        if (s.hz != SCHEDULER_UNCAPPED)
+        {
+            synchronize(s, m);
+        }
+    }
+
+    return m.cycles;
+}
@@ -0,0 +1,64 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    scheduler.h                                                      */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Clock of a machine. Runs the machine by batches of cycles (see the *_CYC  */
+/* definitions) either at full speed or at a given clock rate, and raises    */
+/* periodic events (timers, vblank) at exact cycle counts. Only the cycle    */
+/* counter decides when an event fires, so both modes run the same.          */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef __SCHEDULER_H_
+#define __SCHEDULER_H_
+
+/* INCLUDES ******************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "machine.h"
+
+/* SCHEDULER *****************************************************************/
+
+#define SCHEDULER_UNCAPPED  0       /* clock rate of the full speed mode     */
+#define SCHEDULER_SYNC_HZ   1000    /* host clock checks per second at most  */
+#define SCHEDULER_MAX_LAG   100     /* ms behind before the clock gives up   */
+
+typedef void (*clock_handler)(Machine &m, void *context);
+
+/**
+ *
+ * Event raised every period cycles.
+ *
+ */
+struct clock_event
+{
+    uint64_t period;            /* cycles between two events                 */
+    uint64_t next;              /* cycle counter of the next event           */
+    clock_handler handler;
+    void *context;
+};
+
+struct scheduler
+{
+    uint64_t hz;                /* clock rate, SCHEDULER_UNCAPPED            */
+    uint64_t batch;             /* cycles between two host clock checks      */
+    std::vector<clock_event> events;
+
+    /* real time: host time at which the machine had origin_cycles */
+
+    bool     started;
+    std::chrono::steady_clock::time_point origin;
+    uint64_t origin_cycles;
+};
+
+void init_scheduler(scheduler &s, uint64_t hz);
+void add_clock_event(scheduler &s, const Machine &m, uint64_t period, clock_handler handler, void *context);
+uint64_t run_scheduled(scheduler &s, Machine &m, uint64_t until);
+
+#endif
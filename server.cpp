@@ -0,0 +1,461 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    server.cpp                                                       */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Server mode (see server.h). The images are loaded to snapshots once and   */
+/* a pool of machines restored from them is kept over all requests, so a     */
+/* job only costs restoring the pages the previous job wrote. A batch is     */
+/* read whole, run by the batch runner and answered by one write.            */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "batch.h"
+#include "machine.h"
+#include "server.h"
+
+/* STREAMS *******************************************************************/
+
+/**
+ *
+ * Reads up to size bytes, less only at the end of the stream. Returns the
+ * number of bytes read.
+ *
+ */
+size_t read_stream(const int stream, void *buffer, const size_t size)
+{
+    uint8_t *bytes = static_cast<uint8_t *>(buffer);
+    size_t done = 0;
+
+    while (done < size)
+    {
+#if defined(_WIN32)
+        const int count = _read(stream, bytes + done, static_cast<unsigned int>(size - done));
+#else
+        const ssize_t count = read(stream, bytes + done, size - done);
+#endif
+
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) break;
+
+        done += static_cast<size_t>(count);
+    }
+
+    return done;
+}
+
+bool write_stream(const int stream, const void *buffer, const size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(buffer);
+    size_t done = 0;
+
+    while (done < size)
+    {
+#if defined(_WIN32)
+        const int count = _write(stream, bytes + done, static_cast<unsigned int>(size - done));
+#else
+        const ssize_t count = write(stream, bytes + done, size - done);
+#endif
+
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return false;
+
+        done += static_cast<size_t>(count);
+    }
+
+    return true;
+}
+
+/* BATCHES *******************************************************************/
+
+struct server_state
+{
+    batch_options options;
+    std::vector<batch_image> images;
+    batch_pool pool;
+};
+
+/**
+ *
+ * Job of a request while its batch is read. The input and the ranges are
+ * offsets to the buffers of the batch, which grow until it is read whole.
+ *
+ */
+struct server_task
+{
+    server_job request;
+    size_t input;               /* offset to the input bytes                 */
+    size_t ranges;              /* index of the first range                  */
+    size_t result;              /* offset of the result in the response      */
+    uint32_t output_size;       /* bytes of all the ranges                   */
+    bool rejected;
+};
+
+static bool valid_range(const uint32_t address, const uint32_t size)
+{
+    return size <= MEM_SIZE + 1 && address + size <= MEM_SIZE + 1;
+}
+
+static uint8_t server_status(const uint8_t reason)
+{
+    switch (reason)
+    {
+        case STOP_HALT: return SERVER_HALT;
+        case STOP_INVALID_OPCODE: return SERVER_BAD_OPCODE;
+        case STOP_INVALID_REGISTER: return SERVER_BAD_REGISTER;
+        case STOP_DIVIDE_BY_ZERO: return SERVER_DIVIDE_ERROR;
+        default: return SERVER_BUDGET;
+    }
+}
+
+/**
+ *
+ * Reads one batch, runs it and writes the response. Returns false at the
+ * end of the stream (closed set) or when the request is broken, the stream
+ * can not be read any further then.
+ *
+ */
+bool serve_batch(server_state &state, const int in, const int out, bool &closed)
+{
+    server_batch header;
+    std::vector<server_task> tasks;
+    std::vector<uint8_t> input;
+    std::vector<batch_range> ranges;
+    std::vector<batch_job> jobs;
+    std::vector<uint8_t> response;
+    size_t size, total = 0;
+    uint32_t i, k;
+
+    size = read_stream(in, &header, sizeof(header));
+    closed = size == 0;
+
+    if (size != sizeof(header)) return false;
+
+    if (header.magic != SERVER_MAGIC || header.version != SERVER_VERSION || header.job_count > SERVER_MAX_JOBS)
+    {
+        fprintf(stderr, "bad request header\n");
+        return false;
+    }
+
+    tasks.resize(header.job_count);
+    size = sizeof(server_batch);
+
+    for (server_task &task : tasks)
+    {
+        server_job &request = task.request;
+
+        if (read_stream(in, &request, sizeof(request)) != sizeof(request)) return false;
+
+        if (request.input_size > SERVER_MAX_BYTES - total || request.range_count > SERVER_MAX_RANGES)
+        {
+            fprintf(stderr, "request too large\n");
+            return false;
+        }
+
+        task.input = input.size();
+        task.ranges = ranges.size();
+        task.result = size;
+        task.output_size = 0;
+        task.rejected = request.image >= state.images.size() ||
+                        !valid_range(request.input_address, request.input_size);
+
+        input.resize(task.input + request.input_size);
+        total += request.input_size;
+
+        if (read_stream(in, input.data() + task.input, request.input_size) != request.input_size) return false;
+
+        for (k = 0; k < request.range_count; k++)
+        {
+            server_range range;
+
+            if (read_stream(in, &range, sizeof(range)) != sizeof(range)) return false;
+
+            if (!valid_range(range.address, range.size))
+            {
+                task.rejected = true;
+                continue;
+            }
+
+            if (range.size > SERVER_MAX_BYTES - total)
+            {
+                fprintf(stderr, "request too large\n");
+                return false;
+            }
+
+            ranges.push_back({range.address, range.size});
+            task.output_size += range.size;
+            total += range.size;
+        }
+
+        if (task.rejected) task.output_size = 0;
+        size += sizeof(server_result) + task.output_size;
+    }
+
+    /* the ranges are copied by the workers straight to the response */
+
+    response.resize(size);
+    jobs.reserve(tasks.size());
+
+    for (const server_task &task : tasks)
+    {
+        if (task.rejected) continue;
+
+        batch_job job = {};
+        job.image = task.request.image;
+        job.seed = task.request.seed;
+        job.budget = task.request.budget;
+        job.input = input.data() + task.input;
+        job.input_address = task.request.input_address;
+        job.input_size = task.request.input_size;
+        job.ranges = ranges.data() + task.ranges;
+        job.range_count = task.request.range_count;
+        job.output = response.data() + task.result + sizeof(server_result);
+        jobs.push_back(job);
+    }
+
+    run_batch(state.options, state.images, jobs, &state.pool);
+
+    memcpy(response.data(), &header, sizeof(header));
+
+    for (i = 0, k = 0; i < tasks.size(); i++)
+    {
+        server_result result = {};
+
+        if (tasks[i].rejected)
+        {
+            result.status = SERVER_REJECTED;
+        }
+        else
+        {
+            const batch_job &job = jobs[k++];
+
+            memcpy(result.r, job.r, sizeof(result.r));
+            result.ip = job.ip;
+            result.sp = job.sp;
+            result.bp = job.bp;
+            result.c = job.c;
+            result.status = server_status(job.reason);
+            result.instructions = job.instructions;
+            result.data_size = tasks[i].output_size;
+        }
+
+        memcpy(response.data() + tasks[i].result, &result, sizeof(result));
+    }
+
+    return write_stream(out, response.data(), response.size());
+}
+
+/**
+ *
+ * Serves batches from a stream until it ends. Returns false if it did not
+ * end cleanly between two batches.
+ *
+ */
+bool serve_stream(server_state &state, const int in, const int out)
+{
+    bool closed = false;
+
+    while (serve_batch(state, in, out, closed))
+    {
+    }
+
+    return closed;
+}
+
+#if !defined(_WIN32)
+
+/**
+ *
+ * Serves the clients of a local socket one after another.
+ *
+ */
+bool serve_socket(server_state &state, const char *path)
+{
+    sockaddr_un address = {};
+    const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (listener < 0 || strlen(path) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "can not create socket %s\n", path);
+        if (listener >= 0) close(listener);
+        return false;
+    }
+
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    unlink(path);
+
+    if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listener, 16) != 0)
+    {
+        fprintf(stderr, "can not listen on socket %s\n", path);
+        close(listener);
+        return false;
+    }
+
+    for (;;)
+    {
+        const int client = accept(listener, nullptr, nullptr);
+
+        if (client < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;
+        }
+
+        serve_stream(state, client, client);
+        close(client);
+    }
+
+    close(listener);
+    unlink(path);
+    return false;
+}
+
+#endif
+
+/* SERVER MODE ***************************************************************/
+
+void print_server_usage()
+{
+    printf("usage: sophia8 --server [options] image...\n");
+    printf("  --jobs N       worker threads (default: one per core)\n");
+    printf("  --slice N      instructions per time slice (default: %d)\n", BATCH_SLICE);
+    printf("  --limit N      instructions per job without a budget (default: no limit)\n");
+    printf("  --warm N       machines started per image (default: one per worker)\n");
+    printf("  --list FILE    read image paths from a file, one per line\n");
+#if !defined(_WIN32)
+    printf("  --socket PATH  serve a local socket instead of stdin and stdout\n");
+#endif
+}
+
+/**
+ *
+ * Restores warm machines from every image to the pool, so the first jobs
+ * do not start cold.
+ *
+ */
+void warm_pool(server_state &state, const uint32_t count)
+{
+    uint32_t i;
+
+    for (const batch_image &image : state.images)
+    {
+        for (i = 0; i < count; i++)
+        {
+            std::unique_ptr<Machine> m(new Machine());
+
+            restore_snapshot(*m, image.snapshot);
+            state.pool.machines.push_back(std::move(m));
+        }
+    }
+}
+
+int server_main(int argc, char *argv[])
+{
+    std::unique_ptr<server_state> state(new server_state());
+#if !defined(_WIN32)
+    const char *socket_path = nullptr;
+#endif
+    uint32_t warm = 0;
+    bool warm_set = false;
+    int i;
+
+    state->options = {0, BATCH_SLICE, 0, false};
+
+    for (i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if (arg == "--server")
+        {
+            continue;
+        }
+        else if (arg == "--jobs" && has_value)
+        {
+            state->options.workers = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        }
+        else if (arg == "--slice" && has_value)
+        {
+            state->options.slice = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        }
+        else if (arg == "--limit" && has_value)
+        {
+            state->options.limit = strtoull(argv[++i], nullptr, 0);
+        }
+        else if (arg == "--warm" && has_value)
+        {
+            warm = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+            warm_set = true;
+        }
+        else if (arg == "--list" && has_value)
+        {
+            if (!load_batch_list(argv[++i], state->images)) return 1;
+        }
+#if !defined(_WIN32)
+        else if (arg == "--socket" && has_value)
+        {
+            socket_path = argv[++i];
+        }
+#endif
+        else if (arg.compare(0, 2, "--") == 0)
+        {
+            print_server_usage();
+            return 1;
+        }
+        else if (!load_batch_image(arg, state->images))
+        {
+            return 1;
+        }
+    }
+
+    if (state->images.empty() || state->options.slice == 0)
+    {
+        print_server_usage();
+        return 1;
+    }
+
+    if (!warm_set)
+    {
+        warm = state->options.workers ? state->options.workers : std::thread::hardware_concurrency();
+    }
+
+    warm_pool(*state, warm);
+
+#if defined(_WIN32)
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#else
+    signal(SIGPIPE, SIG_IGN);
+
+    if (socket_path)
+    {
+        return serve_socket(*state, socket_path) ? 0 : 1;
+    }
+#endif
+
+    return serve_stream(*state, 0, 1) ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    server.h                                                         */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Server mode keeping the program images loaded and their machines warm     */
+/* between requests. A client sends batches of jobs over a pipe (stdin and   */
+/* stdout) or a local socket and gets one binary response per batch:         */
+/*                                                                           */
+/*     request                          response                             */
+/*     server_batch                     server_batch                         */
+/*     server_job, input bytes,         server_result, bytes of the ranges   */
+/*     server_range[range_count]        ... for every job in order           */
+/*     ... for every job                                                     */
+/*                                                                           */
+/* All numbers are little endian.                                            */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef __SERVER_H_
+#define __SERVER_H_
+
+/* INCLUDES ******************************************************************/
+
+#include <cstdint>
+
+/* SERVER PROTOCOL ***********************************************************/
+
+#define SERVER_MAGIC        0x56533853  /* "S8SV"                            */
+#define SERVER_VERSION      1
+
+#define SERVER_MAX_JOBS     0x10000     /* jobs in one batch at most         */
+#define SERVER_MAX_RANGES   0x100       /* memory ranges of a job at most    */
+#define SERVER_MAX_BYTES    0x10000000  /* input and output of a batch       */
+
+#define SERVER_HALT         0           /* the program stopped by itself     */
+#define SERVER_BUDGET       1           /* stopped after its budget          */
+#define SERVER_REJECTED     2           /* not run (unknown image, ranges)   */
+#define SERVER_BAD_OPCODE   3           /* stopped by an unknown instruction */
+#define SERVER_BAD_REGISTER 4           /* stopped by an invalid register    */
+#define SERVER_DIVIDE_ERROR 5           /* stopped by a division by zero     */
+
+#pragma pack(push, 1)
+
+struct server_batch
+{
+    uint32_t magic;             /* SERVER_MAGIC                              */
+    uint16_t version;           /* SERVER_VERSION                            */
+    uint16_t reserved;
+    uint32_t job_count;         /* jobs following                            */
+};
+
+struct server_job
+{
+    uint32_t image;             /* index of the image on the command line    */
+    uint16_t seed;              /* passed in R0 (low byte) and R1            */
+    uint16_t input_address;     /* where the input is written to             */
+    uint32_t input_size;        /* input bytes following                     */
+    uint16_t range_count;       /* server_range records after the input      */
+    uint16_t reserved;
+    uint64_t budget;            /* instructions, 0 - the server limit        */
+};
+
+struct server_range
+{
+    uint16_t address;           /* first address                             */
+    uint16_t reserved;
+    uint32_t size;              /* bytes (up to 0x10000 - address)           */
+};
+
+struct server_result
+{
+    uint8_t  r[8];
+    uint16_t ip;
+    uint16_t sp;
+    uint16_t bp;
+    uint8_t  c;
+    uint8_t  status;            /* SERVER_HALT, SERVER_BUDGET, ...           */
+    uint64_t instructions;      /* executed instructions                     */
+    uint32_t data_size;         /* bytes of the ranges following             */
+};
+
+#pragma pack(pop)
+
+/* SERVER MODE ***************************************************************/
+
+/**
+ *
+ * Entry of the server mode of sophia8 (sophia8 --server ...). Returns the
+ * exit code of the process.
+ *
+ */
+int server_main(int argc, char *argv[]);
+
+#endif
@@ -18,1207 +18,217 @@
 
 #include <cstdio>
 #include <cstdint>
-
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "batch.h"
+#include "charset.h"
+#include "debugger.h"
 #include "definitions.h"
+#include "display.h"
+#include "golden.h"
+#include "machine.h"
+#include "profiler.h"
+#include "scheduler.h"
+#include "server.h"
+#include "trace.h"
 
-/* REGISTERS *****************************************************************/
-
-/* registers */
-
-static uint8_t  r[8];           /* general purpose registers                 */
-static uint16_t ip;             /* instruction pointer                       */
-static uint16_t sp;             /* stack pointer                             */
-static uint16_t bp;             /* stack frame pointer                       */
-
-/* flags registers */
-
-static uint8_t  c;              /* carry flag                                */
-
-/* MEMORY ********************************************************************/
+/* MAIN **********************************************************************/
 
-static uint8_t  mem[MEM_SIZE];  /* random access memory                      */
+/* golden image compared with the final memory instead of dumping it and the
+   file the final memory is written to (nullptr - none) */
 
-/* SPECIAL TRIGGERS **********************************************************/
-
-static uint8_t  STOP = 0x00;    /* should stop the machine?                  */
-
-/* MACHINE CODE **************************************************************/
+static const char *golden = nullptr;
+static const char *golden_output = nullptr;
+static bool golden_failed = false;
 
 /**
  *
- * initializes memory and registers to a startup values.
- * 
- * All ram values are set to 0x00 (HALT) and sets stack pointer and block
- * pointer to top of the memory.
+ * Compares the memory with the golden image and prints the differing
+ * ranges. Returns false if it differs or the image can not be read.
  *
  */
-void init_machine()
-{
-    uint16_t i;
-    STOP = 0;
-
-    /* clean all memory */
-    for (i = 0; i < MEM_SIZE; i++)
-    {
-        mem[i] = HALT;
-    }
-
-    /* initialize registers */
-    ip = 0;
-    sp = MEM_SIZE;
-    bp = MEM_SIZE;
-    c = 0;
-
-    for (i = 0; i < 8; i++)
-    {
-        r[i] = 0;
-    }
-}
-
-/**
- * Processing a load instruction. This instruction loads data from a 16bit
- * memory location and saves it to a defined register.
- * 
- * LOAD 0x1A2B, R0 -> 00 1A 2B 00
- */
-void load_instruction()
-{
-    static uint16_t memory_source;
-    static uint8_t destination;
-    static uint8_t value;
-
-    memory_source = static_cast<uint16_t>(mem[ip + 1]);
-    memory_source <<= 8;
-    memory_source += static_cast<uint16_t>(mem[ip + 2]);
-
-    value = mem[memory_source];
-
-    destination = mem[ip + 3];
-
-    switch (destination) 
-    {
-        case IR0: r[0] = value; break;
-        case IR1: r[1] = value; break;
-        case IR2: r[2] = value; break;
-        case IR3: r[3] = value; break;
-        case IR4: r[4] = value; break;
-        case IR5: r[5] = value; break;
-        case IR6: r[6] = value; break;
-        case IR7: r[7] = value; break;
-        default: STOP = 1; break;
-    }
-
-    ip += 4;
-}
-
-/**
- * Processing a store instruction. This instruction stores data from a specific
- * register to a 16bit memory location.
- * 
- * STORE 0x1A2B, R0 -> 01 1A 2B 00
- */
-void store_instruction()
-{
-    static uint16_t memory_destination;
-    static uint8_t source;
-    static uint8_t value;
-
-    source = mem[ip + 1]; 
-
-    memory_destination = static_cast<uint16_t>(mem[ip + 2]);
-    memory_destination <<= 8;
-    memory_destination += static_cast<uint16_t>(mem[ip + 3]);
-
-    switch (source) 
-    {
-        case IR0: value = r[0]; break;
-        case IR1: value = r[1]; break;
-        case IR2: value = r[2]; break;
-        case IR3: value = r[3]; break;
-        case IR4: value = r[4]; break;
-        case IR5: value = r[5]; break;
-        case IR6: value = r[6]; break;
-        case IR7: value = r[7]; break;
-        default: STOP = 1; break;
-    }
-    
-    mem[memory_destination] = value;
-
-    ip += 4;
-}
-
-/**
- * Processing a store instruction. This instruction stores data from a specific
- * register to a 16bit memory location defined by two additional registers.
- * 
- * STORER R0, R1, R2 -> 02 00 01 02
- */
-void storer_instruction()
+bool check_golden(const Machine &m, const char *filename)
 {
-    static uint8_t source_register;
-    static uint8_t destination_register_h;
-    static uint8_t destination_register_l;
-    
-    static uint8_t value;
-    static uint16_t destinationAddress;
+    std::unique_ptr<uint8_t[]> expected(new uint8_t[GOLDEN_SIZE]);
+    std::vector<diff_range> ranges;
 
-    source_register = mem[ip + 1];
-    destination_register_h = mem[ip + 2];
-    destination_register_l = mem[ip + 3];
-    
-    switch (source_register) 
+    if (!load_golden(filename, expected.get()))
     {
-        case IR0: value = r[0]; break;
-        case IR1: value = r[1]; break;
-        case IR2: value = r[2]; break;
-        case IR3: value = r[3]; break;
-        case IR4: value = r[4]; break;
-        case IR5: value = r[5]; break;
-        case IR6: value = r[6]; break;
-        case IR7: value = r[7]; break;
-        default: STOP = 1; break;
+        fprintf(stderr, "can not load golden image %s\n", filename);
+        return false;
     }
 
-    switch (destination_register_h) 
-    {
-        case IR0: destinationAddress = static_cast<uint16_t>(r[0]) << 8; break;
-        case IR1: destinationAddress = static_cast<uint16_t>(r[1]) << 8; break;
-        case IR2: destinationAddress = static_cast<uint16_t>(r[2]) << 8; break;
-        case IR3: destinationAddress = static_cast<uint16_t>(r[3]) << 8; break;
-        case IR4: destinationAddress = static_cast<uint16_t>(r[4]) << 8; break;
-        case IR5: destinationAddress = static_cast<uint16_t>(r[5]) << 8; break;
-        case IR6: destinationAddress = static_cast<uint16_t>(r[6]) << 8; break;
-        case IR7: destinationAddress = static_cast<uint16_t>(r[7]) << 8; break;
-        default: STOP = 1; break;
-    }
-    
-    switch (destination_register_l) 
-    {
-        case IR0: destinationAddress += static_cast<uint16_t>(r[0]); break;
-        case IR1: destinationAddress += static_cast<uint16_t>(r[1]); break;
-        case IR2: destinationAddress += static_cast<uint16_t>(r[2]); break;
-        case IR3: destinationAddress += static_cast<uint16_t>(r[3]); break;
-        case IR4: destinationAddress += static_cast<uint16_t>(r[4]); break;
-        case IR5: destinationAddress += static_cast<uint16_t>(r[5]); break;
-        case IR6: destinationAddress += static_cast<uint16_t>(r[6]); break;
-        case IR7: destinationAddress += static_cast<uint16_t>(r[7]); break;
-        default: STOP = 1; break;
-    }
-    
-    mem[destinationAddress] = value;
-    
-    ip += 4;
-}
+    const uint32_t differing = diff_memory(expected.get(), m.mem, GOLDEN_SIZE, ranges);
 
-/**
- * Processing a set instruction. This instruction stores imidiate value to a
- * specific register.
- * 
- * SET 0x1A, R0 -> 03 1A 00
- */
-void set_instruction()
-{
-    static uint8_t destination;
-    static uint8_t value;
-
-    value = mem[ip + 1];
-    destination = mem[ip + 2];
+    print_diff(expected.get(), m.mem, ranges);
 
-    switch (destination) 
+    if (differing)
     {
-        case IR0: r[0] = value; break;
-        case IR1: r[1] = value; break;
-        case IR2: r[2] = value; break;
-        case IR3: r[3] = value; break;
-        case IR4: r[4] = value; break;
-        case IR5: r[5] = value; break;
-        case IR6: r[6] = value; break;
-        case IR7: r[7] = value; break;
-        default: STOP = 1; break;
+        printf("memory differs: %u bytes in %u ranges\n", differing, static_cast<uint32_t>(ranges.size()));
+        return false;
     }
 
-    ip += 3;
+    printf("memory matches\n");
+    return true;
 }
 
 /**
- * Processing a push instruction. This instruction stores a register value to
- * a top of the stack.
  *
- * PUSH R0 -> 10 00
- */
-void push_instruction()
-{
-    static uint8_t source;
-    static uint8_t value;
-
-    sp--;
-    value = 0;
-
-    source = mem[ip+1];
-
-    if (source == IIP)
-    {
-        value = static_cast<uint8_t>(ip & 0x00FF);
-        mem[sp] = value;
-        value = static_cast<uint8_t>((ip & 0xFF00) >> 8);
-        mem[sp-1] = value;
-        sp--;
-        ip += 2;
-        return;
-    }
-    
-    if (source == ISP)
-    {
-        value = static_cast<uint8_t>(sp & 0x00FF);
-        mem[sp] = value;
-        value = static_cast<uint8_t>((sp & 0xFF00) >> 8);
-        mem[sp-1] = value;
-        sp--;
-        ip += 2;
-        return;
-    }
-
-    if (source == IBP)
-    {
-        value = static_cast<uint8_t>(bp & 0x00FF);
-        mem[sp] = value;
-        value = static_cast<uint8_t>((bp & 0xFF00) >> 8);
-        mem[sp-1] = value;
-        sp--;
-        ip += 2;
-        return;
-    }
-
-    switch (source) 
-    {
-    case IR0: value = r[0]; break;
-    case IR1: value = r[1]; break;
-    case IR2: value = r[2]; break;
-    case IR3: value = r[3]; break;
-    case IR4: value = r[4]; break;
-    case IR5: value = r[5]; break;
-    case IR6: value = r[6]; break;
-    case IR7: value = r[7]; break;
-    default: STOP = 1; break;
-    }
-
-    mem[sp] = value;
-
-    ip+= 2;
-}
-
-/**
- * Processing a pop instruction. This instruction stores value on top of the
- * stack to a specific register.
+ * Dumps the final state of the machine, with a golden image only the
+ * memory which differs from it.
  *
- * POP R0 -> 11 00
  */
-void pop_instruction()
+void print_state(const Machine &m)
 {
-    static uint8_t source;
-    static uint16_t value;
-
-    value = 0;
-
-    source = mem[ip+1];
-
-    if (source == IIP)
+    if (golden)
     {
-        value = (static_cast<uint16_t>(mem[sp]) << 8) + static_cast<uint16_t>(mem[sp + 1]);
-        ip = value;
-        sp += 2;
-        ip += 2;
-        return;
+        golden_failed = !check_golden(m, golden);
     }
-    if (source == ISP)
+    else
     {
-        value = (static_cast<uint16_t>(mem[sp]) << 8) + static_cast<uint16_t>(mem[sp + 1]);
-        sp = value;
-        sp += 2;
-        ip += 2;
-        return;
+        print_memory(m);
     }
-    if (source == IBP)
-    {
-        value = (static_cast<uint16_t>(mem[sp]) << 8) + static_cast<uint16_t>(mem[sp + 1]);
-        bp = value;
-        sp += 2;
-        ip += 2;
-        return;
-    }
-    
-    value = static_cast<uint16_t>(mem[sp]);
-
-    switch (source) 
-    {
-    case IR0: r[0] = static_cast<uint8_t>(value); break;
-    case IR1: r[1] = static_cast<uint8_t>(value); break;
-    case IR2: r[2] = static_cast<uint8_t>(value); break;
-    case IR3: r[3] = static_cast<uint8_t>(value); break;
-    case IR4: r[4] = static_cast<uint8_t>(value); break;
-    case IR5: r[5] = static_cast<uint8_t>(value); break;
-    case IR6: r[6] = static_cast<uint8_t>(value); break;
-    case IR7: r[7] = static_cast<uint8_t>(value); break;
-    default: STOP = 1; break;
-    }
-
-    sp++;
-    ip+= 2;
-}
 
-/*
- *
- * Increase Instruction. Increases register value by 1.
- *
- */
-void inc_instruction()
-{
-    static uint8_t what;
-    
-    what = mem[ip + 1];
+    print_registers(m);
 
-    switch (what) 
+    if (golden_output && !write_golden(golden_output, m.mem))
     {
-        case IR0: r[0]++; c = r[0] == 0x00 ? 1 : 0; break;
-        case IR1: r[1]++; c = r[1] == 0x00 ? 1 : 0; break;
-        case IR2: r[2]++; c = r[2] == 0x00 ? 1 : 0; break;
-        case IR3: r[3]++; c = r[3] == 0x00 ? 1 : 0; break;
-        case IR4: r[4]++; c = r[4] == 0x00 ? 1 : 0; break;
-        case IR5: r[5]++; c = r[5] == 0x00 ? 1 : 0; break;
-        case IR6: r[6]++; c = r[6] == 0x00 ? 1 : 0; break;
-        case IR7: r[7]++; c = r[7] == 0x00 ? 1 : 0; break;
-        default: STOP = 1; break;
+        fprintf(stderr, "can not write golden image %s\n", golden_output);
+        golden_failed = true;
     }
-
-    ip += 2;
-}
-
-/*
- *
- * Decrease Instruction. Decreases register value by 1.
- *
- */
-void dec_instruction()
-{
-    static uint8_t what;
-    
-    what = mem[ip + 1];
-
-    switch (what) 
-    {
-        case IR0: r[0]--; c = r[0] == 0xFF ? 1 : 0; break;
-        case IR1: r[1]--; c = r[1] == 0xFF ? 1 : 0; break;
-        case IR2: r[2]--; c = r[2] == 0xFF ? 1 : 0; break;
-        case IR3: r[3]--; c = r[3] == 0xFF ? 1 : 0; break;
-        case IR4: r[4]--; c = r[4] == 0xFF ? 1 : 0; break;
-        case IR5: r[5]--; c = r[5] == 0xFF ? 1 : 0; break;
-        case IR6: r[6]--; c = r[6] == 0xFF ? 1 : 0; break;
-        case IR7: r[7]--; c = r[7] == 0xFF ? 1 : 0; break;
-        default: STOP = 1; break;
-    }
-
-    ip += 2;
 }
 
 /**
  *
- * JMP instruction. Jumps to a specific 16 bit address.
+ * Tells about a machine stopped by a fault (an invalid opcode or register
+ * operand, a division by zero) instead of HALT.
  *
  */
-void jmp_instruction()
+void report_fault(const Machine &m)
 {
-    static uint16_t jump_address;
-
-    jump_address = static_cast<uint16_t>(mem[ip + 1]) << 8;
-    jump_address += static_cast<uint16_t>(mem[ip + 2]);
-
-    ip = jump_address;
-}
-
-/**
- *
- * compares register to a value. If register value is less than imediate value
- * it sets the carry bit to true. Does subtraction on the backend. Subtracted
- * value is set in the register that has been used for comparison.
- *
- */
-void cmp_instruction()
-{
-    static uint8_t source_register;
-    static uint8_t value;
-    
-    source_register = mem[ip + 1];
-    value = mem[ip + 2];
-    
-    switch (source_register) 
+    if (m.stop & (STOP_INVALID_OPCODE | STOP_INVALID_REGISTER | STOP_DIVIDE_BY_ZERO))
     {
-        case IR0: c = r[0] >= value ? 0 : 1; r[0] -= value; break;
-        case IR1: c = r[1] >= value ? 0 : 1; r[1] -= value; break;
-        case IR2: c = r[2] >= value ? 0 : 1; r[2] -= value; break;
-        case IR3: c = r[3] >= value ? 0 : 1; r[3] -= value; break;
-        case IR4: c = r[4] >= value ? 0 : 1; r[4] -= value; break;
-        case IR5: c = r[5] >= value ? 0 : 1; r[5] -= value; break;
-        case IR6: c = r[6] >= value ? 0 : 1; r[6] -= value; break;
-        case IR7: c = r[7] >= value ? 0 : 1; r[7] -= value; break;
-        default: STOP = 1; break;
+        fprintf(stderr, "stopped by %s, IP = 0x%04x\n", stop_reason(m.stop), m.ip);
     }
-    
-    ip += 3;
 }
 
 /**
  *
- * compares register to another register. If register value is less than
- * imediate value it sets the carry bit to true. Does subtraction on the
- * backend. Subtracted value is set in the register that has been used 
- * for comparison.
+ * Runs the machine with the engine selected at build time (see the
+ * SOPHIA8_ENGINE cmake option) and dumps its state.
  *
  */
-void cmpr_instruction()
+void run(Machine &m)
 {
-    static uint8_t register0;
-    static uint8_t register1;
-    static uint8_t value;
-    
-    register0 = mem[ip + 1];
-    register1 = mem[ip + 2];
-    
-    switch (register1) 
-    {
-        case IR0: value = r[0]; break;
-        case IR1: value = r[1]; break;
-        case IR2: value = r[2]; break;
-        case IR3: value = r[3]; break;
-        case IR4: value = r[4]; break;
-        case IR5: value = r[5]; break;
-        case IR6: value = r[6]; break;
-        case IR7: value = r[7]; break;
-        default: STOP = 1; break;
-    }
-    
-    switch (register0) 
-    {
-        case IR0: c = r[0] >= value ? 0 : 1;  r[0] -= value; break;
-        case IR1: c = r[1] >= value ? 0 : 1;  r[1] -= value; break;
-        case IR2: c = r[2] >= value ? 0 : 1;  r[2] -= value; break;
-        case IR3: c = r[3] >= value ? 0 : 1;  r[3] -= value; break;
-        case IR4: c = r[4] >= value ? 0 : 1;  r[4] -= value; break;
-        case IR5: c = r[5] >= value ? 0 : 1;  r[5] -= value; break;
-        case IR6: c = r[6] >= value ? 0 : 1;  r[6] -= value; break;
-        case IR7: c = r[7] >= value ? 0 : 1;  r[7] -= value; break;
-        default: STOP = 1; break;
-    }
-    
-    ip += 3;
-}
+#if defined(SOPHIA8_ENGINE_SWITCH)
+    run_switch(m);
+#elif defined(SOPHIA8_ENGINE_PREDECODED)
+    run_predecoded(m);
+#elif defined(SOPHIA8_ENGINE_JIT)
+    run_jit(m);
+#else
+    run_threaded(m);
+#endif
 
-/**
- *
- * "Jump if zero" instruction. Jumps to a specific 16 bit address if selected
- * register is set to zero.
- *
- */
-void jz_instruction()
-{
-    static uint8_t sourceRegister;
-    static uint16_t jumpAddress;
-    
-    sourceRegister = mem[ip + 1];
-    
-    jumpAddress = static_cast<uint16_t>(mem[ip + 2]) << 8;
-    jumpAddress += static_cast<uint16_t>(mem[ip + 3]);
-    
-    switch (sourceRegister) 
-    {
-        case IR0: if (r[0] == 0) {ip = jumpAddress; return;} break;
-        case IR1: if (r[1] == 0) {ip = jumpAddress; return;} break;
-        case IR2: if (r[2] == 0) {ip = jumpAddress; return;} break;
-        case IR3: if (r[3] == 0) {ip = jumpAddress; return;} break;
-        case IR4: if (r[4] == 0) {ip = jumpAddress; return;} break;
-        case IR5: if (r[5] == 0) {ip = jumpAddress; return;} break;
-        case IR6: if (r[6] == 0) {ip = jumpAddress; return;} break;
-        case IR7: if (r[7] == 0) {ip = jumpAddress; return;} break;
-        default: STOP = 1; break;
-    }
-    
-    ip += 4;
+    print_state(m);
+    report_fault(m);
 }
 
 /**
  *
- * "Jump if not zero" instruction. Jumps to a specific 16 bit address if
- * selected register is not set to zero.
+ * Runs the machine for a budget of instructions at most (checked at the
+ * ends of the basic blocks) and dumps its state with the stop reason.
  *
  */
-void jnz_instruction()
+void run_budgeted(Machine &m, const uint64_t budget)
 {
-    static uint8_t source_register;
-    static uint16_t jump_address;
-    
-    source_register = mem[ip + 1];
-    
-    jump_address = static_cast<uint16_t>(mem[ip + 2]) << 8;
-    jump_address += static_cast<uint16_t>(mem[ip + 3]);
-    
-    switch (source_register) 
-    {
-        case IR0: if (r[0] != 0) {ip = jump_address; return;} break;
-        case IR1: if (r[1] != 0) {ip = jump_address; return;} break;
-        case IR2: if (r[2] != 0) {ip = jump_address; return;} break;
-        case IR3: if (r[3] != 0) {ip = jump_address; return;} break;
-        case IR4: if (r[4] != 0) {ip = jump_address; return;} break;
-        case IR5: if (r[5] != 0) {ip = jump_address; return;} break;
-        case IR6: if (r[6] != 0) {ip = jump_address; return;} break;
-        case IR7: if (r[7] != 0) {ip = jump_address; return;} break;
-        default: STOP = 1; break;
-    }
-    
-    ip += 4;
-}
+    uint64_t executed = 0;
+    const uint8_t reason = run_budget(m, budget, executed);
 
-/**
- *
- * "Jump if carry set" instruction. Jumps to a specific 16 bit address if
- * carry is set.
- *
- */
-void jc_instruction()
-{
-    static uint16_t jumpAddress;
-    
-    jumpAddress = static_cast<uint16_t>(mem[ip + 1]) << 8;
-    jumpAddress += static_cast<uint16_t>(mem[ip + 2]);
-    
-    if (c != 0)
-    {
-        ip = jumpAddress;
-        return;
-    }
-    
-    ip += 3;
+    print_state(m);
+    printf("stop = %s after %llu instructions\n", stop_reason(reason), static_cast<unsigned long long>(executed));
+    report_fault(m);
 }
 
 /**
  *
- * "Jump if carry not set" instruction. Jumps to a specific 16 bit address if
- * carry is not set.
+ * Runs the machine by cycles at the given clock rate (0 - as fast as
+ * possible) and dumps its state with the number of cycles it took.
  *
  */
-void jnc_instruction()
+void run_clocked(Machine &m, const uint64_t hz)
 {
-    static uint16_t jumpAddress;
-    
-    jumpAddress = static_cast<uint16_t>(mem[ip + 1]) << 8;
-    jumpAddress += static_cast<uint16_t>(mem[ip + 2]);
-    
-    if (c == 0)
-    {
-        ip = jumpAddress;
-        return;
-    }
-    
-    ip += 3;
-}
+    scheduler s;
 
-/**
- *
- * Add instruction. Adds a value to a register.
- *
- */
-void add_instruction()
-{
-    static uint8_t dest_register;
-    static uint8_t value;
-    
-    value = mem[ip + 1];
-    dest_register = mem[ip + 2];
-    
-    switch (dest_register)
-    {
-        case IR0: c = static_cast<uint16_t>(r[0]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[0] += value; break;
-        case IR1: c = static_cast<uint16_t>(r[1]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[1] += value; break;
-        case IR2: c = static_cast<uint16_t>(r[2]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[2] += value; break;
-        case IR3: c = static_cast<uint16_t>(r[3]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[3] += value; break;
-        case IR4: c = static_cast<uint16_t>(r[4]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[4] += value; break;
-        case IR5: c = static_cast<uint16_t>(r[5]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[5] += value; break;
-        case IR6: c = static_cast<uint16_t>(r[6]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[6] += value; break;
-        case IR7: c = static_cast<uint16_t>(r[7]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[7] += value; break;
-        default: STOP = 1; break;
-    }
-    
-    ip += 3;
-}
+    init_scheduler(s, hz);
+    run_scheduled(s, m, UINT64_MAX);
 
-/**
- *
- * Addr instruction. Adds a value of a specific register to a value in destination register.
- *
- */
-void addr_instruction()
-{
-    static uint8_t destRegister;
-    static uint8_t sourceRegister;
-    static uint8_t value;
-    
-    sourceRegister = mem[ip + 1];
-    destRegister = mem[ip + 2];
-    
-    switch (sourceRegister)
-    {
-        case IR0: value = r[0]; break;
-        case IR1: value = r[1]; break;
-        case IR2: value = r[2]; break;
-        case IR3: value = r[3]; break;
-        case IR4: value = r[4]; break;
-        case IR5: value = r[5]; break;
-        case IR6: value = r[6]; break;
-        case IR7: value = r[7]; break;
-        default: STOP = 1; break;
-    }
-    
-    switch (destRegister)
-    {
-        case IR0: c = static_cast<uint16_t>(r[0]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[0] += value; break;
-        case IR1: c = static_cast<uint16_t>(r[1]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[1] += value; break;
-        case IR2: c = static_cast<uint16_t>(r[2]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[2] += value; break;
-        case IR3: c = static_cast<uint16_t>(r[3]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[3] += value; break;
-        case IR4: c = static_cast<uint16_t>(r[4]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[4] += value; break;
-        case IR5: c = static_cast<uint16_t>(r[5]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[5] += value; break;
-        case IR6: c = static_cast<uint16_t>(r[6]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[6] += value; break;
-        case IR7: c = static_cast<uint16_t>(r[7]) + static_cast<uint16_t>(value) > 0xFF ? 1 : 0; r[7] += value; break;
-        default: STOP = 1; break;
-    }
-    
-    ip += 3;
+    print_state(m);
+    printf("cycles = %llu\n", static_cast<unsigned long long>(m.cycles));
+    report_fault(m);
 }
 
 /**
  *
- * Call instruction. Jumps to a specified address and pushes return instruction
- * address onto a stack.
+ * Runs the machine with the profiling switch engine, writes the profile
+ * report and dumps the state. The report names the addresses by the labels
+ * of the image when the program is one.
  *
  */
-void call_instruction()
+bool run_profile(Machine &m, const char *report, const char *image)
 {
-    static uint16_t callAddress;
-    static uint16_t returnAddress;
-    
-    callAddress = static_cast<uint16_t>(mem[ip + 1]) << 8;
-    callAddress += static_cast<uint16_t>(mem[ip + 2]);
-    
-    returnAddress = ip + 3;
-    
-    mem[sp - 2] = static_cast<uint8_t>((returnAddress & 0xFF00) >> 8);
-    mem[sp - 1] = static_cast<uint8_t>(returnAddress & 0x00FF);
-    sp -= 2;
-    
-    ip = callAddress;
-}
+    std::unique_ptr<profile> p(new profile());
+    std::vector<std::pair<uint16_t, std::string>> labels;
 
-/**
- *
- * Ret instruction. Returns from a procedure using the top of the stack as a
- * return address.
- *
- */
-void ret_instruction()
-{
-    ip = static_cast<uint16_t>(mem[sp]) << 8;
-    ip += static_cast<uint16_t>(mem[sp + 1]);
-    sp += 2;
-}
+    init_profile(*p, m.ip);
+    run_profiled(m, *p);
+    finish_profile(*p);
 
-/**
- *
- * Sub instruction. Subtracts a value from a register.
- *
- */
-void sub_instruction()
-{
-    static uint8_t destRegister;
-    static uint8_t value;
-    
-    value = mem[ip + 1];
-    destRegister = mem[ip + 2];
-    
-    switch (destRegister)
-    {
-        case IR0: c = r[0] < value ? 1 : 0; r[0] -= value; break;
-        case IR1: c = r[1] < value ? 1 : 0; r[1] -= value; break;
-        case IR2: c = r[2] < value ? 1 : 0; r[2] -= value; break;
-        case IR3: c = r[3] < value ? 1 : 0; r[3] -= value; break;
-        case IR4: c = r[4] < value ? 1 : 0; r[4] -= value; break;
-        case IR5: c = r[5] < value ? 1 : 0; r[5] -= value; break;
-        case IR6: c = r[6] < value ? 1 : 0; r[6] -= value; break;
-        case IR7: c = r[7] < value ? 1 : 0; r[7] -= value; break;
-        default: STOP = 1; break;
-    }
-    
-    ip += 3;
-}
+    if (image) load_labels(image, labels);
 
-/**
- *
- * Subr instruction. Subtracts a value of a specific register from a value in destination register.
- *
- */
-void subr_instruction()
-{
-    static uint8_t dest_register;
-    static uint8_t source_register;
-    static uint8_t value;
-    
-    source_register = mem[ip + 1];
-    dest_register = mem[ip + 2];
-    
-    switch (source_register)
-    {
-        case IR0: value = r[0]; break;
-        case IR1: value = r[1]; break;
-        case IR2: value = r[2]; break;
-        case IR3: value = r[3]; break;
-        case IR4: value = r[4]; break;
-        case IR5: value = r[5]; break;
-        case IR6: value = r[6]; break;
-        case IR7: value = r[7]; break;
-        default: STOP = 1; break;
-    }
-    
-    switch (dest_register)
-    {
-        case IR0: c = r[0] < value ? 1 : 0; r[0] -= value; break;
-        case IR1: c = r[1] < value ? 1 : 0; r[1] -= value; break;
-        case IR2: c = r[2] < value ? 1 : 0; r[2] -= value; break;
-        case IR3: c = r[3] < value ? 1 : 0; r[3] -= value; break;
-        case IR4: c = r[4] < value ? 1 : 0; r[4] -= value; break;
-        case IR5: c = r[5] < value ? 1 : 0; r[5] -= value; break;
-        case IR6: c = r[6] < value ? 1 : 0; r[6] -= value; break;
-        case IR7: c = r[7] < value ? 1 : 0; r[7] -= value; break;
-        default: STOP = 1; break;
-    }
-    
-    ip += 3;
-}
+    print_state(m);
 
-/**
- *
- * Mul instruction. multiplies a register by value. Saves result into two
- * registers.
- *
- */
-void mul_instruction()
-{
-    static uint8_t dest_register_l;
-    static uint8_t dest_register_h;
-    static uint16_t value;
-    static uint16_t result;
-    
-    value = static_cast<uint16_t>(mem[ip + 1]);
-    dest_register_h = mem[ip + 2];
-    dest_register_l = mem[ip + 3];
-    
-    switch (dest_register_l)
-    {
-        case IR0: 
-            result = static_cast<uint16_t>(r[0]) * value;
-            r[0] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        case IR1: 
-            result = static_cast<uint16_t>(r[1]) * value; 
-            r[1] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        case IR2: 
-            result = static_cast<uint16_t>(r[2]) * value; 
-            r[2] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        case IR3: 
-            result = static_cast<uint16_t>(r[3]) * value; 
-            r[3] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        case IR4: 
-            result = static_cast<uint16_t>(r[4]) * value; 
-            r[4] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        case IR5: 
-            result = static_cast<uint16_t>(r[5]) * value; 
-            r[5] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        case IR6: 
-            result = static_cast<uint16_t>(r[6]) * value; 
-            r[6] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        case IR7: 
-            result = static_cast<uint16_t>(r[7]) * value; 
-            r[7] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        default: STOP = 1; break;
-    }
-    
-    c = result > 0xFF ? 1 : 0;
-    
-    switch (dest_register_h)
+    if (!write_profile(*p, m, labels, report))
     {
-        case IR0: r[0] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        case IR1: r[1] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        case IR2: r[2] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        case IR3: r[3] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        case IR4: r[4] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        case IR5: r[5] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        case IR6: r[6] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        case IR7: r[7] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        default: STOP = 1; break;
+        fprintf(stderr, "can not write profile %s\n", report);
+        return false;
     }
-    
-    ip += 4;
-}
 
-/**
- *
- * Mulr instruction. Multiplies register value by a register value. Saves 
- * result into two registers.
- *
- */
-void mulr_instruction()
-{
-    static uint8_t srcRegister;
-    static uint8_t destRegisterL;
-    static uint8_t destRegisterH;
-    static uint16_t value;
-    static uint16_t result;
-    
-    srcRegister = mem[ip + 1];
-    destRegisterH = mem[ip + 2];
-    destRegisterL = mem[ip + 3];
-    
-    switch (srcRegister)
-    {
-        case IR0: value = static_cast<uint16_t>(r[0]); break;
-        case IR1: value = static_cast<uint16_t>(r[1]); break;
-        case IR2: value = static_cast<uint16_t>(r[2]); break;
-        case IR3: value = static_cast<uint16_t>(r[3]); break;
-        case IR4: value = static_cast<uint16_t>(r[4]); break;
-        case IR5: value = static_cast<uint16_t>(r[5]); break;
-        case IR6: value = static_cast<uint16_t>(r[6]); break;
-        case IR7: value = static_cast<uint16_t>(r[7]); break;
-        default: STOP = 1; break;
-    }
-    
-    switch (destRegisterL)
-    {
-        case IR0: 
-            result = static_cast<uint16_t>(r[0]) * value;
-            r[0] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        case IR1: 
-            result = static_cast<uint16_t>(r[1]) * value; 
-            r[1] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        case IR2: 
-            result = static_cast<uint16_t>(r[2]) * value; 
-            r[2] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        case IR3: 
-            result = static_cast<uint16_t>(r[3]) * value; 
-            r[3] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        case IR4: 
-            result = static_cast<uint16_t>(r[4]) * value; 
-            r[4] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        case IR5: 
-            result = static_cast<uint16_t>(r[5]) * value; 
-            r[5] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        case IR6: 
-            result = static_cast<uint16_t>(r[6]) * value; 
-            r[6] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        case IR7: 
-            result = static_cast<uint16_t>(r[7]) * value; 
-            r[7] = static_cast<uint8_t>(result & 0x00FF); 
-            break;
-        default: STOP = 1; break;
-    }
-    
-    c = result > 0xFF ? 1 : 0;
-    
-    switch (destRegisterH)
-    {
-        case IR0: r[0] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        case IR1: r[1] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        case IR2: r[2] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        case IR3: r[3] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        case IR4: r[4] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        case IR5: r[5] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        case IR6: r[6] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        case IR7: r[7] = static_cast<uint8_t>((result & 0xFF00) >> 8); break;
-        default: STOP = 1; break;
-    }
-    
-    ip += 4;
-}
-
-/**
- *
- * Div instruction. divides a register by value. Saves results into two
- * registers. First register holds rusult of the dision, and the second
- * the rest of the division.
- *
- */
-void divInstruction()
-{
-    static uint8_t dest_register_result;
-    static uint8_t dest_register_rest;
-    static uint8_t value;
-    static uint8_t result;
-    static uint8_t rest;
-    
-    value = mem[ip + 1];
-    dest_register_result = mem[ip + 2];
-    dest_register_rest = mem[ip + 3];
-    
-    switch (dest_register_result)
-    {
-        case IR0: result = r[0] / value; rest = r[0] % value; r[0] = result; break;
-        case IR1: result = r[1] / value; rest = r[1] % value; r[1] = result; break;
-        case IR2: result = r[2] / value; rest = r[2] % value; r[2] = result; break;
-        case IR3: result = r[3] / value; rest = r[3] % value; r[3] = result; break;
-        case IR4: result = r[4] / value; rest = r[4] % value; r[4] = result; break;
-        case IR5: result = r[5] / value; rest = r[5] % value; r[5] = result; break;
-        case IR6: result = r[6] / value; rest = r[6] % value; r[6] = result; break;
-        case IR7: result = r[7] / value; rest = r[7] % value; r[7] = result; break;
-        default: STOP = 1; break;
-    }
-    
-    switch (dest_register_rest)
-    {
-        case IR0: r[0] = rest; break;
-        case IR1: r[1] = rest; break;
-        case IR2: r[2] = rest; break;
-        case IR3: r[3] = rest; break;
-        case IR4: r[4] = rest; break;
-        case IR5: r[5] = rest; break;
-        case IR6: r[6] = rest; break;
-        case IR7: r[7] = rest; break;
-        default: STOP = 1; break;
-    }
-    
-    ip += 4;
-}
-
-/**
- *
- * Divr instruction. divides a register by another register. Saves results into
- * two registers. First register holds rusult of the dision, and the second
- * the rest of the division.
- *
- */
-void divr_instruction()
-{
-    static uint8_t src_register;
-    static uint8_t dest_register_result;
-    static uint8_t dest_register_rest;
-    static uint8_t value;
-    static uint8_t result;
-    static uint8_t rest;
-    
-    src_register = mem[ip + 1];
-    
-    switch (src_register)
-    {
-        case IR0: value = r[0]; break;
-        case IR1: value = r[1]; break;
-        case IR2: value = r[2]; break;
-        case IR3: value = r[3]; break;
-        case IR4: value = r[4]; break;
-        case IR5: value = r[5]; break;
-        case IR6: value = r[6]; break;
-        case IR7: value = r[7]; break;
-        default: STOP = 1; break;
-    }
-    
-    dest_register_result = mem[ip + 2];
-    dest_register_rest = mem[ip + 3];
-    
-    switch (dest_register_result)
-    {
-        case IR0: result = r[0] / value; rest = r[0] % value; r[0] = result; break;
-        case IR1: result = r[1] / value; rest = r[1] % value; r[1] = result; break;
-        case IR2: result = r[2] / value; rest = r[2] % value; r[2] = result; break;
-        case IR3: result = r[3] / value; rest = r[3] % value; r[3] = result; break;
-        case IR4: result = r[4] / value; rest = r[4] % value; r[4] = result; break;
-        case IR5: result = r[5] / value; rest = r[5] % value; r[5] = result; break;
-        case IR6: result = r[6] / value; rest = r[6] % value; r[6] = result; break;
-        case IR7: result = r[7] / value; rest = r[7] % value; r[7] = result; break;
-        default: STOP = 1; break;
-    }
-    
-    switch (dest_register_rest)
-    {
-        case IR0: r[0] = rest; break;
-        case IR1: r[1] = rest; break;
-        case IR2: r[2] = rest; break;
-        case IR3: r[3] = rest; break;
-        case IR4: r[4] = rest; break;
-        case IR5: r[5] = rest; break;
-        case IR6: r[6] = rest; break;
-        case IR7: r[7] = rest; break;
-        default: STOP = 1; break;
-    }
-    
-    ip += 4;
-}
-
-/*
- *
- * Shifts value to the right. If last shifted bit was 1, then sets carry to 1.
- *
- */
-void shrInstruction()
-{
-    static uint8_t what;
-    static uint8_t val;
-    
-    val = mem[ip + 1];
-    what = mem[ip + 2];
-
-    switch (what) 
-    {
-        case IR0: c = (r[0] >> (val - 1)) % 2; r[0] >>= val; break;
-        case IR1: c = (r[1] >> (val - 1)) % 2; r[1] >>= val; break;
-        case IR2: c = (r[2] >> (val - 1)) % 2; r[2] >>= val; break;
-        case IR3: c = (r[3] >> (val - 1)) % 2; r[3] >>= val; break;
-        case IR4: c = (r[4] >> (val - 1)) % 2; r[4] >>= val; break;
-        case IR5: c = (r[5] >> (val - 1)) % 2; r[5] >>= val; break;
-        case IR6: c = (r[6] >> (val - 1)) % 2; r[6] >>= val; break;
-        case IR7: c = (r[7] >> (val - 1)) % 2; r[7] >>= val; break;
-        default: STOP = 1; break;
-    }
-
-    ip += 3;
-}
-
-/*
- *
- * Shifts value to the left. If last shifted bit was 1, then sets carry to 1.
- *
- */
-void shl_instruction()
-{
-    static uint8_t what;
-    static uint8_t val;
-    
-    val = mem[ip + 1];
-    what = mem[ip + 2];
-
-    switch (what) 
-    {
-        case IR0: c = r[0] << (val - 1) > 127 ? 1 : 0; r[0] <<= val; break;
-        case IR1: c = r[1] << (val - 1) > 127 ? 1 : 0; r[1] <<= val; break;
-        case IR2: c = r[2] << (val - 1) > 127 ? 1 : 0; r[2] <<= val; break;
-        case IR3: c = r[3] << (val - 1) > 127 ? 1 : 0; r[3] <<= val; break;
-        case IR4: c = r[4] << (val - 1) > 127 ? 1 : 0; r[4] <<= val; break;
-        case IR5: c = r[5] << (val - 1) > 127 ? 1 : 0; r[5] <<= val; break;
-        case IR6: c = r[6] << (val - 1) > 127 ? 1 : 0; r[6] <<= val; break;
-        case IR7: c = r[7] << (val - 1) > 127 ? 1 : 0; r[7] <<= val; break;
-        default: STOP = 1; break;
-    }
-
-    ip += 3;
-}
-
-/**
- *
- * Processes instruction. If unknown instruction or halt, then the VM stops.
- *
- */
-void process_instruction()
-{
-    switch (mem[ip])
-    {
-        case LOAD: load_instruction(); break;
-        case STORE: store_instruction(); break;
-        case STORER: storer_instruction(); break;
-        case SET: set_instruction(); break;
-        case PUSH: push_instruction(); break;
-        case POP: pop_instruction(); break;
-        case INC: inc_instruction(); break;
-        case DEC: dec_instruction(); break;
-        case JMP: jmp_instruction(); break;
-        case CMP: cmp_instruction(); break;
-        case CMPR: cmpr_instruction(); break;
-        case JZ: jz_instruction(); break;
-        case JNZ: jnz_instruction(); break;
-        case JC: jc_instruction(); break;
-        case JNC: jnc_instruction(); break;
-        case ADD: add_instruction(); break;
-        case ADDR: addr_instruction(); break;
-        case CALL: call_instruction(); break;
-        case RET: ret_instruction(); break;
-        case SUB: sub_instruction(); break;
-        case SUBR: subr_instruction(); break;
-        case MUL: mul_instruction(); break;
-        case MULR: mulr_instruction(); break;
-        case DIV: divInstruction(); break;
-        case DIVR: divr_instruction(); break;
-        case SHL: shl_instruction(); break;
-        case SHR: shrInstruction(); break;
-        case NOP: ip++; break;
-        default: STOP = 1; break;
-    }
+    return true;
 }
 
 /**
  *
- * Prints Memory
+ * Runs the machine with the tracing switch engine, writes the trace to the
+ * file and dumps the state (sophia8 --replay reads the trace).
  *
  */
-void print_memory()
+bool run_trace(Machine &m, const char *filename)
 {
-    for (uint16_t i = 0; i < MEM_SIZE; i++)
-    {
-        if (i % 64 == 0)
-        {
-            // ReSharper disable once CppPrintfRiskyFormat
-            printf("\n%#06x:", i);
-        }
-
-        printf(" %02x", mem[i]);
-    }
-
-    printf("\n");
-}
+    trace_writer t;
 
-/**
- *
- * Print registers
- *
- */
-void print_registers()
-{
-    for (uint8_t i = 0; i < 8; i++)
+    if (!open_trace(t, filename, TRACE_INTERVAL))
     {
-        printf("R%d = 0x%02x ", i, r[i]);
+        fprintf(stderr, "can not create trace %s\n", filename);
+        return false;
     }
 
-    printf("IP = 0x%04x ", ip);
-    printf("SP = 0x%04x ", sp);
-    printf("BP = 0x%04x ", bp);
-    printf("C = %d\n", c ? 1 : 0);
-}
+    run_traced(m, t);
 
-void run()
-{
-    while (!STOP)
+    if (!close_trace(t))
     {
-        process_instruction();
+        fprintf(stderr, "can not write trace %s\n", filename);
+        return false;
     }
 
-    print_memory();
-    print_registers();
+    print_state(m);
+    return true;
 }
 
-void load_test_code()
+void load_test_code(Machine &m)
 {
     uint8_t test_code[202] = {
         SET,   0x0A,       IR0,        // 3
@@ -1296,20 +306,157 @@ void load_test_code()
 
     for (uint16_t i = 0; i < 202; i++)
     {
-        mem[i] = test_code[i];
+        m.mem[i] = test_code[i];
     }
 }
 
 /**
  *
  * Starts the code until it reaches halt instruction or end of code memory.
+ * Runs the program image given on the command line or the test code, with
+ * --batch runs the given program images in parallel instead, --server
+ * serves batches of jobs for them over a pipe or socket, --display
+ * runs one program image showing its video memory in a window, --replay
+ * replays a trace, --debug runs one program image in the debugger.
+ *
+ *     sophia8 [--charset chars.chr] [--golden ref.s8m] [--write-golden out.s8m]
+ *             [--clock hz | --budget n | --profile report.txt | --trace trace.s8t] [image.s8i]
+ *
+ * With --golden the final memory is compared with a golden image (a memory
+ * written by --write-golden or a program image) and only the differences
+ * are printed, the exit code tells if it matched.
+ * With --charset the character set is copied to CHAR_MEM after loading.
+ * With --clock the machine runs at hz cycles per second (0 - uncapped),
+ * with --budget it is stopped after about n instructions.
+ * With --profile it runs profiled and writes the report to the file, with
+ * --trace it records the execution trace to the file.
  *
  */
-int main()
+int main(int argc, char *argv[])
 {
-    init_machine();
-    load_test_code();
-    run();
-    return 0;
-}
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0)
+    {
+        return batch_main(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--server") == 0)
+    {
+        return server_main(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--display") == 0)
+    {
+        return display_main(argc, argv);
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--replay") == 0)
+    {
+        return replay_main(argc, argv);
+    }
 
+    if (argc > 1 && strcmp(argv[1], "--debug") == 0)
+    {
+        return debug_main(argc, argv);
+    }
+
+    std::unique_ptr<Machine> m(new Machine());
+    bool clocked = false;
+    uint64_t hz = 0;
+    bool budgeted = false;
+    uint64_t budget = 0;
+    const char *report = nullptr;
+    const char *trace = nullptr;
+    const char *charset = nullptr;
+
+    while (argc > 2 && strncmp(argv[1], "--", 2) == 0)
+    {
+        if (strcmp(argv[1], "--clock") == 0)
+        {
+            clocked = true;
+            hz = strtoull(argv[2], nullptr, 0);
+        }
+        else if (strcmp(argv[1], "--budget") == 0)
+        {
+            budgeted = true;
+            budget = strtoull(argv[2], nullptr, 0);
+        }
+        else if (strcmp(argv[1], "--profile") == 0)
+        {
+            report = argv[2];
+        }
+        else if (strcmp(argv[1], "--trace") == 0)
+        {
+            trace = argv[2];
+        }
+        else if (strcmp(argv[1], "--charset") == 0)
+        {
+            charset = argv[2];
+        }
+        else if (strcmp(argv[1], "--golden") == 0)
+        {
+            golden = argv[2];
+        }
+        else if (strcmp(argv[1], "--write-golden") == 0)
+        {
+            golden_output = argv[2];
+        }
+        else
+        {
+            break;
+        }
+
+        argc -= 2;
+        argv += 2;
+    }
+
+    if (clocked + budgeted + (report != nullptr) + (trace != nullptr) > 1)
+    {
+        fprintf(stderr, "--clock, --budget, --profile and --trace can not be combined\n");
+        return 1;
+    }
+
+    if (argc > 1)
+    {
+        if (!load_program(*m, argv[1]))
+        {
+            fprintf(stderr, "can not load image %s\n", argv[1]);
+            return 1;
+        }
+    }
+    else
+    {
+        init_machine(*m);
+        load_test_code(*m);
+    }
+
+    if (charset && !load_charset(charset, m->mem + CHAR_MEM_ADDRESS))
+    {
+        fprintf(stderr, "can not load charset %s\n", charset);
+        return 1;
+    }
+
+    if (report)
+    {
+        return run_profile(*m, report, argc > 1 ? argv[1] : nullptr) && !golden_failed ? 0 : 1;
+    }
+
+    if (trace)
+    {
+        return run_trace(*m, trace) && !golden_failed ? 0 : 1;
+    }
+
+    if (clocked)
+    {
+        run_clocked(*m, hz);
+    }
+    else if (budgeted)
+    {
+        run_budgeted(*m, budget);
+    }
+    else
+    {
+        run(*m);
+    }
+
+    return golden_failed ? 1 : 0;
+}
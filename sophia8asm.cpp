@@ -1,7 +1,92 @@
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+#include "assembler.h"
 #include "assembly_parser.h"
+#include "image.h"
+#include "object_file.h"
+
+void usage()
+{
+    printf("usage: sophia8asm [--cache dir | --no-cache] source.asm [image.s8i]\n");
+    printf("\n");
+    printf("  --cache dir  directory of the cached objects (default .s8cache next to the image)\n");
+    printf("  --no-cache   assemble every file from its source\n");
+}
 
-int main()
+int main(int argc, char *argv[])
 {
-    auto commands = assembly_parser::parse_file(R"(C:\developement\Sophia8\test.asm)");
+    std::string cache_directory;
+    std::vector<std::string> files;
+    auto use_cache = true;
+
+    for (auto i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+        {
+            cache_directory = argv[++i];
+        }
+        else if (strcmp(argv[i], "--no-cache") == 0)
+        {
+            use_cache = false;
+        }
+        else if (argv[i][0] == '-' && argv[i][1] == '-')
+        {
+            usage();
+            return 1;
+        }
+        else
+        {
+            files.emplace_back(argv[i]);
+        }
+    }
+
+    if (files.empty() || files.size() > 2)
+    {
+        usage();
+        return 1;
+    }
+
+    const auto &source = files[0];
+    std::string output = files.size() > 1 ? files[1] : source;
+
+    if (files.size() == 1)
+    {
+        const auto dot = output.find_last_of('.');
+        if (dot != std::string::npos && output.find_first_of("/\\", dot) == std::string::npos) output.erase(dot);
+        output += ".s8i";
+    }
+
+    if (cache_directory.empty())
+    {
+        const auto slash = output.find_last_of("/\\");
+        cache_directory = (slash == std::string::npos ? std::string() : output.substr(0, slash + 1)) + ".s8cache";
+    }
+
+    assembly_parser::source_arena sources;
+    std::unique_ptr<assembler::object_cache> cache;
+    image_builder image;
+    std::vector<std::string> errors;
+    std::vector<std::string> warnings;
+
+    if (use_cache) cache.reset(new assembler::object_cache(cache_directory));
+
+    const auto assembled = assembler::assemble(sources, source, image, errors, warnings, cache.get());
+
+    for (const auto &warning : warnings) fprintf(stderr, "warning: %s\n", warning.c_str());
+
+    if (!assembled)
+    {
+        for (const auto &error : errors) fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    if (!write_image(image, output))
+    {
+        fprintf(stderr, "can not write %s\n", output.c_str());
+        return 1;
+    }
+
     return 0;
 }
@@ -0,0 +1,571 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    sophia8bench.cpp                                                 */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Micro benchmarks of the engines, the assembly parser and the rasterizer.  */
+/* Every workload is built the same way on every run (no random input, no    */
+/* host state), runs a few times to warm up and then the given number of     */
+/* measured times. Each benchmark prints one JSON object per line with the   */
+/* percentiles of the run times, the allocations per run and for the        */
+/* machine workloads MIPS and nanoseconds per instruction:                   */
+/*                                                                           */
+/*     sophia8bench [--runs n] [--filter text] [--chars chars.asm]           */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "assembly_parser.h"
+#include "definitions.h"
+#include "machine.h"
+#include "profiler.h"
+#include "raster.h"
+
+/* ALLOCATIONS ***************************************************************/
+
+static std::atomic<uint64_t> allocations{0};
+
+static void *counted_alloc(const size_t size)
+{
+    void *block = malloc(size ? size : 1);
+
+    if (!block) throw std::bad_alloc();
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return block;
+}
+
+void *operator new(const size_t size)
+{
+    return counted_alloc(size);
+}
+
+void *operator new[](const size_t size)
+{
+    return counted_alloc(size);
+}
+
+void operator delete(void *block) noexcept
+{
+    free(block);
+}
+
+void operator delete[](void *block) noexcept
+{
+    free(block);
+}
+
+void operator delete(void *block, size_t) noexcept
+{
+    free(block);
+}
+
+void operator delete[](void *block, size_t) noexcept
+{
+    free(block);
+}
+
+/* RESULTS *******************************************************************/
+
+#define BENCH_WARMUP    2       /* runs before the measured ones             */
+#define BENCH_RUNS      20      /* measured runs by default                  */
+
+typedef std::chrono::steady_clock bench_clock;
+
+struct bench_result
+{
+    std::string name;
+    std::string variant;        /* engine or video mode                      */
+    std::vector<double> ns;     /* time of every measured run                */
+    uint64_t allocations;       /* over all measured runs                    */
+    uint64_t instructions;      /* per run, 0 - not a machine workload       */
+    uint64_t items;             /* lines or frames per run                   */
+    const char *item;           /* name of the items                         */
+};
+
+static double percentile(const std::vector<double> &sorted, const double p)
+{
+    size_t rank;
+
+    if (sorted.empty()) return 0.0;
+
+    rank = static_cast<size_t>(p / 100.0 * static_cast<double>(sorted.size()) + 0.5);
+    if (rank > 0) rank--;
+    if (rank >= sorted.size()) rank = sorted.size() - 1;
+
+    return sorted[rank];
+}
+
+static void print_result(const bench_result &result)
+{
+    std::vector<double> sorted = result.ns;
+    const double runs = static_cast<double>(sorted.size());
+
+    std::sort(sorted.begin(), sorted.end());
+
+    const double median = percentile(sorted, 50.0);
+
+    printf("{\"benchmark\":\"%s\",\"variant\":\"%s\",\"runs\":%zu", result.name.c_str(), result.variant.c_str(),
+           sorted.size());
+    printf(",\"min_ns\":%.0f,\"p50_ns\":%.0f,\"p90_ns\":%.0f,\"p99_ns\":%.0f,\"max_ns\":%.0f", sorted.front(), median,
+           percentile(sorted, 90.0), percentile(sorted, 99.0), sorted.back());
+    printf(",\"allocations_per_run\":%.1f", static_cast<double>(result.allocations) / runs);
+
+    if (result.instructions)
+    {
+        printf(",\"instructions\":%llu,\"mips\":%.2f,\"ns_per_instruction\":%.3f",
+               static_cast<unsigned long long>(result.instructions),
+               static_cast<double>(result.instructions) / median * 1000.0,
+               median / static_cast<double>(result.instructions));
+    }
+
+    if (result.items)
+    {
+        printf(",\"%s\":%llu,\"ns_per_item\":%.1f", result.item, static_cast<unsigned long long>(result.items),
+               median / static_cast<double>(result.items));
+    }
+
+    printf("}\n");
+    fflush(stdout);
+}
+
+/**
+ *
+ * Runs a workload for the warmup and the measured runs. The setup runs
+ * before every run and is neither timed nor counted.
+ *
+ */
+template <typename SETUP, typename RUN>
+static void measure(bench_result &result, const uint32_t runs, SETUP setup, RUN run)
+{
+    uint32_t i;
+
+    result.ns.clear();
+    result.ns.reserve(runs);
+    result.allocations = 0;
+
+    for (i = 0; i < BENCH_WARMUP + runs; i++)
+    {
+        setup();
+
+        const uint64_t allocated = allocations.load(std::memory_order_relaxed);
+        const bench_clock::time_point start = bench_clock::now();
+
+        run();
+
+        const bench_clock::time_point end = bench_clock::now();
+        const uint64_t count = allocations.load(std::memory_order_relaxed) - allocated;
+
+        if (i < BENCH_WARMUP) continue;
+
+        result.ns.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        result.allocations += count;
+    }
+}
+
+/* MACHINE WORKLOADS *********************************************************/
+
+#define HI(address) static_cast<uint8_t>((address) >> 8)
+#define LO(address) static_cast<uint8_t>((address) & 0xFF)
+
+#define COPY_SOURCE     0x4000  /* copied 4 KB                               */
+#define COPY_TARGET     0x8000
+
+static void emit(std::vector<uint8_t> &code, const std::initializer_list<uint8_t> bytes)
+{
+    code.insert(code.end(), bytes);
+}
+
+static uint16_t here(const std::vector<uint8_t> &code)
+{
+    return static_cast<uint16_t>(code.size());
+}
+
+/**
+ *
+ * 256 x 256 iterations of four MULR.
+ *
+ */
+static std::vector<uint8_t> mulr_program()
+{
+    std::vector<uint8_t> code;
+
+    emit(code, {SET, 0x00, IR7});
+    const uint16_t outer = here(code);
+    emit(code, {SET, 0x00, IR6});
+    const uint16_t inner = here(code);
+    emit(code, {SET, 0x07, IR0,
+                SET, 0x0D, IR1,
+                MULR, IR0, IR2, IR1,
+                MULR, IR1, IR3, IR0,
+                MULR, IR0, IR2, IR1,
+                MULR, IR1, IR3, IR0,
+                DEC, IR6,
+                JNZ, IR6, HI(inner), LO(inner),
+                DEC, IR7,
+                JNZ, IR7, HI(outer), LO(outer),
+                HALT});
+    return code;
+}
+
+/**
+ *
+ * 256 x 256 iterations of four DIVR.
+ *
+ */
+static std::vector<uint8_t> divr_program()
+{
+    std::vector<uint8_t> code;
+
+    emit(code, {SET, 0x00, IR7,
+                SET, 0x03, IR1});
+    const uint16_t outer = here(code);
+    emit(code, {SET, 0x00, IR6});
+    const uint16_t inner = here(code);
+    emit(code, {SET, 0xFF, IR0,
+                DIVR, IR1, IR0, IR2,
+                DIVR, IR1, IR0, IR2,
+                DIVR, IR1, IR0, IR2,
+                DIVR, IR1, IR0, IR2,
+                DEC, IR6,
+                JNZ, IR6, HI(inner), LO(inner),
+                DEC, IR7,
+                JNZ, IR7, HI(outer), LO(outer),
+                HALT});
+    return code;
+}
+
+/**
+ *
+ * 256 x 256 iterations pushing and popping four registers.
+ *
+ */
+static std::vector<uint8_t> stack_program()
+{
+    std::vector<uint8_t> code;
+
+    emit(code, {SET, 0x00, IR7});
+    const uint16_t outer = here(code);
+    emit(code, {SET, 0x00, IR6});
+    const uint16_t inner = here(code);
+    emit(code, {PUSH, IR0, PUSH, IR1, PUSH, IR2, PUSH, IR3,
+                POP, IR3, POP, IR2, POP, IR1, POP, IR0,
+                DEC, IR6,
+                JNZ, IR6, HI(inner), LO(inner),
+                DEC, IR7,
+                JNZ, IR7, HI(outer), LO(outer),
+                HALT});
+    return code;
+}
+
+/**
+ *
+ * Binary recursion 18 levels deep (2^19 - 1 calls). The procedure keeps R0:
+ *
+ *     rec:  JZ R0, done
+ *           DEC R0
+ *           CALL rec
+ *           CALL rec
+ *           INC R0
+ *     done: RET
+ *
+ */
+static std::vector<uint8_t> recursion_program()
+{
+    std::vector<uint8_t> code;
+    const uint16_t rec = 7;
+    const uint16_t done = rec + 14;
+
+    emit(code, {SET, 18, IR0,
+                CALL, HI(rec), LO(rec),
+                HALT,
+                JZ, IR0, HI(done), LO(done),
+                DEC, IR0,
+                CALL, HI(rec), LO(rec),
+                CALL, HI(rec), LO(rec),
+                INC, IR0,
+                RET});
+    return code;
+}
+
+/**
+ *
+ * Copies 4 KB 16 times. The bytes are read by POP (the only load from an
+ * address in registers) with the stack pointer moved to the source by
+ * POP SP, and written by STORER.
+ *
+ */
+static std::vector<uint8_t> copy_program()
+{
+    std::vector<uint8_t> code;
+    const uint16_t sp = COPY_SOURCE - 2;
+
+    emit(code, {SET, 16, IR6});
+    const uint16_t top = here(code);
+    emit(code, {SET, LO(sp), IR0, PUSH, IR0,
+                SET, HI(sp), IR0, PUSH, IR0,
+                POP, ISP,
+                SET, HI(COPY_TARGET), IR2,
+                SET, LO(COPY_TARGET), IR3,
+                SET, 0x10, IR5});
+    const uint16_t page = here(code);
+    emit(code, {SET, 0x00, IR4});
+    const uint16_t byte = here(code);
+    emit(code, {POP, IR0,
+                STORER, IR0, IR2, IR3,
+                INC, IR3,
+                DEC, IR4,
+                JNZ, IR4, HI(byte), LO(byte),
+                INC, IR2,
+                DEC, IR5,
+                JNZ, IR5, HI(page), LO(page),
+                DEC, IR6,
+                JNZ, IR6, HI(top), LO(top),
+                HALT});
+    return code;
+}
+
+static void load_code(Machine &m, const std::vector<uint8_t> &code)
+{
+    uint32_t i;
+
+    init_machine(m);
+    memcpy(m.mem, code.data(), code.size());
+
+    for (i = 0; i < 0x1000; i++)
+    {
+        m.mem[COPY_SOURCE + i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+}
+
+struct bench_engine
+{
+    const char *name;
+    void (*run)(Machine &m);
+};
+
+static const bench_engine engines[] = {
+    {"switch", run_switch},
+    {"threaded", run_threaded},
+    {"predecoded", run_predecoded},
+    {"jit", run_jit},
+};
+
+/**
+ *
+ * Runs a machine workload with every engine. The instruction count comes
+ * from one profiled run.
+ *
+ */
+static void bench_machine(const char *name, const std::vector<uint8_t> &code, const uint32_t runs)
+{
+    std::unique_ptr<Machine> m(new Machine());
+    std::unique_ptr<profile> p(new profile());
+
+    load_code(*m, code);
+    init_profile(*p, m->ip);
+    run_profiled(*m, *p);
+
+    for (const bench_engine &engine : engines)
+    {
+        bench_result result;
+
+        result.name = name;
+        result.variant = engine.name;
+        result.instructions = p->executed;
+        result.items = 0;
+        result.item = "";
+
+        measure(result, runs, [&] { load_code(*m, code); }, [&] { engine.run(*m); });
+        print_result(result);
+    }
+}
+
+/* PARSER ********************************************************************/
+
+/* lines of the parsed source, the size of the old 2304 line charset taken
+   100 times (so the benchmark does not follow the size of chars.asm) */
+
+#define PARSE_LINES     230400
+
+/**
+ *
+ * Parses a source of PARSE_LINES lines, the lines of chars.asm repeated
+ * until there are enough. Every run uses a new arena, so nothing parsed
+ * before is reused.
+ *
+ */
+static void bench_parser(const std::string &chars, const uint32_t runs)
+{
+    std::ifstream input(chars, std::ios::binary);
+    std::vector<std::string> lines;
+    std::string line;
+    bench_result result;
+    uint32_t i;
+
+    while (input && std::getline(input, line))
+    {
+        lines.push_back(line);
+    }
+
+    if (lines.empty())
+    {
+        fprintf(stderr, "can not read %s, skipping the parser benchmark\n", chars.c_str());
+        return;
+    }
+
+    const std::string filename = (std::filesystem::temp_directory_path() / "sophia8bench_chars.asm").string();
+
+    {
+        std::ofstream output(filename, std::ios::binary);
+
+        for (i = 0; i < PARSE_LINES; i++)
+        {
+            output << lines[i % lines.size()] << "\n";
+        }
+    }
+
+    result.name = "parse_chars_x100";
+    result.variant = "parser";
+    result.instructions = 0;
+    result.items = 0;
+    result.item = "lines";
+
+    std::unique_ptr<assembly_parser::source_arena> arena;
+
+    measure(result, runs, [&] { arena.reset(); },
+            [&]
+            {
+                arena.reset(new assembly_parser::source_arena());
+                const auto *commands = arena->parse_file(filename);
+                result.items = commands ? commands->size() : 0;
+            });
+
+    arena.reset();
+    std::filesystem::remove(filename);
+    print_result(result);
+}
+
+/* RASTERIZER ****************************************************************/
+
+#define RASTER_FRAMES   100     /* frames rasterized by one run              */
+
+/**
+ *
+ * Rasterizes the whole screen in every video mode. The video memory holds
+ * a fixed pattern touching every character, pixel and color.
+ *
+ */
+static void bench_raster(const uint32_t runs)
+{
+    static const struct { const char *name; uint8_t mode; } modes[] = {
+        {"text", VIDEO_TEXT_MODE},
+        {"bw", VIDEO_BW_MODE},
+        {"color", VIDEO_COLOR_MODE},
+    };
+
+    std::unique_ptr<uint8_t[]> mem(new uint8_t[MEM_SIZE + 1]);
+    std::unique_ptr<uint32_t[]> frame(new uint32_t[VIDEO_WIDTH * VIDEO_HEIGHT]);
+    uint32_t i;
+
+    for (i = 0; i <= MEM_SIZE; i++)
+    {
+        mem[i] = static_cast<uint8_t>(i * 31 + (i >> 8));
+    }
+
+    for (const auto &mode : modes)
+    {
+        bench_result result;
+
+        mem[VIDEO_MODE_ADDRESS] = mode.mode;
+
+        result.name = "raster_screen";
+        result.variant = std::string(mode.name) + "/" + raster_kernel();
+        result.instructions = 0;
+        result.items = RASTER_FRAMES;
+        result.item = "frames";
+
+        measure(result, runs, [] {},
+                [&]
+                {
+                    for (uint32_t f = 0; f < RASTER_FRAMES; f++)
+                    {
+                        raster_screen(frame.get(), mem.get());
+                    }
+                });
+        print_result(result);
+    }
+}
+
+/* MAIN **********************************************************************/
+
+static void usage()
+{
+    printf("usage: sophia8bench [--runs n] [--filter text] [--chars chars.asm]\n");
+    printf("\n");
+    printf("  --runs n       measured runs of every benchmark (default %d)\n", BENCH_RUNS);
+    printf("  --filter text  only the benchmarks with the text in their name\n");
+    printf("  --chars file   source of the parser benchmark (default chars.asm)\n");
+}
+
+static bool selected(const std::string &filter, const char *name)
+{
+    return filter.empty() || strstr(name, filter.c_str()) != nullptr;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t runs = BENCH_RUNS;
+    std::string filter;
+    std::string chars = "chars.asm";
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc)
+        {
+            runs = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        }
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if (strcmp(argv[i], "--chars") == 0 && i + 1 < argc)
+        {
+            chars = argv[++i];
+        }
+        else
+        {
+            usage();
+            return 1;
+        }
+    }
+
+    if (runs == 0) runs = 1;
+
+    if (selected(filter, "mulr")) bench_machine("mulr", mulr_program(), runs);
+    if (selected(filter, "divr")) bench_machine("divr", divr_program(), runs);
+    if (selected(filter, "push_pop")) bench_machine("push_pop", stack_program(), runs);
+    if (selected(filter, "recursion")) bench_machine("recursion", recursion_program(), runs);
+    if (selected(filter, "copy_storer")) bench_machine("copy_storer", copy_program(), runs);
+    if (selected(filter, "parse_chars_x100")) bench_parser(chars, runs);
+    if (selected(filter, "raster_screen")) bench_raster(runs);
+
+    return 0;
+}
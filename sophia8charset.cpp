@@ -4,180 +4,128 @@
 #include <cstdio>
 
 #include "SDL.h"
+#include "atlas.h"
+#include "charset.h"
 #include "definitions.h"
 #include <cstdlib>
+#include <cstring>
 #include <string>
-#include <fstream>
 
 class char_information
 {
 public:
-    bool character[8][8] = {{false}};
-    int addresses[8] = {0};
+    uint8_t rows[CHARSET_ROWS] = {0};       // leftmost pixel in the high bit
 
-    void draw_char_small(SDL_Renderer *renderer, const int xs, const int ys, const bool selected = false)
+    void toggle(const int x, const int y)
     {
-        for (auto y = 0; y < 8; y++)
-        {
-            for (auto x = 0; x < 8; x++)
-            {
-                if (character[y][x])
-                {
-                    SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
-                }
-                else
-                {
-                    SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
-                }
-
-                SDL_RenderDrawPoint(renderer, xs + x, ys + y);
-            }
-        }
-
-        SDL_Rect rect = { xs - 1,ys - 1, 10, 10 };
-        if (selected) SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE);
-        else SDL_SetRenderDrawColor(renderer, 64, 64, 64, SDL_ALPHA_OPAQUE);
-        SDL_RenderDrawRect(renderer, &rect);
-    }
-
-    void draw_char_big(SDL_Renderer *renderer, const int xs, const int ys)
-    {
-        for (auto y = 0; y < 8; y++)
-        {
-            for (auto x = 0; x < 8; x++)
-            {
-                SDL_Rect rect{ xs + x * 32, ys + y * 32, 32, 32 };
-
-                if (character[y][x])
-                {
-                    SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
-                    SDL_RenderFillRect(renderer, &rect);
-                }
-                
-                SDL_SetRenderDrawColor(renderer, 127, 127, 127, SDL_ALPHA_OPAQUE);
-                SDL_RenderDrawRect(renderer, &rect);
-            }
-        }
+        rows[y] ^= static_cast<uint8_t>(0x80 >> x);
     }
 };
 
+static_assert(sizeof(char_information) == CHARSET_ROWS, "the glyphs are the rows of CHAR_MEM");
+
 class characters_information
 {
 public:
-    char_information characters[256];
+    char_information characters[CHARSET_GLYPHS];
 
-    characters_information()
-    {
-        uint16_t address = CHAR_MEM_ADDRESS;
-        for (auto &ch: characters)
-        {
-            for (auto &cur_address: ch.addresses)
-            {
-                cur_address = address;
-                address += 8;
-            }
+    uint8_t *glyphs() { return characters[0].rows; }
 
-            for (auto &char_line: ch.character)
-            {
-                for (auto &char_bit: char_line)
-                {
-                    char_bit = false;
-                }
-            }
-        }
-    }
-
-    void draw_characters(SDL_Renderer *renderer, const int sx, const int sy, const int selected = -1)
+    // position of a glyph in the overview (23 glyphs per row)
+    static SDL_Rect small_rect(const int sx, const int sy, const int index)
     {
-        auto sxc = sx;
-        auto syc = sy;
-        auto index = 0;
-
-        for (auto &ch : characters)
-        {
-            ch.draw_char_small(renderer, sxc, syc, index == selected);
-            sxc += 11;
-            if (sxc - sx > 250) {
-                syc += 11;
-                sxc = sx;
-            }
-            index++;
-        }
+        const auto per_row = 250 / 11 + 1;
+        return SDL_Rect{ sx + index % per_row * 11, sy + index / per_row * 11, 8, 8 };
     }
 
-    void save(const std::string& filename)
+    // the glyph as a grid of 32x32 cells: one scaled copy of the atlas and the cell outlines in one call
+    void draw_char_big(SDL_Renderer *renderer, const glyph_atlas &atlas, const int index, const int xs, const int ys)
     {
-        std::ofstream file;
+        SDL_Rect cells[64];
+        const SDL_Rect target{ xs, ys, 8 * 32, 8 * 32 };
 
-        file.open(filename);
+        atlas_draw(atlas, renderer, static_cast<uint8_t>(index), target, 0xFFFFFFFF);
 
-        for (auto &ch : characters)
+        for (auto y = 0; y < 8; y++)
         {
-            for (auto &ch_line: ch.character)
+            for (auto x = 0; x < 8; x++)
             {
-                for (auto &ch_bit: ch_line)
-                {
-                    file << (ch_bit ? 1 : 0) << " ";
-                }
-                file << std::endl;
+                cells[y * 8 + x] = SDL_Rect{ xs + x * 32, ys + y * 32, 32, 32 };
             }
-            file << std::endl;
         }
 
-        file.close();
+        SDL_SetRenderDrawColor(renderer, 127, 127, 127, SDL_ALPHA_OPAQUE);
+        SDL_RenderDrawRects(renderer, cells, 64);
     }
 
-    void save_asm(const std::string& filename)
+    void draw_char_small(SDL_Renderer *renderer, const glyph_atlas &atlas, const int index, const int xs, const int ys)
     {
-        std::ofstream file;
+        atlas_draw(atlas, renderer, static_cast<uint8_t>(index), SDL_Rect{ xs, ys, 8, 8 }, 0xFFFFFFFF);
+    }
 
-        file.open(filename);
+    // one copy per glyph from the atlas, all the gray outlines in one call
+    void draw_characters(SDL_Renderer *renderer, const glyph_atlas &atlas, const int sx, const int sy, const int selected = -1)
+    {
+        SDL_Rect outlines[CHARSET_GLYPHS];
 
-        for (auto &ch : characters)
+        for (auto index = 0; index < CHARSET_GLYPHS; index++)
         {
-            auto li = 0;
-            for (auto &ch_line : ch.character)
-            {
-                file << "0x" << std::hex << std::uppercase 
-                     << ch.addresses[li] << std::dec 
-                     << std::nouppercase << ": db 0b";
-                for (auto &ch_bit : ch_line)
-                {
-                    file << (ch_bit ? 1 : 0);
-                }
-                file << std::endl;
-                li++;
-            }
-            file << std::endl;
+            const auto rect = small_rect(sx, sy, index);
+
+            draw_char_small(renderer, atlas, index, rect.x, rect.y);
+            outlines[index] = SDL_Rect{ rect.x - 1, rect.y - 1, 10, 10 };
         }
 
-        file.close();
+        SDL_SetRenderDrawColor(renderer, 64, 64, 64, SDL_ALPHA_OPAQUE);
+        SDL_RenderDrawRects(renderer, outlines, CHARSET_GLYPHS);
+
+        if (selected >= 0)
+        {
+            SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE);
+            SDL_RenderDrawRect(renderer, &outlines[selected]);
+        }
     }
 
-    void load(const std::string& filename)
+    bool save(const std::string& filename)
     {
-        std::ifstream file;
+        return write_charset_text(filename, glyphs());
+    }
 
-        file.open(filename);
+    bool save_asm(const std::string& filename)
+    {
+        return write_charset_asm(filename, glyphs());
+    }
 
-        for (auto& character : characters)
-        {
-            for (auto& ch_line : character.character)
-            {
-                for (auto& ch_bit : ch_line)
-                {
-                    char read_char;
-                    file >> read_char;
-                    ch_bit = read_char == '1';
-                }
-            }
-        }
+    bool save_binary(const std::string& filename)
+    {
+        return write_charset(filename, glyphs());
+    }
 
-        file.close();
+    // .chr files or the text format
+    bool load(const std::string& filename)
+    {
+        if (is_charset_file(filename)) return load_charset(filename, glyphs());
+        return read_charset_text(filename, glyphs());
     }
 };
 
 int main(int argc, char* argv[]) {
+    // Bulk conversion without the editor: sophia8charset --convert chars.dat chars.chr
+    if (argc > 1 && strcmp(argv[1], "--convert") == 0)
+    {
+        if (argc != 4)
+        {
+            fprintf(stderr, "usage: sophia8charset --convert source(.chr|.dat) target(.chr|.dat|.asm)\n");
+            return 1;
+        }
+        if (!convert_charset(argv[2], argv[3]))
+        {
+            fprintf(stderr, "can not convert %s to %s\n", argv[2], argv[3]);
+            return 1;
+        }
+        return 0;
+    }
+
     SDL_Init(SDL_INIT_VIDEO);              // Initialize SDL2
 
     // Create an application window with the following settings:
@@ -203,6 +151,13 @@ int main(int argc, char* argv[]) {
     characters_information_table.load(R"(C:\developement\Sophia8\chars.dat)");
     auto current_character = 0;
 
+    // all glyphs in one texture, re-uploaded per edited glyph
+    static glyph_atlas atlas;
+    if (!atlas_open(atlas, renderer)) {
+        printf("Could not create the glyph texture: %s\n", SDL_GetError());
+        return 1;
+    }
+
     while (true) {
         SDL_Event e;
         if (SDL_PollEvent(&e)) {
@@ -229,28 +184,36 @@ int main(int argc, char* argv[]) {
                 {
                     characters_information_table.save(R"(C:\developement\Sophia8\chars.dat)");
                     characters_information_table.save_asm(R"(C:\developement\Sophia8\chars.asm)");
+                    characters_information_table.save_binary(R"(C:\developement\Sophia8\chars.chr)");
                 }
             }
             if (e.type == SDL_MOUSEBUTTONDOWN)
             {
                 int x, y;
                 SDL_GetMouseState(&x, &y);
-                auto& cur_bit = characters_information_table.characters[current_character].character[(y - 10) / 32][(x - 10) / 32];
-                cur_bit = !cur_bit;
+                const auto column = (x - 10) / 32;
+                const auto row = (y - 10) / 32;
+                if (x >= 10 && y >= 10 && column < 8 && row < 8)
+                {
+                    characters_information_table.characters[current_character].toggle(column, row);
+                }
             }
         }
 
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
         SDL_RenderClear(renderer);
         
-        characters_information_table.characters[current_character].draw_char_small(renderer, 300, 10);
-        characters_information_table.characters[current_character].draw_char_big(renderer, 10, 10);
-        characters_information_table.draw_characters(renderer, 10, 300, current_character);
+        atlas_update(atlas, characters_information_table.glyphs());
+        characters_information_table.draw_char_small(renderer, atlas, current_character, 300, 10);
+        characters_information_table.draw_char_big(renderer, atlas, current_character, 10, 10);
+        characters_information_table.draw_characters(renderer, atlas, 10, 300, current_character);
         
         SDL_RenderPresent(renderer);
     }
 
     // Close and destroy the window
+    atlas_close(atlas);
+    SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
 
     // Clean up
@@ -0,0 +1,1030 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    sophia8fuzz.cpp                                                  */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Differential fuzzer of the engines. Every program is generated from its   */
+/* seed out of the opcodes and lengths of definitions.h, put together from   */
+/* small units (straight code, counted loops, forward branches, calls, the   */
+/* stack and block instructions, stores patching the code), so it is valid   */
+/* and always ends. Some end with a fault on purpose (division by zero) or   */
+/* return from a stack moved to the wrap of SP. The engines run it lockstep, */
+/* one basic block at a time, comparing the registers and the memory hash    */
+/* after every block. The programs which halt are then run by every engine   */
+/* at full speed (the JIT chaining its blocks), their final states are       */
+/* compared again and the time is summed up to the throughput. The programs  */
+/* are fuzzed on all cores:                                                  */
+/*                                                                           */
+/*     sophia8fuzz [--programs n] [--seed n] [--jobs n] [--units n]          */
+/*                 [--blocks n]                                              */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "definitions.h"
+#include "golden.h"
+#include "machine.h"
+
+/* PROGRAMS ******************************************************************/
+
+#define FUZZ_PROGRAMS       1000        /* programs by default               */
+#define FUZZ_UNITS          48          /* units of a program by default     */
+#define FUZZ_MAX_UNITS      1000        /* units of a program at most        */
+#define FUZZ_BLOCKS         100000      /* lockstep blocks of a program      */
+#define FUZZ_REPORTS        10          /* mismatches printed at most        */
+
+#define FUZZ_DATA           0x8000      /* data read and written by programs */
+#define FUZZ_DATA_SIZE      0x0800
+#define FUZZ_BLOCK_SIZE     0x0100      /* bytes of a block instruction      */
+
+/*
+ * The units keep the programs valid:
+ *
+ *     - only loops jump back, counted down in R7, which no other unit
+ *       writes (so every loop ends within 256 rounds)
+ *     - branches and jumps go forward to the start of a unit
+ *     - the stack units pop as many bytes as they pushed and procedures
+ *       (called, never jumped to) do not branch, so RET finds its address
+ *     - divisors are set right before DIVR, DIV and the shifts get an
+ *       immediate the patches never touch, a zero divisor is only the
+ *       counter minus one (zero in the last round of a loop) or the end
+ *       of the main code
+ *     - the writes go to the data window, the patches only to immediate
+ *       values of straight instructions (the end of the main code may
+ *       store to the stack page)
+ *
+ */
+
+#define FUZZ_COUNTER        IR7         /* loop counter                      */
+
+enum fuzz_unit
+{
+    UNIT_STRAIGHT,
+    UNIT_STORER,
+    UNIT_DIVR,
+    UNIT_STACK,
+    UNIT_BLOCK,
+    UNIT_PATCH,
+    UNIT_CALL,
+    UNIT_BRANCH,
+    UNIT_JUMP,
+    UNIT_LOOP,
+    UNIT_KINDS
+};
+
+/* weights of the units, the first UNIT_CALL ones are allowed in procedures
+   and the ones up to UNIT_LOOP in loops */
+
+static const uint32_t unit_weights[UNIT_KINDS] = {8, 2, 1, 2, 1, 1, 1, 3, 1, 2};
+
+/**
+ *
+ * Straight instructions and their operands, one letter per operand:
+ *
+ *     v  any immediate value (may be patched)
+ *     d  divisor (1 - 255)
+ *     h  shift count (1 - 7)
+ *     s  register read (R0 - R7)
+ *     t  register written (R0 - R6), CMP and CMPR keep the difference
+ *     a  address read (2 bytes)
+ *     w  address written (2 bytes, in the data window)
+ *
+ */
+struct fuzz_opcode
+{
+    uint8_t opcode;
+    const char *operands;
+};
+
+static const fuzz_opcode straight_opcodes[] = {
+    {LOAD, "at"}, {STORE, "sw"}, {SET, "vt"}, {INC, "t"}, {DEC, "t"},
+    {CMP, "tv"}, {CMPR, "ts"}, {ADD, "vt"}, {ADDR, "st"}, {SUB, "vt"},
+    {SUBR, "st"}, {MUL, "vtt"}, {MULR, "stt"}, {DIV, "dtt"}, {SHL, "ht"},
+    {SHR, "ht"}, {NOP, ""},
+};
+
+static uint32_t operand_bytes(const char *operands)
+{
+    uint32_t bytes = 0;
+
+    for (; *operands; operands++)
+    {
+        bytes += *operands == 'a' || *operands == 'w' ? 2 : 1;
+    }
+
+    return bytes;
+}
+
+/**
+ *
+ * Checks the operands of the straight instructions against the lengths of
+ * the instructions.
+ *
+ */
+static bool check_opcodes()
+{
+    for (const fuzz_opcode &op : straight_opcodes)
+    {
+        if (1 + operand_bytes(op.operands) != instruction_length(op.opcode))
+        {
+            fprintf(stderr, "operands of opcode 0x%02x do not match its length %u\n", op.opcode,
+                    instruction_length(op.opcode));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ *
+ * Address filled in when the program is laid out: the start of a unit of
+ * the main code, of a procedure or an immediate to patch.
+ *
+ */
+struct fuzz_fixup
+{
+    uint32_t position;          /* high byte of the address in the code      */
+    uint8_t  kind;              /* FIXUP_*                                   */
+    uint32_t index;             /* unit or procedure                         */
+};
+
+#define FIXUP_UNIT          0
+#define FIXUP_PROCEDURE     1
+#define FIXUP_PATCH         2
+
+struct fuzz_program
+{
+    std::vector<uint8_t> code;          /* loaded to 0x0000                  */
+    std::vector<uint8_t> data;          /* loaded to FUZZ_DATA               */
+    std::vector<uint16_t> units;        /* start of every main unit and end  */
+    std::vector<uint16_t> procedures;   /* start of every procedure          */
+    std::vector<uint16_t> patches;      /* immediates which may be patched   */
+    std::vector<fuzz_fixup> fixups;
+};
+
+struct fuzz_generator
+{
+    std::mt19937_64 random;
+    fuzz_program &p;
+    uint32_t unit_count;
+
+    uint32_t below(const uint32_t n)
+    {
+        return static_cast<uint32_t>(random() % n);
+    }
+
+    uint8_t source()
+    {
+        return static_cast<uint8_t>(IR0 + below(8));
+    }
+
+    uint8_t target()
+    {
+        return static_cast<uint8_t>(IR0 + below(7));
+    }
+
+    uint16_t here() const
+    {
+        return static_cast<uint16_t>(p.code.size());
+    }
+
+    void emit(const std::initializer_list<uint8_t> bytes)
+    {
+        p.code.insert(p.code.end(), bytes);
+    }
+
+    void emit_address(const uint16_t address)
+    {
+        emit({static_cast<uint8_t>(address >> 8), static_cast<uint8_t>(address & 0xFF)});
+    }
+
+    void emit_fixup(const uint8_t kind, const uint32_t index)
+    {
+        p.fixups.push_back({static_cast<uint32_t>(p.code.size()), kind, index});
+        emit_address(0);
+    }
+
+    /**
+     *
+     * Picks count distinct registers which may be written.
+     *
+     */
+    void targets(uint8_t *registers, const uint32_t count)
+    {
+        uint8_t all[7];
+        uint32_t i;
+
+        for (i = 0; i < 7; i++)
+        {
+            all[i] = static_cast<uint8_t>(IR0 + i);
+        }
+
+        for (i = 0; i < count; i++)
+        {
+            const uint32_t k = i + below(7 - i);
+
+            std::swap(all[i], all[k]);
+            registers[i] = all[i];
+        }
+    }
+
+    void straight_instruction()
+    {
+        const fuzz_opcode &op = straight_opcodes[below(sizeof(straight_opcodes) / sizeof(straight_opcodes[0]))];
+        const char *operand;
+
+        p.code.push_back(op.opcode);
+
+        for (operand = op.operands; *operand; operand++)
+        {
+            switch (*operand)
+            {
+                case 'v':
+                    p.patches.push_back(here());
+                    p.code.push_back(static_cast<uint8_t>(random()));
+                    break;
+                case 'd':
+                    p.code.push_back(static_cast<uint8_t>(1 + below(255)));
+                    break;
+                case 'h':
+                    p.code.push_back(static_cast<uint8_t>(1 + below(7)));
+                    break;
+                case 's':
+                    p.code.push_back(source());
+                    break;
+                case 't':
+                    p.code.push_back(target());
+                    break;
+                case 'a':
+                    emit_address(static_cast<uint16_t>(below(2) ? FUZZ_DATA + below(FUZZ_DATA_SIZE) : random()));
+                    break;
+                case 'w':
+                    emit_address(static_cast<uint16_t>(FUZZ_DATA + below(FUZZ_DATA_SIZE)));
+                    break;
+            }
+        }
+    }
+
+    /**
+     *
+     * Sets registers to a block of the data window (or anywhere when read)
+     * and its size.
+     *
+     */
+    void set_block(const uint8_t high, const uint8_t low, const bool written)
+    {
+        const uint16_t address = static_cast<uint16_t>(written || below(2)
+                                                       ? FUZZ_DATA + below(FUZZ_DATA_SIZE - FUZZ_BLOCK_SIZE)
+                                                       : below(FUZZ_DATA));
+
+        emit({SET, static_cast<uint8_t>(address >> 8), high});
+        emit({SET, static_cast<uint8_t>(address & 0xFF), low});
+    }
+
+    void set_size(const uint8_t high, const uint8_t low)
+    {
+        emit({SET, 0x00, high});
+        emit({SET, static_cast<uint8_t>(below(FUZZ_BLOCK_SIZE)), low});
+    }
+
+    void block_unit()
+    {
+        uint8_t r[7];
+
+        targets(r, 6);
+
+        switch (below(3))
+        {
+            case 0:
+                set_block(r[0], r[1], true);
+                set_block(r[2], r[3], false);
+                set_size(r[4], r[5]);
+                emit({MEMCPY, r[0], r[1], r[2], r[3], r[4], r[5]});
+                break;
+            case 1:
+                set_block(r[0], r[1], true);
+                set_size(r[2], r[3]);
+                emit({MEMSET, source(), r[0], r[1], r[2], r[3]});
+                break;
+            default:
+                set_block(r[0], r[1], false);
+                set_block(r[2], r[3], false);
+                set_size(r[4], r[5]);
+                emit({MEMCMP, target(), r[0], r[1], r[2], r[3], r[4], r[5]});
+                break;
+        }
+    }
+
+    /**
+     *
+     * Pushes a few registers (the 16 bit ones too), runs straight code and
+     * pops the same number of bytes, one or two at a time.
+     *
+     */
+    void stack_unit()
+    {
+        static const uint8_t words[] = {IIP, ISP, IBP};
+        const uint32_t pushes = 1 + below(3);
+        uint32_t bytes = 0, i;
+
+        for (i = 0; i < pushes; i++)
+        {
+            if (below(4) == 0)
+            {
+                emit({PUSH, words[below(3)]});
+                bytes += 2;
+            }
+            else
+            {
+                emit({PUSH, source()});
+                bytes++;
+            }
+        }
+
+        for (i = below(3); i > 0; i--)
+        {
+            straight_instruction();
+        }
+
+        while (bytes)
+        {
+            if (bytes >= 2 && below(4) == 0)
+            {
+                emit({POP, IBP});
+                bytes -= 2;
+            }
+            else
+            {
+                emit({POP, target()});
+                bytes--;
+            }
+        }
+    }
+
+    void branch_unit(const uint32_t unit)
+    {
+        const uint8_t reg = source();
+
+        switch (below(3))
+        {
+            case 0:
+                emit({CMP, target(), static_cast<uint8_t>(random())});
+                break;
+            case 1:
+                emit({CMPR, target(), source()});
+                break;
+            default:
+                emit({DEC, target()});
+                break;
+        }
+
+        switch (below(4))
+        {
+            case 0: emit({JZ, reg}); break;
+            case 1: emit({JNZ, reg}); break;
+            case 2: emit({JC}); break;
+            default: emit({JNC}); break;
+        }
+
+        emit_fixup(FIXUP_UNIT, unit + 1 + below(unit_count - unit));
+    }
+
+    /**
+     *
+     * Moves SP next to its wrap (0xFFFE - 0x0001) by popping a word to it,
+     * pops a few bytes and returns from there. The return address is read
+     * from the stack page and the start of the code, the bytes in the stack
+     * page are stored first, mostly to make it an address in the data
+     * window holding HALT.
+     *
+     */
+    void stack_tail()
+    {
+        static const uint16_t tops[] = {0xFFFE, 0xFFFF, 0x0000, 0x0001};
+        const uint16_t top = tops[below(4)];
+        const uint32_t pops = below(3);
+        const uint16_t at = static_cast<uint16_t>(top + pops);
+        const uint16_t word = static_cast<uint16_t>(top - 2);
+        uint8_t bytes[2], r[3];
+        uint32_t i;
+
+        targets(r, 3);
+        emit({SET, static_cast<uint8_t>(word >> 8), r[0]});
+        emit({SET, static_cast<uint8_t>(word & 0xFF), r[1]});
+        emit({PUSH, r[1]});
+        emit({PUSH, r[0]});
+        emit({POP, ISP});
+
+        bytes[0] = static_cast<uint8_t>((FUZZ_DATA >> 8) + below(FUZZ_DATA_SIZE >> 8));
+        bytes[1] = static_cast<uint8_t>(random());
+
+        for (i = 0; i < 2; i++)
+        {
+            const uint16_t address = static_cast<uint16_t>(at + i);
+
+            if (address >= 0xFF00)
+            {
+                emit({SET, bytes[i], r[2]});
+                emit({STORE, r[2]});
+                emit_address(address);
+            }
+            else
+            {
+                bytes[i] = p.code[address];
+            }
+        }
+
+        /* the pops and RET start a block of their own, so the JIT compiles
+           them (it stops a block at POP SP) */
+
+        emit({JMP});
+        emit_address(static_cast<uint16_t>(here() + 2));
+
+        for (i = 0; i < pops; i++)
+        {
+            emit({POP, target()});
+        }
+
+        emit({RET});
+
+        const uint16_t back = static_cast<uint16_t>(bytes[0] << 8 | bytes[1]);
+
+        if (static_cast<uint16_t>(back - FUZZ_DATA) < FUZZ_DATA_SIZE && below(4))
+        {
+            p.data[back - FUZZ_DATA] = HALT;
+        }
+    }
+
+    /**
+     *
+     * Ends the main code, mostly by HALT, else by a division by zero or
+     * by stack_tail.
+     *
+     */
+    void tail()
+    {
+        uint8_t r[1];
+
+        switch (below(8))
+        {
+            case 0:
+                emit({DIV, 0x00, target(), target()});
+                break;
+            case 1:
+                targets(r, 1);
+                emit({SET, 0x00, r[0]});
+                emit({DIVR, r[0], target(), target()});
+                break;
+            case 2:
+            case 3:
+                stack_tail();
+                break;
+            default:
+                emit({HALT});
+                break;
+        }
+    }
+
+    /**
+     *
+     * Emits one unit of the kinds below limit.
+     *
+     */
+    void unit(const uint32_t index, const uint32_t limit)
+    {
+        uint32_t total = 0, pick, kind, i;
+        uint8_t r[3];
+
+        for (kind = 0; kind < limit; kind++)
+        {
+            total += unit_weights[kind];
+        }
+
+        for (pick = below(total), kind = 0; pick >= unit_weights[kind]; kind++)
+        {
+            pick -= unit_weights[kind];
+        }
+
+        switch (kind)
+        {
+            case UNIT_STRAIGHT:
+                for (i = 1 + below(4); i > 0; i--)
+                {
+                    straight_instruction();
+                }
+                break;
+            case UNIT_STORER:
+                targets(r, 1);
+                emit({SET, static_cast<uint8_t>((FUZZ_DATA >> 8) + below(FUZZ_DATA_SIZE >> 8)), r[0]});
+                emit({STORER, source(), r[0], source()});
+                break;
+            case UNIT_DIVR:
+                targets(r, 1);
+                if (below(8) == 0)
+                {
+                    emit({SET, 0x00, r[0]});
+                    emit({ADDR, FUZZ_COUNTER, r[0]});
+                    emit({DEC, r[0]});
+                }
+                else
+                {
+                    emit({SET, static_cast<uint8_t>(1 + below(255)), r[0]});
+                }
+                emit({DIVR, r[0], target(), target()});
+                break;
+            case UNIT_STACK:
+                stack_unit();
+                break;
+            case UNIT_BLOCK:
+                block_unit();
+                break;
+            case UNIT_PATCH:
+                targets(r, 1);
+                emit({SET, static_cast<uint8_t>(random()), r[0]});
+                emit({STORE, r[0]});
+                emit_fixup(FIXUP_PATCH, 0);
+                break;
+            case UNIT_CALL:
+                emit({CALL});
+                emit_fixup(FIXUP_PROCEDURE, below(static_cast<uint32_t>(p.procedures.size())));
+                break;
+            case UNIT_BRANCH:
+                branch_unit(index);
+                break;
+            case UNIT_JUMP:
+                emit({JMP});
+                emit_fixup(FIXUP_UNIT, index + 1 + below(unit_count - index));
+                break;
+            case UNIT_LOOP:
+            {
+                emit({SET, static_cast<uint8_t>(below(8) ? 1 + below(16) : random()), FUZZ_COUNTER});
+                const uint16_t top = here();
+                for (i = 1 + below(3); i > 0; i--)
+                {
+                    unit(index, UNIT_LOOP);
+                }
+                emit({DEC, FUZZ_COUNTER});
+                emit({JNZ, FUZZ_COUNTER});
+                emit_address(top);
+                break;
+            }
+        }
+    }
+};
+
+/**
+ *
+ * Generates the program of a seed, units units of main code ending with
+ * HALT and the procedures behind it.
+ *
+ */
+static void generate_program(fuzz_program &p, const uint64_t seed, const uint32_t units)
+{
+    fuzz_generator g = {std::mt19937_64(seed), p, units};
+    uint32_t i;
+
+    p.code.clear();
+    p.units.clear();
+    p.patches.clear();
+    p.fixups.clear();
+    p.procedures.assign(1 + units / 16, 0);
+    p.data.resize(FUZZ_DATA_SIZE);
+
+    for (uint8_t &byte : p.data)
+    {
+        byte = static_cast<uint8_t>(g.random());
+    }
+
+    for (i = 0; i < 7; i++)
+    {
+        g.emit({SET, static_cast<uint8_t>(g.random()), static_cast<uint8_t>(IR0 + i)});
+    }
+
+    for (i = 0; i < units; i++)
+    {
+        p.units.push_back(g.here());
+        g.unit(i, UNIT_KINDS);
+    }
+
+    p.units.push_back(g.here());
+    g.tail();
+
+    for (uint16_t &procedure : p.procedures)
+    {
+        procedure = g.here();
+        for (i = 1 + g.below(3); i > 0; i--)
+        {
+            g.unit(units, UNIT_CALL);
+        }
+        g.emit({RET});
+    }
+
+    for (const fuzz_fixup &fixup : p.fixups)
+    {
+        uint16_t address;
+
+        switch (fixup.kind)
+        {
+            case FIXUP_UNIT:
+                address = p.units[fixup.index];
+                break;
+            case FIXUP_PROCEDURE:
+                address = p.procedures[fixup.index];
+                break;
+            default:
+                address = p.patches.empty() ? FUZZ_DATA : p.patches[g.below(static_cast<uint32_t>(p.patches.size()))];
+                break;
+        }
+
+        p.code[fixup.position] = static_cast<uint8_t>(address >> 8);
+        p.code[fixup.position + 1] = static_cast<uint8_t>(address & 0xFF);
+    }
+}
+
+/* LOCKSTEP ******************************************************************/
+
+struct fuzz_engine
+{
+    const char *name;
+    void (*step)(Machine &m);   /* runs one basic block                      */
+    void (*run)(Machine &m);    /* runs until the machine stops              */
+};
+
+static const fuzz_engine engines[] = {
+    {"switch", run_switch_block, run_switch},
+    {"threaded", run_threaded_block, run_threaded},
+    {"predecoded", run_predecoded_block, run_predecoded},
+    {"jit", run_jit_block, run_jit},
+};
+
+#define FUZZ_ENGINES        (sizeof(engines) / sizeof(engines[0]))
+
+/**
+ *
+ * Machine of one engine with the hashes of its memory pages. The pages are
+ * hashed again when the machine marks them dirty (the fuzzer restores no
+ * snapshots, so it takes the dirty flags over).
+ *
+ */
+struct fuzz_lane
+{
+    std::unique_ptr<Machine> m;
+    uint64_t pages[GOLDEN_PAGES];
+};
+
+static void load_fuzz_program(Machine &m, const fuzz_program &p)
+{
+    init_machine(m);
+    memcpy(m.mem, p.code.data(), p.code.size());
+    memcpy(m.mem + FUZZ_DATA, p.data.data(), p.data.size());
+}
+
+static uint64_t memory_hash(fuzz_lane &lane)
+{
+    Machine &m = *lane.m;
+    uint32_t page;
+
+    for (page = 0; page < GOLDEN_PAGES; page++)
+    {
+        if (!m.dirty[page]) continue;
+
+        lane.pages[page] = xxh64(m.mem + page * 256, 256, 0);
+        m.dirty[page] = 0;
+    }
+
+    return hash_memory(lane.pages);
+}
+
+static bool same_registers(const Machine &a, const Machine &b)
+{
+    return memcmp(a.r, b.r, sizeof(a.r)) == 0 && a.ip == b.ip && a.sp == b.sp && a.bp == b.bp && a.c == b.c &&
+           a.stop == b.stop;
+}
+
+static void print_machine(const char *name, const Machine &m)
+{
+    printf("  %-10s r %02x %02x %02x %02x %02x %02x %02x %02x  ip %04x  sp %04x  bp %04x  c %u  stop %s\n", name,
+           m.r[0], m.r[1], m.r[2], m.r[3], m.r[4], m.r[5], m.r[6], m.r[7], m.ip, m.sp, m.bp, m.c,
+           stop_reason(m.stop));
+}
+
+/* FUZZER ********************************************************************/
+
+struct fuzz_options
+{
+    uint32_t programs;
+    uint64_t seed;
+    uint32_t workers;
+    uint32_t units;
+    uint64_t blocks;
+};
+
+/**
+ *
+ * Results of one worker, summed up at the end.
+ *
+ */
+struct fuzz_stats
+{
+    uint64_t programs;
+    uint64_t halted;
+    uint64_t faulted;           /* stopped by a fault instead of HALT        */
+    uint64_t limited;           /* over the block limit                      */
+    uint64_t mismatches;
+    uint64_t blocks;
+    uint64_t instructions;      /* run at full speed by every engine         */
+    double ns[FUZZ_ENGINES];
+};
+
+static std::mutex report_lock;
+static uint32_t reported = 0;
+
+/**
+ *
+ * Prints a mismatch of an engine against the switch engine, the first
+ * FUZZ_REPORTS only.
+ *
+ */
+static void report_mismatch(const uint64_t seed, const char *where, const fuzz_engine &engine,
+                            const Machine &expected, const Machine &actual)
+{
+    std::vector<diff_range> ranges;
+    std::lock_guard<std::mutex> guard(report_lock);
+
+    if (reported++ >= FUZZ_REPORTS) return;
+
+    printf("mismatch: seed %llu, %s, %s against switch\n", static_cast<unsigned long long>(seed), where, engine.name);
+    print_machine("switch", expected);
+    print_machine(engine.name, actual);
+
+    if (diff_memory(expected.mem, actual.mem, GOLDEN_SIZE, ranges))
+    {
+        print_diff(expected.mem, actual.mem, ranges);
+    }
+
+    printf("  repeat: sophia8fuzz --seed %llu --programs 1\n", static_cast<unsigned long long>(seed));
+    fflush(stdout);
+}
+
+/**
+ *
+ * Runs a program in lockstep, stepping every engine over one basic block
+ * and comparing them with the switch engine. Returns false on a mismatch,
+ * else whether the program stopped within the block limit.
+ *
+ */
+static bool run_lockstep(fuzz_lane *lanes, const fuzz_program &p, const fuzz_options &options, const uint64_t seed,
+                         fuzz_stats &stats, bool &stopped)
+{
+    uint64_t block;
+    size_t e;
+
+    for (e = 0; e < FUZZ_ENGINES; e++)
+    {
+        load_fuzz_program(*lanes[e].m, p);
+        hash_pages(lanes[e].m->mem, lanes[e].pages);
+        memset(lanes[e].m->dirty, 0, sizeof(lanes[e].m->dirty));
+    }
+
+    for (block = 0; block < options.blocks && !lanes[0].m->stop; block++)
+    {
+        uint64_t expected = 0;
+
+        for (e = 0; e < FUZZ_ENGINES; e++)
+        {
+            engines[e].step(*lanes[e].m);
+            const uint64_t hash = memory_hash(lanes[e]);
+
+            if (e == 0)
+            {
+                expected = hash;
+                continue;
+            }
+
+            if (!same_registers(*lanes[0].m, *lanes[e].m) || hash != expected)
+            {
+                const std::string where = "block " + std::to_string(block);
+
+                report_mismatch(seed, where.c_str(), engines[e], *lanes[0].m, *lanes[e].m);
+                stats.blocks += block + 1;
+                return false;
+            }
+        }
+    }
+
+    stats.blocks += block;
+    stopped = lanes[0].m->stop != 0;
+    return true;
+}
+
+/**
+ *
+ * Runs a program which stopped in lockstep by every engine at full speed
+ * and compares the final states with the switch engine. The time of every
+ * engine is added to its throughput, the instructions are counted on the
+ * counter machine.
+ *
+ */
+static bool run_full_speed(fuzz_lane *lanes, Machine &counter, const fuzz_program &p, const uint64_t seed,
+                           fuzz_stats &stats)
+{
+    uint64_t executed = 0;
+    size_t e;
+
+    load_fuzz_program(counter, p);
+    run_budget(counter, UINT64_MAX, executed);
+    stats.instructions += executed;
+
+    for (e = 0; e < FUZZ_ENGINES; e++)
+    {
+        const Machine &expected = *lanes[0].m;
+        Machine &m = *lanes[e].m;
+
+        load_fuzz_program(m, p);
+
+        const auto start = std::chrono::steady_clock::now();
+        engines[e].run(m);
+        const auto end = std::chrono::steady_clock::now();
+
+        stats.ns[e] += std::chrono::duration<double, std::nano>(end - start).count();
+
+        if (e > 0 && (!same_registers(expected, m) || memcmp(expected.mem, m.mem, GOLDEN_SIZE) != 0))
+        {
+            report_mismatch(seed, "full speed", engines[e], expected, m);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void fuzz_worker(const fuzz_options &options, std::atomic<uint32_t> &next, fuzz_stats &stats)
+{
+    fuzz_lane lanes[FUZZ_ENGINES];
+    std::unique_ptr<Machine> counter(new Machine());
+    fuzz_program p;
+
+    for (fuzz_lane &lane : lanes)
+    {
+        lane.m.reset(new Machine());
+    }
+
+    for (;;)
+    {
+        const uint32_t index = next.fetch_add(1);
+        const uint64_t seed = options.seed + index;
+        bool stopped = false;
+
+        if (index >= options.programs) break;
+
+        generate_program(p, seed, options.units);
+        stats.programs++;
+
+        if (!run_lockstep(lanes, p, options, seed, stats, stopped))
+        {
+            stats.mismatches++;
+        }
+        else if (!stopped)
+        {
+            stats.limited++;
+        }
+        else if (!run_full_speed(lanes, *counter, p, seed, stats))
+        {
+            stats.mismatches++;
+        }
+        else if (lanes[0].m->stop == STOP_HALT)
+        {
+            stats.halted++;
+        }
+        else
+        {
+            stats.faulted++;
+        }
+    }
+}
+
+static void print_usage()
+{
+    printf("usage: sophia8fuzz [options]\n");
+    printf("  --programs N  programs to generate (default: %d)\n", FUZZ_PROGRAMS);
+    printf("  --seed N      seed of the first program (default: 1)\n");
+    printf("  --jobs N      worker threads (default: one per core)\n");
+    printf("  --units N     units of code per program (default: %d, at most %d)\n", FUZZ_UNITS, FUZZ_MAX_UNITS);
+    printf("  --blocks N    lockstep blocks per program at most (default: %d)\n", FUZZ_BLOCKS);
+}
+
+int main(int argc, char *argv[])
+{
+    fuzz_options options = {FUZZ_PROGRAMS, 1, 0, FUZZ_UNITS, FUZZ_BLOCKS};
+    std::vector<fuzz_stats> stats;
+    std::vector<std::thread> threads;
+    std::atomic<uint32_t> next{0};
+    fuzz_stats total = {};
+    uint32_t i;
+    size_t e;
+
+    for (i = 1; i < static_cast<uint32_t>(argc); i++)
+    {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < static_cast<uint32_t>(argc);
+
+        if (arg == "--programs" && has_value)
+        {
+            options.programs = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        }
+        else if (arg == "--seed" && has_value)
+        {
+            options.seed = strtoull(argv[++i], nullptr, 0);
+        }
+        else if (arg == "--jobs" && has_value)
+        {
+            options.workers = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        }
+        else if (arg == "--units" && has_value)
+        {
+            options.units = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        }
+        else if (arg == "--blocks" && has_value)
+        {
+            options.blocks = strtoull(argv[++i], nullptr, 0);
+        }
+        else
+        {
+            print_usage();
+            return 1;
+        }
+    }
+
+    if (options.units == 0 || options.units > FUZZ_MAX_UNITS)
+    {
+        print_usage();
+        return 1;
+    }
+
+    if (!check_opcodes()) return 1;
+
+    if (options.workers == 0)
+    {
+        options.workers = std::thread::hardware_concurrency();
+        if (options.workers == 0) options.workers = 1;
+    }
+    if (options.workers > options.programs) options.workers = options.programs ? options.programs : 1;
+
+    stats.assign(options.workers, fuzz_stats());
+
+    for (i = 0; i < options.workers; i++)
+    {
+        threads.emplace_back(fuzz_worker, std::cref(options), std::ref(next), std::ref(stats[i]));
+    }
+
+    for (i = 0; i < options.workers; i++)
+    {
+        threads[i].join();
+
+        total.programs += stats[i].programs;
+        total.halted += stats[i].halted;
+        total.faulted += stats[i].faulted;
+        total.limited += stats[i].limited;
+        total.mismatches += stats[i].mismatches;
+        total.blocks += stats[i].blocks;
+        total.instructions += stats[i].instructions;
+
+        for (e = 0; e < FUZZ_ENGINES; e++)
+        {
+            total.ns[e] += stats[i].ns[e];
+        }
+    }
+
+    printf("programs %llu (seeds %llu - %llu), halted %llu, faulted %llu, over the block limit %llu, mismatches %llu\n",
+           static_cast<unsigned long long>(total.programs), static_cast<unsigned long long>(options.seed),
+           static_cast<unsigned long long>(options.seed + (options.programs ? options.programs - 1 : 0)),
+           static_cast<unsigned long long>(total.halted), static_cast<unsigned long long>(total.faulted),
+           static_cast<unsigned long long>(total.limited),
+           static_cast<unsigned long long>(total.mismatches));
+    printf("blocks compared %llu, instructions at full speed %llu per engine\n",
+           static_cast<unsigned long long>(total.blocks), static_cast<unsigned long long>(total.instructions));
+
+    for (e = 0; e < FUZZ_ENGINES; e++)
+    {
+        printf("  %-10s %8.2f MIPS\n", engines[e].name,
+               total.ns[e] > 0.0 ? static_cast<double>(total.instructions) / total.ns[e] * 1000.0 : 0.0);
+    }
+
+    return total.mismatches ? 1 : 0;
+}
@@ -0,0 +1,98 @@
+#include "symbol_table.h"
+
+namespace assembler {
+
+    symbol_table::symbol_table() : slots(64, -1)
+    {
+    }
+
+    /**
+     * FNV-1a hash of a symbol name.
+     */
+    uint32_t symbol_table::hash(const std::string_view name)
+    {
+        uint32_t value = 2166136261u;
+        for (auto ch : name)
+        {
+            value ^= static_cast<uint8_t>(ch);
+            value *= 16777619u;
+        }
+        return value;
+    }
+
+    /**
+     * Returns the slot holding the symbol or the empty slot where it belongs.
+     */
+    size_t symbol_table::probe(const std::string_view name, const uint32_t hash_value) const
+    {
+        const auto mask = slots.size() - 1;
+        auto slot = hash_value & mask;
+
+        while (slots[slot] >= 0)
+        {
+            const auto index = static_cast<size_t>(slots[slot]);
+            if (hashes[index] == hash_value && entries[index].name == name) break;
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void symbol_table::rehash(const size_t slot_count)
+    {
+        std::vector<int32_t> rehashed(slot_count, -1);
+        const auto mask = rehashed.size() - 1;
+
+        for (size_t index = 0; index < entries.size(); index++)
+        {
+            auto slot = hashes[index] & mask;
+            while (rehashed[slot] >= 0) slot = (slot + 1) & mask;
+            rehashed[slot] = static_cast<int32_t>(index);
+        }
+        slots.swap(rehashed);
+    }
+
+    /**
+     * Forgets the symbols defined after the first count ones.
+     */
+    void symbol_table::truncate(const size_t count)
+    {
+        if (count >= entries.size()) return;
+
+        entries.resize(count);
+        hashes.resize(count);
+        rehash(slots.size());
+    }
+
+    symbol *symbol_table::find(const std::string_view name)
+    {
+        const auto slot = probe(name, hash(name));
+        return slots[slot] >= 0 ? &entries[static_cast<size_t>(slots[slot])] : nullptr;
+    }
+
+    symbol &symbol_table::insert(const std::string_view name, bool &inserted)
+    {
+        const auto hash_value = hash(name);
+        auto slot = probe(name, hash_value);
+
+        if (slots[slot] >= 0)
+        {
+            inserted = false;
+            return entries[static_cast<size_t>(slots[slot])];
+        }
+
+        /* keep the load factor at most 1/2 */
+        if ((entries.size() + 1) * 2 > slots.size())
+        {
+            rehash(slots.size() * 2);
+            slot = probe(name, hash_value);
+        }
+
+        slots[slot] = static_cast<int32_t>(entries.size());
+        hashes.push_back(hash_value);
+        entries.emplace_back();
+        entries.back().name = name;
+        inserted = true;
+        return entries.back();
+    }
+
+}
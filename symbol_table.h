@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace assembler {
+
+    enum class symbol_kind
+    {
+        label,      // address of a label, known after the placement
+        constant,   // DEF with a numeric value
+        alias       // DEF referring to another symbol
+    };
+
+    class symbol
+    {
+    public:
+        std::string name;
+        symbol_kind kind{symbol_kind::label};
+        int value{};
+        bool resolved{};
+        std::string alias;
+        std::string_view file;
+        int line{};
+    };
+
+    /**
+     * Symbol table with open addressing (linear probing) over a power of two
+     * array of slots. Symbols are stored in the order of their definition,
+     * slots only keep their indexes, so growing the table rehashes integers
+     * and does not move any string.
+     */
+    class symbol_table
+    {
+    public:
+        symbol_table();
+
+        symbol *find(std::string_view name);
+        symbol &insert(std::string_view name, bool &inserted);
+        void truncate(size_t count);
+
+        std::vector<symbol> &symbols() { return entries; }
+        const std::vector<symbol> &symbols() const { return entries; }
+
+    private:
+        static uint32_t hash(std::string_view name);
+        size_t probe(std::string_view name, uint32_t hash_value) const;
+        void rehash(size_t slot_count);
+
+        std::vector<int32_t> slots;
+        std::vector<uint32_t> hashes;
+        std::vector<symbol> entries;
+    };
+
+}
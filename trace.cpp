@@ -0,0 +1,491 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    trace.cpp                                                        */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Recording and replay of the binary traces (see trace.h). The replay       */
+/* restores the checkpoint before the instruction asked for and executes     */
+/* the machine from there, checking every instruction against its record,    */
+/* so it also tells where a run went a different way than the traced one.    */
+/*                                                                           */
+/*****************************************************************************/
+
+/* INCLUDES ******************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+
+#include "trace.h"
+
+/* RECORDER ******************************************************************/
+
+/**
+ *
+ * Writer thread. Puts the blocks handed over by the machine to the file in
+ * the order they were filled.
+ *
+ */
+static void trace_writer_main(trace_writer &t)
+{
+    std::unique_lock<std::mutex> guard(t.lock);
+
+    for (;;)
+    {
+        t.changed.wait(guard, [&t] { return t.written < t.queued || t.closing; });
+
+        if (t.written == t.queued) break;
+
+        const trace_block &block = t.blocks[t.written % TRACE_BLOCKS];
+
+        guard.unlock();
+        const bool ok = fwrite(block.data, 1, block.used, t.file) == block.used;
+        guard.lock();
+
+        if (!ok) t.failed = true;
+        t.written++;
+        t.changed.notify_all();
+    }
+}
+
+/**
+ *
+ * Creates the trace file. A checkpoint is recorded every interval
+ * instructions, the first one before the first instruction.
+ *
+ */
+bool open_trace(trace_writer &t, const std::string &filename, const uint64_t interval)
+{
+    trace_header header = {};
+
+    t.file = fopen(filename.c_str(), "wb");
+    if (!t.file) return false;
+
+    header.magic = TRACE_MAGIC;
+    header.version = TRACE_VERSION;
+    header.interval = interval ? interval : TRACE_INTERVAL;
+
+    if (fwrite(&header, sizeof(header), 1, t.file) != 1)
+    {
+        fclose(t.file);
+        t.file = nullptr;
+        return false;
+    }
+
+    t.interval = header.interval;
+    t.executed = 0;
+    t.next_checkpoint = 0;
+    t.expected = 0;
+    t.checkpoints.clear();
+
+    t.blocks.reset(new trace_block[TRACE_BLOCKS]);
+    t.queued = 0;
+    t.written = 0;
+    t.closing = false;
+    t.failed = false;
+    t.cursor = t.blocks[0].data;
+    t.limit = t.cursor + TRACE_BLOCK_SIZE;
+    t.offset = sizeof(header);
+
+    t.thread = std::thread(trace_writer_main, std::ref(t));
+    return true;
+}
+
+/**
+ *
+ * Hands the block being filled to the writer thread and starts the next
+ * one, waiting for it to be written first if the ring is full.
+ *
+ */
+void next_trace_block(trace_writer &t)
+{
+    std::unique_lock<std::mutex> guard(t.lock);
+    trace_block &block = t.blocks[t.queued % TRACE_BLOCKS];
+
+    block.used = static_cast<uint32_t>(t.cursor - block.data);
+    t.offset += block.used;
+    t.queued++;
+    t.changed.notify_all();
+
+    t.changed.wait(guard, [&t] { return t.queued - t.written < TRACE_BLOCKS; });
+
+    t.cursor = t.blocks[t.queued % TRACE_BLOCKS].data;
+    t.limit = t.cursor + TRACE_BLOCK_SIZE;
+}
+
+/**
+ *
+ * Copies bytes to the ring, over as many blocks as they need.
+ *
+ */
+static void trace_put(trace_writer &t, const uint8_t *data, size_t size)
+{
+    while (size)
+    {
+        size_t part = static_cast<size_t>(t.limit - t.cursor);
+
+        if (part == 0)
+        {
+            next_trace_block(t);
+            continue;
+        }
+
+        if (part > size) part = size;
+
+        memcpy(t.cursor, data, part);
+        t.cursor += part;
+        data += part;
+        size -= part;
+    }
+}
+
+/**
+ *
+ * Records the block written by MEMCPY or MEMSET, after the varint of the
+ * record: address, length and the bytes as they are in the memory now.
+ *
+ */
+void trace_block_write(trace_writer &t, const trace_step &step, const Machine &m)
+{
+    uint8_t head[2 + 5];
+    uint8_t *end;
+
+    head[0] = static_cast<uint8_t>(step.address);
+    head[1] = static_cast<uint8_t>(step.address >> 8);
+    end = trace_varint(head + 2, step.length);
+    trace_put(t, head, static_cast<size_t>(end - head));
+
+    const uint32_t part = MEM_SIZE + 1 - static_cast<uint32_t>(step.address);
+
+    if (step.length <= part)
+    {
+        trace_put(t, m.mem + step.address, step.length);
+    }
+    else
+    {
+        trace_put(t, m.mem + step.address, part);
+        trace_put(t, m.mem, step.length - part);
+    }
+
+    if (t.cursor + TRACE_RECORD_MAX > t.limit) next_trace_block(t);
+}
+
+/**
+ *
+ * Starts a new chunk with the state of the machine before the next
+ * instruction.
+ *
+ */
+void trace_checkpoint(trace_writer &t, const Machine &m)
+{
+    std::unique_ptr<trace_state> state(new trace_state());
+
+    state->index = t.executed;
+    state->ip = m.ip;
+    state->sp = m.sp;
+    state->bp = m.bp;
+    memcpy(state->r, m.r, sizeof(state->r));
+    state->c = m.c;
+    state->stop = m.stop;
+    memcpy(state->mem, m.mem, sizeof(state->mem));
+
+    t.checkpoints.push_back(t.offset + static_cast<uint64_t>(t.cursor - t.blocks[t.queued % TRACE_BLOCKS].data));
+    trace_put(t, reinterpret_cast<const uint8_t *>(state.get()), sizeof(trace_state));
+
+    t.expected = m.ip;
+    t.next_checkpoint += t.interval;
+}
+
+/**
+ *
+ * Writes the rest of the ring, the chunk table and the footer and closes
+ * the file. Returns false if any of the writes failed.
+ *
+ */
+bool close_trace(trace_writer &t)
+{
+    trace_footer footer = {};
+    bool ok;
+
+    if (!t.file) return false;
+
+    if (t.cursor != t.blocks[t.queued % TRACE_BLOCKS].data) next_trace_block(t);
+
+    {
+        std::lock_guard<std::mutex> guard(t.lock);
+
+        t.closing = true;
+        t.changed.notify_all();
+    }
+
+    t.thread.join();
+
+    footer.instructions = t.executed;
+    footer.checkpoints = t.checkpoints.size();
+    footer.table = t.offset;
+    footer.magic = TRACE_MAGIC;
+
+    ok = !t.failed;
+    ok = ok && fwrite(t.checkpoints.data(), sizeof(uint64_t), t.checkpoints.size(), t.file) == t.checkpoints.size();
+    ok = ok && fwrite(&footer, sizeof(footer), 1, t.file) == 1;
+    ok = fclose(t.file) == 0 && ok;
+
+    t.file = nullptr;
+    t.blocks.reset();
+    return ok;
+}
+
+/* REPLAY ********************************************************************/
+
+/**
+ *
+ * Opens a trace and reads its header, footer and chunk table.
+ *
+ */
+bool open_replay(trace_reader &t, const std::string &filename)
+{
+    t.file = fopen(filename.c_str(), "rb");
+    if (!t.file) return false;
+
+    if (fread(&t.header, sizeof(t.header), 1, t.file) != 1 || t.header.magic != TRACE_MAGIC ||
+        t.header.version != TRACE_VERSION || fseek(t.file, -static_cast<long>(sizeof(t.footer)), SEEK_END) != 0 ||
+        fread(&t.footer, sizeof(t.footer), 1, t.file) != 1 || t.footer.magic != TRACE_MAGIC ||
+        t.footer.checkpoints == 0 || fseek(t.file, static_cast<long>(t.footer.table), SEEK_SET) != 0)
+    {
+        close_replay(t);
+        return false;
+    }
+
+    t.checkpoints.resize(t.footer.checkpoints);
+
+    if (fread(t.checkpoints.data(), sizeof(uint64_t), t.checkpoints.size(), t.file) != t.checkpoints.size())
+    {
+        close_replay(t);
+        return false;
+    }
+
+    return true;
+}
+
+void close_replay(trace_reader &t)
+{
+    if (t.file) fclose(t.file);
+    t.file = nullptr;
+}
+
+/**
+ *
+ * Reads a varint of a record, returns false at the end of the chunk.
+ *
+ */
+static bool read_varint(const uint8_t *&in, const uint8_t *end, uint32_t &value)
+{
+    uint32_t shift = 0;
+
+    value = 0;
+
+    while (in < end && shift < 32)
+    {
+        const uint8_t byte = *in++;
+
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+        shift += 7;
+    }
+
+    return false;
+}
+
+/**
+ *
+ * Checks the block of a record (see trace_block_write) against the memory
+ * after the replayed instruction and moves past it.
+ *
+ */
+static bool replay_block(const uint8_t *&in, const uint8_t *end, const trace_step &step, const Machine &m)
+{
+    uint32_t length;
+    uint32_t i;
+
+    if (end - in < 2) return false;
+
+    const uint16_t address = static_cast<uint16_t>(in[0] | in[1] << 8);
+
+    in += 2;
+
+    if (!read_varint(in, end, length) || address != step.address || length != step.length ||
+        end - in < static_cast<ptrdiff_t>(length))
+    {
+        return false;
+    }
+
+    for (i = 0; i < length; i++)
+    {
+        if (in[i] != m.mem[static_cast<uint16_t>(address + i)]) return false;
+    }
+
+    in += length;
+    return true;
+}
+
+/**
+ *
+ * Brings the machine to the state before the instruction index: restores
+ * the closest checkpoint and executes the instructions after it. Every one
+ * is checked against its record; the first one which runs from another
+ * address or writes other bytes stops the replay with an error, leaving
+ * the machine before it. Returns the index reached.
+ *
+ */
+uint64_t replay_trace(trace_reader &t, Machine &m, uint64_t index, std::string &error)
+{
+    std::unique_ptr<trace_state> state(new trace_state());
+    std::vector<uint8_t> chunk;
+    uint64_t k;
+    char text[128];
+
+    error.clear();
+
+    if (index > t.footer.instructions) index = t.footer.instructions;
+
+    k = index / t.header.interval;
+    if (k >= t.checkpoints.size()) k = t.checkpoints.size() - 1;
+
+    const uint64_t start = t.checkpoints[k] + sizeof(trace_state);
+    const uint64_t end = k + 1 < t.checkpoints.size() ? t.checkpoints[k + 1] : t.footer.table;
+
+    if (fseek(t.file, static_cast<long>(t.checkpoints[k]), SEEK_SET) != 0 ||
+        fread(state.get(), sizeof(trace_state), 1, t.file) != 1 || end < start)
+    {
+        error = "can not read the checkpoint";
+        return 0;
+    }
+
+    chunk.resize(static_cast<size_t>(end - start));
+
+    if (!chunk.empty() && fread(chunk.data(), 1, chunk.size(), t.file) != chunk.size())
+    {
+        error = "can not read the records";
+        return 0;
+    }
+
+    init_machine(m);
+    m.ip = state->ip;
+    m.sp = state->sp;
+    m.bp = state->bp;
+    memcpy(m.r, state->r, sizeof(m.r));
+    m.c = state->c;
+    m.stop = state->stop;
+    memcpy(m.mem, state->mem, sizeof(m.mem));
+
+    const uint8_t *in = chunk.data();
+    const uint8_t *limit = in + chunk.size();
+    uint16_t expected = m.ip;
+    uint64_t i;
+
+    for (i = state->index; i < index; i++)
+    {
+        trace_write writes[2];
+        trace_step step;
+        uint32_t value;
+        uint8_t count;
+        uint8_t w;
+
+        if (!read_varint(in, limit, value) ||
+            ((value & 3) != TRACE_BLOCK_WRITE && limit - in < static_cast<ptrdiff_t>(3 * (value & 3))))
+        {
+            snprintf(text, sizeof(text), "instruction %llu: record cut short", static_cast<unsigned long long>(i));
+            error = text;
+            return i;
+        }
+
+        const uint16_t zigzag = static_cast<uint16_t>(value >> 2);
+        const uint16_t ip = static_cast<uint16_t>(expected + ((zigzag >> 1) ^ -(zigzag & 1)));
+
+        if (m.stop || m.ip != ip)
+        {
+            snprintf(text, sizeof(text), "instruction %llu: traced at 0x%04x, replayed %s 0x%04x",
+                     static_cast<unsigned long long>(i), ip, m.stop ? "stopped at" : "at", m.ip);
+            error = text;
+            return i;
+        }
+
+        begin_step(step, m);
+        process_instruction(m);
+        count = end_step(step, m, writes);
+
+        bool same = count == (value & 3);
+
+        if (same && count == TRACE_BLOCK_WRITE)
+        {
+            same = replay_block(in, limit, step, m);
+            count = 0;
+        }
+
+        for (w = 0; w < count && same; w++)
+        {
+            same = writes[w].address == (in[3 * w] | in[3 * w + 1] << 8) && writes[w].value == in[3 * w + 2];
+        }
+
+        if (!same)
+        {
+            snprintf(text, sizeof(text), "instruction %llu at 0x%04x: writes differ from the trace",
+                     static_cast<unsigned long long>(i), ip);
+            error = text;
+            return i;
+        }
+
+        in += 3 * count;
+        expected = static_cast<uint16_t>(ip + instruction_length(step.opcode));
+    }
+
+    return i;
+}
+
+/* REPLAY TOOL ***************************************************************/
+
+/**
+ *
+ * Replays a trace to an instruction and dumps the state of the machine
+ * before it, or replays all of it without an index.
+ *
+ *     sophia8 --replay trace.s8t [index]
+ *
+ */
+int replay_main(int argc, char *argv[])
+{
+    trace_reader t;
+    std::string error;
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: sophia8 --replay trace.s8t [index]\n");
+        return 1;
+    }
+
+    if (!open_replay(t, argv[2]))
+    {
+        fprintf(stderr, "can not read trace %s\n", argv[2]);
+        return 1;
+    }
+
+    const uint64_t index = argc > 3 ? strtoull(argv[3], nullptr, 0) : t.footer.instructions;
+    std::unique_ptr<Machine> m(new Machine());
+    const uint64_t reached = replay_trace(t, *m, index, error);
+
+    close_replay(t);
+
+    print_memory(*m);
+    print_registers(*m);
+    printf("instruction %llu of %llu\n", static_cast<unsigned long long>(reached),
+           static_cast<unsigned long long>(t.footer.instructions));
+
+    if (!error.empty())
+    {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,308 @@
+/*****************************************************************************/
+/*                                                                           */
+/* Project: Sophia8 - an 8 bit virtual machine                               */
+/* File:    trace.h                                                          */
+/*                                                                           */
+/* Description:                                                              */
+/*                                                                           */
+/* Binary execution trace of a machine run by run_traced. Every instruction  */
+/* leaves a record of its address, as a difference from the address that     */
+/* follows the previous instruction, and of the bytes it wrote to the        */
+/* memory. Every interval instructions a checkpoint with the whole state of  */
+/* the machine starts a new chunk, so a replay can begin close to any        */
+/* instruction:                                                              */
+/*                                                                           */
+/*     trace_header                                                          */
+/*     trace_state, records          (chunk 0, instructions 0 ...)           */
+/*     trace_state, records          (chunk 1, instructions interval ...)    */
+/*     ...                                                                   */
+/*     file offsets of the chunks    (uint64_t[checkpoints])                 */
+/*     trace_footer                                                          */
+/*                                                                           */
+/* A record is a varint of (zigzag(ip difference) << 2 | writes) followed by  */
+/* the writes as address (2 bytes) and value. Instructions running straight  */
+/* on take a single byte. MEMCPY and MEMSET record 3 for the writes and the  */
+/* block instead: its address (2 bytes), a varint of its length and the      */
+/* bytes written. All numbers are little endian.                             */
+/*                                                                           */
+/*****************************************************************************/
+
+#ifndef __TRACE_H_
+#define __TRACE_H_
+
+/* INCLUDES ******************************************************************/
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "definitions.h"
+#include "machine.h"
+
+/* TRACE FORMAT **************************************************************/
+
+#define TRACE_MAGIC         0x52543853  /* "S8TR"                            */
+#define TRACE_VERSION       1
+
+#define TRACE_INTERVAL      (1 << 20)   /* instructions between checkpoints  */
+
+#pragma pack(push, 1)
+
+struct trace_header
+{
+    uint32_t magic;             /* TRACE_MAGIC                               */
+    uint16_t version;           /* TRACE_VERSION                             */
+    uint16_t reserved;
+    uint64_t interval;          /* instructions between two checkpoints      */
+};
+
+struct trace_state
+{
+    uint64_t index;             /* instructions executed before              */
+    uint16_t ip;
+    uint16_t sp;
+    uint16_t bp;
+    uint8_t  r[8];
+    uint8_t  c;
+    uint8_t  stop;
+    uint8_t  mem[MEM_SIZE + 1];
+};
+
+struct trace_footer
+{
+    uint64_t instructions;      /* instructions recorded                     */
+    uint64_t checkpoints;       /* chunks in the file                        */
+    uint64_t table;             /* file offset of the chunk offsets          */
+    uint32_t magic;             /* TRACE_MAGIC                               */
+    uint32_t reserved;
+};
+
+#pragma pack(pop)
+
+/* RECORDS *******************************************************************/
+
+#define TRACE_RECORD_MAX    16          /* bytes of the longest record       */
+#define TRACE_BLOCK_WRITE   3           /* writes of a record with a block   */
+
+struct trace_write
+{
+    uint16_t address;
+    uint8_t  value;
+};
+
+/**
+ *
+ * Instruction being traced. begin_step() looks at the machine before the
+ * instruction and end_step() after it to tell the bytes it wrote: STORE and
+ * STORER write their register to the address, PUSH and CALL the stack
+ * between the new and the old stack pointer, MEMCPY and MEMSET a block.
+ *
+ */
+struct trace_step
+{
+    uint16_t ip;
+    uint16_t sp;                /* stack pointer before                      */
+    uint16_t address;           /* STORE, STORER target                      */
+    uint8_t  value;             /* STORE, STORER value                       */
+    uint8_t  opcode;
+    uint16_t length;            /* MEMCPY, MEMSET bytes (0 for none)         */
+};
+
+static inline uint8_t trace_register(const Machine &m, const uint8_t code)
+{
+    return code >= IR0 && code <= IR7 ? m.r[code - IR0] : 0;
+}
+
+/* operand byte of the instruction at ip, the address wraps like ip does */
+
+static inline uint8_t trace_operand(const Machine &m, const uint8_t index)
+{
+    return m.mem[static_cast<uint16_t>(m.ip + 1 + index)];
+}
+
+static inline void begin_step(trace_step &step, const Machine &m)
+{
+    step.ip = m.ip;
+    step.sp = m.sp;
+    step.opcode = m.mem[m.ip];
+
+    if (step.opcode == STORE)
+    {
+        step.value = trace_register(m, trace_operand(m, 0));
+        step.address = static_cast<uint16_t>(trace_operand(m, 1) << 8 | trace_operand(m, 2));
+    }
+    else if (step.opcode == STORER)
+    {
+        step.value = trace_register(m, trace_operand(m, 0));
+        step.address = static_cast<uint16_t>(trace_register(m, trace_operand(m, 1)) << 8 |
+                                              trace_register(m, trace_operand(m, 2)));
+    }
+    else if (step.opcode == MEMCPY || step.opcode == MEMSET)
+    {
+        const uint8_t first = step.opcode == MEMCPY ? 1 : 2;
+        const uint8_t last = step.opcode == MEMCPY ? 6 : 5;
+        uint8_t codes[6];
+        uint8_t i;
+
+        step.length = 0;
+
+        for (i = 0; i < last; i++)
+        {
+            codes[i] = trace_operand(m, i);
+            if (codes[i] < IR0 || codes[i] > IR7) return;
+        }
+
+        step.address = static_cast<uint16_t>(trace_register(m, codes[first - 1]) << 8 | trace_register(m, codes[first]));
+        step.length = static_cast<uint16_t>(trace_register(m, codes[last - 2]) << 8 | trace_register(m, codes[last - 1]));
+    }
+}
+
+static inline uint8_t end_step(const trace_step &step, const Machine &m, trace_write *writes)
+{
+    uint8_t count = 0;
+    uint16_t address;
+
+    if (step.opcode == STORE || step.opcode == STORER)
+    {
+        writes[0].address = step.address;
+        writes[0].value = step.value;
+        return 1;
+    }
+
+    if ((step.opcode == MEMCPY || step.opcode == MEMSET) && step.length)
+    {
+        return TRACE_BLOCK_WRITE;
+    }
+
+    if (step.opcode == PUSH || step.opcode == CALL)
+    {
+        for (address = m.sp; address != step.sp && count < 2; address++)
+        {
+            writes[count].address = address;
+            writes[count].value = m.mem[address];
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/* RECORDER ******************************************************************/
+
+#define TRACE_BLOCK_SIZE    (1 << 16)   /* bytes written to the file at once */
+#define TRACE_BLOCKS        8           /* blocks in the ring                */
+
+struct trace_block
+{
+    uint8_t  data[TRACE_BLOCK_SIZE];
+    uint32_t used;
+};
+
+/**
+ *
+ * Trace being recorded. The machine fills the blocks of the ring and a
+ * thread of the writer puts the full ones to the file, so the machine only
+ * waits when the disk falls behind by the whole ring.
+ *
+ */
+struct trace_writer
+{
+    FILE    *file = nullptr;
+    uint64_t interval = TRACE_INTERVAL;
+    uint64_t executed = 0;              /* instructions recorded             */
+    uint64_t next_checkpoint = 0;       /* instruction of the next one       */
+    uint16_t expected = 0;              /* address after the previous one    */
+    std::vector<uint64_t> checkpoints;  /* file offsets of the chunks        */
+
+    /* block filled by the machine */
+
+    uint8_t *cursor = nullptr;
+    uint8_t *limit = nullptr;
+    uint64_t offset = 0;                /* file offset of the block          */
+
+    /* ring shared with the writer thread (counts of blocks) */
+
+    std::unique_ptr<trace_block[]> blocks;
+    uint64_t queued = 0;                /* handed to the thread              */
+    uint64_t written = 0;               /* put to the file                   */
+    bool     closing = false;
+    bool     failed = false;
+    std::mutex lock;
+    std::condition_variable changed;
+    std::thread thread;
+};
+
+bool open_trace(trace_writer &t, const std::string &filename, uint64_t interval);
+void trace_checkpoint(trace_writer &t, const Machine &m);
+void next_trace_block(trace_writer &t);
+bool close_trace(trace_writer &t);
+void trace_block_write(trace_writer &t, const trace_step &step, const Machine &m);
+
+static inline uint8_t *trace_varint(uint8_t *out, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+/**
+ *
+ * Records an executed instruction (see begin_step and end_step).
+ *
+ */
+static inline void trace_instruction(trace_writer &t, const trace_step &step, const Machine &m)
+{
+    trace_write writes[2];
+    uint8_t count = end_step(step, m, writes);
+    const int16_t delta = static_cast<int16_t>(step.ip - t.expected);
+    const uint32_t zigzag = static_cast<uint16_t>((delta << 1) ^ (delta >> 15));
+    uint8_t i;
+
+    if (t.cursor + TRACE_RECORD_MAX > t.limit) next_trace_block(t);
+
+    t.cursor = trace_varint(t.cursor, zigzag << 2 | count);
+
+    if (count == TRACE_BLOCK_WRITE)
+    {
+        trace_block_write(t, step, m);
+        count = 0;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        t.cursor[0] = static_cast<uint8_t>(writes[i].address);
+        t.cursor[1] = static_cast<uint8_t>(writes[i].address >> 8);
+        t.cursor[2] = writes[i].value;
+        t.cursor += 3;
+    }
+
+    t.expected = static_cast<uint16_t>(step.ip + instruction_length(step.opcode));
+    t.executed++;
+}
+
+/* REPLAY ********************************************************************/
+
+struct trace_reader
+{
+    FILE *file = nullptr;
+    trace_header header;
+    trace_footer footer;
+    std::vector<uint64_t> checkpoints;
+};
+
+bool open_replay(trace_reader &t, const std::string &filename);
+void close_replay(trace_reader &t);
+uint64_t replay_trace(trace_reader &t, Machine &m, uint64_t index, std::string &error);
+int replay_main(int argc, char *argv[]);
+
+#endif